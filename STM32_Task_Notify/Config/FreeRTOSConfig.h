@@ -69,6 +69,42 @@
 #define configUSE_COUNTING_SEMAPHORES	1
 #define configGENERATE_RUN_TIME_STATS	0
 
+/* The objects listed in inc/app_objects.h are placed in statically allocated
+memory, so nothing is taken from the heap at start up.  The heap is still
+available for objects created at run time. */
+#define configSUPPORT_STATIC_ALLOCATION		1
+#define configSUPPORT_DYNAMIC_ALLOCATION	1
+
+#define configUSE_BLOCK_POOLS			1
+#define configUSE_ARENAS				1
+#define configUSE_QUEUE_LOANS			1
+#define configUSE_QUEUE_BATCHES			1
+#define configUSE_SPSC_RINGS			1
+#define configUSE_QUEUE_WORD_COPY		1
+#define configUSE_PRIORITY_QUEUES		1
+#define configUSE_TOPIC_BUS				1
+#define configUSE_FAST_MUTEXES			1
+#define configUSE_RW_LOCKS				1
+#define configUSE_QUEUE_STATISTICS		1
+#define configUSE_OBJECT_REGISTRY		1
+#define configOBJECT_REGISTRY_SIZE		16
+#define configUSE_STREAM_BUFFER_ZERO_COPY	1
+#define configUSE_STREAM_BUFFER_MULTI_PRODUCER	1
+#define configUSE_COMPACT_MESSAGE_LENGTHS	1
+#define configUSE_STREAM_BUFFER_COALESCING	1
+#define configUSE_INDEXED_EVENT_GROUPS	1
+#define configUSE_EVENT_GROUP_ISR_DIRECT	1
+#define configEVENT_GROUP_ISR_MAX_WAITERS	8
+#define configUSE_64_BIT_EVENT_GROUPS	1
+
+/* Relocatable heap definitions.  Set configUSE_RELOCATABLE_HEAP to 1 to
+reserve configRELOCATABLE_HEAP_SIZE bytes for handle based buffers that the
+idle task compacts in the background. */
+#define configUSE_RELOCATABLE_HEAP					0
+#define configRELOCATABLE_HEAP_SIZE					( ( size_t ) ( 16 * 1024 ) )
+#define configRELOCATABLE_HEAP_MAX_HANDLES			16
+#define configRELOCATABLE_HEAP_COMPACT_STEP_BYTES	256
+
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES 		0
 #define configMAX_CO_ROUTINE_PRIORITIES ( 2 )
@@ -78,6 +114,7 @@
 #define configTIMER_TASK_PRIORITY		( 2 )
 #define configTIMER_QUEUE_LENGTH		10
 #define configTIMER_TASK_STACK_DEPTH	( configMINIMAL_STACK_SIZE * 2 )
+#define configUSE_TIMER_WHEEL			1
 
 /* Set the following definitions to 1 to include the API function, or zero
 to exclude the API function. */
@@ -0,0 +1,325 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "arena.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* This entire source file will be skipped if the application is not configured
+to include arena functionality. */
+#if( configUSE_ARENAS == 1 )
+
+/* Bits stored in the ucFlags field of the arena. */
+#define arFLAGS_IS_STATICALLY_ALLOCATED ( ( uint8_t ) 1 ) /* Set if the arena was created using statically allocated memory. */
+
+/*-----------------------------------------------------------*/
+
+/* Structure that holds the state of an arena. */
+typedef struct xARENA /*lint !e9058 Style convention uses tag. */
+{
+	uint8_t *pucStorage;		/* Points to the first byte of the arena's memory. */
+	size_t xSize;				/* The number of bytes pucStorage points to. */
+	size_t xUsed;				/* Offset of the next free byte, always a multiple of portBYTE_ALIGNMENT. */
+	size_t xHighWaterMark;		/* The largest value xUsed has held. */
+	UBaseType_t uxScopeDepth;	/* The number of scopes that are currently open. */
+	uint8_t ucFlags;
+} Arena_t;
+
+/*
+ * Called by both xArenaCreate() and xArenaCreateStatic() to initialise the
+ * arena structure.
+ */
+static void prvInitialiseNewArena( Arena_t * const pxArena, uint8_t * const pucStorage, size_t xSize ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	ArenaHandle_t xArenaCreate( size_t xArenaSizeBytes )
+	{
+	uint8_t *pucAllocatedMemory;
+	size_t xHeaderSize;
+
+		configASSERT( xArenaSizeBytes > ( size_t ) 0 );
+
+		/* The Arena_t structure is placed at the start of the allocated memory,
+		padded so the storage that follows it is aligned. */
+		xHeaderSize = ( sizeof( Arena_t ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+		/* Check for addition overflow. */
+		if( ( xHeaderSize + xArenaSizeBytes ) > xArenaSizeBytes )
+		{
+			pucAllocatedMemory = ( uint8_t * ) pvPortMalloc( xHeaderSize + xArenaSizeBytes ); /*lint !e9079 malloc() only returns void*. */
+		}
+		else
+		{
+			pucAllocatedMemory = NULL;
+		}
+
+		if( pucAllocatedMemory != NULL )
+		{
+			prvInitialiseNewArena( ( Arena_t * ) pucAllocatedMemory, /*lint !e9087 !e826 Safe cast as allocated memory is aligned. */
+								   pucAllocatedMemory + xHeaderSize,
+								   xArenaSizeBytes );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return ( ArenaHandle_t ) pucAllocatedMemory;
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+	ArenaHandle_t xArenaCreateStatic( size_t xArenaSizeBytes,
+									  uint8_t * const pucArenaStorageArea,
+									  StaticArena_t * const pxStaticArena )
+	{
+	Arena_t * const pxArena = ( Arena_t * ) pxStaticArena; /*lint !e740 !e9087 Safe cast as StaticArena_t is opaque Arena_t. */
+	ArenaHandle_t xReturn;
+
+		configASSERT( pucArenaStorageArea );
+		configASSERT( pxStaticArena );
+		configASSERT( ( ( ( portPOINTER_SIZE_TYPE ) pucArenaStorageArea ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+
+		#if( configASSERT_DEFINED == 1 )
+		{
+			/* Sanity check that the size of the structure used to declare a
+			variable of type StaticArena_t equals the size of the real arena
+			structure. */
+			volatile size_t xSize = sizeof( StaticArena_t );
+			configASSERT( xSize == sizeof( Arena_t ) );
+		}
+		#endif /* configASSERT_DEFINED */
+
+		if( ( pucArenaStorageArea != NULL ) && ( pxStaticArena != NULL ) )
+		{
+			prvInitialiseNewArena( pxArena, pucArenaStorageArea, xArenaSizeBytes );
+
+			/* Remember this was statically allocated in case it is ever deleted
+			again. */
+			pxArena->ucFlags |= arFLAGS_IS_STATICALLY_ALLOCATED;
+
+			xReturn = ( ArenaHandle_t ) pxStaticArena;
+		}
+		else
+		{
+			xReturn = NULL;
+		}
+
+		return xReturn;
+	}
+
+#endif /* ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+/*-----------------------------------------------------------*/
+
+void vArenaDelete( ArenaHandle_t xArena )
+{
+Arena_t * const pxArena = ( Arena_t * ) xArena; /*lint !e9087 !e9079 Safe cast as ArenaHandle_t is opaque Arena_t. */
+
+	configASSERT( pxArena );
+
+	if( ( pxArena->ucFlags & arFLAGS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) pdFALSE )
+	{
+		#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+		{
+			/* The structure and the storage were allocated using a single call
+			to pvPortMalloc(), hence only one call to vPortFree() is required. */
+			vPortFree( ( void * ) pxArena );
+		}
+		#else
+		{
+			/* Should not be possible to get here, ucFlags must be corrupt.
+			Force an assert. */
+			configASSERT( xArena == ( ArenaHandle_t ) ~0 );
+		}
+		#endif
+	}
+	else
+	{
+		/* The structure and storage were not allocated dynamically and cannot
+		be freed - just scrub the structure so future use will assert. */
+		memset( pxArena, 0x00, sizeof( Arena_t ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void *pvArenaAlloc( ArenaHandle_t xArena, size_t xWantedSize )
+{
+Arena_t * const pxArena = ( Arena_t * ) xArena; /*lint !e9087 !e9079 Safe cast as ArenaHandle_t is opaque Arena_t. */
+void *pvReturn = NULL;
+
+	configASSERT( pxArena );
+	configASSERT( pxArena->pucStorage );
+
+	/* Round the request up so the next allocation is also aligned.  The free
+	space is always a multiple of portBYTE_ALIGNMENT, so checking the size before
+	rounding it up also guarantees the rounding cannot overflow. */
+	if( xWantedSize > ( pxArena->xSize - pxArena->xUsed ) )
+	{
+		xWantedSize = ( size_t ) 0;
+	}
+	else if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+	{
+		xWantedSize += ( portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK ) );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( ( xWantedSize > ( size_t ) 0 ) && ( xWantedSize <= ( pxArena->xSize - pxArena->xUsed ) ) )
+	{
+		pvReturn = ( void * ) ( pxArena->pucStorage + pxArena->xUsed );
+		pxArena->xUsed += xWantedSize;
+
+		if( pxArena->xUsed > pxArena->xHighWaterMark )
+		{
+			pxArena->xHighWaterMark = pxArena->xUsed;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vArenaReset( ArenaHandle_t xArena )
+{
+Arena_t * const pxArena = ( Arena_t * ) xArena; /*lint !e9087 !e9079 Safe cast as ArenaHandle_t is opaque Arena_t. */
+
+	configASSERT( pxArena );
+
+	pxArena->xUsed = ( size_t ) 0;
+	pxArena->uxScopeDepth = ( UBaseType_t ) 0;
+}
+/*-----------------------------------------------------------*/
+
+ArenaMark_t xArenaScopeBegin( ArenaHandle_t xArena )
+{
+Arena_t * const pxArena = ( Arena_t * ) xArena; /*lint !e9087 !e9079 Safe cast as ArenaHandle_t is opaque Arena_t. */
+
+	configASSERT( pxArena );
+
+	( pxArena->uxScopeDepth )++;
+
+	/* The mark is simply the current fill level. */
+	return ( ArenaMark_t ) pxArena->xUsed;
+}
+/*-----------------------------------------------------------*/
+
+void vArenaScopeEnd( ArenaHandle_t xArena, ArenaMark_t xMark )
+{
+Arena_t * const pxArena = ( Arena_t * ) xArena; /*lint !e9087 !e9079 Safe cast as ArenaHandle_t is opaque Arena_t. */
+
+	configASSERT( pxArena );
+
+	/* A scope must be open, and the mark cannot be above the current fill
+	level unless an inner scope was not closed or the arena was reset while the
+	scope was open. */
+	configASSERT( pxArena->uxScopeDepth > ( UBaseType_t ) 0 );
+	configASSERT( ( size_t ) xMark <= pxArena->xUsed );
+
+	if( ( pxArena->uxScopeDepth > ( UBaseType_t ) 0 ) && ( ( size_t ) xMark <= pxArena->xUsed ) )
+	{
+		( pxArena->uxScopeDepth )--;
+		pxArena->xUsed = ( size_t ) xMark;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t xArenaGetBytesUsed( ArenaHandle_t xArena )
+{
+const Arena_t * const pxArena = ( Arena_t * ) xArena; /*lint !e9087 !e9079 Safe cast as ArenaHandle_t is opaque Arena_t. */
+
+	configASSERT( pxArena );
+
+	return pxArena->xUsed;
+}
+/*-----------------------------------------------------------*/
+
+size_t xArenaGetFreeSize( ArenaHandle_t xArena )
+{
+const Arena_t * const pxArena = ( Arena_t * ) xArena; /*lint !e9087 !e9079 Safe cast as ArenaHandle_t is opaque Arena_t. */
+
+	configASSERT( pxArena );
+
+	return pxArena->xSize - pxArena->xUsed;
+}
+/*-----------------------------------------------------------*/
+
+size_t xArenaGetHighWaterMark( ArenaHandle_t xArena )
+{
+const Arena_t * const pxArena = ( Arena_t * ) xArena; /*lint !e9087 !e9079 Safe cast as ArenaHandle_t is opaque Arena_t. */
+
+	configASSERT( pxArena );
+
+	return pxArena->xHighWaterMark;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseNewArena( Arena_t * const pxArena, uint8_t * const pucStorage, size_t xSize )
+{
+	memset( ( void * ) pxArena, 0x00, sizeof( Arena_t ) ); /*lint !e9087 memset() requires void *. */
+
+	pxArena->pucStorage = pucStorage;
+
+	/* Only whole aligned units can be handed out. */
+	pxArena->xSize = xSize & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+}
+
+/* This entire source file will be skipped if the application is not configured
+to include arena functionality. */
+#endif /* configUSE_ARENAS == 1 */
@@ -0,0 +1,491 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "block_pool.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* This entire source file will be skipped if the application is not configured
+to include block pool functionality. */
+#if( configUSE_BLOCK_POOLS == 1 )
+
+/* The free list head packs the one based index of the first free block into
+the lower 16 bits (0 meaning the pool is empty) and a modification tag into the
+upper 16 bits.  The tag is incremented on every push and pop so a stale head
+read by a context that was interrupted part way through an update can never
+compare equal again (the ABA problem). */
+#define bpINDEX_MASK			( ( uint32_t ) 0x0000ffffUL )
+#define bpTAG_MASK				( ( uint32_t ) 0xffff0000UL )
+#define bpTAG_INCREMENT			( ( uint32_t ) 0x00010000UL )
+#define bpMAX_BLOCKS			( ( UBaseType_t ) bpINDEX_MASK )
+
+/* Bits stored in the ucFlags field of the block pool. */
+#define bpFLAGS_IS_STATICALLY_ALLOCATED ( ( uint8_t ) 1 ) /* Set if the pool was created using statically allocated memory. */
+
+/*-----------------------------------------------------------*/
+
+/* Structure that holds the state of a block pool.  Every member that is
+written after creation is updated with portCOMPARE_AND_SWAP_32(). */
+typedef struct xBLOCK_POOL /*lint !e9058 Style convention uses tag. */
+{
+	volatile uint32_t ulFreeListHead;			/* Tag and index of the first free block, see bpINDEX_MASK. */
+	volatile uint32_t ulFreeBlocks;				/* The number of blocks currently in the free list. */
+	volatile uint32_t ulMinimumEverFreeBlocks;	/* The lowest value ulFreeBlocks has held. */
+	volatile uint32_t ulExhaustedCount;			/* The number of allocations that failed because the pool was empty. */
+	size_t xBlockSize;							/* The size of each block in bytes, a multiple of portBYTE_ALIGNMENT. */
+	UBaseType_t uxBlockCount;					/* The number of blocks in the pool. */
+	uint8_t *pucStorage;						/* Points to the first block. */
+	uint8_t ucFlags;
+} BlockPool_t;
+
+/*
+ * Called by both xBlockPoolCreate() and xBlockPoolCreateStatic() to link every
+ * block into the free list.
+ */
+static void prvInitialiseNewBlockPool( BlockPool_t * const pxBlockPool,
+									   uint8_t * const pucStorage,
+									   size_t xBlockSize,
+									   UBaseType_t uxBlockCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Atomically add ulDelta to *pulValue, returning the updated value.
+ */
+static uint32_t prvAtomicAdd( volatile uint32_t *pulValue, uint32_t ulDelta ) PRIVILEGED_FUNCTION;
+
+/*
+ * Lower the pool's minimum ever free block count to ulFreeBlocks if it is
+ * below the value already recorded.
+ */
+static void prvUpdateMinimumEverFreeBlocks( BlockPool_t * const pxBlockPool, uint32_t ulFreeBlocks ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	BlockPoolHandle_t xBlockPoolCreate( size_t xBlockSize, UBaseType_t uxBlockCount )
+	{
+	uint8_t *pucAllocatedMemory = NULL;
+	size_t xHeaderSize, xStorageSize;
+
+		configASSERT( uxBlockCount > ( UBaseType_t ) 0 );
+		configASSERT( uxBlockCount <= bpMAX_BLOCKS );
+
+		/* Each free block holds the index of the next free block in its first
+		word, and all blocks must be aligned for any type. */
+		if( xBlockSize < sizeof( uint32_t ) )
+		{
+			xBlockSize = sizeof( uint32_t );
+		}
+
+		if( ( xBlockSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+		{
+			xBlockSize += ( portBYTE_ALIGNMENT - ( xBlockSize & portBYTE_ALIGNMENT_MASK ) );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* The BlockPool_t structure is placed at the start of the allocated
+		memory, padded so the blocks that follow it are aligned. */
+		xHeaderSize = ( sizeof( BlockPool_t ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+		xStorageSize = xBlockSize * ( size_t ) uxBlockCount;
+
+		/* Check for multiplication overflow. */
+		if( ( xStorageSize / ( size_t ) uxBlockCount ) == xBlockSize )
+		{
+			pucAllocatedMemory = ( uint8_t * ) pvPortMalloc( xHeaderSize + xStorageSize ); /*lint !e9079 malloc() only returns void*. */
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( pucAllocatedMemory != NULL )
+		{
+			prvInitialiseNewBlockPool( ( BlockPool_t * ) pucAllocatedMemory, /*lint !e9087 !e826 Safe cast as allocated memory is aligned. */
+									   pucAllocatedMemory + xHeaderSize,
+									   xBlockSize,
+									   uxBlockCount );
+
+			traceBLOCK_POOL_CREATE( ( ( BlockPool_t * ) pucAllocatedMemory ) );
+		}
+		else
+		{
+			traceBLOCK_POOL_CREATE_FAILED();
+		}
+
+		return ( BlockPoolHandle_t ) pucAllocatedMemory;
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+	BlockPoolHandle_t xBlockPoolCreateStatic( size_t xBlockSize,
+											  UBaseType_t uxBlockCount,
+											  uint8_t * const pucPoolStorageArea,
+											  StaticBlockPool_t * const pxStaticBlockPool )
+	{
+	BlockPool_t * const pxBlockPool = ( BlockPool_t * ) pxStaticBlockPool; /*lint !e740 !e9087 Safe cast as StaticBlockPool_t is opaque BlockPool_t. */
+	BlockPoolHandle_t xReturn;
+
+		configASSERT( pucPoolStorageArea );
+		configASSERT( pxStaticBlockPool );
+		configASSERT( uxBlockCount > ( UBaseType_t ) 0 );
+		configASSERT( uxBlockCount <= bpMAX_BLOCKS );
+		configASSERT( xBlockSize >= sizeof( uint32_t ) );
+		configASSERT( ( xBlockSize & portBYTE_ALIGNMENT_MASK ) == 0 );
+		configASSERT( ( ( ( portPOINTER_SIZE_TYPE ) pucPoolStorageArea ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+
+		#if( configASSERT_DEFINED == 1 )
+		{
+			/* Sanity check that the size of the structure used to declare a
+			variable of type StaticBlockPool_t equals the size of the real
+			block pool structure. */
+			volatile size_t xSize = sizeof( StaticBlockPool_t );
+			configASSERT( xSize == sizeof( BlockPool_t ) );
+		}
+		#endif /* configASSERT_DEFINED */
+
+		if( ( pucPoolStorageArea != NULL ) && ( pxStaticBlockPool != NULL ) )
+		{
+			prvInitialiseNewBlockPool( pxBlockPool, pucPoolStorageArea, xBlockSize, uxBlockCount );
+
+			/* Remember this was statically allocated in case it is ever deleted
+			again. */
+			pxBlockPool->ucFlags |= bpFLAGS_IS_STATICALLY_ALLOCATED;
+
+			traceBLOCK_POOL_CREATE( pxBlockPool );
+
+			xReturn = ( BlockPoolHandle_t ) pxStaticBlockPool;
+		}
+		else
+		{
+			xReturn = NULL;
+			traceBLOCK_POOL_CREATE_FAILED();
+		}
+
+		return xReturn;
+	}
+
+#endif /* ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+/*-----------------------------------------------------------*/
+
+void vBlockPoolDelete( BlockPoolHandle_t xBlockPool )
+{
+BlockPool_t * const pxBlockPool = ( BlockPool_t * ) xBlockPool; /*lint !e9087 !e9079 Safe cast as BlockPoolHandle_t is opaque BlockPool_t. */
+
+	configASSERT( pxBlockPool );
+
+	/* Every block must have been returned before the pool is deleted. */
+	configASSERT( pxBlockPool->ulFreeBlocks == ( uint32_t ) pxBlockPool->uxBlockCount );
+
+	traceBLOCK_POOL_DELETE( pxBlockPool );
+
+	if( ( pxBlockPool->ucFlags & bpFLAGS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) pdFALSE )
+	{
+		#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+		{
+			/* The structure and the blocks were allocated using a single call
+			to pvPortMalloc(), hence only one call to vPortFree() is required. */
+			vPortFree( ( void * ) pxBlockPool );
+		}
+		#else
+		{
+			/* Should not be possible to get here, ucFlags must be corrupt.
+			Force an assert. */
+			configASSERT( xBlockPool == ( BlockPoolHandle_t ) ~0 );
+		}
+		#endif
+	}
+	else
+	{
+		/* The structure and storage were not allocated dynamically and cannot
+		be freed - just scrub the structure so future use will assert. */
+		memset( pxBlockPool, 0x00, sizeof( BlockPool_t ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void *pvBlockPoolAlloc( BlockPoolHandle_t xBlockPool )
+{
+BlockPool_t * const pxBlockPool = ( BlockPool_t * ) xBlockPool; /*lint !e9087 !e9079 Safe cast as BlockPoolHandle_t is opaque BlockPool_t. */
+uint32_t ulHead, ulIndex, ulNext, ulFreeBlocks;
+uint8_t *pucBlock;
+
+	configASSERT( pxBlockPool );
+
+	do
+	{
+		ulHead = pxBlockPool->ulFreeListHead;
+		ulIndex = ulHead & bpINDEX_MASK;
+
+		if( ulIndex == 0UL )
+		{
+			( void ) prvAtomicAdd( &( pxBlockPool->ulExhaustedCount ), 1UL );
+			traceBLOCK_POOL_ALLOC_FAILED( pxBlockPool );
+			return NULL;
+		}
+
+		/* If another context pops this block between the read of the head
+		and the swap below then ulNext may be stale, but the tag in the head
+		will have changed so the swap fails and the loop is retried. */
+		pucBlock = pxBlockPool->pucStorage + ( ( size_t ) ( ulIndex - 1UL ) * pxBlockPool->xBlockSize );
+		ulNext = *( ( volatile uint32_t * ) pucBlock ); /*lint !e9087 !e826 Blocks are aligned to portBYTE_ALIGNMENT. */
+
+	} while( portCOMPARE_AND_SWAP_32( &( pxBlockPool->ulFreeListHead ), ( ( ulHead + bpTAG_INCREMENT ) & bpTAG_MASK ) | ulNext, ulHead ) == pdFALSE );
+
+	ulFreeBlocks = prvAtomicAdd( &( pxBlockPool->ulFreeBlocks ), ( uint32_t ) -1 );
+	prvUpdateMinimumEverFreeBlocks( pxBlockPool, ulFreeBlocks );
+
+	traceBLOCK_POOL_ALLOC( pxBlockPool, pucBlock );
+
+	return ( void * ) pucBlock;
+}
+/*-----------------------------------------------------------*/
+
+void vBlockPoolFree( BlockPoolHandle_t xBlockPool, void *pvBlock )
+{
+BlockPool_t * const pxBlockPool = ( BlockPool_t * ) xBlockPool; /*lint !e9087 !e9079 Safe cast as BlockPoolHandle_t is opaque BlockPool_t. */
+uint32_t ulHead, ulIndex;
+size_t xOffset;
+
+	configASSERT( pxBlockPool );
+	configASSERT( pvBlock );
+	configASSERT( xBlockPoolOwnsBlock( xBlockPool, pvBlock ) != pdFALSE );
+
+	xOffset = ( size_t ) ( ( uint8_t * ) pvBlock - pxBlockPool->pucStorage );
+
+	/* The pointer must be the start of a block, not somewhere inside one. */
+	configASSERT( ( xOffset % pxBlockPool->xBlockSize ) == 0 );
+
+	ulIndex = ( uint32_t ) ( xOffset / pxBlockPool->xBlockSize ) + 1UL;
+
+	traceBLOCK_POOL_FREE( pxBlockPool, pvBlock );
+
+	do
+	{
+		ulHead = pxBlockPool->ulFreeListHead;
+		*( ( volatile uint32_t * ) pvBlock ) = ulHead & bpINDEX_MASK; /*lint !e9087 !e826 Blocks are aligned to portBYTE_ALIGNMENT. */
+
+	} while( portCOMPARE_AND_SWAP_32( &( pxBlockPool->ulFreeListHead ), ( ( ulHead + bpTAG_INCREMENT ) & bpTAG_MASK ) | ulIndex, ulHead ) == pdFALSE );
+
+	( void ) prvAtomicAdd( &( pxBlockPool->ulFreeBlocks ), 1UL );
+}
+/*-----------------------------------------------------------*/
+
+void *pvBlockPoolAllocFromSet( const BlockPoolHandle_t *pxBlockPools, UBaseType_t uxNumberOfPools, size_t xWantedSize )
+{
+UBaseType_t ux;
+void *pvReturn = NULL;
+
+	configASSERT( pxBlockPools );
+
+	for( ux = 0; ux < uxNumberOfPools; ux++ )
+	{
+		if( xBlockPoolGetBlockSize( pxBlockPools[ ux ] ) >= xWantedSize )
+		{
+			pvReturn = pvBlockPoolAlloc( pxBlockPools[ ux ] );
+
+			if( pvReturn != NULL )
+			{
+				break;
+			}
+			else
+			{
+				/* This pool is exhausted, spill over into the next larger
+				one. */
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vBlockPoolFreeToSet( const BlockPoolHandle_t *pxBlockPools, UBaseType_t uxNumberOfPools, void *pvBlock )
+{
+UBaseType_t ux;
+
+	configASSERT( pxBlockPools );
+
+	for( ux = 0; ux < uxNumberOfPools; ux++ )
+	{
+		if( xBlockPoolOwnsBlock( pxBlockPools[ ux ], pvBlock ) != pdFALSE )
+		{
+			vBlockPoolFree( pxBlockPools[ ux ], pvBlock );
+			break;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	/* The block must have come from one of the pools in the set. */
+	configASSERT( ux < uxNumberOfPools );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xBlockPoolOwnsBlock( BlockPoolHandle_t xBlockPool, const void *pvBlock )
+{
+const BlockPool_t * const pxBlockPool = ( const BlockPool_t * ) xBlockPool; /*lint !e9087 !e9079 Safe cast as BlockPoolHandle_t is opaque BlockPool_t. */
+const uint8_t * const pucBlock = ( const uint8_t * ) pvBlock;
+BaseType_t xReturn;
+
+	configASSERT( pxBlockPool );
+
+	if( ( pucBlock >= pxBlockPool->pucStorage ) &&
+		( pucBlock < ( pxBlockPool->pucStorage + ( pxBlockPool->xBlockSize * ( size_t ) pxBlockPool->uxBlockCount ) ) ) )
+	{
+		xReturn = pdTRUE;
+	}
+	else
+	{
+		xReturn = pdFALSE;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xBlockPoolGetBlockSize( BlockPoolHandle_t xBlockPool )
+{
+const BlockPool_t * const pxBlockPool = ( const BlockPool_t * ) xBlockPool; /*lint !e9087 !e9079 Safe cast as BlockPoolHandle_t is opaque BlockPool_t. */
+
+	configASSERT( pxBlockPool );
+	return pxBlockPool->xBlockSize;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxBlockPoolGetFreeBlocks( BlockPoolHandle_t xBlockPool )
+{
+const BlockPool_t * const pxBlockPool = ( const BlockPool_t * ) xBlockPool; /*lint !e9087 !e9079 Safe cast as BlockPoolHandle_t is opaque BlockPool_t. */
+
+	configASSERT( pxBlockPool );
+	return ( UBaseType_t ) pxBlockPool->ulFreeBlocks;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxBlockPoolGetMinimumEverFreeBlocks( BlockPoolHandle_t xBlockPool )
+{
+const BlockPool_t * const pxBlockPool = ( const BlockPool_t * ) xBlockPool; /*lint !e9087 !e9079 Safe cast as BlockPoolHandle_t is opaque BlockPool_t. */
+
+	configASSERT( pxBlockPool );
+	return ( UBaseType_t ) pxBlockPool->ulMinimumEverFreeBlocks;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulBlockPoolGetExhaustedCount( BlockPoolHandle_t xBlockPool )
+{
+const BlockPool_t * const pxBlockPool = ( const BlockPool_t * ) xBlockPool; /*lint !e9087 !e9079 Safe cast as BlockPoolHandle_t is opaque BlockPool_t. */
+
+	configASSERT( pxBlockPool );
+	return pxBlockPool->ulExhaustedCount;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseNewBlockPool( BlockPool_t * const pxBlockPool,
+									   uint8_t * const pucStorage,
+									   size_t xBlockSize,
+									   UBaseType_t uxBlockCount )
+{
+UBaseType_t ux;
+uint8_t *pucBlock = pucStorage;
+
+	memset( ( void * ) pxBlockPool, 0x00, sizeof( BlockPool_t ) ); /*lint !e9087 memset() requires void *. */
+
+	pxBlockPool->pucStorage = pucStorage;
+	pxBlockPool->xBlockSize = xBlockSize;
+	pxBlockPool->uxBlockCount = uxBlockCount;
+
+	/* Link each block to the one that follows it.  Indexes are one based so
+	the last block, which links to index 0, terminates the list. */
+	for( ux = 1; ux < uxBlockCount; ux++ )
+	{
+		*( ( uint32_t * ) pucBlock ) = ( uint32_t ) ux + 1UL; /*lint !e9087 !e826 Blocks are aligned to portBYTE_ALIGNMENT. */
+		pucBlock += xBlockSize;
+	}
+	*( ( uint32_t * ) pucBlock ) = 0UL; /*lint !e9087 !e826 Blocks are aligned to portBYTE_ALIGNMENT. */
+
+	pxBlockPool->ulFreeListHead = 1UL;
+	pxBlockPool->ulFreeBlocks = ( uint32_t ) uxBlockCount;
+	pxBlockPool->ulMinimumEverFreeBlocks = ( uint32_t ) uxBlockCount;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvAtomicAdd( volatile uint32_t *pulValue, uint32_t ulDelta )
+{
+uint32_t ulOriginal;
+
+	do
+	{
+		ulOriginal = *pulValue;
+	} while( portCOMPARE_AND_SWAP_32( pulValue, ulOriginal + ulDelta, ulOriginal ) == pdFALSE );
+
+	return ulOriginal + ulDelta;
+}
+/*-----------------------------------------------------------*/
+
+static void prvUpdateMinimumEverFreeBlocks( BlockPool_t * const pxBlockPool, uint32_t ulFreeBlocks )
+{
+uint32_t ulMinimum;
+
+	do
+	{
+		ulMinimum = pxBlockPool->ulMinimumEverFreeBlocks;
+
+		if( ulFreeBlocks >= ulMinimum )
+		{
+			break;
+		}
+	} while( portCOMPARE_AND_SWAP_32( &( pxBlockPool->ulMinimumEverFreeBlocks ), ulFreeBlocks, ulMinimum ) == pdFALSE );
+}
+
+/* This entire source file will be skipped if the application is not configured
+to include block pool functionality. */
+#endif /* configUSE_BLOCK_POOLS == 1 */
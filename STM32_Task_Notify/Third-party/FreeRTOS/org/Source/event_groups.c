@@ -39,6 +39,7 @@ task.h is included from an application file. */
 #include "task.h"
 #include "timers.h"
 #include "event_groups.h"
+#include "object_registry.h"
 
 /* Lint e961 and e750 are suppressed as a MISRA exception justified because the
 MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined for the
@@ -54,18 +55,56 @@ taskEVENT_LIST_ITEM_VALUE_IN_USE definition. */
 	#define eventUNBLOCKED_DUE_TO_BIT_SET	0x0200U
 	#define eventWAIT_FOR_ALL_BITS			0x0400U
 	#define eventEVENT_BITS_CONTROL_BYTES	0xff00U
+	#define eventNUMBER_OF_BITS				8U
 #else
 	#define eventCLEAR_EVENTS_ON_EXIT_BIT	0x01000000UL
 	#define eventUNBLOCKED_DUE_TO_BIT_SET	0x02000000UL
 	#define eventWAIT_FOR_ALL_BITS			0x04000000UL
 	#define eventEVENT_BITS_CONTROL_BYTES	0xff000000UL
+	#define eventNUMBER_OF_BITS				24U
 #endif
 
+#if( configUSE_INDEXED_EVENT_GROUPS == 1 )
+
+	/* Find the number of the most significant bit set in uxBits, which must
+	not be 0. */
+	#if( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+
+		/* The port provides a count leading zeros instruction for selecting
+		the highest priority ready task - use it here too. */
+		#define eventGET_HIGHEST_BIT( uxBit, uxBits ) portGET_HIGHEST_PRIORITY( uxBit, uxBits )
+
+	#else
+
+		#define eventGET_HIGHEST_BIT( uxBit, uxBits )								\
+		{																			\
+			( uxBit ) = eventNUMBER_OF_BITS - 1U;									\
+			while( ( ( uxBits ) & ( ( EventBits_t ) 1 << ( uxBit ) ) ) == 0U )		\
+			{																		\
+				--( uxBit );														\
+			}																		\
+		}
+
+	#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+
+#endif /* configUSE_INDEXED_EVENT_GROUPS */
+
 typedef struct xEventGroupDefinition
 {
 	EventBits_t uxEventBits;
 	List_t xTasksWaitingForBits;		/*< List of tasks waiting for a bit to be set. */
 
+	#if( configUSE_INDEXED_EVENT_GROUPS == 1 )
+		List_t xTasksWaitingForBit[ eventNUMBER_OF_BITS ];	/*< xTasksWaitingForBit[ n ] holds the tasks that cannot be unblocked until bit n is set.  xTasksWaitingForBits then only holds tasks waiting for any one of several bits. */
+		EventBits_t uxBitsWithWaiters;		/*< Bit n is set if xTasksWaitingForBit[ n ] might not be empty. */
+		EventBits_t uxBitsWaitedForByAny;	/*< Holds at least every bit that a task in xTasksWaitingForBits is waiting for. */
+	#endif
+
+	#if( configUSE_EVENT_GROUP_ISR_DIRECT == 1 )
+		volatile UBaseType_t uxLockDepth;		/*< Non-zero while a task is working on the event group.  Interrupts leave the waiting tasks alone while it is. */
+		volatile EventBits_t uxBitsToCheck;		/*< Bits set by interrupts whose waiting tasks have not been checked yet, as the event group was locked or too many tasks were waiting. */
+	#endif
+
 	#if( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxEventGroupNumber;
 	#endif
@@ -75,6 +114,30 @@ typedef struct xEventGroupDefinition
 	#endif
 } EventGroup_t;
 
+#if( configUSE_EVENT_GROUP_ISR_DIRECT == 1 )
+
+	/*
+	 * Interrupts set bits and unblock tasks directly, in place of deferring the
+	 * work to the timer task.  Tasks still work on an event group with the
+	 * scheduler suspended, so an interrupt must not touch the lists of waiting
+	 * tasks while a task is doing so.  The lock tells it not to - it still sets
+	 * the bits, but leaves them in uxBitsToCheck for the task to check the
+	 * waiting tasks against when it unlocks the event group.
+	 */
+	#define prvLockEventGroup( pxEventBits )		\
+		taskENTER_CRITICAL();						\
+		{											\
+			( pxEventBits )->uxLockDepth++;			\
+		}											\
+		taskEXIT_CRITICAL()
+
+#else
+
+	#define prvLockEventGroup( pxEventBits )
+	#define prvUnlockEventGroup( pxEventBits )
+
+#endif /* configUSE_EVENT_GROUP_ISR_DIRECT */
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -87,6 +150,78 @@ typedef struct xEventGroupDefinition
  */
 static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, const EventBits_t uxBitsToWaitFor, const BaseType_t xWaitForAllBits ) PRIVILEGED_FUNCTION;
 
+/*
+ * Initialise the lists and bits used to track the tasks waiting for bits.
+ */
+static void prvInitialiseWaitLists( EventGroup_t *pxEventBits ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the list a task waiting for uxBitsToWaitFor should be placed on.
+ * Without configUSE_INDEXED_EVENT_GROUPS that is always xTasksWaitingForBits.
+ * With it, a task whose wait cannot end until one particular bit is set is
+ * placed on the list for that bit, so setting other bits does not have to look
+ * at it.  Must be called with the scheduler suspended, and only once the wait
+ * condition is known not to be met.
+ */
+static List_t *prvGetWaitList( EventGroup_t *pxEventBits, const EventBits_t uxBitsToWaitFor, const BaseType_t xWaitForAllBits ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock the tasks in pxList whose wait condition is met by the current
+ * event bits.  Returns the bits those tasks asked to be cleared on exit.
+ * pxHigherPriorityTaskWoken is NULL when called from a task with the scheduler
+ * suspended, and otherwise is used as in any other FromISR function.
+ */
+static EventBits_t prvUnblockWaitingTasks( EventGroup_t *pxEventBits, List_t *pxList, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*
+ * Set uxBitsToSet, then unblock the tasks waiting for them as
+ * prvUnblockTasksWaitingFor() does.
+ */
+static void prvSetBitsAndUnblock( EventGroup_t *pxEventBits, const EventBits_t uxBitsToSet, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock the tasks that might be waiting for uxBitsSet and whose wait
+ * condition is met by the current event bits, then clear the bits those tasks
+ * asked to be cleared on exit.
+ */
+static void prvUnblockTasksWaitingFor( EventGroup_t *pxEventBits, const EventBits_t uxBitsSet, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock every task in pxList, as the event group is being deleted.
+ */
+static void prvUnblockAllTasks( const List_t *pxList ) PRIVILEGED_FUNCTION;
+
+#if( configUSE_EVENT_GROUP_ISR_DIRECT == 1 )
+
+	/*
+	 * Undo one prvLockEventGroup().  The last unlock also checks the tasks
+	 * waiting for any bits in uxBitsToCheck.
+	 */
+	static void prvUnlockEventGroup( EventGroup_t *pxEventBits ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Check the tasks waiting for the bits in uxBitsToCheck, from a task.
+	 */
+	static void prvCheckDeferredWaiters( EventGroup_t *pxEventBits ) PRIVILEGED_FUNCTION;
+
+	#if( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+
+		/*
+		 * Run by the timer task when xEventGroupSetBitsFromISR() left the
+		 * check of the waiting tasks to it.
+		 */
+		static void prvCheckDeferredWaitersCallback( void *pvEventGroup, const uint32_t ulUnused ) PRIVILEGED_FUNCTION;
+
+	#endif
+
+	/*
+	 * The number of waiting tasks that setting uxBitsToSet would have to look
+	 * at, which is the work xEventGroupSetBitsFromISR() would do.
+	 */
+	static UBaseType_t prvCountWaitersToCheck( const EventGroup_t *pxEventBits, const EventBits_t uxBitsToSet ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_EVENT_GROUP_ISR_DIRECT */
+
 /*-----------------------------------------------------------*/
 
 #if( configSUPPORT_STATIC_ALLOCATION == 1 )
@@ -114,7 +249,7 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, co
 		if( pxEventBits != NULL )
 		{
 			pxEventBits->uxEventBits = 0;
-			vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
+			prvInitialiseWaitLists( pxEventBits );
 
 			#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
 			{
@@ -150,7 +285,7 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, co
 		if( pxEventBits != NULL )
 		{
 			pxEventBits->uxEventBits = 0;
-			vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
+			prvInitialiseWaitLists( pxEventBits );
 
 			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
 			{
@@ -191,6 +326,8 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 
 	vTaskSuspendAll();
 	{
+		prvLockEventGroup( pxEventBits );
+
 		uxOriginalBitValue = pxEventBits->uxEventBits;
 
 		( void ) xEventGroupSetBits( xEventGroup, uxBitsToSet );
@@ -215,7 +352,7 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 				/* Store the bits that the calling task is waiting for in the
 				task's event list item so the kernel knows when a match is
 				found.  Then enter the blocked state. */
-				vTaskPlaceOnUnorderedEventList( &( pxEventBits->xTasksWaitingForBits ), ( uxBitsToWaitFor | eventCLEAR_EVENTS_ON_EXIT_BIT | eventWAIT_FOR_ALL_BITS ), xTicksToWait );
+				vTaskPlaceOnUnorderedEventList( prvGetWaitList( pxEventBits, uxBitsToWaitFor, pdTRUE ), ( uxBitsToWaitFor | eventCLEAR_EVENTS_ON_EXIT_BIT | eventWAIT_FOR_ALL_BITS ), xTicksToWait );
 
 				/* This assignment is obsolete as uxReturn will get set after
 				the task unblocks, but some compilers mistakenly generate a
@@ -231,6 +368,8 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 				xTimeoutOccurred = pdTRUE;
 			}
 		}
+
+		prvUnlockEventGroup( pxEventBits );
 	}
 	xAlreadyYielded = xTaskResumeAll();
 
@@ -297,7 +436,7 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 EventBits_t xEventGroupWaitBits( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToWaitFor, const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits, TickType_t xTicksToWait )
 {
 EventGroup_t *pxEventBits = ( EventGroup_t * ) xEventGroup;
-EventBits_t uxReturn, uxControlBits = 0;
+EventBits_t uxReturn, uxCurrentEventBits, uxControlBits = 0;
 BaseType_t xWaitConditionMet, xAlreadyYielded;
 BaseType_t xTimeoutOccurred = pdFALSE;
 
@@ -314,7 +453,9 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 
 	vTaskSuspendAll();
 	{
-		const EventBits_t uxCurrentEventBits = pxEventBits->uxEventBits;
+		prvLockEventGroup( pxEventBits );
+
+		uxCurrentEventBits = pxEventBits->uxEventBits;
 
 		/* Check to see if the wait condition is already met or not. */
 		xWaitConditionMet = prvTestWaitCondition( uxCurrentEventBits, uxBitsToWaitFor, xWaitForAllBits );
@@ -370,7 +511,7 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 			/* Store the bits that the calling task is waiting for in the
 			task's event list item so the kernel knows when a match is
 			found.  Then enter the blocked state. */
-			vTaskPlaceOnUnorderedEventList( &( pxEventBits->xTasksWaitingForBits ), ( uxBitsToWaitFor | uxControlBits ), xTicksToWait );
+			vTaskPlaceOnUnorderedEventList( prvGetWaitList( pxEventBits, uxBitsToWaitFor, xWaitForAllBits ), ( uxBitsToWaitFor | uxControlBits ), xTicksToWait );
 
 			/* This is obsolete as it will get set after the task unblocks, but
 			some compilers mistakenly generate a warning about the variable
@@ -379,6 +520,8 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 
 			traceEVENT_GROUP_WAIT_BITS_BLOCK( xEventGroup, uxBitsToWaitFor );
 		}
+
+		prvUnlockEventGroup( pxEventBits );
 	}
 	xAlreadyYielded = xTaskResumeAll();
 
@@ -454,18 +597,50 @@ EventBits_t uxReturn;
 	configASSERT( xEventGroup );
 	configASSERT( ( uxBitsToClear & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
 
-	taskENTER_CRITICAL();
+	#if( configUSE_EVENT_GROUP_ISR_DIRECT == 1 )
 	{
-		traceEVENT_GROUP_CLEAR_BITS( xEventGroup, uxBitsToClear );
+		/* An interrupt may have set bits without checking the tasks waiting
+		for them.  Those tasks are checked first, so they see the bits before
+		they are cleared, as they would have had the interrupt done the check
+		itself. */
+		for( ;; )
+		{
+			taskENTER_CRITICAL();
+			{
+				if( pxEventBits->uxBitsToCheck == ( EventBits_t ) 0 )
+				{
+					traceEVENT_GROUP_CLEAR_BITS( xEventGroup, uxBitsToClear );
+					uxReturn = pxEventBits->uxEventBits;
+					pxEventBits->uxEventBits &= ~uxBitsToClear;
+					taskEXIT_CRITICAL();
+					break;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
 
-		/* The value returned is the event group value prior to the bits being
-		cleared. */
-		uxReturn = pxEventBits->uxEventBits;
+			prvCheckDeferredWaiters( pxEventBits );
+		}
+	}
+	#else
+	{
+		taskENTER_CRITICAL();
+		{
+			traceEVENT_GROUP_CLEAR_BITS( xEventGroup, uxBitsToClear );
 
-		/* Clear the bits. */
-		pxEventBits->uxEventBits &= ~uxBitsToClear;
+			/* The value returned is the event group value prior to the bits
+			being cleared. */
+			uxReturn = pxEventBits->uxEventBits;
+
+			/* Clear the bits. */
+			pxEventBits->uxEventBits &= ~uxBitsToClear;
+		}
+		taskEXIT_CRITICAL();
 	}
-	taskEXIT_CRITICAL();
+	#endif /* configUSE_EVENT_GROUP_ISR_DIRECT */
 
 	return uxReturn;
 }
@@ -504,91 +679,20 @@ EventBits_t uxReturn;
 
 EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet )
 {
-ListItem_t *pxListItem, *pxNext;
-ListItem_t const *pxListEnd;
-List_t *pxList;
-EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits;
 EventGroup_t *pxEventBits = ( EventGroup_t * ) xEventGroup;
-BaseType_t xMatchFound = pdFALSE;
 
 	/* Check the user is not attempting to set the bits used by the kernel
 	itself. */
 	configASSERT( xEventGroup );
 	configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
 
-	pxList = &( pxEventBits->xTasksWaitingForBits );
-	pxListEnd = listGET_END_MARKER( pxList ); /*lint !e826 !e740 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
 	vTaskSuspendAll();
 	{
 		traceEVENT_GROUP_SET_BITS( xEventGroup, uxBitsToSet );
 
-		pxListItem = listGET_HEAD_ENTRY( pxList );
-
-		/* Set the bits. */
-		pxEventBits->uxEventBits |= uxBitsToSet;
-
-		/* See if the new bit value should unblock any tasks. */
-		while( pxListItem != pxListEnd )
-		{
-			pxNext = listGET_NEXT( pxListItem );
-			uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
-			xMatchFound = pdFALSE;
-
-			/* Split the bits waited for from the control bits. */
-			uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
-			uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
-
-			if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
-			{
-				/* Just looking for single bit being set. */
-				if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
-				{
-					xMatchFound = pdTRUE;
-				}
-				else
-				{
-					mtCOVERAGE_TEST_MARKER();
-				}
-			}
-			else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
-			{
-				/* All bits are set. */
-				xMatchFound = pdTRUE;
-			}
-			else
-			{
-				/* Need all bits to be set, but not all the bits were set. */
-			}
-
-			if( xMatchFound != pdFALSE )
-			{
-				/* The bits match.  Should the bits be cleared on exit? */
-				if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
-				{
-					uxBitsToClear |= uxBitsWaitedFor;
-				}
-				else
-				{
-					mtCOVERAGE_TEST_MARKER();
-				}
-
-				/* Store the actual event flag value in the task's event list
-				item before removing the task from the event list.  The
-				eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
-				that is was unblocked due to its required bits matching, rather
-				than because it timed out. */
-				vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
-			}
-
-			/* Move onto the next list item.  Note pxListItem->pxNext is not
-			used here as the list item may have been removed from the event list
-			and inserted into the ready/pending reading list. */
-			pxListItem = pxNext;
-		}
-
-		/* Clear any bits that matched when the eventCLEAR_EVENTS_ON_EXIT_BIT
-		bit was set in the control word. */
-		pxEventBits->uxEventBits &= ~uxBitsToClear;
+		prvLockEventGroup( pxEventBits );
+		prvSetBitsAndUnblock( pxEventBits, uxBitsToSet, NULL );
+		prvUnlockEventGroup( pxEventBits );
 	}
 	( void ) xTaskResumeAll();
 
@@ -599,19 +703,34 @@ BaseType_t xMatchFound = pdFALSE;
 void vEventGroupDelete( EventGroupHandle_t xEventGroup )
 {
 EventGroup_t *pxEventBits = ( EventGroup_t * ) xEventGroup;
-const List_t *pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits );
+#if( configUSE_INDEXED_EVENT_GROUPS == 1 )
+	UBaseType_t uxBit;
+#endif
 
 	vTaskSuspendAll();
 	{
 		traceEVENT_GROUP_DELETE( xEventGroup );
 
-		while( listCURRENT_LIST_LENGTH( pxTasksWaitingForBits ) > ( UBaseType_t ) 0 )
+		/* Not unlocked again, as the event group is going away.  Any tasks
+		waiting for bits an interrupt set are unblocked below with the rest. */
+		prvLockEventGroup( pxEventBits );
+
+		#if( configUSE_OBJECT_REGISTRY == 1 )
 		{
-			/* Unblock the task, returning 0 as the event list is being deleted
-			and cannot therefore have any bits set. */
-			configASSERT( pxTasksWaitingForBits->xListEnd.pxNext != ( const ListItem_t * ) &( pxTasksWaitingForBits->xListEnd ) );
-			vTaskRemoveFromUnorderedEventList( pxTasksWaitingForBits->xListEnd.pxNext, eventUNBLOCKED_DUE_TO_BIT_SET );
+			vObjectRegistryRemove( xEventGroup );
 		}
+		#endif
+
+		prvUnblockAllTasks( &( pxEventBits->xTasksWaitingForBits ) );
+
+		#if( configUSE_INDEXED_EVENT_GROUPS == 1 )
+		{
+			for( uxBit = 0; uxBit < eventNUMBER_OF_BITS; uxBit++ )
+			{
+				prvUnblockAllTasks( &( pxEventBits->xTasksWaitingForBit[ uxBit ] ) );
+			}
+		}
+		#endif
 
 		#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
 		{
@@ -689,7 +808,551 @@ BaseType_t xWaitConditionMet = pdFALSE;
 }
 /*-----------------------------------------------------------*/
 
-#if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+static void prvInitialiseWaitLists( EventGroup_t *pxEventBits )
+{
+	vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
+
+	#if( configUSE_INDEXED_EVENT_GROUPS == 1 )
+	{
+	UBaseType_t uxBit;
+
+		for( uxBit = 0; uxBit < eventNUMBER_OF_BITS; uxBit++ )
+		{
+			vListInitialise( &( pxEventBits->xTasksWaitingForBit[ uxBit ] ) );
+		}
+
+		pxEventBits->uxBitsWithWaiters = 0;
+		pxEventBits->uxBitsWaitedForByAny = 0;
+	}
+	#endif /* configUSE_INDEXED_EVENT_GROUPS */
+
+	#if( configUSE_EVENT_GROUP_ISR_DIRECT == 1 )
+	{
+		pxEventBits->uxLockDepth = 0;
+		pxEventBits->uxBitsToCheck = 0;
+	}
+	#endif /* configUSE_EVENT_GROUP_ISR_DIRECT */
+}
+/*-----------------------------------------------------------*/
+
+static List_t *prvGetWaitList( EventGroup_t *pxEventBits, const EventBits_t uxBitsToWaitFor, const BaseType_t xWaitForAllBits )
+{
+List_t *pxList;
+
+	#if( configUSE_INDEXED_EVENT_GROUPS == 1 )
+	{
+	EventBits_t uxBitsStillNeeded;
+	UBaseType_t uxBit;
+
+		/* A task waiting for all of its bits cannot be unblocked until every
+		one of them that is still clear has been set, so can wait on the list
+		of any one of those.  The bit is still clear, so its list is looked at
+		when it gets set, and the task is moved to the list of another clear
+		bit if that is not the last one. */
+		if( xWaitForAllBits != pdFALSE )
+		{
+			uxBitsStillNeeded = uxBitsToWaitFor & ~( pxEventBits->uxEventBits );
+		}
+		else
+		{
+			uxBitsStillNeeded = uxBitsToWaitFor;
+		}
+
+		#if( configUSE_EVENT_GROUP_ISR_DIRECT == 1 )
+		{
+			/* An interrupt can set bits while the event group is locked, so
+			by now every bit may be set.  The bits it set are in uxBitsToCheck,
+			and the lists of those bits are checked when the event group is
+			unlocked, so the task waits on one of those. */
+			if( uxBitsStillNeeded == ( EventBits_t ) 0 )
+			{
+				uxBitsStillNeeded = uxBitsToWaitFor & pxEventBits->uxBitsToCheck;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configUSE_EVENT_GROUP_ISR_DIRECT */
+
+		configASSERT( uxBitsStillNeeded != ( EventBits_t ) 0 );
+		eventGET_HIGHEST_BIT( uxBit, uxBitsStillNeeded );
+
+		if( ( xWaitForAllBits != pdFALSE ) || ( uxBitsStillNeeded == ( ( EventBits_t ) 1 << uxBit ) ) )
+		{
+			pxList = &( pxEventBits->xTasksWaitingForBit[ uxBit ] );
+			pxEventBits->uxBitsWithWaiters |= ( EventBits_t ) 1 << uxBit;
+		}
+		else
+		{
+			/* Waiting for any one of several bits, so any of them being set
+			ends the wait. */
+			pxList = &( pxEventBits->xTasksWaitingForBits );
+			pxEventBits->uxBitsWaitedForByAny |= uxBitsToWaitFor;
+		}
+	}
+	#else
+	{
+		( void ) uxBitsToWaitFor;
+		( void ) xWaitForAllBits;
+		pxList = &( pxEventBits->xTasksWaitingForBits );
+	}
+	#endif /* configUSE_INDEXED_EVENT_GROUPS */
+
+	return pxList;
+}
+/*-----------------------------------------------------------*/
+
+static EventBits_t prvUnblockWaitingTasks( EventGroup_t *pxEventBits, List_t *pxList, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+ListItem_t *pxListItem, *pxNext;
+ListItem_t const *pxListEnd;
+EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits;
+BaseType_t xMatchFound;
+#if( configUSE_INDEXED_EVENT_GROUPS == 1 )
+	EventBits_t uxBitsStillWaitedFor = 0, uxListBit = 0;
+#endif
+
+	#if( configUSE_INDEXED_EVENT_GROUPS == 1 )
+	{
+		/* The bit whose list this is, if it is the list of one bit. */
+		if( pxList != &( pxEventBits->xTasksWaitingForBits ) )
+		{
+			uxListBit = ( EventBits_t ) 1 << ( UBaseType_t ) ( pxList - &( pxEventBits->xTasksWaitingForBit[ 0 ] ) );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configUSE_INDEXED_EVENT_GROUPS */
+
+	pxListEnd = listGET_END_MARKER( pxList ); /*lint !e826 !e740 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
+	pxListItem = listGET_HEAD_ENTRY( pxList );
+
+	while( pxListItem != pxListEnd )
+	{
+		pxNext = listGET_NEXT( pxListItem );
+		uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
+		xMatchFound = pdFALSE;
+
+		/* Split the bits waited for from the control bits. */
+		uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
+		uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
+
+		if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
+		{
+			/* Just looking for single bit being set. */
+			if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
+			{
+				xMatchFound = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
+		{
+			/* All bits are set. */
+			xMatchFound = pdTRUE;
+		}
+		else
+		{
+			/* Need all bits to be set, but not all the bits were set. */
+		}
+
+		if( xMatchFound != pdFALSE )
+		{
+			/* The bits match.  Should the bits be cleared on exit? */
+			if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
+			{
+				uxBitsToClear |= uxBitsWaitedFor;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* Store the actual event flag value in the task's event list
+			item before removing the task from the event list.  The
+			eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
+			that is was unblocked due to its required bits matching, rather
+			than because it timed out. */
+			#if( configUSE_EVENT_GROUP_ISR_DIRECT == 1 )
+			{
+				if( pxHigherPriorityTaskWoken != NULL )
+				{
+					if( xTaskRemoveFromUnorderedEventListFromISR( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET ) != pdFALSE )
+					{
+						*pxHigherPriorityTaskWoken = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
+				}
+			}
+			#else
+			{
+				( void ) pxHigherPriorityTaskWoken;
+				vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
+			}
+			#endif /* configUSE_EVENT_GROUP_ISR_DIRECT */
+		}
+		else
+		{
+			#if( configUSE_INDEXED_EVENT_GROUPS == 1 )
+			{
+				if( pxList == &( pxEventBits->xTasksWaitingForBits ) )
+				{
+					uxBitsStillWaitedFor |= uxBitsWaitedFor;
+				}
+				else if( ( pxEventBits->uxEventBits & uxListBit ) == ( EventBits_t ) 0 )
+				{
+					/* Only when checking for bits an interrupt set earlier -
+					the bit of this list has been cleared again since, so the
+					task still has to wait for it, here. */
+					mtCOVERAGE_TEST_MARKER();
+				}
+				else
+				{
+					/* The task needs all of several bits, and the bit whose
+					list it was on is now set, but others are not.  Move it to
+					the list of one of those.  That bit is clear, so the task
+					stays where it is if this call looks at that list too. */
+					( void ) uxListRemove( pxListItem );
+					vListInsertEnd( prvGetWaitList( pxEventBits, uxBitsWaitedFor, pdTRUE ), pxListItem );
+				}
+			}
+			#endif /* configUSE_INDEXED_EVENT_GROUPS */
+		}
+
+		/* Move onto the next list item.  Note pxListItem->pxNext is not
+		used here as the list item may have been removed from the event list
+		and inserted into the ready/pending reading list. */
+		pxListItem = pxNext;
+	}
+
+	#if( configUSE_INDEXED_EVENT_GROUPS == 1 )
+	{
+		/* Tasks that timed out are removed from the list without the event
+		group knowing, so the bits are worked out again whenever the whole
+		list has been looked at. */
+		if( pxList == &( pxEventBits->xTasksWaitingForBits ) )
+		{
+			pxEventBits->uxBitsWaitedForByAny = uxBitsStillWaitedFor;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configUSE_INDEXED_EVENT_GROUPS */
+
+	return uxBitsToClear;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSetBitsAndUnblock( EventGroup_t *pxEventBits, const EventBits_t uxBitsToSet, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+	/* Set the bits. */
+	pxEventBits->uxEventBits |= uxBitsToSet;
+
+	/* See if the new bit value should unblock any tasks. */
+	prvUnblockTasksWaitingFor( pxEventBits, uxBitsToSet, pxHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnblockTasksWaitingFor( EventGroup_t *pxEventBits, const EventBits_t uxBitsSet, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+EventBits_t uxBitsToClear = 0;
+#if( configUSE_INDEXED_EVENT_GROUPS == 1 )
+	EventBits_t uxBitsToVisit;
+	UBaseType_t uxBit;
+#endif
+
+	#if( configUSE_INDEXED_EVENT_GROUPS == 1 )
+	{
+		/* Only the lists of the bits being set can hold tasks that were
+		waiting for one particular bit. */
+		uxBitsToVisit = uxBitsSet & pxEventBits->uxBitsWithWaiters;
+
+		while( uxBitsToVisit != ( EventBits_t ) 0 )
+		{
+			eventGET_HIGHEST_BIT( uxBit, uxBitsToVisit );
+			uxBitsToVisit &= ~( ( EventBits_t ) 1 << uxBit );
+
+			uxBitsToClear |= prvUnblockWaitingTasks( pxEventBits, &( pxEventBits->xTasksWaitingForBit[ uxBit ] ), pxHigherPriorityTaskWoken );
+
+			if( listLIST_IS_EMPTY( &( pxEventBits->xTasksWaitingForBit[ uxBit ] ) ) != pdFALSE )
+			{
+				pxEventBits->uxBitsWithWaiters &= ~( ( EventBits_t ) 1 << uxBit );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		/* Tasks waiting for any one of several bits only need to be
+		checked if one of those bits is being set. */
+		if( ( uxBitsSet & pxEventBits->uxBitsWaitedForByAny ) != ( EventBits_t ) 0 )
+		{
+			uxBitsToClear |= prvUnblockWaitingTasks( pxEventBits, &( pxEventBits->xTasksWaitingForBits ), pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#else
+	{
+		( void ) uxBitsSet;
+		uxBitsToClear = prvUnblockWaitingTasks( pxEventBits, &( pxEventBits->xTasksWaitingForBits ), pxHigherPriorityTaskWoken );
+	}
+	#endif /* configUSE_INDEXED_EVENT_GROUPS */
+
+	/* Clear any bits that matched when the eventCLEAR_EVENTS_ON_EXIT_BIT
+	bit was set in the control word. */
+	pxEventBits->uxEventBits &= ~uxBitsToClear;
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnblockAllTasks( const List_t *pxList )
+{
+	while( listCURRENT_LIST_LENGTH( pxList ) > ( UBaseType_t ) 0 )
+	{
+		/* Unblock the task, returning 0 as the event list is being deleted
+		and cannot therefore have any bits set. */
+		configASSERT( pxList->xListEnd.pxNext != ( const ListItem_t * ) &( pxList->xListEnd ) );
+		vTaskRemoveFromUnorderedEventList( pxList->xListEnd.pxNext, eventUNBLOCKED_DUE_TO_BIT_SET );
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_EVENT_GROUP_ISR_DIRECT == 1 )
+
+	static void prvUnlockEventGroup( EventGroup_t *pxEventBits )
+	{
+	EventBits_t uxBitsToCheck;
+
+		for( ;; )
+		{
+			taskENTER_CRITICAL();
+			{
+				/* The waiting tasks are only checked by the last unlock, so
+				the lists do not change under a task part way through an
+				operation on the event group. */
+				uxBitsToCheck = 0;
+
+				if( pxEventBits->uxLockDepth == ( UBaseType_t ) 1 )
+				{
+					uxBitsToCheck = pxEventBits->uxBitsToCheck;
+					pxEventBits->uxBitsToCheck = 0;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* The event group stays locked while the tasks are checked,
+				so interrupts keep leaving the lists alone. */
+				if( uxBitsToCheck == ( EventBits_t ) 0 )
+				{
+					pxEventBits->uxLockDepth--;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			if( uxBitsToCheck == ( EventBits_t ) 0 )
+			{
+				break;
+			}
+			else
+			{
+				/* The interrupts already set the bits.  They are not set
+				again, as the task that held the lock may have cleared them
+				since. */
+				prvUnblockTasksWaitingFor( pxEventBits, uxBitsToCheck, NULL );
+			}
+		}
+	}
+
+#endif /* configUSE_EVENT_GROUP_ISR_DIRECT */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_EVENT_GROUP_ISR_DIRECT == 1 )
+
+	static void prvCheckDeferredWaiters( EventGroup_t *pxEventBits )
+	{
+		vTaskSuspendAll();
+		{
+			/* Locking and unlocking the event group is enough, as the unlock
+			does the check. */
+			prvLockEventGroup( pxEventBits );
+			prvUnlockEventGroup( pxEventBits );
+		}
+		( void ) xTaskResumeAll();
+	}
+
+	#if( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+
+		static void prvCheckDeferredWaitersCallback( void *pvEventGroup, const uint32_t ulUnused )
+		{
+			( void ) ulUnused;
+			prvCheckDeferredWaiters( ( EventGroup_t * ) pvEventGroup );
+		}
+
+	#endif
+
+#endif /* configUSE_EVENT_GROUP_ISR_DIRECT */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_EVENT_GROUP_ISR_DIRECT == 1 )
+
+	static UBaseType_t prvCountWaitersToCheck( const EventGroup_t *pxEventBits, const EventBits_t uxBitsToSet )
+	{
+	UBaseType_t uxWaiters = 0;
+
+		#if( configUSE_INDEXED_EVENT_GROUPS == 1 )
+		{
+		EventBits_t uxBitsToVisit;
+		UBaseType_t uxBit;
+
+			uxBitsToVisit = uxBitsToSet & pxEventBits->uxBitsWithWaiters;
+
+			while( uxBitsToVisit != ( EventBits_t ) 0 )
+			{
+				eventGET_HIGHEST_BIT( uxBit, uxBitsToVisit );
+				uxBitsToVisit &= ~( ( EventBits_t ) 1 << uxBit );
+				uxWaiters += listCURRENT_LIST_LENGTH( &( pxEventBits->xTasksWaitingForBit[ uxBit ] ) );
+			}
+
+			if( ( uxBitsToSet & pxEventBits->uxBitsWaitedForByAny ) != ( EventBits_t ) 0 )
+			{
+				uxWaiters += listCURRENT_LIST_LENGTH( &( pxEventBits->xTasksWaitingForBits ) );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#else
+		{
+			( void ) uxBitsToSet;
+			uxWaiters = listCURRENT_LIST_LENGTH( &( pxEventBits->xTasksWaitingForBits ) );
+		}
+		#endif /* configUSE_INDEXED_EVENT_GROUPS */
+
+		return uxWaiters;
+	}
+
+#endif /* configUSE_EVENT_GROUP_ISR_DIRECT */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_EVENT_GROUP_ISR_DIRECT == 1 )
+
+	BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet, BaseType_t *pxHigherPriorityTaskWoken )
+	{
+	EventGroup_t *pxEventBits = ( EventGroup_t * ) xEventGroup;
+	UBaseType_t uxSavedInterruptStatus;
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+	BaseType_t xDeferToTimerTask = pdFALSE;
+
+		configASSERT( xEventGroup );
+		configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
+
+		/* RTOS ports that support interrupt nesting have the concept of a
+		maximum system call (or maximum API call) interrupt priority, as for
+		any other FromISR function. */
+		portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			traceEVENT_GROUP_SET_BITS_FROM_ISR( xEventGroup, uxBitsToSet );
+
+			if( pxEventBits->uxLockDepth != ( UBaseType_t ) 0 )
+			{
+				/* The interrupted task is part way through an operation on
+				this event group.  The bits are set now, and the task checks
+				the tasks waiting for them when it has finished. */
+				pxEventBits->uxEventBits |= uxBitsToSet;
+				pxEventBits->uxBitsToCheck |= uxBitsToSet;
+			}
+			else if( prvCountWaitersToCheck( pxEventBits, uxBitsToSet ) <= ( UBaseType_t ) configEVENT_GROUP_ISR_MAX_WAITERS )
+			{
+				/* Few enough tasks to look at that the work can be done here,
+				with interrupts masked, so at most
+				configEVENT_GROUP_ISR_MAX_WAITERS tasks are unblocked. */
+				prvSetBitsAndUnblock( pxEventBits, uxBitsToSet, &xHigherPriorityTaskWoken );
+			}
+			else
+			{
+				/* Too many tasks to look at in an interrupt.  The bits are
+				still set now, but none of the waiting tasks are checked, as
+				the bits the ones unblocked here asked to clear on exit could
+				not be cleared before the rest had seen them.  The timer task,
+				if there is one, or else the next task to set, clear or wait
+				for bits in the event group, does the check.  Only the first
+				set to be left over asks the timer task, as its check covers
+				every bit left over by the time it runs. */
+				if( pxEventBits->uxBitsToCheck == ( EventBits_t ) 0 )
+				{
+					xDeferToTimerTask = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				pxEventBits->uxEventBits |= uxBitsToSet;
+				pxEventBits->uxBitsToCheck |= uxBitsToSet;
+			}
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		#if( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+		{
+			/* If the timer service queue is full the check is left to the
+			next task that uses the event group. */
+			if( xDeferToTimerTask != pdFALSE )
+			{
+				( void ) xTimerPendFunctionCallFromISR( prvCheckDeferredWaitersCallback, ( void * ) xEventGroup, ( uint32_t ) 0, &xHigherPriorityTaskWoken );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#else
+		{
+			( void ) xDeferToTimerTask;
+		}
+		#endif
+
+		if( ( xHigherPriorityTaskWoken != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+		{
+			*pxHigherPriorityTaskWoken = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* The bits are always set, so this cannot fail. */
+		return pdPASS;
+	}
+
+#elif ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
 
 	BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet, BaseType_t *pxHigherPriorityTaskWoken )
 	{
@@ -0,0 +1,659 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "event_groups64.h"
+#include "object_registry.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* This entire source file will be skipped if the application is not configured
+to include 64-bit event group functionality. */
+#if( configUSE_64_BIT_EVENT_GROUPS == 1 )
+
+/* The event bits themselves are held in the TCB of the blocked task (see
+vTaskPlaceOnUnorderedEventList64()), so the event list item value only holds
+these control bits.  eg64UNBLOCKED_DUE_TO_BIT_SET is set when the task is
+unblocked because its wait condition was met (or the event group was deleted),
+rather than because it timed out. */
+#define eg64UNBLOCKED_DUE_TO_BIT_SET	( ( TickType_t ) 0x01 )
+#define eg64CLEAR_EVENTS_ON_EXIT_BIT	( ( TickType_t ) 0x02 )
+#define eg64WAIT_FOR_ALL_BITS			( ( TickType_t ) 0x04 )
+
+/*-----------------------------------------------------------*/
+
+typedef struct xEVENT_GROUP_64 /*lint !e9058 Style convention uses tag. */
+{
+	EventBits64_t uxEventBits;
+	List_t xTasksWaitingForBits;		/*< List of tasks waiting for a bit to be set. */
+
+	#if( configUSE_TRACE_FACILITY == 1 )
+		UBaseType_t uxEventGroupNumber;
+	#endif
+
+	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+		uint8_t ucStaticallyAllocated; /*< Set to pdTRUE if the event group is statically allocated to ensure no attempt is made to free the memory. */
+	#endif
+} EventGroup64_t;
+
+/*
+ * Test the bits set in uxCurrentEventBits to see if the wait condition is met.
+ * The wait condition is defined by xWaitForAllBits.  If xWaitForAllBits is
+ * pdTRUE then the wait condition is met if all the bits set in
+ * uxBitsToWaitFor are also set in uxCurrentEventBits.  If xWaitForAllBits is
+ * pdFALSE then the wait condition is met if any of the bits set in
+ * uxBitsToWaitFor are also set in uxCurrentEventBits.
+ */
+static BaseType_t prvTestWaitCondition( const EventBits64_t uxCurrentEventBits, const EventBits64_t uxBitsToWaitFor, const BaseType_t xWaitForAllBits ) PRIVILEGED_FUNCTION;
+
+/*
+ * Place the calling task on the event group's list of waiting tasks, with the
+ * bits it waits for in its TCB and how it waits for them in its event list
+ * item value.  Called with the scheduler suspended.
+ */
+static void prvBlockOnEventGroup( EventGroup64_t *pxEventBits, const EventBits64_t uxBitsToWaitFor, const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits, const TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called once a task that blocked in prvBlockOnEventGroup() runs again.
+ * Returns the event group value the task should return, and sets
+ * *pxTimeoutOccurred to pdTRUE if the task was not unblocked by its wait
+ * condition being met.
+ */
+static EventBits64_t prvCompleteWait( EventGroup64_t *pxEventBits, BaseType_t * const pxTimeoutOccurred ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock the task that owns pxListItem, which must be on the event group's
+ * list of waiting tasks, passing it uxBits as the event group's value.  Called
+ * with the scheduler suspended.
+ */
+static void prvUnblockTask( EventGroup64_t *pxEventBits, ListItem_t *pxListItem, const EventBits64_t uxBits ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+	EventGroup64Handle_t xEventGroup64CreateStatic( StaticEventGroup64_t *pxEventGroupBuffer )
+	{
+	EventGroup64_t *pxEventBits;
+
+		/* A StaticEventGroup64_t object must be provided. */
+		configASSERT( pxEventGroupBuffer );
+
+		#if( configASSERT_DEFINED == 1 )
+		{
+			/* Sanity check that the size of the structure used to declare a
+			variable of type StaticEventGroup64_t equals the size of the real
+			event group structure. */
+			volatile size_t xSize = sizeof( StaticEventGroup64_t );
+			configASSERT( xSize == sizeof( EventGroup64_t ) );
+		}
+		#endif /* configASSERT_DEFINED */
+
+		/* The user has provided a statically allocated event group - use it. */
+		pxEventBits = ( EventGroup64_t * ) pxEventGroupBuffer; /*lint !e740 EventGroup64_t and StaticEventGroup64_t are guaranteed to have the same size and alignment requirement - checked by configASSERT(). */
+
+		if( pxEventBits != NULL )
+		{
+			pxEventBits->uxEventBits = 0;
+			vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
+
+			#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+			{
+				/* Both static and dynamic allocation can be used, so note that
+				this event group was created statically in case the event group
+				is later deleted. */
+				pxEventBits->ucStaticallyAllocated = pdTRUE;
+			}
+			#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+
+			traceEVENT_GROUP64_CREATE( pxEventBits );
+		}
+		else
+		{
+			traceEVENT_GROUP64_CREATE_FAILED();
+		}
+
+		return ( EventGroup64Handle_t ) pxEventBits;
+	}
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	EventGroup64Handle_t xEventGroup64Create( void )
+	{
+	EventGroup64_t *pxEventBits;
+
+		/* Allocate the event group. */
+		pxEventBits = ( EventGroup64_t * ) pvPortMalloc( sizeof( EventGroup64_t ) );
+
+		if( pxEventBits != NULL )
+		{
+			pxEventBits->uxEventBits = 0;
+			vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
+
+			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+			{
+				/* Both static and dynamic allocation can be used, so note this
+				event group was allocated dynamically in case the event group
+				is later deleted. */
+				pxEventBits->ucStaticallyAllocated = pdFALSE;
+			}
+			#endif /* configSUPPORT_STATIC_ALLOCATION */
+
+			traceEVENT_GROUP64_CREATE( pxEventBits );
+		}
+		else
+		{
+			traceEVENT_GROUP64_CREATE_FAILED();
+		}
+
+		return ( EventGroup64Handle_t ) pxEventBits;
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+EventBits64_t xEventGroup64Sync( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToSet, const EventBits64_t uxBitsToWaitFor, TickType_t xTicksToWait )
+{
+EventBits64_t uxOriginalBitValue, uxReturn;
+EventGroup64_t *pxEventBits = ( EventGroup64_t * ) xEventGroup;
+BaseType_t xAlreadyYielded;
+BaseType_t xTimeoutOccurred = pdFALSE;
+
+	configASSERT( xEventGroup );
+	configASSERT( uxBitsToWaitFor != 0 );
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+	vTaskSuspendAll();
+	{
+		uxOriginalBitValue = pxEventBits->uxEventBits;
+
+		( void ) xEventGroup64SetBits( xEventGroup, uxBitsToSet );
+
+		if( ( ( uxOriginalBitValue | uxBitsToSet ) & uxBitsToWaitFor ) == uxBitsToWaitFor )
+		{
+			/* All the rendezvous bits are now set - no need to block. */
+			uxReturn = ( uxOriginalBitValue | uxBitsToSet );
+
+			/* Rendezvous always clear the bits.  They will have been cleared
+			already unless this is the only task in the rendezvous. */
+			pxEventBits->uxEventBits &= ~uxBitsToWaitFor;
+
+			xTicksToWait = 0;
+		}
+		else
+		{
+			if( xTicksToWait != ( TickType_t ) 0 )
+			{
+				traceEVENT_GROUP64_SYNC_BLOCK( xEventGroup, uxBitsToSet, uxBitsToWaitFor );
+
+				/* Rendezvous always clear the bits and wait for all of them. */
+				prvBlockOnEventGroup( pxEventBits, uxBitsToWaitFor, pdTRUE, pdTRUE, xTicksToWait );
+
+				/* This assignment is obsolete as uxReturn will get set after
+				the task unblocks, but some compilers mistakenly generate a
+				warning about uxReturn being returned without being set if the
+				assignment is omitted. */
+				uxReturn = 0;
+			}
+			else
+			{
+				/* The rendezvous bits were not set, but no block time was
+				specified - just return the current event bit value. */
+				uxReturn = pxEventBits->uxEventBits;
+				xTimeoutOccurred = pdTRUE;
+			}
+		}
+	}
+	xAlreadyYielded = xTaskResumeAll();
+
+	if( xTicksToWait != ( TickType_t ) 0 )
+	{
+		if( xAlreadyYielded == pdFALSE )
+		{
+			portYIELD_WITHIN_API();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* The task blocked to wait for its required bits to be set - at this
+		point either the required bits were set or the block time expired. */
+		uxReturn = prvCompleteWait( pxEventBits, &xTimeoutOccurred );
+	}
+
+	traceEVENT_GROUP64_SYNC_END( xEventGroup, uxBitsToSet, uxBitsToWaitFor, xTimeoutOccurred );
+
+	/* Prevent compiler warnings when trace macros are not used. */
+	( void ) xTimeoutOccurred;
+
+	return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+EventBits64_t xEventGroup64WaitBits( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToWaitFor, const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits, TickType_t xTicksToWait )
+{
+EventGroup64_t *pxEventBits = ( EventGroup64_t * ) xEventGroup;
+EventBits64_t uxReturn, uxCurrentEventBits;
+BaseType_t xAlreadyYielded;
+BaseType_t xTimeoutOccurred = pdFALSE;
+
+	/* Check at least one bit is being requested. */
+	configASSERT( xEventGroup );
+	configASSERT( uxBitsToWaitFor != 0 );
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+	vTaskSuspendAll();
+	{
+		uxCurrentEventBits = pxEventBits->uxEventBits;
+
+		/* Check to see if the wait condition is already met or not. */
+		if( prvTestWaitCondition( uxCurrentEventBits, uxBitsToWaitFor, xWaitForAllBits ) != pdFALSE )
+		{
+			/* The wait condition has already been met so there is no need to
+			block. */
+			uxReturn = uxCurrentEventBits;
+			xTicksToWait = ( TickType_t ) 0;
+
+			/* Clear the wait bits if requested to do so. */
+			if( xClearOnExit != pdFALSE )
+			{
+				pxEventBits->uxEventBits &= ~uxBitsToWaitFor;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else if( xTicksToWait == ( TickType_t ) 0 )
+		{
+			/* The wait condition has not been met, but no block time was
+			specified, so just return the current value. */
+			uxReturn = uxCurrentEventBits;
+			xTimeoutOccurred = pdTRUE;
+		}
+		else
+		{
+			/* The task is going to block to wait for its required bits to be
+			set.  The task's TCB and event list item remember the specified
+			behaviour of this call for use when the event bits unblock the
+			task. */
+			prvBlockOnEventGroup( pxEventBits, uxBitsToWaitFor, xClearOnExit, xWaitForAllBits, xTicksToWait );
+
+			/* This is obsolete as it will get set after the task unblocks, but
+			some compilers mistakenly generate a warning about the variable
+			being returned without being set if it is not done. */
+			uxReturn = 0;
+
+			traceEVENT_GROUP64_WAIT_BITS_BLOCK( xEventGroup, uxBitsToWaitFor );
+		}
+	}
+	xAlreadyYielded = xTaskResumeAll();
+
+	if( xTicksToWait != ( TickType_t ) 0 )
+	{
+		if( xAlreadyYielded == pdFALSE )
+		{
+			portYIELD_WITHIN_API();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* The task blocked to wait for its required bits to be set - at this
+		point either the required bits were set or the block time expired. */
+		uxReturn = prvCompleteWait( pxEventBits, &xTimeoutOccurred );
+	}
+	traceEVENT_GROUP64_WAIT_BITS_END( xEventGroup, uxBitsToWaitFor, xTimeoutOccurred );
+
+	/* Prevent compiler warnings when trace macros are not used. */
+	( void ) xTimeoutOccurred;
+
+	return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+EventBits64_t xEventGroup64ClearBits( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToClear )
+{
+EventGroup64_t *pxEventBits = ( EventGroup64_t * ) xEventGroup;
+EventBits64_t uxReturn;
+
+	configASSERT( xEventGroup );
+
+	/* The bits are only accessed by tasks, either with the scheduler suspended
+	or from a critical section, so no task can see the two halves of the 64-bit
+	value from different moments. */
+	taskENTER_CRITICAL();
+	{
+		traceEVENT_GROUP64_CLEAR_BITS( xEventGroup, uxBitsToClear );
+
+		/* The value returned is the event group value prior to the bits being
+		cleared. */
+		uxReturn = pxEventBits->uxEventBits;
+
+		/* Clear the bits. */
+		pxEventBits->uxEventBits &= ~uxBitsToClear;
+	}
+	taskEXIT_CRITICAL();
+
+	return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+EventBits64_t xEventGroup64GetBits( EventGroup64Handle_t xEventGroup )
+{
+EventGroup64_t *pxEventBits = ( EventGroup64_t * ) xEventGroup;
+EventBits64_t uxReturn;
+
+	configASSERT( xEventGroup );
+
+	taskENTER_CRITICAL();
+	{
+		uxReturn = pxEventBits->uxEventBits;
+	}
+	taskEXIT_CRITICAL();
+
+	return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+EventBits64_t xEventGroup64SetBits( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToSet )
+{
+ListItem_t *pxListItem, *pxNext;
+ListItem_t const *pxListEnd;
+EventBits64_t uxBitsToClear = 0, uxBitsWaitedFor, uxReturn;
+TickType_t uxControlBits;
+EventGroup64_t *pxEventBits = ( EventGroup64_t * ) xEventGroup;
+
+	configASSERT( xEventGroup );
+
+	pxListEnd = listGET_END_MARKER( &( pxEventBits->xTasksWaitingForBits ) ); /*lint !e826 !e740 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
+	vTaskSuspendAll();
+	{
+		traceEVENT_GROUP64_SET_BITS( xEventGroup, uxBitsToSet );
+
+		pxListItem = listGET_HEAD_ENTRY( &( pxEventBits->xTasksWaitingForBits ) );
+
+		/* Set the bits. */
+		pxEventBits->uxEventBits |= uxBitsToSet;
+
+		/* See if the new bit value should unblock any tasks.  A task that
+		timed out, or was deleted, has already been removed from the list by
+		the kernel. */
+		while( pxListItem != pxListEnd )
+		{
+			pxNext = listGET_NEXT( pxListItem );
+			uxControlBits = listGET_LIST_ITEM_VALUE( pxListItem );
+			uxBitsWaitedFor = ullTaskGetEventValue64( pxListItem );
+
+			if( prvTestWaitCondition( pxEventBits->uxEventBits, uxBitsWaitedFor, ( ( uxControlBits & eg64WAIT_FOR_ALL_BITS ) != ( TickType_t ) 0 ) ? pdTRUE : pdFALSE ) != pdFALSE )
+			{
+				/* The bits match.  Should the bits be cleared on exit? */
+				if( ( uxControlBits & eg64CLEAR_EVENTS_ON_EXIT_BIT ) != ( TickType_t ) 0 )
+				{
+					uxBitsToClear |= uxBitsWaitedFor;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				prvUnblockTask( pxEventBits, pxListItem, pxEventBits->uxEventBits );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* Move onto the next list item.  Note pxListItem->pxNext is not
+			used here as the list item may have been removed from the event list
+			and inserted into the ready/pending reading list. */
+			pxListItem = pxNext;
+		}
+
+		/* Clear any bits that matched when a waiting task asked for its bits
+		to be cleared on exit. */
+		pxEventBits->uxEventBits &= ~uxBitsToClear;
+		uxReturn = pxEventBits->uxEventBits;
+	}
+	( void ) xTaskResumeAll();
+
+	return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vEventGroup64Delete( EventGroup64Handle_t xEventGroup )
+{
+EventGroup64_t *pxEventBits = ( EventGroup64_t * ) xEventGroup;
+
+	configASSERT( xEventGroup );
+
+	vTaskSuspendAll();
+	{
+		traceEVENT_GROUP64_DELETE( xEventGroup );
+
+		#if( configUSE_OBJECT_REGISTRY == 1 )
+		{
+			vObjectRegistryRemove( xEventGroup );
+		}
+		#endif
+
+		while( listCURRENT_LIST_LENGTH( &( pxEventBits->xTasksWaitingForBits ) ) > ( UBaseType_t ) 0 )
+		{
+			/* Unblock the task, returning 0 as the event group is being
+			deleted and cannot therefore have any bits set. */
+			prvUnblockTask( pxEventBits, listGET_HEAD_ENTRY( &( pxEventBits->xTasksWaitingForBits ) ), 0 );
+		}
+
+		#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
+		{
+			/* The event group can only have been allocated dynamically - free
+			it again. */
+			vPortFree( pxEventBits );
+		}
+		#elif( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+		{
+			/* The event group could have been allocated statically or
+			dynamically, so check before attempting to free the memory. */
+			if( pxEventBits->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+			{
+				vPortFree( pxEventBits );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+	}
+	( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTestWaitCondition( const EventBits64_t uxCurrentEventBits, const EventBits64_t uxBitsToWaitFor, const BaseType_t xWaitForAllBits )
+{
+BaseType_t xWaitConditionMet = pdFALSE;
+
+	if( xWaitForAllBits == pdFALSE )
+	{
+		/* Task only has to wait for one bit within uxBitsToWaitFor to be
+		set.  Is one already set? */
+		if( ( uxCurrentEventBits & uxBitsToWaitFor ) != ( EventBits64_t ) 0 )
+		{
+			xWaitConditionMet = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		/* Task has to wait for all the bits in uxBitsToWaitFor to be set.
+		Are they set already? */
+		if( ( uxCurrentEventBits & uxBitsToWaitFor ) == uxBitsToWaitFor )
+		{
+			xWaitConditionMet = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	return xWaitConditionMet;
+}
+/*-----------------------------------------------------------*/
+
+static void prvBlockOnEventGroup( EventGroup64_t *pxEventBits, const EventBits64_t uxBitsToWaitFor, const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits, const TickType_t xTicksToWait )
+{
+TickType_t uxControlBits = 0;
+
+	if( xClearOnExit != pdFALSE )
+	{
+		uxControlBits |= eg64CLEAR_EVENTS_ON_EXIT_BIT;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( xWaitForAllBits != pdFALSE )
+	{
+		uxControlBits |= eg64WAIT_FOR_ALL_BITS;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	/* Store the bits that the calling task is waiting for in the task's TCB
+	and how it is waiting for them in its event list item, so the kernel can
+	access them, and remove the task from the list, when the task times out or
+	is deleted.  The scheduler is suspended so an interrupt cannot access the
+	list. */
+	vTaskPlaceOnUnorderedEventList64( &( pxEventBits->xTasksWaitingForBits ), uxControlBits, uxBitsToWaitFor, xTicksToWait );
+}
+/*-----------------------------------------------------------*/
+
+static EventBits64_t prvCompleteWait( EventGroup64_t *pxEventBits, BaseType_t * const pxTimeoutOccurred )
+{
+EventBits64_t uxReturn, uxBitsWaitedFor;
+TickType_t uxControlBits;
+
+	/* The task blocked to wait for its required bits to be set - at this point
+	either the required bits were set or the block time expired.  If the
+	required bits were set they will have been stored in the task's TCB. */
+	uxControlBits = uxTaskResetEventItemValue();
+	uxReturn = ullTaskResetEventValue64();
+
+	if( ( uxControlBits & eg64UNBLOCKED_DUE_TO_BIT_SET ) == ( TickType_t ) 0 )
+	{
+		/* The task timed out, and the kernel has already removed it from the
+		event group's list.  The TCB still holds the bits it waited for. */
+		uxBitsWaitedFor = uxReturn;
+
+		vTaskSuspendAll();
+		{
+			/* The task timed out, just return the current event bit value. */
+			uxReturn = pxEventBits->uxEventBits;
+
+			/* It is possible that the event bits were updated between this
+			task leaving the Blocked state and running again. */
+			if( prvTestWaitCondition( uxReturn, uxBitsWaitedFor, ( ( uxControlBits & eg64WAIT_FOR_ALL_BITS ) != ( TickType_t ) 0 ) ? pdTRUE : pdFALSE ) != pdFALSE )
+			{
+				if( ( uxControlBits & eg64CLEAR_EVENTS_ON_EXIT_BIT ) != ( TickType_t ) 0 )
+				{
+					pxEventBits->uxEventBits &= ~uxBitsWaitedFor;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		( void ) xTaskResumeAll();
+
+		*pxTimeoutOccurred = pdTRUE;
+	}
+	else
+	{
+		/* The task unblocked because the bits were set, and the task that set
+		them stored the event group's value in the TCB. */
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnblockTask( EventGroup64_t *pxEventBits, ListItem_t *pxListItem, const EventBits64_t uxBits )
+{
+	/* Only a task still blocked on this event group can be removed from its
+	list. */
+	if( listIS_CONTAINED_WITHIN( &( pxEventBits->xTasksWaitingForBits ), pxListItem ) != pdFALSE )
+	{
+		vTaskRemoveFromUnorderedEventList64( pxListItem, eg64UNBLOCKED_DUE_TO_BIT_SET, uxBits );
+	}
+	else
+	{
+		/* The item came from the list, with the scheduler suspended, so this
+		cannot happen. */
+		configASSERT( pdFALSE );
+	}
+}
+
+/* This entire source file will be skipped if the application is not configured
+to include 64-bit event group functionality. */
+#endif /* configUSE_64_BIT_EVENT_GROUPS == 1 */
@@ -0,0 +1,512 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "fast_mutex.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* This entire source file will be skipped if the application is not configured
+to include fast mutex functionality. */
+#if( configUSE_FAST_MUTEXES == 1 )
+
+#if( configUSE_MUTEXES != 1 )
+	#error configUSE_MUTEXES must be set to 1 to build fast_mutex.c
+#endif
+
+/* Bits stored in the ucFlags field of the mutex. */
+#define fmFLAGS_IS_STATICALLY_ALLOCATED ( ( uint8_t ) 1 ) /* Set if the mutex was created using statically allocated memory. */
+
+/* A TCB is at least word aligned, so bit 0 of the owner word is free to mark
+that tasks are blocked on the mutex. */
+#define fmWAITERS_BIT	( ( portPOINTER_SIZE_TYPE ) 1 )
+#define fmOWNER_MASK	( ~fmWAITERS_BIT )
+
+/*-----------------------------------------------------------*/
+
+/* Structure that holds the state of a fast mutex.  uxOwner is the holder's
+handle, or 0 if the mutex is free, with fmWAITERS_BIT set while
+xTasksWaitingToTake is not empty.  Outside a critical section uxOwner is only
+changed with portCOMPARE_AND_SWAP_32(), and only between 0 and the handle of
+the task making the change.  Everything else is changed inside a critical
+section, which makes any compare-and-swap another task has part completed
+fail.  portPOINTER_SIZE_TYPE is used so the word can hold a handle - on 32-bit
+ports it is the uint32_t portCOMPARE_AND_SWAP_32() expects. */
+typedef struct xFAST_MUTEX /*lint !e9058 Style convention uses tag. */
+{
+	volatile portPOINTER_SIZE_TYPE uxOwner;
+	List_t xTasksWaitingToTake;		/* Tasks blocked waiting for the mutex, in priority order. */
+	uint8_t ucFlags;
+} FastMutex_t;
+
+/*
+ * Called by both xFastMutexCreate() and xFastMutexCreateStatic() to initialise
+ * the mutex structure.
+ */
+static void prvInitialiseNewFastMutex( FastMutex_t * const pxMutex ) PRIVILEGED_FUNCTION;
+
+/*
+ * The part of xFastMutexTake() that runs when the compare-and-swap fails
+ * because the mutex is held.  On entry the calling task's mutex held count has
+ * already been incremented; it is decremented again if the mutex is not
+ * obtained.
+ */
+static BaseType_t prvTakeContended( FastMutex_t * const pxMutex, const portPOINTER_SIZE_TYPE uxSelf, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * The part of xFastMutexGive() that runs when the compare-and-swap fails,
+ * either because tasks are waiting for the mutex or because the calling task
+ * does not hold it.
+ */
+static BaseType_t prvGiveContended( FastMutex_t * const pxMutex, const portPOINTER_SIZE_TYPE uxSelf ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the priority of the highest priority task still waiting for the
+ * mutex, or tskIDLE_PRIORITY if there are none.  Used to limit how far the
+ * holder disinherits when a waiting task times out.
+ */
+static UBaseType_t prvGetDisinheritPriorityAfterTimeout( const FastMutex_t * const pxMutex ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	FastMutexHandle_t xFastMutexCreate( void )
+	{
+	FastMutex_t *pxMutex;
+
+		pxMutex = ( FastMutex_t * ) pvPortMalloc( sizeof( FastMutex_t ) ); /*lint !e9079 malloc() only returns void*. */
+
+		if( pxMutex != NULL )
+		{
+			prvInitialiseNewFastMutex( pxMutex );
+			traceFAST_MUTEX_CREATE( pxMutex );
+		}
+		else
+		{
+			traceFAST_MUTEX_CREATE_FAILED();
+		}
+
+		return ( FastMutexHandle_t ) pxMutex;
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+	FastMutexHandle_t xFastMutexCreateStatic( StaticFastMutex_t * const pxStaticFastMutex )
+	{
+	FastMutex_t * const pxMutex = ( FastMutex_t * ) pxStaticFastMutex; /*lint !e740 !e9087 Safe cast as StaticFastMutex_t is opaque FastMutex_t. */
+	FastMutexHandle_t xReturn;
+
+		configASSERT( pxStaticFastMutex );
+
+		#if( configASSERT_DEFINED == 1 )
+		{
+			/* Sanity check that the size of the structure used to declare a
+			variable of type StaticFastMutex_t equals the size of the real
+			mutex structure. */
+			volatile size_t xSize = sizeof( StaticFastMutex_t );
+			configASSERT( xSize == sizeof( FastMutex_t ) );
+		}
+		#endif /* configASSERT_DEFINED */
+
+		if( pxStaticFastMutex != NULL )
+		{
+			prvInitialiseNewFastMutex( pxMutex );
+
+			/* Remember this was statically allocated in case it is ever deleted
+			again. */
+			pxMutex->ucFlags |= fmFLAGS_IS_STATICALLY_ALLOCATED;
+
+			traceFAST_MUTEX_CREATE( pxMutex );
+
+			xReturn = ( FastMutexHandle_t ) pxStaticFastMutex;
+		}
+		else
+		{
+			xReturn = NULL;
+			traceFAST_MUTEX_CREATE_FAILED();
+		}
+
+		return xReturn;
+	}
+
+#endif /* ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+/*-----------------------------------------------------------*/
+
+void vFastMutexDelete( FastMutexHandle_t xMutex )
+{
+FastMutex_t * const pxMutex = ( FastMutex_t * ) xMutex; /*lint !e9087 !e9079 Safe cast as FastMutexHandle_t is opaque FastMutex_t. */
+
+	configASSERT( pxMutex );
+	configASSERT( pxMutex->uxOwner == ( portPOINTER_SIZE_TYPE ) 0 );
+
+	traceFAST_MUTEX_DELETE( pxMutex );
+
+	if( ( pxMutex->ucFlags & fmFLAGS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) pdFALSE )
+	{
+		#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+		{
+			vPortFree( ( void * ) pxMutex );
+		}
+		#else
+		{
+			/* Should not be possible to get here, ucFlags must be corrupt.
+			Force an assert. */
+			configASSERT( xMutex == ( FastMutexHandle_t ) ~0 );
+		}
+		#endif
+	}
+	else
+	{
+		/* The structure was not allocated dynamically and cannot be freed -
+		just scrub it so future use will assert. */
+		memset( pxMutex, 0x00, sizeof( FastMutex_t ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xFastMutexTake( FastMutexHandle_t xMutex, TickType_t xTicksToWait )
+{
+FastMutex_t * const pxMutex = ( FastMutex_t * ) xMutex; /*lint !e9087 !e9079 Safe cast as FastMutexHandle_t is opaque FastMutex_t. */
+portPOINTER_SIZE_TYPE uxSelf;
+BaseType_t xReturn;
+
+	configASSERT( pxMutex );
+
+	/* Count the mutex as held before trying to take it.  A task that times
+	out waiting for the mutex may disinherit the holder's priority, which
+	asserts the holder's held count is not zero - so the count must never lag
+	the owner word. */
+	uxSelf = ( portPOINTER_SIZE_TYPE ) pvTaskIncrementMutexHeldCount(); /*lint !e923 Handle stored in the owner word. */
+
+	/* Can only be called by a task. */
+	configASSERT( uxSelf != ( portPOINTER_SIZE_TYPE ) 0 );
+	configASSERT( ( uxSelf & fmWAITERS_BIT ) == ( portPOINTER_SIZE_TYPE ) 0 );
+
+	if( portCOMPARE_AND_SWAP_32( &( pxMutex->uxOwner ), uxSelf, ( portPOINTER_SIZE_TYPE ) 0 ) != pdFALSE )
+	{
+		traceFAST_MUTEX_TAKE( pxMutex );
+		xReturn = pdPASS;
+	}
+	else
+	{
+		xReturn = prvTakeContended( pxMutex, uxSelf, xTicksToWait );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xFastMutexGive( FastMutexHandle_t xMutex )
+{
+FastMutex_t * const pxMutex = ( FastMutex_t * ) xMutex; /*lint !e9087 !e9079 Safe cast as FastMutexHandle_t is opaque FastMutex_t. */
+portPOINTER_SIZE_TYPE uxSelf;
+BaseType_t xReturn;
+
+	configASSERT( pxMutex );
+
+	uxSelf = ( portPOINTER_SIZE_TYPE ) xTaskGetCurrentTaskHandle(); /*lint !e923 Handle stored in the owner word. */
+
+	/* Only succeeds if the calling task holds the mutex and no other task is
+	waiting for it. */
+	if( portCOMPARE_AND_SWAP_32( &( pxMutex->uxOwner ), ( portPOINTER_SIZE_TYPE ) 0, uxSelf ) != pdFALSE )
+	{
+		traceFAST_MUTEX_GIVE( pxMutex );
+
+		/* No task waited for this mutex, but the calling task may still run
+		at a priority inherited through another mutex that it has already
+		given back. */
+		if( xTaskDecrementMutexHeldCount() != pdFALSE )
+		{
+			portYIELD_WITHIN_API();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		xReturn = pdPASS;
+	}
+	else
+	{
+		xReturn = prvGiveContended( pxMutex, uxSelf );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+TaskHandle_t xFastMutexGetHolder( FastMutexHandle_t xMutex )
+{
+FastMutex_t * const pxMutex = ( FastMutex_t * ) xMutex; /*lint !e9087 !e9079 Safe cast as FastMutexHandle_t is opaque FastMutex_t. */
+
+	configASSERT( pxMutex );
+
+	return ( TaskHandle_t ) ( pxMutex->uxOwner & fmOWNER_MASK ); /*lint !e923 Handle stored in the owner word. */
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTakeContended( FastMutex_t * const pxMutex, const portPOINTER_SIZE_TYPE uxSelf, TickType_t xTicksToWait )
+{
+TimeOut_t xTimeOut;
+BaseType_t xEntryTimeSet = pdFALSE, xInheritanceOccurred = pdFALSE;
+BaseType_t xReturn = pdFAIL, xBlocked;
+portPOINTER_SIZE_TYPE uxOwner;
+
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+	do
+	{
+		xBlocked = pdFALSE;
+
+		taskENTER_CRITICAL();
+		{
+			uxOwner = pxMutex->uxOwner;
+
+			if( uxOwner == ( portPOINTER_SIZE_TYPE ) 0 )
+			{
+				/* The mutex was given back after the compare-and-swap failed.
+				The mutex is only ever free when no tasks are waiting for it,
+				as xFastMutexGive() hands it directly to a waiting task. */
+				pxMutex->uxOwner = uxSelf;
+				traceFAST_MUTEX_TAKE( pxMutex );
+				xReturn = pdPASS;
+			}
+			else if( ( uxOwner & fmOWNER_MASK ) == uxSelf )
+			{
+				/* A task cannot take a mutex it already holds, so the mutex
+				was handed to this task by the previous holder while this task
+				was blocked. */
+				configASSERT( xEntryTimeSet != pdFALSE );
+				traceFAST_MUTEX_TAKE( pxMutex );
+				xReturn = pdPASS;
+			}
+			else if( ( ( xEntryTimeSet == pdFALSE ) && ( xTicksToWait == ( TickType_t ) 0 ) ) ||
+					 ( ( xEntryTimeSet != pdFALSE ) && ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE ) ) )
+			{
+				/* Timed out.  If no other task is still waiting, clear the
+				waiters bit so the holder can give the mutex back without
+				entering a critical section. */
+				if( listLIST_IS_EMPTY( &( pxMutex->xTasksWaitingToTake ) ) != pdFALSE )
+				{
+					pxMutex->uxOwner = uxOwner & fmOWNER_MASK;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* If this task raised the holder's priority, lower it again,
+				but not below the priority of any task still waiting. */
+				if( xInheritanceOccurred != pdFALSE )
+				{
+					vTaskPriorityDisinheritAfterTimeout( ( TaskHandle_t ) ( uxOwner & fmOWNER_MASK ), prvGetDisinheritPriorityAfterTimeout( pxMutex ) ); /*lint !e923 Handle stored in the owner word. */
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* Undo the increment made by xFastMutexTake().  This task
+				does not hold this mutex, so cannot have inherited a priority
+				through it, but xTaskPriorityDisinherit() is still needed to
+				keep the count consistent with any other mutexes it holds.  If
+				the count reaches zero while this task still runs at an
+				inherited priority it drops back to its base priority, so a
+				task of a higher priority may now be ready to run, as after a
+				mutex is given in xQueueGenericSend().  The yield is pended
+				until the critical section is exited. */
+				if( xTaskPriorityDisinherit( ( TaskHandle_t ) uxSelf ) != pdFALSE ) /*lint !e923 Handle stored in the owner word. */
+				{
+					portYIELD_WITHIN_API();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				traceFAST_MUTEX_TAKE_FAILED( pxMutex );
+				xReturn = pdFAIL;
+			}
+			else
+			{
+				if( xEntryTimeSet == pdFALSE )
+				{
+					vTaskInternalSetTimeOutState( &xTimeOut );
+					xEntryTimeSet = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* Setting the waiters bit makes the holder's compare-and-swap
+				in xFastMutexGive() fail, so the holder will hand the mutex
+				over instead of just marking it free. */
+				pxMutex->uxOwner = uxOwner | fmWAITERS_BIT;
+
+				if( xTaskPriorityInherit( ( TaskHandle_t ) ( uxOwner & fmOWNER_MASK ) ) != pdFALSE ) /*lint !e923 Handle stored in the owner word. */
+				{
+					xInheritanceOccurred = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				traceBLOCKING_ON_FAST_MUTEX( pxMutex );
+				vTaskPlaceOnEventList( &( pxMutex->xTasksWaitingToTake ), xTicksToWait );
+
+				/* The yield is pended until the critical section is exited. */
+				portYIELD_WITHIN_API();
+				xBlocked = pdTRUE;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+	} while( xBlocked != pdFALSE );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvGiveContended( FastMutex_t * const pxMutex, const portPOINTER_SIZE_TYPE uxSelf )
+{
+void *pvNewOwner;
+portPOINTER_SIZE_TYPE uxNewOwner;
+BaseType_t xReturn;
+
+	taskENTER_CRITICAL();
+	{
+		if( ( pxMutex->uxOwner & fmOWNER_MASK ) == uxSelf )
+		{
+			traceFAST_MUTEX_GIVE( pxMutex );
+
+			if( listLIST_IS_EMPTY( &( pxMutex->xTasksWaitingToTake ) ) == pdFALSE )
+			{
+				/* Hand the mutex to the highest priority waiting task.  That
+				task already counted the mutex as held before it blocked. */
+				pvNewOwner = listGET_OWNER_OF_HEAD_ENTRY( &( pxMutex->xTasksWaitingToTake ) );
+				uxNewOwner = ( portPOINTER_SIZE_TYPE ) pvNewOwner; /*lint !e923 Handle stored in the owner word. */
+
+				if( xTaskRemoveFromEventList( &( pxMutex->xTasksWaitingToTake ) ) != pdFALSE )
+				{
+					portYIELD_WITHIN_API();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				if( listLIST_IS_EMPTY( &( pxMutex->xTasksWaitingToTake ) ) == pdFALSE )
+				{
+					uxNewOwner |= fmWAITERS_BIT;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				pxMutex->uxOwner = uxNewOwner;
+			}
+			else
+			{
+				pxMutex->uxOwner = ( portPOINTER_SIZE_TYPE ) 0;
+			}
+
+			/* Drop any priority inherited from the tasks that waited. */
+			if( xTaskPriorityDisinherit( ( TaskHandle_t ) uxSelf ) != pdFALSE ) /*lint !e923 Handle stored in the owner word. */
+			{
+				portYIELD_WITHIN_API();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			xReturn = pdPASS;
+		}
+		else
+		{
+			/* The calling task does not hold the mutex. */
+			traceFAST_MUTEX_GIVE_FAILED( pxMutex );
+			xReturn = pdFAIL;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvGetDisinheritPriorityAfterTimeout( const FastMutex_t * const pxMutex )
+{
+UBaseType_t uxHighestPriorityOfWaitingTasks;
+
+	/* The list is in priority order, and the item value of a task's event list
+	item is configMAX_PRIORITIES minus the task's priority. */
+	if( listCURRENT_LIST_LENGTH( &( pxMutex->xTasksWaitingToTake ) ) > 0 )
+	{
+		uxHighestPriorityOfWaitingTasks = configMAX_PRIORITIES - listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxMutex->xTasksWaitingToTake ) );
+	}
+	else
+	{
+		uxHighestPriorityOfWaitingTasks = tskIDLE_PRIORITY;
+	}
+
+	return uxHighestPriorityOfWaitingTasks;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseNewFastMutex( FastMutex_t * const pxMutex )
+{
+	pxMutex->uxOwner = ( portPOINTER_SIZE_TYPE ) 0;
+	vListInitialise( &( pxMutex->xTasksWaitingToTake ) );
+	pxMutex->ucFlags = ( uint8_t ) 0;
+}
+
+/* This entire source file will be skipped if the application is not configured
+to include fast mutex functionality. */
+#endif /* configUSE_FAST_MUTEXES == 1 */
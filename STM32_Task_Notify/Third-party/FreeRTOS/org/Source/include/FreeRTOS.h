@@ -498,6 +498,48 @@ extern "C" {
 	#define traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue )
 #endif
 
+#ifndef traceQUEUE_LOAN_WRITE_SLOT
+	#define traceQUEUE_LOAN_WRITE_SLOT( pxQueue, pvSlot, xTicksToWait )
+#endif
+
+#ifndef traceQUEUE_LOAN_WRITE_SLOT_FAILED
+	#define traceQUEUE_LOAN_WRITE_SLOT_FAILED( pxQueue, xTicksToWait )
+#endif
+
+#ifndef traceQUEUE_COMMIT_WRITE_SLOT
+	#define traceQUEUE_COMMIT_WRITE_SLOT( pxQueue, pvSlot )
+#endif
+
+#ifndef traceQUEUE_LOAN_READ_SLOT
+	#define traceQUEUE_LOAN_READ_SLOT( pxQueue, pvSlot, xTicksToWait )
+#endif
+
+#ifndef traceQUEUE_LOAN_READ_SLOT_FAILED
+	#define traceQUEUE_LOAN_READ_SLOT_FAILED( pxQueue, xTicksToWait )
+#endif
+
+#ifndef traceQUEUE_RELEASE_READ_SLOT
+	#define traceQUEUE_RELEASE_READ_SLOT( pxQueue, pvSlot )
+#endif
+
+/* The batch send and receive trace macros are passed the number of items
+moved, which is 0 when the call failed. */
+#ifndef traceQUEUE_SEND_MULTIPLE
+	#define traceQUEUE_SEND_MULTIPLE( pxQueue, uxItemCount )
+#endif
+
+#ifndef traceQUEUE_SEND_MULTIPLE_FROM_ISR
+	#define traceQUEUE_SEND_MULTIPLE_FROM_ISR( pxQueue, uxItemCount )
+#endif
+
+#ifndef traceQUEUE_RECEIVE_MULTIPLE
+	#define traceQUEUE_RECEIVE_MULTIPLE( pxQueue, uxItemCount )
+#endif
+
+#ifndef traceQUEUE_RECEIVE_MULTIPLE_FROM_ISR
+	#define traceQUEUE_RECEIVE_MULTIPLE_FROM_ISR( pxQueue, uxItemCount )
+#endif
+
 #ifndef traceQUEUE_PEEK_FROM_ISR_FAILED
 	#define traceQUEUE_PEEK_FROM_ISR_FAILED( pxQueue )
 #endif
@@ -574,6 +616,10 @@ extern "C" {
     #define traceFREE( pvAddress, uiSize )
 #endif
 
+#ifndef traceHEAP_INIT
+	#define traceHEAP_INIT( pucHeapStart, xHeapSize )
+#endif
+
 #ifndef traceEVENT_GROUP_CREATE
 	#define traceEVENT_GROUP_CREATE( xEventGroup )
 #endif
@@ -722,6 +768,182 @@ extern "C" {
 	#define traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength )
 #endif
 
+#ifndef traceBLOCK_POOL_CREATE
+	#define traceBLOCK_POOL_CREATE( pxBlockPool )
+#endif
+
+#ifndef traceBLOCK_POOL_CREATE_FAILED
+	#define traceBLOCK_POOL_CREATE_FAILED()
+#endif
+
+#ifndef traceBLOCK_POOL_DELETE
+	#define traceBLOCK_POOL_DELETE( pxBlockPool )
+#endif
+
+#ifndef traceBLOCK_POOL_ALLOC
+	#define traceBLOCK_POOL_ALLOC( pxBlockPool, pvBlock )
+#endif
+
+#ifndef traceBLOCK_POOL_ALLOC_FAILED
+	#define traceBLOCK_POOL_ALLOC_FAILED( pxBlockPool )
+#endif
+
+#ifndef traceBLOCK_POOL_FREE
+	#define traceBLOCK_POOL_FREE( pxBlockPool, pvBlock )
+#endif
+
+#ifndef traceSPSC_RING_CREATE
+	#define traceSPSC_RING_CREATE( pxRing )
+#endif
+
+#ifndef traceSPSC_RING_CREATE_FAILED
+	#define traceSPSC_RING_CREATE_FAILED()
+#endif
+
+#ifndef traceSPSC_RING_DELETE
+	#define traceSPSC_RING_DELETE( pxRing )
+#endif
+
+#ifndef traceSPSC_RING_OVERRUN
+	#define traceSPSC_RING_OVERRUN( pxRing )
+#endif
+
+#ifndef traceSPSC_RING_BLOCKING_ON_RECEIVE
+	#define traceSPSC_RING_BLOCKING_ON_RECEIVE( pxRing )
+#endif
+
+#ifndef traceTOPIC_CREATE
+	#define traceTOPIC_CREATE( pxTopic )
+#endif
+
+#ifndef traceTOPIC_CREATE_FAILED
+	#define traceTOPIC_CREATE_FAILED()
+#endif
+
+#ifndef traceTOPIC_DELETE
+	#define traceTOPIC_DELETE( pxTopic )
+#endif
+
+#ifndef traceTOPIC_PUBLISH
+	#define traceTOPIC_PUBLISH( pxTopic, uxDelivered )
+#endif
+
+#ifndef traceTOPIC_PUBLISH_FROM_ISR
+	#define traceTOPIC_PUBLISH_FROM_ISR( pxTopic, uxDelivered )
+#endif
+
+#ifndef traceTOPIC_INBOX_FULL
+	#define traceTOPIC_INBOX_FULL( pxTopic, xInbox )
+#endif
+
+#ifndef traceFAST_MUTEX_CREATE
+	#define traceFAST_MUTEX_CREATE( pxMutex )
+#endif
+
+#ifndef traceFAST_MUTEX_CREATE_FAILED
+	#define traceFAST_MUTEX_CREATE_FAILED()
+#endif
+
+#ifndef traceFAST_MUTEX_DELETE
+	#define traceFAST_MUTEX_DELETE( pxMutex )
+#endif
+
+#ifndef traceFAST_MUTEX_TAKE
+	#define traceFAST_MUTEX_TAKE( pxMutex )
+#endif
+
+#ifndef traceFAST_MUTEX_TAKE_FAILED
+	#define traceFAST_MUTEX_TAKE_FAILED( pxMutex )
+#endif
+
+#ifndef traceBLOCKING_ON_FAST_MUTEX
+	#define traceBLOCKING_ON_FAST_MUTEX( pxMutex )
+#endif
+
+#ifndef traceFAST_MUTEX_GIVE
+	#define traceFAST_MUTEX_GIVE( pxMutex )
+#endif
+
+#ifndef traceFAST_MUTEX_GIVE_FAILED
+	#define traceFAST_MUTEX_GIVE_FAILED( pxMutex )
+#endif
+
+#ifndef traceRW_LOCK_CREATE
+	#define traceRW_LOCK_CREATE( pxLock )
+#endif
+
+#ifndef traceRW_LOCK_CREATE_FAILED
+	#define traceRW_LOCK_CREATE_FAILED()
+#endif
+
+#ifndef traceRW_LOCK_DELETE
+	#define traceRW_LOCK_DELETE( pxLock )
+#endif
+
+#ifndef traceRW_LOCK_READ_LOCK
+	#define traceRW_LOCK_READ_LOCK( pxLock )
+#endif
+
+#ifndef traceRW_LOCK_READ_LOCK_FAILED
+	#define traceRW_LOCK_READ_LOCK_FAILED( pxLock )
+#endif
+
+#ifndef traceRW_LOCK_READ_UNLOCK
+	#define traceRW_LOCK_READ_UNLOCK( pxLock )
+#endif
+
+#ifndef traceRW_LOCK_WRITE_LOCK
+	#define traceRW_LOCK_WRITE_LOCK( pxLock )
+#endif
+
+#ifndef traceRW_LOCK_WRITE_LOCK_FAILED
+	#define traceRW_LOCK_WRITE_LOCK_FAILED( pxLock )
+#endif
+
+#ifndef traceRW_LOCK_WRITE_UNLOCK
+	#define traceRW_LOCK_WRITE_UNLOCK( pxLock )
+#endif
+
+#ifndef traceBLOCKING_ON_RW_LOCK
+	#define traceBLOCKING_ON_RW_LOCK( pxLock, xForWriting )
+#endif
+
+#ifndef traceEVENT_GROUP64_CREATE
+	#define traceEVENT_GROUP64_CREATE( xEventGroup )
+#endif
+
+#ifndef traceEVENT_GROUP64_CREATE_FAILED
+	#define traceEVENT_GROUP64_CREATE_FAILED()
+#endif
+
+#ifndef traceEVENT_GROUP64_SYNC_BLOCK
+	#define traceEVENT_GROUP64_SYNC_BLOCK( xEventGroup, uxBitsToSet, uxBitsToWaitFor )
+#endif
+
+#ifndef traceEVENT_GROUP64_SYNC_END
+	#define traceEVENT_GROUP64_SYNC_END( xEventGroup, uxBitsToSet, uxBitsToWaitFor, xTimeoutOccurred ) ( void ) xTimeoutOccurred
+#endif
+
+#ifndef traceEVENT_GROUP64_WAIT_BITS_BLOCK
+	#define traceEVENT_GROUP64_WAIT_BITS_BLOCK( xEventGroup, uxBitsToWaitFor )
+#endif
+
+#ifndef traceEVENT_GROUP64_WAIT_BITS_END
+	#define traceEVENT_GROUP64_WAIT_BITS_END( xEventGroup, uxBitsToWaitFor, xTimeoutOccurred ) ( void ) xTimeoutOccurred
+#endif
+
+#ifndef traceEVENT_GROUP64_CLEAR_BITS
+	#define traceEVENT_GROUP64_CLEAR_BITS( xEventGroup, uxBitsToClear )
+#endif
+
+#ifndef traceEVENT_GROUP64_SET_BITS
+	#define traceEVENT_GROUP64_SET_BITS( xEventGroup, uxBitsToSet )
+#endif
+
+#ifndef traceEVENT_GROUP64_DELETE
+	#define traceEVENT_GROUP64_DELETE( xEventGroup )
+#endif
+
 #ifndef configGENERATE_RUN_TIME_STATS
 	#define configGENERATE_RUN_TIME_STATS 0
 #endif
@@ -844,6 +1066,138 @@ extern "C" {
 	#define portTICK_TYPE_IS_ATOMIC 0
 #endif
 
+#ifndef portCOMPARE_AND_SWAP_32
+	/* The port does not provide its own exclusive access primitive (as is the
+	case for the host simulator ports), so fall back to the compiler's atomic
+	builtin.  Returns pdTRUE if *pulDestination held ulComparand and was
+	replaced by ulExchange. */
+	#define portCOMPARE_AND_SWAP_32( pulDestination, ulExchange, ulComparand ) ( ( BaseType_t ) __sync_bool_compare_and_swap( ( pulDestination ), ( ulComparand ), ( ulExchange ) ) )
+#endif
+
+#ifndef portMEMORY_BARRIER
+	/* Orders the memory accesses before the barrier with those after it, as
+	seen by other contexts.  Fall back to a full barrier when the port does not
+	say what is needed. */
+	#define portMEMORY_BARRIER() __sync_synchronize()
+#endif
+
+#ifndef configUSE_BLOCK_POOLS
+	#define configUSE_BLOCK_POOLS 0
+#endif
+
+#ifndef configUSE_ARENAS
+	#define configUSE_ARENAS 0
+#endif
+
+#ifndef configUSE_RELOCATABLE_HEAP
+	#define configUSE_RELOCATABLE_HEAP 0
+#endif
+
+#ifndef configUSE_QUEUE_LOANS
+	#define configUSE_QUEUE_LOANS 0
+#endif
+
+#ifndef configUSE_QUEUE_BATCHES
+	#define configUSE_QUEUE_BATCHES 0
+#endif
+
+#ifndef configUSE_SPSC_RINGS
+	#define configUSE_SPSC_RINGS 0
+#endif
+
+#ifndef configUSE_QUEUE_WORD_COPY
+	#define configUSE_QUEUE_WORD_COPY 0
+#endif
+
+#ifndef configUSE_PRIORITY_QUEUES
+	#define configUSE_PRIORITY_QUEUES 0
+#endif
+
+#ifndef configUSE_TOPIC_BUS
+	#define configUSE_TOPIC_BUS 0
+#endif
+
+#ifndef configUSE_FAST_MUTEXES
+	#define configUSE_FAST_MUTEXES 0
+#endif
+
+#ifndef configUSE_RW_LOCKS
+	#define configUSE_RW_LOCKS 0
+#endif
+
+#ifndef configRW_LOCK_MAX_READERS
+	/* The maximum number of tasks that can hold a reader-writer lock for
+	reading at the same time. */
+	#define configRW_LOCK_MAX_READERS 8
+#endif
+
+#ifndef configUSE_QUEUE_STATISTICS
+	#define configUSE_QUEUE_STATISTICS 0
+#endif
+
+#ifndef configUSE_OBJECT_REGISTRY
+	#define configUSE_OBJECT_REGISTRY 0
+#endif
+
+#ifndef configOBJECT_REGISTRY_SIZE
+	/* The number of objects the object registry can hold.  When
+	configUSE_OBJECT_REGISTRY is 1 the object registry is used in place of the
+	queue registry, and configQUEUE_REGISTRY_SIZE only needs to be greater than
+	0 for the queue registry API to be available. */
+	#define configOBJECT_REGISTRY_SIZE 16
+#endif
+
+#ifndef configUSE_STREAM_BUFFER_ZERO_COPY
+	#define configUSE_STREAM_BUFFER_ZERO_COPY 0
+#endif
+
+#ifndef configUSE_STREAM_BUFFER_MULTI_PRODUCER
+	#define configUSE_STREAM_BUFFER_MULTI_PRODUCER 0
+#endif
+
+#ifndef configUSE_COMPACT_MESSAGE_LENGTHS
+	#define configUSE_COMPACT_MESSAGE_LENGTHS 0
+#endif
+
+#ifndef configUSE_STREAM_BUFFER_COALESCING
+	#define configUSE_STREAM_BUFFER_COALESCING 0
+#endif
+
+#ifndef configUSE_INDEXED_EVENT_GROUPS
+	#define configUSE_INDEXED_EVENT_GROUPS 0
+#endif
+
+#ifndef configUSE_EVENT_GROUP_ISR_DIRECT
+	#define configUSE_EVENT_GROUP_ISR_DIRECT 0
+#endif
+
+#ifndef configEVENT_GROUP_ISR_MAX_WAITERS
+	#define configEVENT_GROUP_ISR_MAX_WAITERS 8
+#endif
+
+#ifndef configUSE_64_BIT_EVENT_GROUPS
+	#define configUSE_64_BIT_EVENT_GROUPS 0
+#endif
+
+#ifndef configUSE_TIMER_WHEEL
+	#define configUSE_TIMER_WHEEL 0
+#endif
+
+#if( configUSE_RELOCATABLE_HEAP == 1 )
+	#ifndef configRELOCATABLE_HEAP_SIZE
+		#error configRELOCATABLE_HEAP_SIZE must be defined in FreeRTOSConfig.h when configUSE_RELOCATABLE_HEAP is set to 1.
+	#endif
+
+	#ifndef configRELOCATABLE_HEAP_MAX_HANDLES
+		#define configRELOCATABLE_HEAP_MAX_HANDLES 16
+	#endif
+
+	#ifndef configRELOCATABLE_HEAP_COMPACT_STEP_BYTES
+		/* The most bytes the idle task will copy in one compaction step. */
+		#define configRELOCATABLE_HEAP_COMPACT_STEP_BYTES 256
+	#endif
+#endif
+
 #ifndef configSUPPORT_STATIC_ALLOCATION
 	/* Defaults to 0 for backward compatibility. */
 	#define configSUPPORT_STATIC_ALLOCATION 0
@@ -1060,6 +1414,9 @@ typedef struct xSTATIC_TCB
 	#if( INCLUDE_xTaskAbortDelay == 1 )
 		uint8_t ucDummy21;
 	#endif
+	#if( configUSE_64_BIT_EVENT_GROUPS == 1 )
+		uint64_t		ullDummy22;
+	#endif
 
 } StaticTask_t;
 
@@ -1104,6 +1461,21 @@ typedef struct xSTATIC_QUEUE
 		uint8_t ucDummy9;
 	#endif
 
+	#if ( configUSE_QUEUE_LOANS == 1 )
+		void *pvDummy10[ 2 ];
+	#endif
+
+	#if ( configUSE_PRIORITY_QUEUES == 1 )
+		void *pvDummy11;
+	#endif
+
+	#if ( configUSE_QUEUE_STATISTICS == 1 )
+		void *pvDummy12;
+		UBaseType_t uxDummy13;
+		uint32_t ulDummy14[ 3 ];
+		TickType_t xDummy15[ 2 ];
+	#endif
+
 } StaticQueue_t;
 typedef StaticQueue_t StaticSemaphore_t;
 
@@ -1126,6 +1498,18 @@ typedef struct xSTATIC_EVENT_GROUP
 	TickType_t xDummy1;
 	StaticList_t xDummy2;
 
+	#if( configUSE_INDEXED_EVENT_GROUPS == 1 )
+		/* One list for each bit the application can use - 8 with 16 bit
+		ticks, 24 with 32 bit ticks. */
+		StaticList_t xDummy5[ ( configUSE_16_BIT_TICKS == 1 ) ? 8 : 24 ];
+		TickType_t xDummy6[ 2 ];
+	#endif
+
+	#if( configUSE_EVENT_GROUP_ISR_DIRECT == 1 )
+		UBaseType_t uxDummy7;
+		TickType_t xDummy8;
+	#endif
+
 	#if( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxDummy3;
 	#endif
@@ -1189,11 +1573,103 @@ typedef struct xSTATIC_STREAM_BUFFER
 	#if ( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxDummy4;
 	#endif
+	#if ( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+		size_t uxDummy5;
+		UBaseType_t uxDummy6;
+		StaticList_t xDummy7;
+	#endif
+	#if ( configUSE_STREAM_BUFFER_COALESCING == 1 )
+		TickType_t xDummy8[ 2 ];
+		BaseType_t xDummy9;
+	#endif
 } StaticStreamBuffer_t;
 
 /* Message buffers are built on stream buffers. */
 typedef StaticStreamBuffer_t StaticMessageBuffer_t;
 
+/*
+ * In line with software engineering best practice, FreeRTOS implements a strict
+ * data hiding policy, so the fixed block pool structure used internally is not
+ * accessible to application code.  However, if the application writer wants to
+ * statically allocate a block pool then the size of the object needs to be
+ * known.  The StaticBlockPool_t structure below is provided for this purpose.
+ * Its size and alignment requirements are guaranteed to match those of the
+ * genuine structure, no matter which architecture is being used, and no matter
+ * how the values in FreeRTOSConfig.h are set.
+ */
+typedef struct xSTATIC_BLOCK_POOL
+{
+	uint32_t ulDummy1[ 4 ];
+	size_t uxDummy2;
+	UBaseType_t uxDummy3;
+	void *pvDummy4;
+	uint8_t ucDummy5;
+} StaticBlockPool_t;
+
+/* See the comments above the StaticBlockPool_t definition. */
+typedef struct xSTATIC_ARENA
+{
+	void *pvDummy1;
+	size_t uxDummy2[ 3 ];
+	UBaseType_t uxDummy3;
+	uint8_t ucDummy4;
+} StaticArena_t;
+
+/* See the comments above the StaticBlockPool_t definition. */
+typedef struct xSTATIC_SPSC_RING
+{
+	uint32_t ulDummy1[ 4 ];
+	size_t uxDummy2;
+	void *pvDummy3[ 2 ];
+	uint8_t ucDummy4;
+} StaticSpscRing_t;
+
+/* See the comments above the StaticBlockPool_t definition. */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	typedef struct xSTATIC_TOPIC
+	{
+		void *pvDummy1[ 2 ];
+		size_t uxDummy2;
+		UBaseType_t uxDummy3;
+		uint32_t ulDummy4;
+		uint8_t ucDummy5;
+		StaticBlockPool_t xDummy6;
+	} StaticTopic_t;
+#endif
+
+/* See the comments above the StaticBlockPool_t definition. */
+typedef struct xSTATIC_FAST_MUTEX
+{
+	portPOINTER_SIZE_TYPE uxDummy1;
+	StaticList_t xDummy2;
+	uint8_t ucDummy3;
+} StaticFastMutex_t;
+
+/* See the comments above the StaticBlockPool_t definition. */
+typedef struct xSTATIC_RW_LOCK
+{
+	void *pvDummy1;
+	UBaseType_t uxDummy2;
+	void *pvDummy3[ configRW_LOCK_MAX_READERS ];
+	StaticList_t xDummy4[ 2 ];
+	uint8_t ucDummy5;
+} StaticRwLock_t;
+
+/* See the comments above the StaticBlockPool_t definition. */
+typedef struct xSTATIC_EVENT_GROUP_64
+{
+	uint64_t ullDummy1;
+	StaticList_t xDummy2;
+
+	#if( configUSE_TRACE_FACILITY == 1 )
+		UBaseType_t uxDummy3;
+	#endif
+
+	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+		uint8_t ucDummy4;
+	#endif
+} StaticEventGroup64_t;
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,245 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Arenas (also called regions) hand out memory for data that all dies at the
+ * same time, such as the buffers used while handling one request.  Allocation
+ * bumps an offset and is O(1); nothing is freed individually.  Instead the
+ * whole arena is reset in O(1), or a scope is closed to release everything
+ * allocated since the scope was opened.  Scopes nest.
+ *
+ * ***NOTE***:  An arena is not protected against concurrent use.  It is
+ * intended to be owned by a single task.  If more than one task or interrupt
+ * must use the same arena then the application writer must serialise the
+ * calls.
+ *
+ * configUSE_ARENAS must be set to 1 in FreeRTOSConfig.h for the arena API to
+ * be available.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include arena.h"
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * Type by which arenas are referenced.  For example, a call to xArenaCreate()
+ * returns an ArenaHandle_t variable that can then be used as a parameter to
+ * pvArenaAlloc(), vArenaReset(), etc.
+ */
+typedef void * ArenaHandle_t;
+
+/**
+ * Marks a position in an arena.  Returned by xArenaScopeBegin() and passed to
+ * vArenaScopeEnd().
+ */
+typedef size_t ArenaMark_t;
+
+/**
+ * arena.h
+ *
+<pre>
+ArenaHandle_t xArenaCreate( size_t xArenaSizeBytes );
+</pre>
+ *
+ * Creates an arena that can hold xArenaSizeBytes bytes, taking the memory
+ * from the kernel heap with a single call to pvPortMalloc().
+ *
+ * @return The handle of the created arena, or NULL if there was not enough
+ * heap memory available.
+ *
+ * \defgroup xArenaCreate xArenaCreate
+ * \ingroup ArenaManagement
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	ArenaHandle_t xArenaCreate( size_t xArenaSizeBytes ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * arena.h
+ *
+<pre>
+ArenaHandle_t xArenaCreateStatic( size_t xArenaSizeBytes,
+                                  uint8_t *pucArenaStorageArea,
+                                  StaticArena_t *pxStaticArena );
+</pre>
+ *
+ * Creates an arena on a buffer supplied by the application.
+ *
+ * @param xArenaSizeBytes The size of the buffer pointed to by
+ * pucArenaStorageArea.
+ *
+ * @param pucArenaStorageArea Must point to a portBYTE_ALIGNMENT aligned
+ * buffer of at least xArenaSizeBytes bytes.
+ *
+ * @param pxStaticArena Must point to a variable of type StaticArena_t, which
+ * will be used to hold the arena's data structure.
+ *
+ * @return The handle of the created arena, or NULL if either pointer was NULL.
+ *
+ * Example use:
+<pre>
+static uint8_t ucRequestMemory[ 512 ] __attribute__( ( aligned( 8 ) ) );
+static StaticArena_t xRequestArenaStruct;
+
+void vRequestTask( void *pvParameters )
+{
+ArenaHandle_t xArena;
+ArenaMark_t xMark;
+char *pcReply;
+
+    xArena = xArenaCreateStatic( sizeof( ucRequestMemory ), ucRequestMemory, &xRequestArenaStruct );
+
+    for( ;; )
+    {
+        // ... Wait for a request, allocate per-request buffers ...
+        pcReply = ( char * ) pvArenaAlloc( xArena, 64 );
+
+        // A nested scope for temporaries that are only needed briefly.
+        xMark = xArenaScopeBegin( xArena );
+        {
+            uint8_t *pucScratch = ( uint8_t * ) pvArenaAlloc( xArena, 128 );
+            // ... use pucScratch ...
+        }
+        vArenaScopeEnd( xArena, xMark );
+
+        // ... send pcReply ...
+
+        // Release everything allocated for this request in one go.
+        vArenaReset( xArena );
+    }
+}
+</pre>
+ * \defgroup xArenaCreateStatic xArenaCreateStatic
+ * \ingroup ArenaManagement
+ */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	ArenaHandle_t xArenaCreateStatic( size_t xArenaSizeBytes,
+									  uint8_t * const pucArenaStorageArea,
+									  StaticArena_t * const pxStaticArena ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * arena.h
+ *
+<pre>
+void vArenaDelete( ArenaHandle_t xArena );
+</pre>
+ *
+ * Deletes an arena.  If the arena was created with xArenaCreate() its memory
+ * is returned to the kernel heap.
+ *
+ * \defgroup vArenaDelete vArenaDelete
+ * \ingroup ArenaManagement
+ */
+void vArenaDelete( ArenaHandle_t xArena ) PRIVILEGED_FUNCTION;
+
+/**
+ * arena.h
+ *
+<pre>
+void *pvArenaAlloc( ArenaHandle_t xArena, size_t xWantedSize );
+</pre>
+ *
+ * Allocates xWantedSize bytes, aligned to portBYTE_ALIGNMENT, from the arena.
+ * The memory remains valid until the arena is reset, or until the innermost
+ * scope that was open when it was allocated is closed.
+ *
+ * @return A pointer to the memory, or NULL if the arena does not have
+ * xWantedSize bytes left.
+ *
+ * \defgroup pvArenaAlloc pvArenaAlloc
+ * \ingroup ArenaManagement
+ */
+void *pvArenaAlloc( ArenaHandle_t xArena, size_t xWantedSize ) PRIVILEGED_FUNCTION;
+
+/**
+ * arena.h
+ *
+<pre>
+void vArenaReset( ArenaHandle_t xArena );
+</pre>
+ *
+ * Releases everything allocated from the arena, and closes any open scopes.
+ *
+ * \defgroup vArenaReset vArenaReset
+ * \ingroup ArenaManagement
+ */
+void vArenaReset( ArenaHandle_t xArena ) PRIVILEGED_FUNCTION;
+
+/**
+ * arena.h
+ *
+<pre>
+ArenaMark_t xArenaScopeBegin( ArenaHandle_t xArena );
+void vArenaScopeEnd( ArenaHandle_t xArena, ArenaMark_t xMark );
+</pre>
+ *
+ * xArenaScopeBegin() opens a scope and returns a mark.  Passing the mark to
+ * vArenaScopeEnd() releases everything that was allocated from the arena since
+ * the scope was opened.  Scopes can be nested, but must be closed in the
+ * reverse order to the one in which they were opened.
+ *
+ * \defgroup xArenaScopeBegin xArenaScopeBegin
+ * \ingroup ArenaManagement
+ */
+ArenaMark_t xArenaScopeBegin( ArenaHandle_t xArena ) PRIVILEGED_FUNCTION;
+void vArenaScopeEnd( ArenaHandle_t xArena, ArenaMark_t xMark ) PRIVILEGED_FUNCTION;
+
+/**
+ * arena.h
+ *
+<pre>
+size_t xArenaGetBytesUsed( ArenaHandle_t xArena );
+size_t xArenaGetFreeSize( ArenaHandle_t xArena );
+size_t xArenaGetHighWaterMark( ArenaHandle_t xArena );
+</pre>
+ *
+ * Return the number of bytes currently allocated from the arena (including
+ * alignment padding), the number of bytes still available, and the largest
+ * number of bytes that have ever been allocated at once.  The high water mark
+ * shows how big the arena really needs to be.
+ *
+ * \defgroup xArenaGetHighWaterMark xArenaGetHighWaterMark
+ * \ingroup ArenaManagement
+ */
+size_t xArenaGetBytesUsed( ArenaHandle_t xArena ) PRIVILEGED_FUNCTION;
+size_t xArenaGetFreeSize( ArenaHandle_t xArena ) PRIVILEGED_FUNCTION;
+size_t xArenaGetHighWaterMark( ArenaHandle_t xArena ) PRIVILEGED_FUNCTION;
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( ARENA_H ) */
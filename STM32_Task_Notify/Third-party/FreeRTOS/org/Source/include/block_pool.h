@@ -0,0 +1,277 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Block pools hand out fixed size blocks of memory from a pre-allocated area.
+ * Unlike pvPortMalloc(), allocating and freeing a block never suspends the
+ * scheduler and never masks interrupts - the free list is updated with
+ * portCOMPARE_AND_SWAP_32() (LDREX/STREX on Cortex-M) - so blocks can be taken
+ * and returned from any task or interrupt, including interrupts that run above
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY.  A typical use is for an interrupt to
+ * fill a block and pass the pointer to a task through a queue or a task
+ * notification, with the task freeing the block once it has been processed.
+ *
+ * Creating and deleting a pool is not interrupt safe.
+ *
+ * configUSE_BLOCK_POOLS must be set to 1 in FreeRTOSConfig.h for the block
+ * pool API to be available.
+ */
+
+#ifndef BLOCK_POOL_H
+#define BLOCK_POOL_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include block_pool.h"
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * Type by which block pools are referenced.  For example, a call to
+ * xBlockPoolCreate() returns a BlockPoolHandle_t variable that can then be
+ * used as a parameter to pvBlockPoolAlloc(), vBlockPoolFree(), etc.
+ */
+typedef void * BlockPoolHandle_t;
+
+/**
+ * block_pool.h
+ *
+<pre>
+BlockPoolHandle_t xBlockPoolCreate( size_t xBlockSize, UBaseType_t uxBlockCount );
+</pre>
+ *
+ * Creates a pool of uxBlockCount blocks, each at least xBlockSize bytes, using
+ * a single call to pvPortMalloc().  The block size is rounded up to
+ * portBYTE_ALIGNMENT so every block is suitably aligned for any type.  See
+ * xBlockPoolCreateStatic() for a version that uses statically allocated memory.
+ *
+ * @param xBlockSize The number of bytes in each block.
+ *
+ * @param uxBlockCount The number of blocks in the pool.  Must not exceed
+ * 0xffff.
+ *
+ * @return The handle of the created pool, or NULL if the memory could not be
+ * allocated.
+ *
+ * \defgroup xBlockPoolCreate xBlockPoolCreate
+ * \ingroup BlockPoolManagement
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	BlockPoolHandle_t xBlockPoolCreate( size_t xBlockSize, UBaseType_t uxBlockCount ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * block_pool.h
+ *
+<pre>
+BlockPoolHandle_t xBlockPoolCreateStatic( size_t xBlockSize,
+                                          UBaseType_t uxBlockCount,
+                                          uint8_t *pucPoolStorageArea,
+                                          StaticBlockPool_t *pxStaticBlockPool );
+</pre>
+ *
+ * Creates a block pool using statically allocated memory.
+ *
+ * @param xBlockSize The number of bytes in each block.  Must be a multiple of
+ * portBYTE_ALIGNMENT.
+ *
+ * @param uxBlockCount The number of blocks in the pool.  Must not exceed
+ * 0xffff.
+ *
+ * @param pucPoolStorageArea Must point to a portBYTE_ALIGNMENT aligned array
+ * of at least xBlockSize * uxBlockCount bytes.
+ *
+ * @param pxStaticBlockPool Must point to a variable of type StaticBlockPool_t,
+ * which will be used to hold the pool's data structure.
+ *
+ * @return The handle of the created pool, or NULL if either pointer was NULL.
+ *
+ * \defgroup xBlockPoolCreateStatic xBlockPoolCreateStatic
+ * \ingroup BlockPoolManagement
+ */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	BlockPoolHandle_t xBlockPoolCreateStatic( size_t xBlockSize,
+											  UBaseType_t uxBlockCount,
+											  uint8_t * const pucPoolStorageArea,
+											  StaticBlockPool_t * const pxStaticBlockPool ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * block_pool.h
+ *
+<pre>
+void vBlockPoolDelete( BlockPoolHandle_t xBlockPool );
+</pre>
+ *
+ * Deletes a block pool.  All the blocks must have been returned to the pool
+ * first.  Must not be called from an interrupt.
+ *
+ * \defgroup vBlockPoolDelete vBlockPoolDelete
+ * \ingroup BlockPoolManagement
+ */
+void vBlockPoolDelete( BlockPoolHandle_t xBlockPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * block_pool.h
+ *
+<pre>
+void *pvBlockPoolAlloc( BlockPoolHandle_t xBlockPool );
+</pre>
+ *
+ * Takes one block from the pool.  Can be called from a task or from any
+ * interrupt, and never blocks.  If the pool is empty NULL is returned and the
+ * pool's exhausted counter (see ulBlockPoolGetExhaustedCount()) is
+ * incremented.
+ *
+ * Example use:
+<pre>
+// A pool that has already been created, and a queue that carries pointers.
+BlockPoolHandle_t xRxPool;
+QueueHandle_t xRxQueue;
+
+void USART2_IRQHandler( void )
+{
+uint8_t *pucBlock;
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    pucBlock = ( uint8_t * ) pvBlockPoolAlloc( xRxPool );
+
+    if( pucBlock != NULL )
+    {
+        pucBlock[ 0 ] = ( uint8_t ) USART_ReceiveData( USART2 );
+        xQueueSendFromISR( xRxQueue, &pucBlock, &xHigherPriorityTaskWoken );
+    }
+
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+</pre>
+ * \defgroup pvBlockPoolAlloc pvBlockPoolAlloc
+ * \ingroup BlockPoolManagement
+ */
+void *pvBlockPoolAlloc( BlockPoolHandle_t xBlockPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * block_pool.h
+ *
+<pre>
+void vBlockPoolFree( BlockPoolHandle_t xBlockPool, void *pvBlock );
+</pre>
+ *
+ * Returns a block previously obtained from pvBlockPoolAlloc() to the same
+ * pool.  Can be called from a task or from any interrupt.
+ *
+ * \defgroup vBlockPoolFree vBlockPoolFree
+ * \ingroup BlockPoolManagement
+ */
+void vBlockPoolFree( BlockPoolHandle_t xBlockPool, void *pvBlock ) PRIVILEGED_FUNCTION;
+
+/**
+ * block_pool.h
+ *
+<pre>
+void *pvBlockPoolAllocFromSet( const BlockPoolHandle_t *pxBlockPools,
+                               UBaseType_t uxNumberOfPools,
+                               size_t xWantedSize );
+</pre>
+ *
+ * Takes a block of at least xWantedSize bytes from a set of pools that have
+ * different block sizes.  The pools in pxBlockPools[] must be ordered from
+ * the smallest block size to the largest.  The smallest pool that can hold
+ * xWantedSize bytes is tried first, then the next larger one, and so on, so an
+ * exhausted small pool spills over into the larger pools.  Each exhausted pool
+ * that is tried has its exhausted counter incremented.  Interrupt safe.
+ *
+ * @return A pointer to the block, or NULL if no pool could supply one.
+ *
+ * \defgroup pvBlockPoolAllocFromSet pvBlockPoolAllocFromSet
+ * \ingroup BlockPoolManagement
+ */
+void *pvBlockPoolAllocFromSet( const BlockPoolHandle_t *pxBlockPools, UBaseType_t uxNumberOfPools, size_t xWantedSize ) PRIVILEGED_FUNCTION;
+
+/**
+ * block_pool.h
+ *
+<pre>
+void vBlockPoolFreeToSet( const BlockPoolHandle_t *pxBlockPools,
+                          UBaseType_t uxNumberOfPools,
+                          void *pvBlock );
+</pre>
+ *
+ * Returns a block obtained from pvBlockPoolAllocFromSet() to whichever pool
+ * in the set it came from.  Interrupt safe.
+ *
+ * \defgroup vBlockPoolFreeToSet vBlockPoolFreeToSet
+ * \ingroup BlockPoolManagement
+ */
+void vBlockPoolFreeToSet( const BlockPoolHandle_t *pxBlockPools, UBaseType_t uxNumberOfPools, void *pvBlock ) PRIVILEGED_FUNCTION;
+
+/**
+ * block_pool.h
+ *
+<pre>
+BaseType_t xBlockPoolOwnsBlock( BlockPoolHandle_t xBlockPool, const void *pvBlock );
+</pre>
+ *
+ * @return pdTRUE if pvBlock lies within the storage area of xBlockPool,
+ * otherwise pdFALSE.
+ *
+ * \defgroup xBlockPoolOwnsBlock xBlockPoolOwnsBlock
+ * \ingroup BlockPoolManagement
+ */
+BaseType_t xBlockPoolOwnsBlock( BlockPoolHandle_t xBlockPool, const void *pvBlock ) PRIVILEGED_FUNCTION;
+
+/**
+ * block_pool.h
+ *
+<pre>
+size_t xBlockPoolGetBlockSize( BlockPoolHandle_t xBlockPool );
+UBaseType_t uxBlockPoolGetFreeBlocks( BlockPoolHandle_t xBlockPool );
+UBaseType_t uxBlockPoolGetMinimumEverFreeBlocks( BlockPoolHandle_t xBlockPool );
+uint32_t ulBlockPoolGetExhaustedCount( BlockPoolHandle_t xBlockPool );
+</pre>
+ *
+ * Query the pool's block size (after rounding), the number of blocks currently
+ * free, the lowest number of free blocks seen since the pool was created, and
+ * the number of allocation attempts that failed because the pool was empty.
+ * All are interrupt safe.
+ *
+ * \defgroup ulBlockPoolGetExhaustedCount ulBlockPoolGetExhaustedCount
+ * \ingroup BlockPoolManagement
+ */
+size_t xBlockPoolGetBlockSize( BlockPoolHandle_t xBlockPool ) PRIVILEGED_FUNCTION;
+UBaseType_t uxBlockPoolGetFreeBlocks( BlockPoolHandle_t xBlockPool ) PRIVILEGED_FUNCTION;
+UBaseType_t uxBlockPoolGetMinimumEverFreeBlocks( BlockPoolHandle_t xBlockPool ) PRIVILEGED_FUNCTION;
+uint32_t ulBlockPoolGetExhaustedCount( BlockPoolHandle_t xBlockPool ) PRIVILEGED_FUNCTION;
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( BLOCK_POOL_H ) */
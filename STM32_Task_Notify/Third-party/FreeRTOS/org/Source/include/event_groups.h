@@ -500,6 +500,18 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_
  * context of the timer task - where a scheduler lock is used in place of a
  * critical section.
  *
+ * When configUSE_EVENT_GROUP_ISR_DIRECT is set to 1 in FreeRTOSConfig.h the
+ * bits are always set by xEventGroupSetBitsFromISR() itself, before it
+ * returns, and the timer task is not needed.  The waiting tasks are unblocked
+ * by xEventGroupSetBitsFromISR() too, as long as no more than
+ * configEVENT_GROUP_ISR_MAX_WAITERS of them have to be checked, so the work
+ * done in the interrupt is bounded.  Otherwise none of them are checked in the
+ * interrupt.  The check is left to the timer task when there is one, and in
+ * any case is done by the next task to set, clear or wait for bits in the
+ * event group, before it does so.  If a task is part way through an operation
+ * on the event group when the interrupt executes then that task checks the
+ * waiting tasks as soon as the operation completes.
+ *
  * @param xEventGroup The event group in which the bits are to be set.
  *
  * @param uxBitsToSet A bitwise value that indicates the bit or bits to set.
@@ -518,7 +530,8 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_
  *
  * @return If the request to execute the function was posted successfully then
  * pdPASS is returned, otherwise pdFALSE is returned.  pdFALSE will be returned
- * if the timer service queue was full.
+ * if the timer service queue was full.  When configUSE_EVENT_GROUP_ISR_DIRECT
+ * is 1 the bits are always set, and pdPASS is always returned.
  *
  * Example usage:
    <pre>
@@ -556,7 +569,7 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_
  * \defgroup xEventGroupSetBitsFromISR xEventGroupSetBitsFromISR
  * \ingroup EventGroup
  */
-#if( configUSE_TRACE_FACILITY == 1 )
+#if( ( configUSE_TRACE_FACILITY == 1 ) || ( configUSE_EVENT_GROUP_ISR_DIRECT == 1 ) )
 	BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 #else
 	#define xEventGroupSetBitsFromISR( xEventGroup, uxBitsToSet, pxHigherPriorityTaskWoken ) xTimerPendFunctionCallFromISR( vEventGroupSetBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToSet, pxHigherPriorityTaskWoken )
@@ -0,0 +1,287 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * 64-bit event groups work as standard event groups (see event_groups.h), but
+ * hold 64 event bits, all of which are available to the application.  A
+ * standard event group keeps its control bits in the top 8 bits of a
+ * TickType_t, leaving 24 bits (or 8 with configUSE_16_BIT_TICKS set to 1).
+ *
+ * Setting, clearing and waiting for bits act on all 64 bits at once, so a task
+ * can wait for any combination of up to 64 events atomically, rather than
+ * waiting on several standard event groups one after the other.
+ *
+ * The bits a blocked task is waiting for do not fit in its event list item, so
+ * they are held in a 64-bit value in the task's TCB, next to the event list
+ * item.  Both belong to the kernel, so a blocked task that times out or is
+ * deleted leaves nothing behind on the event group.
+ *
+ * 64-bit event groups cannot be used from interrupts.
+ *
+ * configUSE_64_BIT_EVENT_GROUPS must be set to 1 in FreeRTOSConfig.h for the
+ * 64-bit event group API to be available.
+ */
+
+#ifndef EVENT_GROUPS64_H
+#define EVENT_GROUPS64_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include event_groups64.h"
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * Type by which 64-bit event groups are referenced.  For example, a call to
+ * xEventGroup64Create() returns an EventGroup64Handle_t variable that can then
+ * be used as a parameter to other 64-bit event group functions.
+ */
+typedef void * EventGroup64Handle_t;
+
+/**
+ * The type that holds the bits of a 64-bit event group.
+ */
+typedef uint64_t EventBits64_t;
+
+/**
+ * event_groups64.h
+ *
+<pre>
+EventGroup64Handle_t xEventGroup64Create( void );
+</pre>
+ *
+ * Creates a 64-bit event group using pvPortMalloc().  All the bits of the new
+ * event group are clear.
+ *
+ * @return The handle of the created event group, or NULL if the memory could
+ * not be allocated.
+ *
+ * \defgroup xEventGroup64Create xEventGroup64Create
+ * \ingroup EventGroup64
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	EventGroup64Handle_t xEventGroup64Create( void ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * event_groups64.h
+ *
+<pre>
+EventGroup64Handle_t xEventGroup64CreateStatic( StaticEventGroup64_t *pxEventGroupBuffer );
+</pre>
+ *
+ * Creates a 64-bit event group using statically allocated memory.
+ *
+ * @param pxEventGroupBuffer Must point to a variable of type
+ * StaticEventGroup64_t, which will be used to hold the event group's data
+ * structure.
+ *
+ * @return The handle of the created event group, or NULL if
+ * pxEventGroupBuffer was NULL.
+ *
+ * Example use:
+<pre>
+// Bit 40 : the motor controller is ready.  Bit 52 : the encoder is calibrated.
+#define MOTOR_READY		( ( EventBits64_t ) 1 << 40 )
+#define ENCODER_READY	( ( EventBits64_t ) 1 << 52 )
+
+static StaticEventGroup64_t xSystemStateStruct;
+static EventGroup64Handle_t xSystemState;
+
+void vStartUp( void )
+{
+    xSystemState = xEventGroup64CreateStatic( &xSystemStateStruct );
+}
+
+void vMotorTask( void *pvParameters )
+{
+    // Wait for both, leaving the bits set for other tasks.
+    xEventGroup64WaitBits( xSystemState, MOTOR_READY | ENCODER_READY, pdFALSE, pdTRUE, portMAX_DELAY );
+
+    for( ;; )
+    {
+        // ...
+    }
+}
+</pre>
+ *
+ * \defgroup xEventGroup64CreateStatic xEventGroup64CreateStatic
+ * \ingroup EventGroup64
+ */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	EventGroup64Handle_t xEventGroup64CreateStatic( StaticEventGroup64_t *pxEventGroupBuffer ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * event_groups64.h
+ *
+<pre>
+EventBits64_t xEventGroup64WaitBits( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToWaitFor, const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits, TickType_t xTicksToWait );
+</pre>
+ *
+ * The 64-bit version of xEventGroupWaitBits().  Reads bits within a 64-bit
+ * event group, optionally entering the Blocked state (with a timeout) to wait
+ * for a bit or group of bits to become set.
+ *
+ * @param xEventGroup The event group in which the bits are being tested.
+ *
+ * @param uxBitsToWaitFor A bitwise value that indicates the bit or bits to
+ * test.  Any of the 64 bits can be used.  uxBitsToWaitFor must not be 0.
+ *
+ * @param xClearOnExit If xClearOnExit is set to pdTRUE then any bits within
+ * uxBitsToWaitFor that are set within the event group will be cleared before
+ * xEventGroup64WaitBits() returns if the wait condition was met (if the
+ * function returns for a reason other than a timeout).
+ *
+ * @param xWaitForAllBits If set to pdTRUE the function waits for all the bits
+ * in uxBitsToWaitFor to be set, otherwise for any one of them.
+ *
+ * @param xTicksToWait The maximum amount of time (specified in 'ticks') to
+ * wait for the bits to become set.
+ *
+ * @return The value of the event group at the time either the bits being
+ * waited for became set, or the block time expired.
+ *
+ * \defgroup xEventGroup64WaitBits xEventGroup64WaitBits
+ * \ingroup EventGroup64
+ */
+EventBits64_t xEventGroup64WaitBits( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToWaitFor, const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * event_groups64.h
+ *
+<pre>
+EventBits64_t xEventGroup64ClearBits( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToClear );
+</pre>
+ *
+ * Clear bits within a 64-bit event group.
+ *
+ * @param xEventGroup The event group in which the bits are to be cleared.
+ *
+ * @param uxBitsToClear A bitwise value that indicates the bit or bits to
+ * clear.
+ *
+ * @return The value of the event group before the specified bits were cleared.
+ *
+ * \defgroup xEventGroup64ClearBits xEventGroup64ClearBits
+ * \ingroup EventGroup64
+ */
+EventBits64_t xEventGroup64ClearBits( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToClear ) PRIVILEGED_FUNCTION;
+
+/**
+ * event_groups64.h
+ *
+<pre>
+EventBits64_t xEventGroup64SetBits( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToSet );
+</pre>
+ *
+ * Set bits within a 64-bit event group, unblocking the tasks whose wait
+ * condition is then met.
+ *
+ * @param xEventGroup The event group in which the bits are to be set.
+ *
+ * @param uxBitsToSet A bitwise value that indicates the bit or bits to set.
+ *
+ * @return The value of the event group at the time the call to
+ * xEventGroup64SetBits() returns, which, as for xEventGroupSetBits(), might
+ * not have the bits just set if an unblocked task cleared them on exit.
+ *
+ * \defgroup xEventGroup64SetBits xEventGroup64SetBits
+ * \ingroup EventGroup64
+ */
+EventBits64_t xEventGroup64SetBits( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToSet ) PRIVILEGED_FUNCTION;
+
+/**
+ * event_groups64.h
+ *
+<pre>
+EventBits64_t xEventGroup64Sync( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToSet, const EventBits64_t uxBitsToWaitFor, TickType_t xTicksToWait );
+</pre>
+ *
+ * The 64-bit version of xEventGroupSync().  Atomically set bits within a
+ * 64-bit event group, then wait for a combination of bits to be set within
+ * the same event group.  This allows up to 64 tasks to meet at a rendezvous.
+ *
+ * @param xEventGroup The event group in which the bits are being tested.
+ *
+ * @param uxBitsToSet The bits to set in the event group before determining if,
+ * and possibly waiting for, all the bits specified by the uxBitsToWaitFor
+ * parameter are set.
+ *
+ * @param uxBitsToWaitFor A bitwise value that indicates the bit or bits to
+ * test.  uxBitsToWaitFor must not be 0.
+ *
+ * @param xTicksToWait The maximum amount of time (specified in 'ticks') to
+ * wait for all of the bits specified by uxBitsToWaitFor to become set.
+ *
+ * @return The value of the event group at the time either the bits being
+ * waited for became set, or the block time expired.  If all the bits were set
+ * the returned value is the value before they were automatically cleared.
+ *
+ * \defgroup xEventGroup64Sync xEventGroup64Sync
+ * \ingroup EventGroup64
+ */
+EventBits64_t xEventGroup64Sync( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToSet, const EventBits64_t uxBitsToWaitFor, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * event_groups64.h
+ *
+<pre>
+EventBits64_t xEventGroup64GetBits( EventGroup64Handle_t xEventGroup );
+</pre>
+ *
+ * Returns the current value of the bits in a 64-bit event group.  The value is
+ * read in a critical section, so all 64 bits come from the same moment.
+ *
+ * \defgroup xEventGroup64GetBits xEventGroup64GetBits
+ * \ingroup EventGroup64
+ */
+EventBits64_t xEventGroup64GetBits( EventGroup64Handle_t xEventGroup ) PRIVILEGED_FUNCTION;
+
+/**
+ * event_groups64.h
+ *
+<pre>
+void vEventGroup64Delete( EventGroup64Handle_t xEventGroup );
+</pre>
+ *
+ * Delete a 64-bit event group.  Tasks that are blocked on the event group are
+ * unblocked, and obtain 0 as the event group's value.
+ *
+ * \defgroup vEventGroup64Delete vEventGroup64Delete
+ * \ingroup EventGroup64
+ */
+void vEventGroup64Delete( EventGroup64Handle_t xEventGroup ) PRIVILEGED_FUNCTION;
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif /* EVENT_GROUPS64_H */
@@ -0,0 +1,212 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Fast mutexes are mutual exclusion locks that do not use a queue.  The state
+ * of the mutex is a single word that holds the handle of the task that holds
+ * it, or 0 if the mutex is free.  When no other task wants the mutex,
+ * xFastMutexTake() and xFastMutexGive() are each a single compare-and-swap on
+ * that word (LDREX/STREX on Cortex-M), so interrupts are never masked.
+ *
+ * Only when the mutex is contended does a task enter a critical section.  It
+ * marks the word as having waiters, raises the priority of the holder to its
+ * own (priority inheritance, as with a standard FreeRTOS mutex) and blocks on
+ * the mutex's list of waiting tasks.  The compare-and-swap in the holder's
+ * xFastMutexGive() then fails, so the holder also enters a critical section,
+ * hands the mutex directly to the highest priority waiting task and
+ * disinherits its raised priority.
+ *
+ * Fast mutexes are not recursive, cannot be used from interrupts, and cannot
+ * be added to queue sets.  Use a standard mutex for any of those.
+ *
+ * configUSE_FAST_MUTEXES must be set to 1 in FreeRTOSConfig.h for the fast
+ * mutex API to be available.  configUSE_MUTEXES must also be set to 1.
+ */
+
+#ifndef FAST_MUTEX_H
+#define FAST_MUTEX_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include fast_mutex.h"
+#endif
+
+#include "task.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * Type by which fast mutexes are referenced.  For example, a call to
+ * xFastMutexCreate() returns a FastMutexHandle_t variable that can then be
+ * used as a parameter to xFastMutexTake(), xFastMutexGive(), etc.
+ */
+typedef void * FastMutexHandle_t;
+
+/**
+ * fast_mutex.h
+ *
+<pre>
+FastMutexHandle_t xFastMutexCreate( void );
+</pre>
+ *
+ * Creates a fast mutex using pvPortMalloc().  The mutex is created free.
+ *
+ * @return The handle of the created mutex, or NULL if the memory could not be
+ * allocated.
+ *
+ * \defgroup xFastMutexCreate xFastMutexCreate
+ * \ingroup FastMutexManagement
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	FastMutexHandle_t xFastMutexCreate( void ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * fast_mutex.h
+ *
+<pre>
+FastMutexHandle_t xFastMutexCreateStatic( StaticFastMutex_t *pxStaticFastMutex );
+</pre>
+ *
+ * Creates a fast mutex using statically allocated memory.
+ *
+ * @param pxStaticFastMutex Must point to a variable of type StaticFastMutex_t,
+ * which will be used to hold the mutex's data structure.
+ *
+ * @return The handle of the created mutex, or NULL if pxStaticFastMutex was
+ * NULL.
+ *
+ * Example use:
+<pre>
+static StaticFastMutex_t xBusMutexStruct;
+static FastMutexHandle_t xBusMutex;
+
+void vSetupBus( void )
+{
+    xBusMutex = xFastMutexCreateStatic( &xBusMutexStruct );
+}
+
+void vWriteRegister( uint8_t ucRegister, uint8_t ucValue )
+{
+    if( xFastMutexTake( xBusMutex, pdMS_TO_TICKS( 10 ) ) == pdPASS )
+    {
+        // ... Access the bus ...
+
+        xFastMutexGive( xBusMutex );
+    }
+}
+</pre>
+ * \defgroup xFastMutexCreateStatic xFastMutexCreateStatic
+ * \ingroup FastMutexManagement
+ */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	FastMutexHandle_t xFastMutexCreateStatic( StaticFastMutex_t * const pxStaticFastMutex ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * fast_mutex.h
+ *
+<pre>
+void vFastMutexDelete( FastMutexHandle_t xMutex );
+</pre>
+ *
+ * Deletes a fast mutex.  The mutex must not be held, and no task may be
+ * waiting for it.
+ *
+ * \defgroup vFastMutexDelete vFastMutexDelete
+ * \ingroup FastMutexManagement
+ */
+void vFastMutexDelete( FastMutexHandle_t xMutex ) PRIVILEGED_FUNCTION;
+
+/**
+ * fast_mutex.h
+ *
+<pre>
+BaseType_t xFastMutexTake( FastMutexHandle_t xMutex, TickType_t xTicksToWait );
+</pre>
+ *
+ * Takes a fast mutex, waiting up to xTicksToWait ticks for it if it is held by
+ * another task.  While the calling task waits, the holder runs at the calling
+ * task's priority if that is higher than its own.
+ *
+ * Must only be called from a task, once the scheduler has been started.  A
+ * task must not take a fast mutex it already holds.
+ *
+ * @param xMutex The mutex to take.
+ *
+ * @param xTicksToWait The maximum number of ticks to wait for the mutex.  Set
+ * to 0 to return immediately if the mutex is held.  Set to portMAX_DELAY to
+ * wait indefinitely (if INCLUDE_vTaskSuspend is set to 1).
+ *
+ * @return pdPASS if the mutex was taken, otherwise pdFAIL.
+ *
+ * \defgroup xFastMutexTake xFastMutexTake
+ * \ingroup FastMutexManagement
+ */
+BaseType_t xFastMutexTake( FastMutexHandle_t xMutex, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * fast_mutex.h
+ *
+<pre>
+BaseType_t xFastMutexGive( FastMutexHandle_t xMutex );
+</pre>
+ *
+ * Gives back a fast mutex held by the calling task.  If other tasks are waiting
+ * for the mutex it is handed to the highest priority one.
+ *
+ * @return pdPASS if the mutex was given back, or pdFAIL if the calling task did
+ * not hold it.
+ *
+ * \defgroup xFastMutexGive xFastMutexGive
+ * \ingroup FastMutexManagement
+ */
+BaseType_t xFastMutexGive( FastMutexHandle_t xMutex ) PRIVILEGED_FUNCTION;
+
+/**
+ * fast_mutex.h
+ *
+<pre>
+TaskHandle_t xFastMutexGetHolder( FastMutexHandle_t xMutex );
+</pre>
+ *
+ * @return The handle of the task that holds the mutex, or NULL if the mutex is
+ * free.  The result is only a snapshot, and can be out of date by the time it
+ * is used.
+ *
+ * \defgroup xFastMutexGetHolder xFastMutexGetHolder
+ * \ingroup FastMutexManagement
+ */
+TaskHandle_t xFastMutexGetHolder( FastMutexHandle_t xMutex ) PRIVILEGED_FUNCTION;
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( FAST_MUTEX_H ) */
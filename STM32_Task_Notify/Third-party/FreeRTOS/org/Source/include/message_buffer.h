@@ -48,7 +48,10 @@
  * block time to 0.  Likewise, if there are to be multiple different readers
  * then the application writer must place each call to a reading API function
  * (such as xMessageBufferRead()) inside a critical section and set the receive
- * timeout to 0.
+ * timeout to 0.  The exception is a message buffer created with
+ * xMessageBufferCreateMultiProducer() or
+ * xMessageBufferCreateMultiProducerStatic(), which any number of tasks and
+ * interrupts can write to at once.
  *
  * Message buffers hold variable length messages.  To enable that, when a
  * message is written to the message buffer an additional sizeof( size_t ) bytes
@@ -57,7 +60,8 @@
  * architecture, so writing a 10 byte message to a message buffer on a 32-bit
  * architecture will actually reduce the available space in the message buffer
  * by 14 bytes (10 byte are used by the message, and 4 bytes to hold the length
- * of the message).
+ * of the message).  Message buffers created with
+ * xMessageBufferCreateWithLengthFormat() can store the length in fewer bytes.
  */
 
 #ifndef FREERTOS_MESSAGE_BUFFER_H
@@ -136,7 +140,7 @@ const size_t xMessageBufferSizeBytes = 100;
  * \defgroup xMessageBufferCreate xMessageBufferCreate
  * \ingroup MessageBufferManagement
  */
-#define xMessageBufferCreate( xBufferSizeBytes ) ( MessageBufferHandle_t ) xStreamBufferGenericCreate( xBufferSizeBytes, ( size_t ) 0, pdTRUE )
+#define xMessageBufferCreate( xBufferSizeBytes ) ( MessageBufferHandle_t ) xStreamBufferGenericCreate( xBufferSizeBytes, ( size_t ) 0, sbTYPE_MESSAGE_BUFFER )
 
 /**
  * message_buffer.h
@@ -202,7 +206,118 @@ MessageBufferHandle_t xMessageBuffer;
  * \defgroup xMessageBufferCreateStatic xMessageBufferCreateStatic
  * \ingroup MessageBufferManagement
  */
-#define xMessageBufferCreateStatic( xBufferSizeBytes, pucMessageBufferStorageArea, pxStaticMessageBuffer ) ( MessageBufferHandle_t ) xStreamBufferGenericCreateStatic( xBufferSizeBytes, 0, pdTRUE, pucMessageBufferStorageArea, pxStaticMessageBuffer )
+#define xMessageBufferCreateStatic( xBufferSizeBytes, pucMessageBufferStorageArea, pxStaticMessageBuffer ) ( MessageBufferHandle_t ) xStreamBufferGenericCreateStatic( xBufferSizeBytes, 0, sbTYPE_MESSAGE_BUFFER, pucMessageBufferStorageArea, pxStaticMessageBuffer )
+
+/**
+ * message_buffer.h
+ *
+<pre>
+MessageBufferHandle_t xMessageBufferCreateMultiProducer( size_t xBufferSizeBytes );
+
+MessageBufferHandle_t xMessageBufferCreateMultiProducerStatic( size_t xBufferSizeBytes,
+                                                               uint8_t *pucMessageBufferStorageArea,
+                                                               StaticMessageBuffer_t *pxStaticMessageBuffer );
+</pre>
+ *
+ * As xMessageBufferCreate() and xMessageBufferCreateStatic(), but creates a
+ * message buffer that any number of tasks and interrupts can write to at the
+ * same time without using a critical section.  Writers reserve space for the
+ * whole message, including its length, with interrupts masked for only a few
+ * instructions, then copy the message concurrently.  Messages reach the reader
+ * in the order in which their space was reserved.  See
+ * xStreamBufferCreateMultiProducer() in stream_buffer.h for the restrictions
+ * that apply.
+ *
+ * configUSE_STREAM_BUFFER_MULTI_PRODUCER must be set to 1 in FreeRTOSConfig.h
+ * for these functions to be available.
+ *
+ * \defgroup xMessageBufferCreateMultiProducer xMessageBufferCreateMultiProducer
+ * \ingroup MessageBufferManagement
+ */
+#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+	#define xMessageBufferCreateMultiProducer( xBufferSizeBytes ) ( MessageBufferHandle_t ) xStreamBufferGenericCreate( xBufferSizeBytes, ( size_t ) 0, sbTYPE_MESSAGE_BUFFER | sbTYPE_MULTI_PRODUCER )
+	#define xMessageBufferCreateMultiProducerStatic( xBufferSizeBytes, pucMessageBufferStorageArea, pxStaticMessageBuffer ) ( MessageBufferHandle_t ) xStreamBufferGenericCreateStatic( xBufferSizeBytes, 0, sbTYPE_MESSAGE_BUFFER | sbTYPE_MULTI_PRODUCER, pucMessageBufferStorageArea, pxStaticMessageBuffer )
+#endif
+
+/*
+ * The length formats that can be passed to
+ * xMessageBufferCreateWithLengthFormat() and
+ * xMessageBufferCreateWithLengthFormatStatic().
+ */
+#define mbLENGTH_FORMAT_SIZE_T	sbTYPE_MESSAGE_BUFFER
+#define mbLENGTH_FORMAT_1_BYTE	sbTYPE_LENGTH_1_BYTE
+#define mbLENGTH_FORMAT_2_BYTES	sbTYPE_LENGTH_2_BYTES
+#define mbLENGTH_FORMAT_VARINT	sbTYPE_LENGTH_VARINT
+
+/**
+ * message_buffer.h
+ *
+<pre>
+MessageBufferHandle_t xMessageBufferCreateWithLengthFormat( size_t xBufferSizeBytes,
+                                                            BaseType_t xLengthFormat );
+
+MessageBufferHandle_t xMessageBufferCreateWithLengthFormatStatic( size_t xBufferSizeBytes,
+                                                                  BaseType_t xLengthFormat,
+                                                                  uint8_t *pucMessageBufferStorageArea,
+                                                                  StaticMessageBuffer_t *pxStaticMessageBuffer );
+</pre>
+ *
+ * As xMessageBufferCreate() and xMessageBufferCreateStatic(), but chooses how
+ * many bytes the message buffer uses to store the length of each message.
+ * xLengthFormat is one of:
+ *
+ * mbLENGTH_FORMAT_SIZE_T - sizeof( size_t ) bytes, as xMessageBufferCreate().
+ *
+ * mbLENGTH_FORMAT_1_BYTE - 1 byte.  Messages can be up to 255 bytes long.
+ *
+ * mbLENGTH_FORMAT_2_BYTES - 2 bytes.  Messages can be up to 65535 bytes long.
+ *
+ * mbLENGTH_FORMAT_VARINT - 1 byte for messages of up to 127 bytes, 2 bytes
+ * for messages of up to 16383 bytes, 3 bytes for messages of up to 2097151
+ * bytes, and so on.  There is no limit on the message length.
+ *
+ * A 10 byte message written to a message buffer that uses
+ * mbLENGTH_FORMAT_1_BYTE or mbLENGTH_FORMAT_VARINT takes 11 bytes of the
+ * buffer, rather than 14 on a 32-bit architecture, so a buffer holds nearly
+ * twice as many short messages.  A message that is too long for the length
+ * format is never written, and the send functions return 0 for it without
+ * waiting for space.  The zero copy write functions always leave room for the
+ * length of the longest message the buffer can hold, so in a
+ * mbLENGTH_FORMAT_VARINT buffer a message written that way can have a longer
+ * length than is strictly needed.
+ *
+ * The length format can be combined with sbTYPE_MULTI_PRODUCER, for example
+ * xMessageBufferCreateWithLengthFormat( 100, mbLENGTH_FORMAT_VARINT | sbTYPE_MULTI_PRODUCER ).
+ *
+ * configUSE_COMPACT_MESSAGE_LENGTHS must be set to 1 in FreeRTOSConfig.h for
+ * these functions to be available.
+ *
+ * Example use:
+<pre>
+
+// Telemetry records are between 2 and 16 bytes, so a single byte is plenty
+// to hold the length of each one.
+#define TELEMETRY_BUFFER_BYTES 256
+
+static uint8_t ucTelemetryStorage[ TELEMETRY_BUFFER_BYTES ];
+static StaticMessageBuffer_t xTelemetryStruct;
+
+MessageBufferHandle_t xCreateTelemetryBuffer( void )
+{
+    return xMessageBufferCreateWithLengthFormatStatic( sizeof( ucTelemetryStorage ),
+                                                       mbLENGTH_FORMAT_1_BYTE,
+                                                       ucTelemetryStorage,
+                                                       &xTelemetryStruct );
+}
+
+</pre>
+ * \defgroup xMessageBufferCreateWithLengthFormat xMessageBufferCreateWithLengthFormat
+ * \ingroup MessageBufferManagement
+ */
+#if( configUSE_COMPACT_MESSAGE_LENGTHS == 1 )
+	#define xMessageBufferCreateWithLengthFormat( xBufferSizeBytes, xLengthFormat ) ( MessageBufferHandle_t ) xStreamBufferGenericCreate( xBufferSizeBytes, ( size_t ) 0, sbTYPE_MESSAGE_BUFFER | ( xLengthFormat ) )
+	#define xMessageBufferCreateWithLengthFormatStatic( xBufferSizeBytes, xLengthFormat, pucMessageBufferStorageArea, pxStaticMessageBuffer ) ( MessageBufferHandle_t ) xStreamBufferGenericCreateStatic( xBufferSizeBytes, 0, sbTYPE_MESSAGE_BUFFER | ( xLengthFormat ), pucMessageBufferStorageArea, pxStaticMessageBuffer )
+#endif
 
 /**
  * message_buffer.h
@@ -596,6 +711,59 @@ BaseType_t xHigherPriorityTaskWoken = pdFALSE;  // Initialised to pdFALSE.
  */
 #define xMessageBufferReceiveFromISR( xMessageBuffer, pvRxData, xBufferLengthBytes, pxHigherPriorityTaskWoken ) xStreamBufferReceiveFromISR( ( StreamBufferHandle_t ) xMessageBuffer, pvRxData, xBufferLengthBytes, pxHigherPriorityTaskWoken )
 
+/**
+ * message_buffer.h
+ *
+<pre>
+size_t xMessageBufferAcquireWrite( MessageBufferHandle_t xMessageBuffer,
+                                   StreamBufferRegions_t * const pxRegions,
+                                   size_t xWantedBytes,
+                                   TickType_t xTicksToWait );
+size_t xMessageBufferAcquireWriteFromISR( MessageBufferHandle_t xMessageBuffer,
+                                          StreamBufferRegions_t * const pxRegions );
+size_t xMessageBufferCommitWrite( MessageBufferHandle_t xMessageBuffer,
+                                  size_t xCount );
+size_t xMessageBufferCommitWriteFromISR( MessageBufferHandle_t xMessageBuffer,
+                                         size_t xCount,
+                                         BaseType_t * const pxHigherPriorityTaskWoken );
+size_t xMessageBufferAcquireRead( MessageBufferHandle_t xMessageBuffer,
+                                  StreamBufferRegions_t * const pxRegions,
+                                  TickType_t xTicksToWait );
+size_t xMessageBufferAcquireReadFromISR( MessageBufferHandle_t xMessageBuffer,
+                                         StreamBufferRegions_t * const pxRegions );
+size_t xMessageBufferConsume( MessageBufferHandle_t xMessageBuffer,
+                              size_t xCount );
+size_t xMessageBufferConsumeFromISR( MessageBufferHandle_t xMessageBuffer,
+                                     size_t xCount,
+                                     BaseType_t * const pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Zero copy alternatives to xMessageBufferSend() and xMessageBufferReceive().
+ * See xStreamBufferAcquireWrite() and xStreamBufferAcquireRead() in
+ * stream_buffer.h for a full description.
+ *
+ * On the write side the regions describe the space available for the body of
+ * the next message, and committing xCount bytes posts them as one message.
+ * On the read side the regions describe the body of the next message, and
+ * xCount must be either its length, to remove it, or 0, to leave it in place.
+ *
+ * configUSE_STREAM_BUFFER_ZERO_COPY must be set to 1 in FreeRTOSConfig.h for
+ * these macros to be available.
+ *
+ * \defgroup xMessageBufferAcquireWrite xMessageBufferAcquireWrite
+ * \ingroup MessageBufferManagement
+ */
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+	#define xMessageBufferAcquireWrite( xMessageBuffer, pxRegions, xWantedBytes, xTicksToWait ) xStreamBufferAcquireWrite( ( StreamBufferHandle_t ) xMessageBuffer, pxRegions, xWantedBytes, xTicksToWait )
+	#define xMessageBufferAcquireWriteFromISR( xMessageBuffer, pxRegions ) xStreamBufferAcquireWriteFromISR( ( StreamBufferHandle_t ) xMessageBuffer, pxRegions )
+	#define xMessageBufferCommitWrite( xMessageBuffer, xCount ) xStreamBufferCommitWrite( ( StreamBufferHandle_t ) xMessageBuffer, xCount )
+	#define xMessageBufferCommitWriteFromISR( xMessageBuffer, xCount, pxHigherPriorityTaskWoken ) xStreamBufferCommitWriteFromISR( ( StreamBufferHandle_t ) xMessageBuffer, xCount, pxHigherPriorityTaskWoken )
+	#define xMessageBufferAcquireRead( xMessageBuffer, pxRegions, xTicksToWait ) xStreamBufferAcquireRead( ( StreamBufferHandle_t ) xMessageBuffer, pxRegions, xTicksToWait )
+	#define xMessageBufferAcquireReadFromISR( xMessageBuffer, pxRegions ) xStreamBufferAcquireReadFromISR( ( StreamBufferHandle_t ) xMessageBuffer, pxRegions )
+	#define xMessageBufferConsume( xMessageBuffer, xCount ) xStreamBufferConsume( ( StreamBufferHandle_t ) xMessageBuffer, xCount )
+	#define xMessageBufferConsumeFromISR( xMessageBuffer, xCount, pxHigherPriorityTaskWoken ) xStreamBufferConsumeFromISR( ( StreamBufferHandle_t ) xMessageBuffer, xCount, pxHigherPriorityTaskWoken )
+#endif
+
 /**
  * message_buffer.h
  *
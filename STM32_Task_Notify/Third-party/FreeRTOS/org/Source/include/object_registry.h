@@ -0,0 +1,177 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * The object registry associates a name with the handle of a task, queue,
+ * semaphore, mutex, event group, software timer or stream buffer, so that a
+ * kernel aware debugger, a trace decoder or a command shell can go from either
+ * one to the other.  Both lookups are O(1) on average: the registry is a fixed
+ * table of configOBJECT_REGISTRY_SIZE entries, each of which is chained into
+ * one hash bucket by its handle and one by its name.
+ *
+ * Tasks and named software timers are added when they are created.  Queues,
+ * semaphores and mutexes are added with vQueueAddToRegistry(), which uses the
+ * object registry in place of the queue registry array when
+ * configUSE_OBJECT_REGISTRY is 1.  Event groups and stream buffers have no
+ * name of their own, so are added with xObjectRegistryAdd().  Every object is
+ * removed from the registry when it is deleted.
+ *
+ * The registry only stores a pointer to each name, so the string must remain
+ * valid for as long as the object is registered.
+ *
+ * The registry must not be used from an interrupt.
+ *
+ * configUSE_OBJECT_REGISTRY must be set to 1 in FreeRTOSConfig.h for the
+ * object registry to be available.
+ */
+
+#ifndef OBJECT_REGISTRY_H
+#define OBJECT_REGISTRY_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include object_registry.h"
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/* The kinds of object that can be registered. */
+typedef enum
+{
+	eObjectTypeAny = 0,		/* Only used with pvObjectRegistryFind(), to match an object of any type. */
+	eObjectTypeTask,
+	eObjectTypeQueue,
+	eObjectTypeSemaphore,	/* Semaphores and mutexes. */
+	eObjectTypeEventGroup,
+	eObjectTypeTimer,
+	eObjectTypeStreamBuffer	/* Stream and message buffers. */
+} eObjectType;
+
+/**
+ * object_registry.h
+ *
+<pre>
+BaseType_t xObjectRegistryAdd( void *pvObject, const char *pcName, eObjectType eType );
+</pre>
+ *
+ * Registers the object pvObject under the name pcName.  If the object is
+ * already registered its name and type are replaced.
+ *
+ * @param pvObject The handle of the object, for example the EventGroupHandle_t
+ * returned by xEventGroupCreate().
+ *
+ * @param pcName The name to give the object.  Names do not have to be unique.
+ * Only a pointer to the string is stored, so the string must be persistent
+ * (global, or preferably in ROM/Flash), not on the stack.
+ *
+ * @param eType The kind of object pvObject is.
+ *
+ * @return pdPASS if the object was registered, or pdFAIL if the registry
+ * already holds configOBJECT_REGISTRY_SIZE objects.
+ *
+ * Example usage:
+<pre>
+EventGroupHandle_t xLinkEvents;
+
+void vCreateLinkEvents( void )
+{
+    xLinkEvents = xEventGroupCreate();
+    configASSERT( xLinkEvents );
+    xObjectRegistryAdd( xLinkEvents, "LinkEvents", eObjectTypeEventGroup );
+}
+
+// Elsewhere, for example in a shell command.
+EventGroupHandle_t xFindLinkEvents( void )
+{
+    return ( EventGroupHandle_t ) pvObjectRegistryFind( "LinkEvents", eObjectTypeEventGroup );
+}
+</pre>
+ * \defgroup xObjectRegistryAdd xObjectRegistryAdd
+ * \ingroup ObjectRegistry
+ */
+BaseType_t xObjectRegistryAdd( void *pvObject, const char *pcName, eObjectType eType ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+
+/**
+ * object_registry.h
+ *
+<pre>
+void vObjectRegistryRemove( void *pvObject );
+</pre>
+ *
+ * Removes pvObject from the registry.  Nothing happens if the object is not
+ * registered.  The kernel calls this function when an object is deleted, so
+ * it only needs to be called directly to remove an object that still exists.
+ *
+ * \defgroup vObjectRegistryRemove vObjectRegistryRemove
+ * \ingroup ObjectRegistry
+ */
+void vObjectRegistryRemove( void *pvObject ) PRIVILEGED_FUNCTION;
+
+/**
+ * object_registry.h
+ *
+<pre>
+const char *pcObjectRegistryGetName( void *pvObject );
+</pre>
+ *
+ * @return The name pvObject was registered with, or NULL if it is not
+ * registered.
+ *
+ * \defgroup pcObjectRegistryGetName pcObjectRegistryGetName
+ * \ingroup ObjectRegistry
+ */
+const char *pcObjectRegistryGetName( void *pvObject ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+
+/**
+ * object_registry.h
+ *
+<pre>
+void *pvObjectRegistryFind( const char *pcName, eObjectType eType );
+</pre>
+ *
+ * Looks up an object by name.
+ *
+ * @param pcName The name to look for.
+ *
+ * @param eType The kind of object to look for, or eObjectTypeAny to accept an
+ * object of any kind.
+ *
+ * @return The handle of the object registered most recently with the name
+ * pcName and type eType, or NULL if there is no such object.
+ *
+ * \defgroup pvObjectRegistryFind pvObjectRegistryFind
+ * \ingroup ObjectRegistry
+ */
+void *pvObjectRegistryFind( const char *pcName, eObjectType eType ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( OBJECT_REGISTRY_H ) */
@@ -60,11 +60,39 @@ typedef void * QueueSetHandle_t;
  */
 typedef void * QueueSetMemberHandle_t;
 
+/* Counters kept for each queue, semaphore and mutex when
+configUSE_QUEUE_STATISTICS is set to 1.  Read with vQueueGetStatistics() or
+uxQueueGetSystemState().  The counts wrap on overflow. */
+typedef struct xQUEUE_STATS
+{
+	UBaseType_t uxMaxMessagesWaiting;	/* The most items the queue has held at once - the high water mark. */
+	uint32_t ulSendCount;				/* The number of items sent to the queue (semaphores given). */
+	uint32_t ulReceiveCount;			/* The number of items received from the queue (semaphores taken).  Peeking does not count. */
+	uint32_t ulSendFailCount;			/* The number of sends that failed because the queue was full, including sends that timed out. */
+	TickType_t xSendBlockedTicks;		/* The total time tasks have spent blocked waiting to send to the queue. */
+	TickType_t xReceiveBlockedTicks;	/* The total time tasks have spent blocked waiting to receive from, or peek, the queue. */
+} QueueStats_t;
+
+/* Used with the uxQueueGetSystemState() function to return the state of each
+queue in the system. */
+typedef struct xQUEUE_STATUS
+{
+	QueueHandle_t xHandle;				/* The handle of the queue to which the rest of the information in the structure relates. */
+	const char *pcQueueName;			/* The name the queue was given in the queue registry, or NULL if it is not in the registry. */ /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+	UBaseType_t uxLength;				/* The number of items the queue can hold. */
+	UBaseType_t uxMessagesWaiting;		/* The number of items in the queue when the structure was populated. */
+	QueueStats_t xStats;				/* The queue's counters when the structure was populated. */
+} QueueStatus_t;
+
 /* For internal use only. */
 #define	queueSEND_TO_BACK		( ( BaseType_t ) 0 )
 #define	queueSEND_TO_FRONT		( ( BaseType_t ) 1 )
 #define queueOVERWRITE			( ( BaseType_t ) 2 )
 
+/* For internal use only.  Used by xQueueSendWithPriority() to pass the
+priority of the item in place of the position. */
+#define queueSEND_WITH_PRIORITY( uxPriority ) ( ( BaseType_t ) 3 + ( BaseType_t ) ( uxPriority ) )
+
 /* For internal use only.  These definitions *must* match those in queue.c. */
 #define queueQUEUE_TYPE_BASE				( ( uint8_t ) 0U )
 #define queueQUEUE_TYPE_SET					( ( uint8_t ) 0U )
@@ -72,6 +100,7 @@ typedef void * QueueSetMemberHandle_t;
 #define queueQUEUE_TYPE_COUNTING_SEMAPHORE	( ( uint8_t ) 2U )
 #define queueQUEUE_TYPE_BINARY_SEMAPHORE	( ( uint8_t ) 3U )
 #define queueQUEUE_TYPE_RECURSIVE_MUTEX		( ( uint8_t ) 4U )
+#define queueQUEUE_TYPE_PRIORITY			( ( uint8_t ) 5U )
 
 /**
  * queue. h
@@ -1383,6 +1412,422 @@ BaseType_t xQueueGiveFromISR( QueueHandle_t xQueue, BaseType_t * const pxHigherP
  */
 BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue, void * const pvBuffer, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * <pre>
+ void *pvQueueLoanWriteSlot(
+                             QueueHandle_t xQueue,
+                             TickType_t xTicksToWait
+                         );
+ void vQueueCommitWriteSlot(
+                             QueueHandle_t xQueue,
+                             void *pvSlot
+                         );
+ </pre>
+ *
+ * Zero copy alternative to xQueueSendToBack().  pvQueueLoanWriteSlot() lends
+ * the caller the queue storage slot the next item will occupy.  The caller
+ * builds the item directly in the slot, then calls vQueueCommitWriteSlot() to
+ * post it.  Compared with xQueueSendToBack() the item is written once, outside
+ * of the critical section, instead of being built in a local buffer and then
+ * copied into the queue with interrupts masked.
+ *
+ * Only one slot can be on loan to a sender at a time.  Until the slot is
+ * committed the queue appears full to every other sender, including
+ * interrupts, so items always leave the queue in the order they were posted.
+ * Keep the time between loan and commit short.
+ *
+ * configUSE_QUEUE_LOANS must be set to 1 in FreeRTOSConfig.h for these
+ * functions to be available.  They cannot be used on semaphores or mutexes,
+ * or on queues with a length of one, and must not be called from an interrupt.
+ * A queue of length one is the mailbox used with xQueueOverwrite(), which is
+ * guaranteed to succeed, and could not be if its only slot were on loan.
+ *
+ * @param xQueue The handle of the queue.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for a free slot.  Setting xTicksToWait to 0 causes the function to
+ * return immediately if no slot is free.
+ *
+ * @param pvSlot The pointer returned by pvQueueLoanWriteSlot().  It must not
+ * be used after vQueueCommitWriteSlot() has returned.
+ *
+ * @return pvQueueLoanWriteSlot() returns a pointer to uxItemSize bytes of
+ * queue storage, or NULL if no slot became free before the block time expired.
+ *
+ * If the queue is reset while a slot is on loan the loan is cancelled, and
+ * the later call to vQueueCommitWriteSlot() does not post anything.
+ *
+ * Example usage:
+   <pre>
+ struct AMessage
+ {
+	char ucMessageID;
+	char ucData[ 20 ];
+ };
+
+ void vATask( void *pvParameters )
+ {
+ QueueHandle_t xQueue;
+ struct AMessage *pxMessage;
+
+	xQueue = xQueueCreate( 10, sizeof( struct AMessage ) );
+
+	// ...
+
+	pxMessage = ( struct AMessage * ) pvQueueLoanWriteSlot( xQueue, ( TickType_t ) 10 );
+	if( pxMessage != NULL )
+	{
+		// Fill in the message where it will be read from.
+		pxMessage->ucMessageID = 1;
+		vFillData( pxMessage->ucData );
+
+		vQueueCommitWriteSlot( xQueue, pxMessage );
+	}
+ }
+ </pre>
+ * \defgroup pvQueueLoanWriteSlot pvQueueLoanWriteSlot
+ * \ingroup QueueManagement
+ */
+void *pvQueueLoanWriteSlot( QueueHandle_t xQueue, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+void vQueueCommitWriteSlot( QueueHandle_t xQueue, void *pvSlot ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>
+ void *pvQueueLoanReadSlot(
+                            QueueHandle_t xQueue,
+                            TickType_t xTicksToWait
+                        );
+ void vQueueReleaseReadSlot(
+                            QueueHandle_t xQueue,
+                            void *pvSlot
+                        );
+ </pre>
+ *
+ * Zero copy alternative to xQueueReceive().  pvQueueLoanReadSlot() returns a
+ * pointer to the oldest item while it is still in the queue storage area.  The
+ * item remains in the queue until vQueueReleaseReadSlot() is called, at which
+ * point it is removed and its slot can be reused by a sender.
+ *
+ * Only one slot can be on loan to a receiver at a time.  Until the slot is
+ * released the queue appears empty to every other receiver, including
+ * interrupts, and sending to the front of the queue is held off.  Sending to
+ * the back is not affected.
+ *
+ * configUSE_QUEUE_LOANS must be set to 1 in FreeRTOSConfig.h for these
+ * functions to be available.  They cannot be used on semaphores or mutexes,
+ * or on queues with a length of one, and must not be called from an interrupt.
+ * A queue of length one is the mailbox used with xQueueOverwrite(), which is
+ * guaranteed to succeed, and could not be if its only slot were on loan.
+ *
+ * @param xQueue The handle of the queue.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for an item.  Setting xTicksToWait to 0 causes the function to
+ * return immediately if the queue is empty.
+ *
+ * @param pvSlot The pointer returned by pvQueueLoanReadSlot().  It must not
+ * be used after vQueueReleaseReadSlot() has returned.
+ *
+ * @return pvQueueLoanReadSlot() returns a pointer to the oldest item, or NULL
+ * if no item arrived before the block time expired.
+ *
+ * \defgroup pvQueueLoanReadSlot pvQueueLoanReadSlot
+ * \ingroup QueueManagement
+ */
+void *pvQueueLoanReadSlot( QueueHandle_t xQueue, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+void vQueueReleaseReadSlot( QueueHandle_t xQueue, void *pvSlot ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>
+ UBaseType_t uxQueueSendMultiple(
+                                  QueueHandle_t xQueue,
+                                  const void * const pvItems,
+                                  UBaseType_t uxItemCount,
+                                  TickType_t xTicksToWait
+                              );
+ UBaseType_t uxQueueReceiveMultiple(
+                                     QueueHandle_t xQueue,
+                                     void * const pvBuffer,
+                                     UBaseType_t uxMaxItems,
+                                     TickType_t xTicksToWait
+                                 );
+ </pre>
+ *
+ * Batch versions of xQueueSendToBack() and xQueueReceive().  As many of the
+ * items as there is space for (or as many as are available, up to uxMaxItems)
+ * are moved with a single critical section, using at most two calls to
+ * memcpy(), and waiting tasks are unblocked once for the whole batch instead
+ * of once per item.
+ *
+ * The calling task blocks, for up to xTicksToWait ticks, only while the queue
+ * is completely full (or completely empty).  As soon as at least one item can
+ * be moved the call moves what it can and returns, so fewer items than
+ * requested may be sent or received.
+ *
+ * Interrupts stay masked while the items are copied, so keep batches small
+ * enough for the copy to fit within the interrupt latency the application
+ * can tolerate.
+ *
+ * configUSE_QUEUE_BATCHES must be set to 1 in FreeRTOSConfig.h for these
+ * functions to be available.  They cannot be used on semaphores or mutexes.
+ *
+ * @param xQueue The handle of the queue.
+ *
+ * @param pvItems An array of uxItemCount items to send, in the order they
+ * should be received.
+ *
+ * @param pvBuffer A buffer with room for uxMaxItems items.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for space (or for data).
+ *
+ * @return The number of items sent (or received), which is 0 if the block
+ * time expired.  A call with uxItemCount (or uxMaxItems) set to 0 returns 0
+ * at once without blocking, whatever the state of the queue.
+ *
+ * Example usage:
+   <pre>
+ #define rxBATCH_SIZE 8
+
+ void vDrainTask( void *pvParameters )
+ {
+ uint32_t ulSamples[ rxBATCH_SIZE ];
+ UBaseType_t uxCount, ux;
+
+	for( ;; )
+	{
+		// Wait for at least one sample, then take up to rxBATCH_SIZE of them.
+		uxCount = uxQueueReceiveMultiple( xSampleQueue, ulSamples, rxBATCH_SIZE, portMAX_DELAY );
+
+		for( ux = 0; ux < uxCount; ux++ )
+		{
+			vProcessSample( ulSamples[ ux ] );
+		}
+	}
+ }
+ </pre>
+ * \defgroup uxQueueSendMultiple uxQueueSendMultiple
+ * \ingroup QueueManagement
+ */
+UBaseType_t uxQueueSendMultiple( QueueHandle_t xQueue, const void * const pvItems, UBaseType_t uxItemCount, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+UBaseType_t uxQueueReceiveMultiple( QueueHandle_t xQueue, void * const pvBuffer, UBaseType_t uxMaxItems, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>
+ UBaseType_t uxQueueSendMultipleFromISR(
+                                         QueueHandle_t xQueue,
+                                         const void * const pvItems,
+                                         UBaseType_t uxItemCount,
+                                         BaseType_t *pxHigherPriorityTaskWoken
+                                     );
+ UBaseType_t uxQueueReceiveMultipleFromISR(
+                                            QueueHandle_t xQueue,
+                                            void * const pvBuffer,
+                                            UBaseType_t uxMaxItems,
+                                            BaseType_t *pxHigherPriorityTaskWoken
+                                        );
+ </pre>
+ *
+ * Versions of uxQueueSendMultiple() and uxQueueReceiveMultiple() that can be
+ * called from an interrupt service routine.  They never block: as many items
+ * as possible are moved and the number moved is returned.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if moving the items unblocked
+ * a task with a priority higher than the currently running task, in which case
+ * a context switch should be requested before the interrupt is exited.  Can be
+ * NULL.
+ *
+ * Example usage:
+   <pre>
+ void vUART_ISR( void )
+ {
+ char cRxBuffer[ 16 ];
+ UBaseType_t uxCount;
+ BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	// Empty the peripheral FIFO, then post everything in one call.
+	uxCount = uxReadRxFIFO( cRxBuffer, sizeof( cRxBuffer ) );
+	( void ) uxQueueSendMultipleFromISR( xRxQueue, cRxBuffer, uxCount, &xHigherPriorityTaskWoken );
+
+	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+ }
+ </pre>
+ * \defgroup uxQueueSendMultipleFromISR uxQueueSendMultipleFromISR
+ * \ingroup QueueManagement
+ */
+UBaseType_t uxQueueSendMultipleFromISR( QueueHandle_t xQueue, const void * const pvItems, UBaseType_t uxItemCount, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+UBaseType_t uxQueueReceiveMultipleFromISR( QueueHandle_t xQueue, void * const pvBuffer, UBaseType_t uxMaxItems, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * The largest number of priority levels a priority queue can be created with.
+ */
+#define queuePRIORITY_LEVELS_MAX ( ( UBaseType_t ) 32U )
+
+/**
+ * The number of bytes a priority queue needs for the index that orders its
+ * items, and for the index and the items together.  The index is three
+ * UBaseType_t variables, plus two for each priority level and one for each item.
+ * The storage area passed to xQueueCreatePriorityStatic() must be
+ * queuePRIORITY_STORAGE_SIZE() bytes long.
+ */
+#define queuePRIORITY_INDEX_SIZE( uxQueueLength, uxPriorityLevels ) ( ( ( size_t ) 3 + ( ( size_t ) 2 * ( size_t ) ( uxPriorityLevels ) ) + ( size_t ) ( uxQueueLength ) ) * sizeof( UBaseType_t ) )
+#define queuePRIORITY_STORAGE_SIZE( uxQueueLength, uxItemSize, uxPriorityLevels ) ( queuePRIORITY_INDEX_SIZE( ( uxQueueLength ), ( uxPriorityLevels ) ) + ( ( size_t ) ( uxQueueLength ) * ( size_t ) ( uxItemSize ) ) )
+
+/**
+ * queue. h
+ * <pre>
+ QueueHandle_t xQueueCreatePriority(
+                                     UBaseType_t uxQueueLength,
+                                     UBaseType_t uxItemSize,
+                                     UBaseType_t uxPriorityLevels
+                                 );
+ QueueHandle_t xQueueCreatePriorityStatic(
+                                           UBaseType_t uxQueueLength,
+                                           UBaseType_t uxItemSize,
+                                           UBaseType_t uxPriorityLevels,
+                                           uint8_t *pucQueueStorageBuffer,
+                                           StaticQueue_t *pxQueueBuffer
+                                       );
+ * </pre>
+ *
+ * Creates a priority queue.  Each item is sent with a priority from 0 to
+ * ( uxPriorityLevels - 1 ) using xQueueSendWithPriority() or
+ * xQueueSendWithPriorityFromISR(), and is received highest priority first.
+ * Items of the same priority are received in the order they were sent.
+ *
+ * Items are received with the normal xQueueReceive(), xQueuePeek(),
+ * xQueueReceiveFromISR() and xQueuePeekFromISR() functions, and all the send
+ * and receive functions block and time out exactly as they do for any other
+ * queue.  xQueueSend() and xQueueSendToBack() send at priority 0.
+ * xQueueSendToFront() places the item in front of the item that would be
+ * received next.  Sending and receiving take the same time however many items
+ * are queued.
+ *
+ * A priority queue cannot be added to a queue set, and cannot be used with
+ * the slot loan or the multiple item send and receive functions.
+ *
+ * @param uxQueueLength The maximum number of items the queue can hold.
+ *
+ * @param uxItemSize The size, in bytes, of each item.  Must not be zero.
+ *
+ * @param uxPriorityLevels The number of priorities, from 1 to
+ * queuePRIORITY_LEVELS_MAX.
+ *
+ * @param pucQueueStorageBuffer Must point to a buffer of at least
+ * queuePRIORITY_STORAGE_SIZE( uxQueueLength, uxItemSize, uxPriorityLevels )
+ * bytes, aligned to the size of a UBaseType_t.
+ *
+ * @param pxQueueBuffer Must point to a variable of type StaticQueue_t, which
+ * will be used to hold the queue's data structure.
+ *
+ * @return The handle of the created queue, or NULL if the queue could not be
+ * created.
+ *
+ * Example usage:
+   <pre>
+ #define CMD_PRIORITIES 4
+ #define CMD_LENGTH 16
+
+ // Priority 3 is reserved for emergency stop commands.
+ #define CMD_ESTOP_PRIORITY 3
+
+ static StaticQueue_t xCommandQueueStruct;
+ static uint8_t ucCommandQueueStorage[ queuePRIORITY_STORAGE_SIZE( CMD_LENGTH, sizeof( uint32_t ), CMD_PRIORITIES ) ] __attribute__( ( aligned( 4 ) ) );
+ static QueueHandle_t xCommandQueue;
+
+ void vSetupCommands( void )
+ {
+	xCommandQueue = xQueueCreatePriorityStatic( CMD_LENGTH, sizeof( uint32_t ), CMD_PRIORITIES, ucCommandQueueStorage, &xCommandQueueStruct );
+ }
+
+ void vCommandTask( void *pvParameters )
+ {
+ uint32_t ulCommand;
+
+	for( ;; )
+	{
+		// An emergency stop is received before any routine command that is
+		// already queued.
+		if( xQueueReceive( xCommandQueue, &ulCommand, portMAX_DELAY ) == pdPASS )
+		{
+			// ... Execute ulCommand ...
+		}
+	}
+ }
+ </pre>
+ * \defgroup xQueueCreatePriority xQueueCreatePriority
+ * \ingroup QueueManagement
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	QueueHandle_t xQueueCreatePriority( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize, const UBaseType_t uxPriorityLevels ) PRIVILEGED_FUNCTION;
+#endif
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	QueueHandle_t xQueueCreatePriorityStatic( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize, const UBaseType_t uxPriorityLevels, uint8_t *pucQueueStorage, StaticQueue_t *pxStaticQueue ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * queue. h
+ * <pre>
+ BaseType_t xQueueSendWithPriority(
+                                    QueueHandle_t xQueue,
+                                    const void *pvItemToQueue,
+                                    UBaseType_t uxPriority,
+                                    TickType_t xTicksToWait
+                                );
+ BaseType_t xQueueSendWithPriorityFromISR(
+                                           QueueHandle_t xQueue,
+                                           const void *pvItemToQueue,
+                                           UBaseType_t uxPriority,
+                                           BaseType_t *pxHigherPriorityTaskWoken
+                                       );
+ * </pre>
+ *
+ * Post an item to a queue created with xQueueCreatePriority() or
+ * xQueueCreatePriorityStatic().  The item is received after every item of a
+ * higher priority and every item of the same priority that is already in the
+ * queue, and before every item of a lower priority.  These are macros that
+ * call xQueueGenericSend() and xQueueGenericSendFromISR(), and otherwise
+ * behave exactly as xQueueSend() and xQueueSendFromISR().
+ *
+ * @param xQueue The handle of the priority queue.
+ *
+ * @param pvItemToQueue A pointer to the item that is to be placed on the
+ * queue.
+ *
+ * @param uxPriority The priority of the item, from 0 (the lowest) to one less
+ * than the number of priority levels the queue was created with.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for space to become available on the queue.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if sending to the queue
+ * caused a task to unblock, and the unblocked task has a priority higher than
+ * the currently running task.
+ *
+ * @return pdTRUE if the item was posted, otherwise errQUEUE_FULL.
+ *
+ * Example usage:
+   <pre>
+ void vEmergencyStopISR( void )
+ {
+ uint32_t ulCommand = CMD_STOP;
+ BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	xQueueSendWithPriorityFromISR( xCommandQueue, &ulCommand, CMD_ESTOP_PRIORITY, &xHigherPriorityTaskWoken );
+	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+ }
+ </pre>
+ * \defgroup xQueueSendWithPriority xQueueSendWithPriority
+ * \ingroup QueueManagement
+ */
+#define xQueueSendWithPriority( xQueue, pvItemToQueue, uxPriority, xTicksToWait ) xQueueGenericSend( ( xQueue ), ( pvItemToQueue ), ( xTicksToWait ), queueSEND_WITH_PRIORITY( uxPriority ) )
+#define xQueueSendWithPriorityFromISR( xQueue, pvItemToQueue, uxPriority, pxHigherPriorityTaskWoken ) xQueueGenericSendFromISR( ( xQueue ), ( pvItemToQueue ), ( pxHigherPriorityTaskWoken ), queueSEND_WITH_PRIORITY( uxPriority ) )
+
 /*
  * Utilities to query queues that are safe to use from an ISR.  These utilities
  * should be used only from witin an ISR, or within a critical section.
@@ -1391,6 +1836,86 @@ BaseType_t xQueueIsQueueEmptyFromISR( const QueueHandle_t xQueue ) PRIVILEGED_FU
 BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
 UBaseType_t uxQueueMessagesWaitingFromISR( const QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * <pre>
+ void vQueueGetStatistics( QueueHandle_t xQueue, QueueStats_t *pxStats );
+ void vQueueResetStatistics( QueueHandle_t xQueue );
+ </pre>
+ *
+ * configUSE_QUEUE_STATISTICS must be defined as 1 for these functions to be
+ * available.
+ *
+ * vQueueGetStatistics() copies the counters kept for a queue, semaphore or
+ * mutex into the structure pointed to by pxStats.  vQueueResetStatistics()
+ * zeros the counters, and restarts the high water mark from the number of
+ * items currently in the queue, so a later vQueueGetStatistics() call shows
+ * the activity over a chosen interval.
+ *
+ * \defgroup vQueueGetStatistics vQueueGetStatistics
+ * \ingroup QueueManagement
+ */
+#if( configUSE_QUEUE_STATISTICS == 1 )
+	void vQueueGetStatistics( QueueHandle_t xQueue, QueueStats_t *pxStats ) PRIVILEGED_FUNCTION;
+	void vQueueResetStatistics( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * queue. h
+ * <pre>
+ UBaseType_t uxQueueGetNumberOfQueues( void );
+ UBaseType_t uxQueueGetSystemState( QueueStatus_t * const pxQueueStatusArray, const UBaseType_t uxArraySize );
+ </pre>
+ *
+ * configUSE_QUEUE_STATISTICS must be defined as 1 for these functions to be
+ * available.
+ *
+ * uxQueueGetNumberOfQueues() returns the number of queues, semaphores and
+ * mutexes that currently exist.
+ *
+ * uxQueueGetSystemState() populates a QueueStatus_t structure for each of
+ * them, most recently created first, in the same way that
+ * uxTaskGetSystemState() does for tasks.  The scheduler is suspended while
+ * the queues are walked, but interrupts are only disabled while each
+ * structure is copied.
+ *
+ * @param pxQueueStatusArray A pointer to an array of QueueStatus_t structures.
+ *
+ * @param uxArraySize The size of the array pointed to by pxQueueStatusArray.
+ * If the array is too small only the first uxArraySize queues are reported.
+ *
+ * @return The number of QueueStatus_t structures that were populated.
+ *
+ * Example usage:
+   <pre>
+    // Print the queues that have ever been full.
+    void vReportFullQueues( void )
+    {
+    QueueStatus_t xStatus[ 16 ];
+    UBaseType_t uxQueues, x;
+
+        uxQueues = uxQueueGetSystemState( xStatus, 16 );
+
+        for( x = 0; x < uxQueues; x++ )
+        {
+            if( xStatus[ x ].xStats.uxMaxMessagesWaiting == xStatus[ x ].uxLength )
+            {
+                printf( "%s: %u sends failed, senders blocked for %u ticks\r\n",
+                        xStatus[ x ].pcQueueName != NULL ? xStatus[ x ].pcQueueName : "?",
+                        ( unsigned ) xStatus[ x ].xStats.ulSendFailCount,
+                        ( unsigned ) xStatus[ x ].xStats.xSendBlockedTicks );
+            }
+        }
+    }
+   </pre>
+ * \defgroup uxQueueGetSystemState uxQueueGetSystemState
+ * \ingroup QueueManagement
+ */
+#if( configUSE_QUEUE_STATISTICS == 1 )
+	UBaseType_t uxQueueGetNumberOfQueues( void ) PRIVILEGED_FUNCTION;
+	UBaseType_t uxQueueGetSystemState( QueueStatus_t * const pxQueueStatusArray, const UBaseType_t uxArraySize ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * The functions defined above are for passing data to and from tasks.  The
  * functions below are the equivalents for passing data to and from
@@ -1444,6 +1969,11 @@ BaseType_t xQueueGiveMutexRecursive( QueueHandle_t pxMutex ) PRIVILEGED_FUNCTION
  * does not effect the number of queues, semaphores and mutexes that can be
  * created - just the number that the registry can hold.
  *
+ * If configUSE_OBJECT_REGISTRY is set to 1 then the queue is added to the
+ * object registry instead (see object_registry.h), which is sized by
+ * configOBJECT_REGISTRY_SIZE and also holds tasks, timers, event groups and
+ * stream buffers.
+ *
  * @param xQueue The handle of the queue being added to the registry.  This
  * is the handle returned by a call to xQueueCreate().  Semaphore and mutex
  * handles can also be passed in here.
@@ -1453,7 +1983,7 @@ BaseType_t xQueueGiveMutexRecursive( QueueHandle_t pxMutex ) PRIVILEGED_FUNCTION
  * stores a pointer to the string - so the string must be persistent (global or
  * preferably in ROM/Flash), not on the stack.
  */
-#if( configQUEUE_REGISTRY_SIZE > 0 )
+#if( ( configQUEUE_REGISTRY_SIZE > 0 ) || ( configUSE_OBJECT_REGISTRY == 1 ) )
 	void vQueueAddToRegistry( QueueHandle_t xQueue, const char *pcName ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
 #endif
 
@@ -1467,7 +1997,7 @@ BaseType_t xQueueGiveMutexRecursive( QueueHandle_t pxMutex ) PRIVILEGED_FUNCTION
  *
  * @param xQueue The handle of the queue being removed from the registry.
  */
-#if( configQUEUE_REGISTRY_SIZE > 0 )
+#if( ( configQUEUE_REGISTRY_SIZE > 0 ) || ( configUSE_OBJECT_REGISTRY == 1 ) )
 	void vQueueUnregisterQueue( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
 #endif
 
@@ -1482,7 +2012,7 @@ BaseType_t xQueueGiveMutexRecursive( QueueHandle_t pxMutex ) PRIVILEGED_FUNCTION
  * queue is returned.  If the queue is not in the registry then NULL is
  * returned.
  */
-#if( configQUEUE_REGISTRY_SIZE > 0 )
+#if( ( configQUEUE_REGISTRY_SIZE > 0 ) || ( configUSE_OBJECT_REGISTRY == 1 ) )
 	const char *pcQueueGetName( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
 #endif
 
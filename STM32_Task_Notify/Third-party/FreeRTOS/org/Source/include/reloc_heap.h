@@ -0,0 +1,206 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * The relocatable heap holds large buffers that are accessed through handles
+ * rather than raw pointers.  Because the application only holds a handle, the
+ * heap is free to move a buffer whenever it is not locked, so the idle task
+ * can slide buffers down over the holes left by freed buffers.  Free space
+ * that heap_4.c could only merge with adjacent blocks is instead gathered into
+ * one block at the top of the region, so a large allocation that fits in the
+ * total free space will, once compaction has caught up, succeed.
+ *
+ * A buffer must be locked with pvRelocHeapLock() to obtain a pointer to its
+ * data.  The pointer stays valid until the matching vRelocHeapUnlock().  Keep
+ * buffers unlocked when they are not being accessed - a locked buffer cannot
+ * be moved and pins the free space below it.
+ *
+ * Compaction is incremental.  Each call to xRelocHeapCompactStep(), which the
+ * idle task makes once per loop, copies at most
+ * configRELOCATABLE_HEAP_COMPACT_STEP_BYTES bytes with the scheduler
+ * suspended, so the pause it causes is bounded no matter how large the buffer
+ * being moved.  Locking a buffer that is part way through being moved, or
+ * allocating a new buffer while a move is in progress, completes the move
+ * first.
+ *
+ * None of these functions can be called from an interrupt.
+ *
+ * configUSE_RELOCATABLE_HEAP must be set to 1, and configRELOCATABLE_HEAP_SIZE
+ * defined, in FreeRTOSConfig.h for the relocatable heap to be available.
+ */
+
+#ifndef RELOC_HEAP_H
+#define RELOC_HEAP_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include reloc_heap.h"
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * Type by which relocatable buffers are referenced.  For example, a call to
+ * xRelocHeapAlloc() returns a RelocHandle_t variable that can then be used as
+ * a parameter to pvRelocHeapLock(), vRelocHeapFree(), etc.
+ */
+typedef void * RelocHandle_t;
+
+/**
+ * reloc_heap.h
+ *
+<pre>
+RelocHandle_t xRelocHeapAlloc( size_t xWantedSize );
+</pre>
+ *
+ * Allocates a buffer of at least xWantedSize bytes from the relocatable heap.
+ * The buffer is returned unlocked.
+ *
+ * @return The handle of the buffer, or NULL if there is no free block large
+ * enough or all configRELOCATABLE_HEAP_MAX_HANDLES handles are in use.  An
+ * allocation that fails because the free space is fragmented may succeed later
+ * once the idle task has compacted the heap.
+ *
+ * Example use:
+<pre>
+void vLoggerTask( void *pvParameters )
+{
+RelocHandle_t xLog;
+uint8_t *pucLog;
+
+    xLog = xRelocHeapAlloc( 4096 );
+
+    for( ;; )
+    {
+        // Wait for something to log ...
+
+        pucLog = ( uint8_t * ) pvRelocHeapLock( xLog );
+        // ... write to pucLog ...
+        vRelocHeapUnlock( xLog );
+
+        // pucLog must not be used again until the buffer is locked again, as
+        // the idle task may have moved it.
+    }
+}
+</pre>
+ * \defgroup xRelocHeapAlloc xRelocHeapAlloc
+ * \ingroup RelocHeapManagement
+ */
+RelocHandle_t xRelocHeapAlloc( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+
+/**
+ * reloc_heap.h
+ *
+<pre>
+void vRelocHeapFree( RelocHandle_t xHandle );
+</pre>
+ *
+ * Frees a buffer and its handle.  The buffer must not be locked.
+ *
+ * \defgroup vRelocHeapFree vRelocHeapFree
+ * \ingroup RelocHeapManagement
+ */
+void vRelocHeapFree( RelocHandle_t xHandle ) PRIVILEGED_FUNCTION;
+
+/**
+ * reloc_heap.h
+ *
+<pre>
+void *pvRelocHeapLock( RelocHandle_t xHandle );
+void vRelocHeapUnlock( RelocHandle_t xHandle );
+</pre>
+ *
+ * pvRelocHeapLock() pins the buffer in place and returns a pointer to its
+ * data, aligned to portBYTE_ALIGNMENT.  Locks nest - the buffer can be moved
+ * again once vRelocHeapUnlock() has been called as many times as
+ * pvRelocHeapLock().
+ *
+ * \defgroup pvRelocHeapLock pvRelocHeapLock
+ * \ingroup RelocHeapManagement
+ */
+void *pvRelocHeapLock( RelocHandle_t xHandle ) PRIVILEGED_FUNCTION;
+void vRelocHeapUnlock( RelocHandle_t xHandle ) PRIVILEGED_FUNCTION;
+
+/**
+ * reloc_heap.h
+ *
+<pre>
+size_t xRelocHeapGetBufferSize( RelocHandle_t xHandle );
+</pre>
+ *
+ * @return The number of bytes that can be used in the buffer, which may be
+ * slightly more than was requested.
+ *
+ * \defgroup xRelocHeapGetBufferSize xRelocHeapGetBufferSize
+ * \ingroup RelocHeapManagement
+ */
+size_t xRelocHeapGetBufferSize( RelocHandle_t xHandle ) PRIVILEGED_FUNCTION;
+
+/**
+ * reloc_heap.h
+ *
+<pre>
+size_t xRelocHeapGetFreeHeapSize( void );
+size_t xRelocHeapGetLargestFreeBlock( void );
+</pre>
+ *
+ * Return the total number of free bytes in the relocatable heap, and the
+ * largest buffer that could be allocated right now.  The difference between
+ * the two shows how fragmented the heap is.
+ *
+ * \defgroup xRelocHeapGetFreeHeapSize xRelocHeapGetFreeHeapSize
+ * \ingroup RelocHeapManagement
+ */
+size_t xRelocHeapGetFreeHeapSize( void ) PRIVILEGED_FUNCTION;
+size_t xRelocHeapGetLargestFreeBlock( void ) PRIVILEGED_FUNCTION;
+
+/**
+ * reloc_heap.h
+ *
+<pre>
+BaseType_t xRelocHeapCompactStep( void );
+</pre>
+ *
+ * Performs one bounded step of compaction.  Called from the idle task, so the
+ * application does not normally need to call it, but a low priority task can
+ * call it too if the idle task does not get enough processor time.
+ *
+ * @return pdTRUE if there may be more compaction to do, or pdFALSE if every
+ * unlocked buffer has already been moved as low as it can go.
+ *
+ * \defgroup xRelocHeapCompactStep xRelocHeapCompactStep
+ * \ingroup RelocHeapManagement
+ */
+BaseType_t xRelocHeapCompactStep( void ) PRIVILEGED_FUNCTION;
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( RELOC_HEAP_H ) */
@@ -0,0 +1,266 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Reader-writer locks protect data that many tasks read but few tasks update,
+ * such as configuration tables.  Any number of tasks, up to
+ * configRW_LOCK_MAX_READERS, can hold the lock for reading at the same time.
+ * A task that holds the lock for writing holds it alone.
+ *
+ * Writers are preferred: once a writer is waiting, tasks that ask for the read
+ * lock wait behind it, so a writer only ever waits for the readers that held
+ * the lock when it arrived.  When the last of those readers unlocks, the lock
+ * passes directly to the highest priority waiting writer.  When a writer
+ * unlocks and no other writer is waiting, every waiting reader is given the
+ * lock at once.
+ *
+ * A task that has to wait for the lock raises the priority of every task that
+ * holds it, the writer or all of the current readers, to its own, in the same
+ * way as a task waiting for a standard FreeRTOS mutex.  Each read or write lock
+ * held counts as a held mutex for the purpose of disinheriting that priority.
+ *
+ * Reader-writer locks are not recursive - a task must not lock a reader-writer
+ * lock it already holds, for reading or for writing - and cannot be used from
+ * interrupts.
+ *
+ * configUSE_RW_LOCKS must be set to 1 in FreeRTOSConfig.h for the
+ * reader-writer lock API to be available.  configUSE_MUTEXES must also be set
+ * to 1.
+ */
+
+#ifndef RW_LOCK_H
+#define RW_LOCK_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include rw_lock.h"
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * Type by which reader-writer locks are referenced.  For example, a call to
+ * xRwLockCreate() returns an RwLockHandle_t variable that can then be used as
+ * a parameter to xRwLockReadLock(), xRwLockWriteUnlock(), etc.
+ */
+typedef void * RwLockHandle_t;
+
+/**
+ * rw_lock.h
+ *
+<pre>
+RwLockHandle_t xRwLockCreate( void );
+</pre>
+ *
+ * Creates a reader-writer lock using pvPortMalloc().  The lock is created
+ * unlocked.
+ *
+ * @return The handle of the created lock, or NULL if the memory could not be
+ * allocated.
+ *
+ * \defgroup xRwLockCreate xRwLockCreate
+ * \ingroup RwLockManagement
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	RwLockHandle_t xRwLockCreate( void ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * rw_lock.h
+ *
+<pre>
+RwLockHandle_t xRwLockCreateStatic( StaticRwLock_t *pxStaticRwLock );
+</pre>
+ *
+ * Creates a reader-writer lock using statically allocated memory.
+ *
+ * @param pxStaticRwLock Must point to a variable of type StaticRwLock_t, which
+ * will be used to hold the lock's data structure.
+ *
+ * @return The handle of the created lock, or NULL if pxStaticRwLock was NULL.
+ *
+ * Example use:
+<pre>
+static StaticRwLock_t xConfigLockStruct;
+static RwLockHandle_t xConfigLock;
+static ConfigTable_t xConfig;
+
+uint32_t ulReadBaudRate( void )
+{
+uint32_t ulBaudRate = 0;
+
+    if( xRwLockReadLock( xConfigLock, pdMS_TO_TICKS( 5 ) ) == pdPASS )
+    {
+        ulBaudRate = xConfig.ulBaudRate;
+        xRwLockReadUnlock( xConfigLock );
+    }
+
+    return ulBaudRate;
+}
+
+void vUpdateConfig( const ConfigTable_t *pxNewConfig )
+{
+    if( xRwLockWriteLock( xConfigLock, portMAX_DELAY ) == pdPASS )
+    {
+        xConfig = *pxNewConfig;
+        xRwLockWriteUnlock( xConfigLock );
+    }
+}
+
+void vSetup( void )
+{
+    xConfigLock = xRwLockCreateStatic( &xConfigLockStruct );
+}
+</pre>
+ * \defgroup xRwLockCreateStatic xRwLockCreateStatic
+ * \ingroup RwLockManagement
+ */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	RwLockHandle_t xRwLockCreateStatic( StaticRwLock_t * const pxStaticRwLock ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * rw_lock.h
+ *
+<pre>
+void vRwLockDelete( RwLockHandle_t xLock );
+</pre>
+ *
+ * Deletes a reader-writer lock.  The lock must not be held, and no task may be
+ * waiting for it.
+ *
+ * \defgroup vRwLockDelete vRwLockDelete
+ * \ingroup RwLockManagement
+ */
+void vRwLockDelete( RwLockHandle_t xLock ) PRIVILEGED_FUNCTION;
+
+/**
+ * rw_lock.h
+ *
+<pre>
+BaseType_t xRwLockReadLock( RwLockHandle_t xLock, TickType_t xTicksToWait );
+BaseType_t xRwLockTryReadLock( RwLockHandle_t xLock );
+</pre>
+ *
+ * Locks a reader-writer lock for reading, waiting up to xTicksToWait ticks if
+ * a writer holds the lock or is waiting for it, or if
+ * configRW_LOCK_MAX_READERS tasks already hold it for reading.
+ * xRwLockTryReadLock() does not wait.
+ *
+ * @param xLock The lock to lock.
+ *
+ * @param xTicksToWait The maximum number of ticks to wait.  Set to
+ * portMAX_DELAY to wait indefinitely (if INCLUDE_vTaskSuspend is set to 1).
+ *
+ * @return pdPASS if the lock was locked for reading, otherwise pdFAIL.
+ *
+ * \defgroup xRwLockReadLock xRwLockReadLock
+ * \ingroup RwLockManagement
+ */
+BaseType_t xRwLockReadLock( RwLockHandle_t xLock, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#define xRwLockTryReadLock( xLock ) xRwLockReadLock( ( xLock ), ( TickType_t ) 0 )
+
+/**
+ * rw_lock.h
+ *
+<pre>
+BaseType_t xRwLockReadUnlock( RwLockHandle_t xLock );
+</pre>
+ *
+ * Releases a read lock held by the calling task.
+ *
+ * @return pdPASS if the read lock was released, or pdFAIL if the calling task
+ * did not hold it.
+ *
+ * \defgroup xRwLockReadUnlock xRwLockReadUnlock
+ * \ingroup RwLockManagement
+ */
+BaseType_t xRwLockReadUnlock( RwLockHandle_t xLock ) PRIVILEGED_FUNCTION;
+
+/**
+ * rw_lock.h
+ *
+<pre>
+BaseType_t xRwLockWriteLock( RwLockHandle_t xLock, TickType_t xTicksToWait );
+BaseType_t xRwLockTryWriteLock( RwLockHandle_t xLock );
+</pre>
+ *
+ * Locks a reader-writer lock for writing, waiting up to xTicksToWait ticks for
+ * the tasks that hold it to unlock it.  While the calling task waits, tasks
+ * that ask for the read lock wait too.  xRwLockTryWriteLock() does not wait.
+ *
+ * @param xLock The lock to lock.
+ *
+ * @param xTicksToWait The maximum number of ticks to wait.  Set to
+ * portMAX_DELAY to wait indefinitely (if INCLUDE_vTaskSuspend is set to 1).
+ *
+ * @return pdPASS if the lock was locked for writing, otherwise pdFAIL.
+ *
+ * \defgroup xRwLockWriteLock xRwLockWriteLock
+ * \ingroup RwLockManagement
+ */
+BaseType_t xRwLockWriteLock( RwLockHandle_t xLock, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#define xRwLockTryWriteLock( xLock ) xRwLockWriteLock( ( xLock ), ( TickType_t ) 0 )
+
+/**
+ * rw_lock.h
+ *
+<pre>
+BaseType_t xRwLockWriteUnlock( RwLockHandle_t xLock );
+</pre>
+ *
+ * Releases the write lock held by the calling task.
+ *
+ * @return pdPASS if the write lock was released, or pdFAIL if the calling task
+ * did not hold it.
+ *
+ * \defgroup xRwLockWriteUnlock xRwLockWriteUnlock
+ * \ingroup RwLockManagement
+ */
+BaseType_t xRwLockWriteUnlock( RwLockHandle_t xLock ) PRIVILEGED_FUNCTION;
+
+/**
+ * rw_lock.h
+ *
+<pre>
+UBaseType_t uxRwLockGetReaderCount( RwLockHandle_t xLock );
+</pre>
+ *
+ * @return The number of tasks that hold the lock for reading.
+ *
+ * \defgroup uxRwLockGetReaderCount uxRwLockGetReaderCount
+ * \ingroup RwLockManagement
+ */
+UBaseType_t uxRwLockGetReaderCount( RwLockHandle_t xLock ) PRIVILEGED_FUNCTION;
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( RW_LOCK_H ) */
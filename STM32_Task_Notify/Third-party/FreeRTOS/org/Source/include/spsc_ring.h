@@ -0,0 +1,256 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * An SPSC ring is a fixed size FIFO of fixed size items with exactly one
+ * producer and exactly one consumer, intended for high rate data paths such as
+ * a UART receive or ADC interrupt feeding a task.
+ *
+ * Sending is wait-free: it never masks interrupts, never suspends the
+ * scheduler, never loops and never walks a list of blocked tasks.  The
+ * producer writes the item and advances the head index; the consumer reads the
+ * item and advances the tail index.  Each index is only ever written by one
+ * side, so no read-modify-write sequence is needed.  The consumer task is only
+ * woken, with a direct to task notification, when the producer adds an item to
+ * a ring the consumer had emptied.  While the consumer keeps up with a burst
+ * the producer sends no notifications at all.
+ *
+ * Because of this:
+ *
+ *  + There must only be one producer (one task or one interrupt) and one
+ *    consumer task per ring.  Use a queue if there are more.
+ *
+ *  + The consumer task's notification value is used as a counting semaphore,
+ *    as with ulTaskNotifyTake().  The consumer must not use task notifications
+ *    for anything else, but can consume from several rings, polling each in
+ *    turn after every wake up.
+ *
+ *  + The producer never blocks.  If the ring is full the item is dropped and
+ *    the ring's overrun count is incremented.
+ *
+ * As waking the consumer uses the FreeRTOS API, xSpscRingSendFromISR() has the
+ * same interrupt priority restrictions as other FromISR() functions.
+ *
+ * configUSE_SPSC_RINGS must be set to 1 in FreeRTOSConfig.h for the SPSC
+ * ring API to be available.
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include spsc_ring.h"
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * Type by which SPSC rings are referenced.  For example, a call to
+ * xSpscRingCreate() returns an SpscRingHandle_t variable that can then be used
+ * as a parameter to xSpscRingSendFromISR(), xSpscRingReceive(), etc.
+ */
+typedef void * SpscRingHandle_t;
+
+/**
+ * The number of bytes of storage needed for a ring of uxLength items of
+ * xItemSize bytes each.  One extra slot is used to tell a full ring from an
+ * empty one without a shared item count.
+ */
+#define spscRING_STORAGE_SIZE( uxLength, xItemSize ) ( ( ( size_t ) ( uxLength ) + ( size_t ) 1 ) * ( size_t ) ( xItemSize ) )
+
+/**
+ * spsc_ring.h
+ *
+<pre>
+SpscRingHandle_t xSpscRingCreate( UBaseType_t uxLength, size_t xItemSize );
+</pre>
+ *
+ * Creates a ring that can hold uxLength items of xItemSize bytes each, using
+ * a single call to pvPortMalloc().
+ *
+ * @return The handle of the created ring, or NULL if the memory could not be
+ * allocated.
+ *
+ * \defgroup xSpscRingCreate xSpscRingCreate
+ * \ingroup SpscRingManagement
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	SpscRingHandle_t xSpscRingCreate( UBaseType_t uxLength, size_t xItemSize ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * spsc_ring.h
+ *
+<pre>
+SpscRingHandle_t xSpscRingCreateStatic( UBaseType_t uxLength,
+                                        size_t xItemSize,
+                                        uint8_t *pucRingStorageArea,
+                                        StaticSpscRing_t *pxStaticSpscRing );
+</pre>
+ *
+ * Creates a ring using statically allocated memory.
+ *
+ * @param pucRingStorageArea Must point to an array of at least
+ * spscRING_STORAGE_SIZE( uxLength, xItemSize ) bytes.
+ *
+ * @param pxStaticSpscRing Must point to a variable of type StaticSpscRing_t,
+ * which will be used to hold the ring's data structure.
+ *
+ * @return The handle of the created ring, or NULL if either pointer was NULL.
+ *
+ * Example use:
+<pre>
+#define adcRING_LENGTH 64
+
+static uint8_t ucAdcRingStorage[ spscRING_STORAGE_SIZE( adcRING_LENGTH, sizeof( uint16_t ) ) ];
+static StaticSpscRing_t xAdcRingStruct;
+static SpscRingHandle_t xAdcRing;
+
+void ADC_IRQHandler( void )
+{
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+uint16_t usSample = ( uint16_t ) ADC1->DR;
+
+    // Never blocks.  Drops the sample if the task has fallen too far behind.
+    ( void ) xSpscRingSendFromISR( xAdcRing, &usSample, &xHigherPriorityTaskWoken );
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
+void vAdcTask( void *pvParameters )
+{
+uint16_t usSample;
+
+    for( ;; )
+    {
+        if( xSpscRingReceive( xAdcRing, &usSample, portMAX_DELAY ) == pdPASS )
+        {
+            // ... process usSample ...
+        }
+    }
+}
+
+// Before the scheduler is started.
+xAdcRing = xSpscRingCreateStatic( adcRING_LENGTH, sizeof( uint16_t ), ucAdcRingStorage, &xAdcRingStruct );
+</pre>
+ * \defgroup xSpscRingCreateStatic xSpscRingCreateStatic
+ * \ingroup SpscRingManagement
+ */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	SpscRingHandle_t xSpscRingCreateStatic( UBaseType_t uxLength,
+											size_t xItemSize,
+											uint8_t * const pucRingStorageArea,
+											StaticSpscRing_t * const pxStaticSpscRing ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * spsc_ring.h
+ *
+<pre>
+void vSpscRingDelete( SpscRingHandle_t xRing );
+</pre>
+ *
+ * Deletes a ring.  The producer and consumer must have stopped using it.  Must
+ * not be called from an interrupt.
+ *
+ * \defgroup vSpscRingDelete vSpscRingDelete
+ * \ingroup SpscRingManagement
+ */
+void vSpscRingDelete( SpscRingHandle_t xRing ) PRIVILEGED_FUNCTION;
+
+/**
+ * spsc_ring.h
+ *
+<pre>
+BaseType_t xSpscRingSend( SpscRingHandle_t xRing, const void *pvItem );
+BaseType_t xSpscRingSendFromISR( SpscRingHandle_t xRing,
+                                 const void *pvItem,
+                                 BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Copy an item into the ring.  xSpscRingSend() is used when the producer is a
+ * task, and xSpscRingSendFromISR() when the producer is an interrupt.
+ * Neither function blocks.
+ *
+ * @param pvItem Points to the xItemSize bytes to copy into the ring.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if sending the item woke the
+ * consumer and the consumer has a higher priority than the interrupted task,
+ * in which case a context switch should be requested before the interrupt is
+ * exited.  Can be NULL.
+ *
+ * @return pdPASS if the item was copied into the ring, or errQUEUE_FULL if the
+ * ring was full, in which case the overrun count is incremented.
+ *
+ * \defgroup xSpscRingSendFromISR xSpscRingSendFromISR
+ * \ingroup SpscRingManagement
+ */
+BaseType_t xSpscRingSend( SpscRingHandle_t xRing, const void * const pvItem ) PRIVILEGED_FUNCTION;
+BaseType_t xSpscRingSendFromISR( SpscRingHandle_t xRing, const void * const pvItem, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * spsc_ring.h
+ *
+<pre>
+BaseType_t xSpscRingReceive( SpscRingHandle_t xRing, void *pvBuffer, TickType_t xTicksToWait );
+</pre>
+ *
+ * Copy the oldest item out of the ring, blocking for up to xTicksToWait ticks
+ * if the ring is empty.  Must only be called by the ring's consumer task.
+ *
+ * @return pdPASS if an item was received, or errQUEUE_EMPTY if the ring was
+ * still empty when the block time expired.
+ *
+ * \defgroup xSpscRingReceive xSpscRingReceive
+ * \ingroup SpscRingManagement
+ */
+BaseType_t xSpscRingReceive( SpscRingHandle_t xRing, void * const pvBuffer, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * spsc_ring.h
+ *
+<pre>
+UBaseType_t uxSpscRingItemsWaiting( SpscRingHandle_t xRing );
+uint32_t ulSpscRingGetOverrunCount( SpscRingHandle_t xRing );
+</pre>
+ *
+ * Query the number of items in the ring, and the number of items dropped
+ * because the ring was full.  Both are interrupt safe.
+ *
+ * \defgroup ulSpscRingGetOverrunCount ulSpscRingGetOverrunCount
+ * \ingroup SpscRingManagement
+ */
+UBaseType_t uxSpscRingItemsWaiting( SpscRingHandle_t xRing ) PRIVILEGED_FUNCTION;
+uint32_t ulSpscRingGetOverrunCount( SpscRingHandle_t xRing ) PRIVILEGED_FUNCTION;
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( SPSC_RING_H ) */
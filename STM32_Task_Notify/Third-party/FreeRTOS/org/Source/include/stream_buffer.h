@@ -47,6 +47,12 @@
  * (such as xStreamBufferRead()) inside a critical section section and set the
  * receive block time to 0.
  *
+ * The exception is a stream buffer created with
+ * xStreamBufferCreateMultiProducer() or
+ * xStreamBufferCreateMultiProducerStatic(), which any number of tasks and
+ * interrupts can write to at once without the critical section (see those
+ * functions).  There must still be only one reader.
+ *
  */
 
 #ifndef STREAM_BUFFER_H
@@ -60,6 +66,37 @@
  */
 typedef void * StreamBufferHandle_t;
 
+/**
+ * Used by the zero copy stream buffer API to describe space or data within a
+ * stream buffer's storage area.  The storage area is circular, so the space
+ * or data can be split in two at its end.  pucRegion1 is used first and
+ * pucRegion2, which starts at the beginning of the storage area, is NULL
+ * (with a length of 0) when there is no wrap.
+ */
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+	typedef struct xSTREAM_BUFFER_REGIONS
+	{
+		uint8_t *pucRegion1;
+		size_t xRegion1Length;
+		uint8_t *pucRegion2;
+		size_t xRegion2Length;
+	} StreamBufferRegions_t;
+#endif
+
+/*
+ * The type of buffer created by xStreamBufferGenericCreate() and
+ * xStreamBufferGenericCreateStatic().  sbTYPE_MULTI_PRODUCER can be OR'ed
+ * with either of the first two.  One of the sbTYPE_LENGTH_ values can be
+ * OR'ed with sbTYPE_MESSAGE_BUFFER to choose how the length of each message is
+ * stored - see xMessageBufferCreateWithLengthFormat() in message_buffer.h.
+ */
+#define sbTYPE_STREAM_BUFFER	( ( BaseType_t ) 0 )
+#define sbTYPE_MESSAGE_BUFFER	( ( BaseType_t ) 1 )
+#define sbTYPE_MULTI_PRODUCER	( ( BaseType_t ) 2 )
+#define sbTYPE_LENGTH_1_BYTE	( ( BaseType_t ) 4 )
+#define sbTYPE_LENGTH_2_BYTES	( ( BaseType_t ) 8 )
+#define sbTYPE_LENGTH_VARINT	( ( BaseType_t ) 12 )
+
 
 /**
  * message_buffer.h
@@ -126,7 +163,7 @@ const size_t xStreamBufferSizeBytes = 100, xTriggerLevel = 10;
  * \defgroup xStreamBufferCreate xStreamBufferCreate
  * \ingroup StreamBufferManagement
  */
-#define xStreamBufferCreate( xBufferSizeBytes, xTriggerLevelBytes ) xStreamBufferGenericCreate( xBufferSizeBytes, xTriggerLevelBytes, pdFALSE )
+#define xStreamBufferCreate( xBufferSizeBytes, xTriggerLevelBytes ) xStreamBufferGenericCreate( xBufferSizeBytes, xTriggerLevelBytes, sbTYPE_STREAM_BUFFER )
 
 /**
  * stream_buffer.h
@@ -207,7 +244,53 @@ const size_t xTriggerLevel = 1;
  * \defgroup xStreamBufferCreateStatic xStreamBufferCreateStatic
  * \ingroup StreamBufferManagement
  */
-#define xStreamBufferCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, pucStreamBufferStorageArea, pxStaticStreamBuffer ) xStreamBufferGenericCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, pdFALSE, pucStreamBufferStorageArea, pxStaticStreamBuffer )
+#define xStreamBufferCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, pucStreamBufferStorageArea, pxStaticStreamBuffer ) xStreamBufferGenericCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, sbTYPE_STREAM_BUFFER, pucStreamBufferStorageArea, pxStaticStreamBuffer )
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+StreamBufferHandle_t xStreamBufferCreateMultiProducer( size_t xBufferSizeBytes, size_t xTriggerLevelBytes );
+
+StreamBufferHandle_t xStreamBufferCreateMultiProducerStatic( size_t xBufferSizeBytes,
+                                                             size_t xTriggerLevelBytes,
+                                                             uint8_t *pucStreamBufferStorageArea,
+                                                             StaticStreamBuffer_t *pxStaticStreamBuffer );
+</pre>
+ *
+ * As xStreamBufferCreate() and xStreamBufferCreateStatic(), but creates a
+ * stream buffer that any number of tasks and interrupts can write to at the
+ * same time without the caller having to use a critical section.
+ *
+ * Each write reserves the space it needs with interrupts masked for just the
+ * few instructions needed to move an index, then copies its data with
+ * interrupts enabled, so interrupts can write while a task is copying and the
+ * time interrupts are masked does not depend on the amount of data written.
+ * A writing task holds the scheduler suspended while it copies, so no other
+ * task runs in that time.  The bytes from each write are kept together, in the
+ * order in which the space was reserved, and are made available to the reader
+ * when no earlier write is still being copied, which is never longer than the
+ * time it takes to copy one write and run the interrupts that land in it.
+ *
+ * Writes to a multi-producer stream buffer are all or nothing:  a write that
+ * does not fit in the free space writes nothing, so the bytes of two writers
+ * are never interleaved.  Any number of writing tasks can block to wait for
+ * space.  They are all unblocked whenever the reader frees some, highest
+ * priority first, and those whose writes still do not fit wait again.  The
+ * zero copy write functions, xStreamBufferAcquireWrite() and
+ * xStreamBufferCommitWrite(), cannot be used on a multi-producer stream
+ * buffer.  There must still be only one reader.
+ *
+ * configUSE_STREAM_BUFFER_MULTI_PRODUCER must be set to 1 in FreeRTOSConfig.h
+ * for these functions to be available.
+ *
+ * \defgroup xStreamBufferCreateMultiProducer xStreamBufferCreateMultiProducer
+ * \ingroup StreamBufferManagement
+ */
+#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+	#define xStreamBufferCreateMultiProducer( xBufferSizeBytes, xTriggerLevelBytes ) xStreamBufferGenericCreate( xBufferSizeBytes, xTriggerLevelBytes, sbTYPE_STREAM_BUFFER | sbTYPE_MULTI_PRODUCER )
+	#define xStreamBufferCreateMultiProducerStatic( xBufferSizeBytes, xTriggerLevelBytes, pucStreamBufferStorageArea, pxStaticStreamBuffer ) xStreamBufferGenericCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, sbTYPE_STREAM_BUFFER | sbTYPE_MULTI_PRODUCER, pucStreamBufferStorageArea, pxStaticStreamBuffer )
+#endif
 
 /**
  * stream_buffer.h
@@ -582,6 +665,201 @@ size_t xStreamBufferReceiveFromISR( StreamBufferHandle_t xStreamBuffer,
 									size_t xBufferLengthBytes,
 									BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferAcquireWrite( StreamBufferHandle_t xStreamBuffer,
+                                  StreamBufferRegions_t * const pxRegions,
+                                  size_t xWantedBytes,
+                                  TickType_t xTicksToWait );
+size_t xStreamBufferAcquireWriteFromISR( StreamBufferHandle_t xStreamBuffer,
+                                         StreamBufferRegions_t * const pxRegions );
+size_t xStreamBufferCommitWrite( StreamBufferHandle_t xStreamBuffer,
+                                 size_t xCount );
+size_t xStreamBufferCommitWriteFromISR( StreamBufferHandle_t xStreamBuffer,
+                                        size_t xCount,
+                                        BaseType_t * const pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Zero copy alternative to xStreamBufferSend().  xStreamBufferAcquireWrite()
+ * describes the free space in the stream buffer's own storage area, so the
+ * data can be written there directly - for example by a DMA controller, or by
+ * a formatter - instead of being built in a separate buffer and then copied.
+ * The free space wraps at the end of the storage area so it is returned as up
+ * to two regions: pxRegions->pucRegion1 is filled first, then
+ * pxRegions->pucRegion2, which is NULL if the free space does not wrap.
+ *
+ * Nothing is added to the stream buffer until xStreamBufferCommitWrite() is
+ * called.  Committing xCount bytes makes the first xCount bytes of the regions
+ * available to the reader, and unblocks a task waiting to read in the same way
+ * as xStreamBufferSend() - that is, once the number of bytes in the stream
+ * buffer reaches its trigger level.
+ *
+ * When used on a message buffer the regions describe the space available for
+ * the body of the next message, the message's length having already been
+ * allowed for.  Committing xCount bytes then writes the length and posts the
+ * first xCount bytes of the regions as one message.
+ *
+ * Like xStreamBufferSend() these functions assume there is only one writer.
+ * The regions remain valid until the commit, or until the stream buffer is
+ * reset.  Acquiring again without committing returns regions that start at
+ * the same place, but which may be longer if the reader has made more space.
+ *
+ * configUSE_STREAM_BUFFER_ZERO_COPY must be set to 1 in FreeRTOSConfig.h for
+ * these functions to be available.  Use the FromISR() versions from an
+ * interrupt.
+ *
+ * @param xStreamBuffer The handle of the stream buffer.
+ *
+ * @param pxRegions Used to pass out the free regions.
+ *
+ * @param xWantedBytes The number of free bytes the calling task wants to
+ * write.  If fewer than xWantedBytes are free the task will block, for at most
+ * xTicksToWait, until they are.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for xWantedBytes of space to become free.
+ *
+ * @param xCount The number of bytes written into the regions.  Must not be
+ * greater than the value returned by the preceding acquire.  A value of 0
+ * abandons the write.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if committing the data
+ * unblocked a task that has a priority above the interrupted task, in which
+ * case a context switch should be requested before the interrupt exits.
+ *
+ * @return The acquire functions return the total length of the regions, which
+ * can be more than xWantedBytes, and is less than xWantedBytes if the block
+ * time expired first.  The commit functions return xCount.
+ *
+ * Example use:
+<pre>
+void vAFunction( StreamBufferHandle_t xStreamBuffer )
+{
+StreamBufferRegions_t xRegions;
+size_t xFree, xWritten;
+
+    // Wait up to 10ms for at least 16 bytes of space.
+    xFree = xStreamBufferAcquireWrite( xStreamBuffer, &xRegions, 16, pdMS_TO_TICKS( 10 ) );
+
+    if( xFree >= 16 )
+    {
+        // Format directly into the stream buffer storage.
+        xWritten = xFormatInto( xRegions.pucRegion1, xRegions.xRegion1Length,
+                                xRegions.pucRegion2, xRegions.xRegion2Length );
+
+        // Make the formatted bytes available to the reader.
+        ( void ) xStreamBufferCommitWrite( xStreamBuffer, xWritten );
+    }
+}
+</pre>
+ * \defgroup xStreamBufferAcquireWrite xStreamBufferAcquireWrite
+ * \ingroup StreamBufferManagement
+ */
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+	size_t xStreamBufferAcquireWrite( StreamBufferHandle_t xStreamBuffer,
+									  StreamBufferRegions_t * const pxRegions,
+									  size_t xWantedBytes,
+									  TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+	size_t xStreamBufferAcquireWriteFromISR( StreamBufferHandle_t xStreamBuffer,
+											 StreamBufferRegions_t * const pxRegions ) PRIVILEGED_FUNCTION;
+	size_t xStreamBufferCommitWrite( StreamBufferHandle_t xStreamBuffer,
+									 size_t xCount ) PRIVILEGED_FUNCTION;
+	size_t xStreamBufferCommitWriteFromISR( StreamBufferHandle_t xStreamBuffer,
+											size_t xCount,
+											BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferAcquireRead( StreamBufferHandle_t xStreamBuffer,
+                                 StreamBufferRegions_t * const pxRegions,
+                                 TickType_t xTicksToWait );
+size_t xStreamBufferAcquireReadFromISR( StreamBufferHandle_t xStreamBuffer,
+                                        StreamBufferRegions_t * const pxRegions );
+size_t xStreamBufferConsume( StreamBufferHandle_t xStreamBuffer,
+                             size_t xCount );
+size_t xStreamBufferConsumeFromISR( StreamBufferHandle_t xStreamBuffer,
+                                    size_t xCount,
+                                    BaseType_t * const pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Zero copy alternative to xStreamBufferReceive().
+ * xStreamBufferAcquireRead() describes the data held in the stream buffer's
+ * storage area, so it can be parsed or transmitted where it is rather than
+ * copied out first.  As with xStreamBufferAcquireWrite() the data is returned
+ * as up to two regions, pxRegions->pucRegion1 holding the oldest bytes.
+ *
+ * The data stays in the stream buffer until xStreamBufferConsume() is called.
+ * Consuming xCount bytes removes the oldest xCount bytes, and unblocks a task
+ * waiting for space in the same way as xStreamBufferReceive().  A parser can
+ * therefore consume only the complete records it has found and leave a
+ * partial record in place until the rest of it arrives.
+ *
+ * When used on a message buffer the regions describe the body of the next
+ * message, and xCount must be either the length of that message, which
+ * removes it, or 0, which leaves it in the message buffer.
+ *
+ * Like xStreamBufferReceive() these functions assume there is only one reader.
+ *
+ * configUSE_STREAM_BUFFER_ZERO_COPY must be set to 1 in FreeRTOSConfig.h for
+ * these functions to be available.  Use the FromISR() versions from an
+ * interrupt.
+ *
+ * @param xStreamBuffer The handle of the stream buffer.
+ *
+ * @param pxRegions Used to pass out the regions holding the data.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for data if the stream buffer is empty.
+ *
+ * @param xCount The number of bytes to remove.  Must not be greater than the
+ * value returned by the preceding acquire.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if consuming the data
+ * unblocked a task that has a priority above the interrupted task, in which
+ * case a context switch should be requested before the interrupt exits.
+ *
+ * @return The acquire functions return the total length of the regions, or 0
+ * if the stream buffer remained empty.  The consume functions return xCount.
+ *
+ * Example use:
+<pre>
+void vAFunction( StreamBufferHandle_t xStreamBuffer )
+{
+StreamBufferRegions_t xRegions;
+size_t xAvailable, xUsed;
+
+    xAvailable = xStreamBufferAcquireRead( xStreamBuffer, &xRegions, portMAX_DELAY );
+
+    if( xAvailable > 0 )
+    {
+        // Parse in place, and remove only the bytes that were used.
+        xUsed = xParse( xRegions.pucRegion1, xRegions.xRegion1Length,
+                        xRegions.pucRegion2, xRegions.xRegion2Length );
+        ( void ) xStreamBufferConsume( xStreamBuffer, xUsed );
+    }
+}
+</pre>
+ * \defgroup xStreamBufferAcquireRead xStreamBufferAcquireRead
+ * \ingroup StreamBufferManagement
+ */
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+	size_t xStreamBufferAcquireRead( StreamBufferHandle_t xStreamBuffer,
+									 StreamBufferRegions_t * const pxRegions,
+									 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+	size_t xStreamBufferAcquireReadFromISR( StreamBufferHandle_t xStreamBuffer,
+											StreamBufferRegions_t * const pxRegions ) PRIVILEGED_FUNCTION;
+	size_t xStreamBufferConsume( StreamBufferHandle_t xStreamBuffer,
+								 size_t xCount ) PRIVILEGED_FUNCTION;
+	size_t xStreamBufferConsumeFromISR( StreamBufferHandle_t xStreamBuffer,
+										size_t xCount,
+										BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * stream_buffer.h
  *
@@ -746,6 +1024,75 @@ BaseType_t xStreamBufferSetTriggerLevel( StreamBufferHandle_t xStreamBuffer, siz
  */
 BaseType_t xStreamBufferSetTriggerLevel( StreamBufferHandle_t xStreamBuffer, size_t xTriggerLevel ) PRIVILEGED_FUNCTION;
 
+/**
+ * stream_buffer.h
+ *
+<pre>
+BaseType_t xStreamBufferSetCoalescing( StreamBufferHandle_t xStreamBuffer, size_t xTriggerLevel, TickType_t xMaxLatency );
+</pre>
+ *
+ * Sets the stream buffer's trigger level, as xStreamBufferSetTriggerLevel()
+ * does, and bounds how long bytes can wait in the buffer below the trigger
+ * level.  configUSE_STREAM_BUFFER_COALESCING must be set to 1 in
+ * FreeRTOSConfig.h for xStreamBufferSetCoalescing() to be available.
+ *
+ * With a plain trigger level a producer that sends short bursts either wakes
+ * the reader for every burst (low trigger level) or leaves the tail of a burst
+ * in the buffer until more data arrives (high trigger level).  With coalescing
+ * a task blocked in xStreamBufferReceive() or xStreamBufferAcquireRead()
+ * returns as soon as either
+ *
+ * - the stream buffer holds at least xTriggerLevel bytes, or
+ * - xMaxLatency ticks have passed since the oldest byte still in the buffer
+ *   was written,
+ *
+ * or when its own block time expires, whichever comes first.  The reader is
+ * unblocked at most twice for each batch - once when the first byte is
+ * written to the empty buffer, so it can start timing, and once more when the
+ * trigger level is reached or the latency expires.  Bytes are never held for
+ * longer than xMaxLatency ticks plus the resolution of the tick.
+ *
+ * Coalescing only applies to stream buffers, not message buffers, as message
+ * buffers already unblock the reader once per message.
+ *
+ * @param xStreamBuffer The handle of the stream buffer being updated.
+ *
+ * @param xTriggerLevel The new trigger level for the stream buffer.  The same
+ * rules apply as for xStreamBufferSetTriggerLevel().
+ *
+ * @param xMaxLatency The most ticks the oldest byte in the buffer is held back
+ * waiting for the trigger level to be reached.  Setting xMaxLatency to 0 turns
+ * coalescing off again.
+ *
+ * @return pdTRUE if the trigger level and latency were updated, or pdFALSE if
+ * xTriggerLevel was greater than the stream buffer's length, in which case
+ * nothing is changed.
+ *
+ * Example use:
+<pre>
+void vAFunction( StreamBufferHandle_t xStreamBuffer )
+{
+uint8_t ucRxData[ 64 ];
+size_t xReceived;
+
+    // Wake up for every 64 bytes, but never leave a byte waiting for more
+    // than 5ms.
+    xStreamBufferSetCoalescing( xStreamBuffer, sizeof( ucRxData ), pdMS_TO_TICKS( 5 ) );
+
+    for( ;; )
+    {
+        xReceived = xStreamBufferReceive( xStreamBuffer, ucRxData, sizeof( ucRxData ), portMAX_DELAY );
+        vProcessData( ucRxData, xReceived );
+    }
+}
+</pre>
+ * \defgroup xStreamBufferSetCoalescing xStreamBufferSetCoalescing
+ * \ingroup StreamBufferManagement
+ */
+#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+	BaseType_t xStreamBufferSetCoalescing( StreamBufferHandle_t xStreamBuffer, size_t xTriggerLevel, TickType_t xMaxLatency ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * stream_buffer.h
  *
@@ -828,11 +1175,11 @@ BaseType_t xStreamBufferReceiveCompletedFromISR( StreamBufferHandle_t xStreamBuf
 /* Functions below here are not part of the public API. */
 StreamBufferHandle_t xStreamBufferGenericCreate( size_t xBufferSizeBytes,
 												 size_t xTriggerLevelBytes,
-												 BaseType_t xIsMessageBuffer ) PRIVILEGED_FUNCTION;
+												 BaseType_t xStreamBufferType ) PRIVILEGED_FUNCTION;
 
 StreamBufferHandle_t xStreamBufferGenericCreateStatic( size_t xBufferSizeBytes,
 													   size_t xTriggerLevelBytes,
-													   BaseType_t xIsMessageBuffer,
+													   BaseType_t xStreamBufferType,
 													   uint8_t * const pucStreamBufferStorageArea,
 													   StaticStreamBuffer_t * const pxStaticStreamBuffer ) PRIVILEGED_FUNCTION;
 
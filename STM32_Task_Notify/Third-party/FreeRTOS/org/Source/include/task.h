@@ -2233,6 +2233,21 @@ void vTaskPlaceOnEventListRestricted( List_t * const pxEventList, TickType_t xTi
 BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList ) PRIVILEGED_FUNCTION;
 void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem, const TickType_t xItemValue ) PRIVILEGED_FUNCTION;
 
+/*
+ * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS AN
+ * INTERFACE WHICH IS FOR THE EXCLUSIVE USE OF THE SCHEDULER.
+ *
+ * THIS FUNCTION MUST BE CALLED WITH INTERRUPTS DISABLED.
+ *
+ * The version of vTaskRemoveFromUnorderedEventList() that does not need the
+ * scheduler to be suspended, so xEventGroupSetBitsFromISR() can unblock tasks
+ * directly when configUSE_EVENT_GROUP_ISR_DIRECT is 1.
+ *
+ * @return pdTRUE if the task being removed has a higher priority than the task
+ * that was running, otherwise pdFALSE.
+ */
+BaseType_t xTaskRemoveFromUnorderedEventListFromISR( ListItem_t * pxEventListItem, const TickType_t xItemValue ) PRIVILEGED_FUNCTION;
+
 /*
  * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS ONLY
  * INTENDED FOR USE WHEN IMPLEMENTING A PORT OF THE SCHEDULER AND IS
@@ -2249,6 +2264,26 @@ void vTaskSwitchContext( void ) PRIVILEGED_FUNCTION;
  */
 TickType_t uxTaskResetEventItemValue( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * THESE FUNCTIONS MUST NOT BE USED FROM APPLICATION CODE.  THEY ARE USED BY
+ * THE 64-BIT EVENT BITS MODULE.
+ *
+ * THEY MUST BE CALLED WITH THE SCHEDULER SUSPENDED.
+ *
+ * As vTaskPlaceOnUnorderedEventList() and vTaskRemoveFromUnorderedEventList(),
+ * but also set a 64-bit value held in the TCB of the task being blocked or
+ * unblocked, for the event bits that do not fit in the event list item value.
+ * ullTaskGetEventValue64() returns the value of the task that owns
+ * pxEventListItem, and ullTaskResetEventValue64() returns the calling task's
+ * value and clears it.
+ */
+#if( configUSE_64_BIT_EVENT_GROUPS == 1 )
+	void vTaskPlaceOnUnorderedEventList64( List_t * pxEventList, const TickType_t xItemValue, const uint64_t ullEventValue, const TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+	void vTaskRemoveFromUnorderedEventList64( ListItem_t * pxEventListItem, const TickType_t xItemValue, const uint64_t ullEventValue ) PRIVILEGED_FUNCTION;
+	uint64_t ullTaskGetEventValue64( const ListItem_t * pxEventListItem ) PRIVILEGED_FUNCTION;
+	uint64_t ullTaskResetEventValue64( void ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Return the handle of the calling task.
  */
@@ -2342,6 +2377,14 @@ eSleepModeStatus eTaskConfirmSleepModeStatus( void ) PRIVILEGED_FUNCTION;
  */
 void *pvTaskIncrementMutexHeldCount( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * For internal use only.  Decrement the mutex held count of the calling task
+ * when it has given back a fast mutex without entering a critical section.  A
+ * critical section is only entered if the task must also disinherit a
+ * priority.  Returns pdTRUE if a context switch is required.
+ */
+BaseType_t xTaskDecrementMutexHeldCount( void ) PRIVILEGED_FUNCTION;
+
 /*
  * For internal use only.  Same as vTaskSetTimeOutState(), but without a critial
  * section.
@@ -0,0 +1,360 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A topic delivers each message published to it to every task that has
+ * subscribed to it, without copying the message.
+ *
+ * The publisher takes a message buffer from the topic's pool with
+ * pvTopicAllocMessage(), writes the message into it once, and publishes it
+ * with uxTopicPublish() or uxTopicPublishFromISR().  Each subscriber has its
+ * own inbox, which is an ordinary queue that carries pointers, so only a
+ * pointer is copied for each subscriber.  Subscribers receive the pointer with
+ * pvTopicReceive() (or xQueueReceive()), read the message in place, and hand
+ * it back with vTopicReleaseMessage().  Every message carries a reference
+ * count, and the buffer returns to the pool when the last subscriber releases
+ * it.  A slow subscriber therefore holds on to buffers, but never holds up the
+ * publisher or the other subscribers.
+ *
+ *  + The message pool is a block pool (see block_pool.h), so taking and
+ *    releasing a message never masks interrupts or suspends the scheduler, and
+ *    can be done from any task or interrupt.
+ *
+ *  + Publishing never blocks.  If the pool is empty pvTopicAllocMessage()
+ *    returns NULL.  If a subscriber's inbox is full that subscriber misses the
+ *    message, and the topic's dropped count is incremented.
+ *
+ *  + The inboxes are created by the application, statically or dynamically,
+ *    with an item size of sizeof( void * ).  A queue should only be the inbox
+ *    of one topic.  A task that subscribes to several topics can wait on all
+ *    of them through a queue set.
+ *
+ * configUSE_TOPIC_BUS and configUSE_BLOCK_POOLS must both be set to 1 in
+ * FreeRTOSConfig.h for the topic API to be available.
+ */
+
+#ifndef TOPIC_BUS_H
+#define TOPIC_BUS_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include topic_bus.h"
+#endif
+
+#include "queue.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * Type by which topics are referenced.  For example, a call to xTopicCreate()
+ * returns a TopicHandle_t variable that can then be used as a parameter to
+ * xTopicSubscribe(), pvTopicAllocMessage(), uxTopicPublish(), etc.
+ */
+typedef void * TopicHandle_t;
+
+/**
+ * The number of bytes in front of each message that hold its reference count.
+ */
+#define topicMESSAGE_HEADER_SIZE ( ( ( sizeof( uint32_t ) + sizeof( void * ) ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/**
+ * The size of each block in a topic's message pool, and the number of bytes
+ * of storage needed by a topic created with xTopicCreateStatic().
+ */
+#define topicBLOCK_SIZE( xMessageSize ) ( topicMESSAGE_HEADER_SIZE + ( ( ( size_t ) ( xMessageSize ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) ) )
+#define topicSTORAGE_SIZE( xMessageSize, uxMessageCount, uxMaxSubscribers ) ( ( topicBLOCK_SIZE( xMessageSize ) * ( size_t ) ( uxMessageCount ) ) + ( ( size_t ) ( uxMaxSubscribers ) * sizeof( QueueHandle_t ) ) )
+
+/**
+ * topic_bus.h
+ *
+<pre>
+TopicHandle_t xTopicCreate( size_t xMessageSize,
+                            UBaseType_t uxMessageCount,
+                            UBaseType_t uxMaxSubscribers );
+</pre>
+ *
+ * Creates a topic with a pool of uxMessageCount message buffers of
+ * xMessageSize bytes each, to which up to uxMaxSubscribers inboxes can
+ * subscribe.  The memory is taken from the FreeRTOS heap.
+ *
+ * uxMessageCount should allow for every message that can be waiting in an
+ * inbox or being read by a subscriber at the same time, plus the messages the
+ * publishers are filling in.
+ *
+ * @return The handle of the created topic, or NULL if the memory could not be
+ * allocated.
+ *
+ * \defgroup xTopicCreate xTopicCreate
+ * \ingroup TopicManagement
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	TopicHandle_t xTopicCreate( size_t xMessageSize, UBaseType_t uxMessageCount, UBaseType_t uxMaxSubscribers ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * topic_bus.h
+ *
+<pre>
+TopicHandle_t xTopicCreateStatic( size_t xMessageSize,
+                                  UBaseType_t uxMessageCount,
+                                  UBaseType_t uxMaxSubscribers,
+                                  uint8_t *pucTopicStorageArea,
+                                  StaticTopic_t *pxStaticTopic );
+</pre>
+ *
+ * Creates a topic using statically allocated memory.
+ *
+ * @param pucTopicStorageArea Must point to a portBYTE_ALIGNMENT aligned array
+ * of at least topicSTORAGE_SIZE( xMessageSize, uxMessageCount,
+ * uxMaxSubscribers ) bytes, which holds the message pool and the table of
+ * subscribers.
+ *
+ * @param pxStaticTopic Must point to a variable of type StaticTopic_t, which
+ * will be used to hold the topic's data structure.
+ *
+ * @return The handle of the created topic, or NULL if either pointer was NULL.
+ *
+ * Example use:
+<pre>
+typedef struct
+{
+    TickType_t xTimeStamp;
+    int16_t sAcceleration[ 3 ];
+} Sample_t;
+
+#define SAMPLE_BUFFERS      8
+#define SAMPLE_SUBSCRIBERS  3
+
+static uint8_t ucSampleTopicStorage[ topicSTORAGE_SIZE( sizeof( Sample_t ), SAMPLE_BUFFERS, SAMPLE_SUBSCRIBERS ) ] __attribute__( ( aligned( 8 ) ) );
+static StaticTopic_t xSampleTopicStruct;
+TopicHandle_t xSampleTopic;
+
+void vCreateSampleTopic( void )
+{
+    xSampleTopic = xTopicCreateStatic( sizeof( Sample_t ), SAMPLE_BUFFERS, SAMPLE_SUBSCRIBERS,
+                                       ucSampleTopicStorage, &xSampleTopicStruct );
+}
+
+// The sensor interrupt fills in one sample and publishes it to every
+// subscriber.
+void EXTI0_IRQHandler( void )
+{
+Sample_t *pxSample;
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    pxSample = ( Sample_t * ) pvTopicAllocMessage( xSampleTopic );
+
+    if( pxSample != NULL )
+    {
+        pxSample->xTimeStamp = xTaskGetTickCountFromISR();
+        // ... Read the sensor into pxSample->sAcceleration ...
+        ( void ) uxTopicPublishFromISR( xSampleTopic, pxSample, &xHigherPriorityTaskWoken );
+    }
+
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
+// Each consumer reads the same buffer, and releases it when done.
+void vLoggerTask( void *pvParameters )
+{
+QueueHandle_t xInbox = xQueueCreate( 4, sizeof( void * ) );
+const Sample_t *pxSample;
+
+    xTopicSubscribe( xSampleTopic, xInbox );
+
+    for( ;; )
+    {
+        pxSample = ( const Sample_t * ) pvTopicReceive( xInbox, portMAX_DELAY );
+
+        if( pxSample != NULL )
+        {
+            // ... Log the sample ...
+            vTopicReleaseMessage( pxSample );
+        }
+    }
+}
+</pre>
+ * \defgroup xTopicCreateStatic xTopicCreateStatic
+ * \ingroup TopicManagement
+ */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	TopicHandle_t xTopicCreateStatic( size_t xMessageSize,
+									  UBaseType_t uxMessageCount,
+									  UBaseType_t uxMaxSubscribers,
+									  uint8_t * const pucTopicStorageArea,
+									  StaticTopic_t * const pxStaticTopic ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * topic_bus.h
+ *
+<pre>
+void vTopicDelete( TopicHandle_t xTopic );
+</pre>
+ *
+ * Deletes a topic.  Every message must have been released first.  The inboxes
+ * belong to the application and are not deleted.
+ *
+ * \defgroup vTopicDelete vTopicDelete
+ * \ingroup TopicManagement
+ */
+void vTopicDelete( TopicHandle_t xTopic ) PRIVILEGED_FUNCTION;
+
+/**
+ * topic_bus.h
+ *
+<pre>
+BaseType_t xTopicSubscribe( TopicHandle_t xTopic, QueueHandle_t xInbox );
+BaseType_t xTopicUnsubscribe( TopicHandle_t xTopic, QueueHandle_t xInbox );
+</pre>
+ *
+ * Adds xInbox to, or removes it from, the inboxes every message published to
+ * the topic is sent to.  xInbox must be a queue with an item size of
+ * sizeof( void * ).  Must not be called from an interrupt.
+ *
+ * A message being published by an interrupt at the same time as xInbox is
+ * unsubscribed can still arrive in xInbox, so a task that unsubscribes should
+ * drain its inbox afterwards, releasing each message it finds.
+ *
+ * @return xTopicSubscribe() returns pdFAIL if the topic already has its
+ * maximum number of subscribers.  xTopicUnsubscribe() returns pdFAIL if xInbox
+ * was not subscribed.  Otherwise pdPASS is returned.
+ *
+ * \defgroup xTopicSubscribe xTopicSubscribe
+ * \ingroup TopicManagement
+ */
+BaseType_t xTopicSubscribe( TopicHandle_t xTopic, QueueHandle_t xInbox ) PRIVILEGED_FUNCTION;
+BaseType_t xTopicUnsubscribe( TopicHandle_t xTopic, QueueHandle_t xInbox ) PRIVILEGED_FUNCTION;
+
+/**
+ * topic_bus.h
+ *
+<pre>
+void *pvTopicAllocMessage( TopicHandle_t xTopic );
+</pre>
+ *
+ * Takes a message buffer of the size given when the topic was created from
+ * the topic's pool.  Can be called from a task or from any interrupt, and
+ * never blocks.  The buffer belongs to the caller until it is passed to
+ * uxTopicPublish(), uxTopicPublishFromISR() or vTopicReleaseMessage().
+ *
+ * @return A pointer to the buffer, aligned to portBYTE_ALIGNMENT, or NULL if
+ * every buffer is in use.
+ *
+ * \defgroup pvTopicAllocMessage pvTopicAllocMessage
+ * \ingroup TopicManagement
+ */
+void *pvTopicAllocMessage( TopicHandle_t xTopic ) PRIVILEGED_FUNCTION;
+
+/**
+ * topic_bus.h
+ *
+<pre>
+UBaseType_t uxTopicPublish( TopicHandle_t xTopic, void *pvMessage );
+UBaseType_t uxTopicPublishFromISR( TopicHandle_t xTopic, void *pvMessage, BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Sends a pointer to pvMessage to the inbox of every subscriber, without
+ * blocking.  pvMessage must have been obtained from pvTopicAllocMessage() on
+ * the same topic, and must not be used by the publisher once this function has
+ * been called, as the last subscriber to release it may already have returned
+ * it to the pool.  If no inbox accepted the message it is returned to the pool
+ * straight away.
+ *
+ * @param pxHigherPriorityTaskWoken uxTopicPublishFromISR() sets
+ * *pxHigherPriorityTaskWoken to pdTRUE if delivering the message unblocked a
+ * subscriber that has a priority above the task that was interrupted.
+ *
+ * @return The number of inboxes the message was delivered to.
+ *
+ * \defgroup uxTopicPublish uxTopicPublish
+ * \ingroup TopicManagement
+ */
+UBaseType_t uxTopicPublish( TopicHandle_t xTopic, void *pvMessage ) PRIVILEGED_FUNCTION;
+UBaseType_t uxTopicPublishFromISR( TopicHandle_t xTopic, void *pvMessage, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * topic_bus.h
+ *
+<pre>
+void *pvTopicReceive( QueueHandle_t xInbox, TickType_t xTicksToWait );
+</pre>
+ *
+ * Waits up to xTicksToWait ticks for a message to arrive in the subscriber's
+ * inbox.  Equivalent to receiving a pointer from xInbox with xQueueReceive().
+ *
+ * @return A pointer to the message, which must be passed to
+ * vTopicReleaseMessage() once it has been read, or NULL if no message arrived
+ * in time.
+ *
+ * \defgroup pvTopicReceive pvTopicReceive
+ * \ingroup TopicManagement
+ */
+void *pvTopicReceive( QueueHandle_t xInbox, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * topic_bus.h
+ *
+<pre>
+void vTopicReleaseMessage( const void *pvMessage );
+</pre>
+ *
+ * Drops the caller's reference to a message, returning the buffer to its
+ * topic's pool if that was the last reference.  Called by each subscriber once
+ * it has finished with a message, and by a publisher that allocated a message
+ * but decided not to publish it.  Can be called from a task or from any
+ * interrupt.
+ *
+ * \defgroup vTopicReleaseMessage vTopicReleaseMessage
+ * \ingroup TopicManagement
+ */
+void vTopicReleaseMessage( const void *pvMessage ) PRIVILEGED_FUNCTION;
+
+/**
+ * topic_bus.h
+ *
+<pre>
+UBaseType_t uxTopicGetFreeMessages( TopicHandle_t xTopic );
+uint32_t ulTopicGetDroppedCount( TopicHandle_t xTopic );
+</pre>
+ *
+ * Return the number of message buffers left in the topic's pool, and the
+ * number of times a subscriber missed a message because its inbox was full.
+ *
+ * \defgroup ulTopicGetDroppedCount ulTopicGetDroppedCount
+ * \ingroup TopicManagement
+ */
+UBaseType_t uxTopicGetFreeMessages( TopicHandle_t xTopic ) PRIVILEGED_FUNCTION;
+uint32_t ulTopicGetDroppedCount( TopicHandle_t xTopic ) PRIVILEGED_FUNCTION;
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( TOPIC_BUS_H ) */
@@ -0,0 +1,335 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "object_registry.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* This entire source file will be skipped if the application is not configured
+to include object registry functionality. */
+#if( configUSE_OBJECT_REGISTRY == 1 )
+
+#if( configOBJECT_REGISTRY_SIZE < 1 )
+	#error configOBJECT_REGISTRY_SIZE must be at least 1 when configUSE_OBJECT_REGISTRY is set to 1
+#endif
+
+/* Entries are linked to each other by index.  A link holds one more than the
+index of the entry it refers to, so that 0 can mark the end of a chain and the
+zero initialised tables below need no initialisation at run time. */
+#define orEND_OF_CHAIN	( ( UBaseType_t ) 0 )
+
+/*-----------------------------------------------------------*/
+
+/* One entry in the registry.  The type and field names are kept simple so a
+kernel aware debugger can read the xObjectRegistry array directly - a NULL
+pvObject member marks an unused entry. */
+typedef struct xOBJECT_REGISTRY_ITEM /*lint !e9058 Style convention uses tag. */
+{
+	void *pvObject;				/* The handle of the registered object, or NULL if the entry is free. */
+	const char *pcName;			/* The name of the registered object. */ /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+	UBaseType_t uxNextByObject;	/* Link to the next entry whose handle hashes to the same bucket.  Links free entries together while the entry is free. */
+	UBaseType_t uxNextByName;	/* Link to the next entry whose name hashes to the same bucket. */
+	uint8_t ucType;				/* The eObjectType of the registered object. */
+} ObjectRegistryItem_t;
+
+/* The registry entries, and the heads of the hash chains.  Both hash tables
+have as many buckets as there are entries, so on average a chain holds at most
+one entry. */
+PRIVILEGED_DATA ObjectRegistryItem_t xObjectRegistry[ configOBJECT_REGISTRY_SIZE ];
+PRIVILEGED_DATA static UBaseType_t uxObjectBuckets[ configOBJECT_REGISTRY_SIZE ];
+PRIVILEGED_DATA static UBaseType_t uxNameBuckets[ configOBJECT_REGISTRY_SIZE ];
+
+/* Entries that have been used and freed again are linked into a free list.
+Entries from uxItemsUsed onwards have never been used. */
+PRIVILEGED_DATA static UBaseType_t uxFreeItems = orEND_OF_CHAIN;
+PRIVILEGED_DATA static UBaseType_t uxItemsUsed = ( UBaseType_t ) 0;
+
+/*
+ * Return the bucket that the handle pvObject, or the name pcName, hashes to.
+ */
+static UBaseType_t prvHashObject( const void *pvObject ) PRIVILEGED_FUNCTION;
+static UBaseType_t prvHashName( const char *pcName ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+
+/*
+ * Return a pointer to the link that refers to the entry for pvObject - either
+ * the head of its bucket or the uxNextByObject member of the entry before it.
+ * The link holds orEND_OF_CHAIN if pvObject is not registered.
+ */
+static UBaseType_t *prvFindObjectLink( const void *pvObject ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unlink the entry that *puxObjectLink refers to from both of its hash chains
+ * and place it on the free list.
+ */
+static void prvRemoveItem( UBaseType_t * const puxObjectLink ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xObjectRegistryAdd( void *pvObject, const char *pcName, eObjectType eType ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+{
+UBaseType_t *puxLink, uxItem, uxBucket;
+ObjectRegistryItem_t *pxItem;
+BaseType_t xReturn = pdFAIL;
+
+	configASSERT( pvObject );
+	configASSERT( pcName );
+	configASSERT( eType != eObjectTypeAny );
+
+	/* Only tasks use the registry, so suspending the scheduler is enough to
+	protect it, and interrupts are never masked while the chains are
+	walked. */
+	vTaskSuspendAll();
+	{
+		/* An object that is registered again is given its new name. */
+		puxLink = prvFindObjectLink( pvObject );
+
+		if( *puxLink != orEND_OF_CHAIN )
+		{
+			prvRemoveItem( puxLink );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* Take a free entry, preferring one that has been used before. */
+		if( uxFreeItems != orEND_OF_CHAIN )
+		{
+			uxItem = uxFreeItems;
+			uxFreeItems = xObjectRegistry[ uxItem - ( UBaseType_t ) 1 ].uxNextByObject;
+		}
+		else if( uxItemsUsed < ( UBaseType_t ) configOBJECT_REGISTRY_SIZE )
+		{
+			uxItemsUsed++;
+			uxItem = uxItemsUsed;
+		}
+		else
+		{
+			/* The registry is full. */
+			uxItem = orEND_OF_CHAIN;
+		}
+
+		if( uxItem != orEND_OF_CHAIN )
+		{
+			pxItem = &( xObjectRegistry[ uxItem - ( UBaseType_t ) 1 ] );
+			pxItem->pvObject = pvObject;
+			pxItem->pcName = pcName;
+			pxItem->ucType = ( uint8_t ) eType;
+
+			/* New entries go to the front of their chains, so a name lookup
+			finds the most recently registered object with that name. */
+			uxBucket = prvHashObject( pvObject );
+			pxItem->uxNextByObject = uxObjectBuckets[ uxBucket ];
+			uxObjectBuckets[ uxBucket ] = uxItem;
+
+			uxBucket = prvHashName( pcName );
+			pxItem->uxNextByName = uxNameBuckets[ uxBucket ];
+			uxNameBuckets[ uxBucket ] = uxItem;
+
+			xReturn = pdPASS;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vObjectRegistryRemove( void *pvObject )
+{
+UBaseType_t *puxLink;
+
+	vTaskSuspendAll();
+	{
+		puxLink = prvFindObjectLink( pvObject );
+
+		if( *puxLink != orEND_OF_CHAIN )
+		{
+			prvRemoveItem( puxLink );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+const char *pcObjectRegistryGetName( void *pvObject ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+{
+UBaseType_t *puxLink;
+const char *pcReturn = NULL; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+
+	vTaskSuspendAll();
+	{
+		puxLink = prvFindObjectLink( pvObject );
+
+		if( *puxLink != orEND_OF_CHAIN )
+		{
+			pcReturn = xObjectRegistry[ *puxLink - ( UBaseType_t ) 1 ].pcName;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	return pcReturn;
+}
+/*-----------------------------------------------------------*/
+
+void *pvObjectRegistryFind( const char *pcName, eObjectType eType ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+{
+UBaseType_t uxItem;
+const ObjectRegistryItem_t *pxItem;
+void *pvReturn = NULL;
+
+	configASSERT( pcName );
+
+	vTaskSuspendAll();
+	{
+		for( uxItem = uxNameBuckets[ prvHashName( pcName ) ]; uxItem != orEND_OF_CHAIN; uxItem = pxItem->uxNextByName )
+		{
+			pxItem = &( xObjectRegistry[ uxItem - ( UBaseType_t ) 1 ] );
+
+			if( ( ( eType == eObjectTypeAny ) || ( pxItem->ucType == ( uint8_t ) eType ) ) && ( strcmp( pxItem->pcName, pcName ) == 0 ) )
+			{
+				pvReturn = pxItem->pvObject;
+				break;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvHashObject( const void *pvObject )
+{
+uint32_t ulHash;
+
+	/* Handles are the addresses of word aligned structures, so the low bits
+	carry no information.  Fibonacci hashing spreads the rest of the address
+	across the bits that are kept. */
+	ulHash = ( uint32_t ) ( ( portPOINTER_SIZE_TYPE ) pvObject ) >> 2;
+	ulHash *= 2654435761UL;
+
+	return ( UBaseType_t ) ( ( ulHash >> 16 ) % ( uint32_t ) configOBJECT_REGISTRY_SIZE );
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvHashName( const char *pcName ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+{
+uint32_t ulHash = 2166136261UL;
+
+	/* 32-bit FNV-1a. */
+	while( *pcName != ( char ) 0x00 )
+	{
+		ulHash ^= ( uint32_t ) ( uint8_t ) *pcName;
+		ulHash *= 16777619UL;
+		pcName++;
+	}
+
+	return ( UBaseType_t ) ( ulHash % ( uint32_t ) configOBJECT_REGISTRY_SIZE );
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t *prvFindObjectLink( const void *pvObject )
+{
+UBaseType_t *puxLink;
+
+	puxLink = &( uxObjectBuckets[ prvHashObject( pvObject ) ] );
+
+	while( *puxLink != orEND_OF_CHAIN )
+	{
+		if( xObjectRegistry[ *puxLink - ( UBaseType_t ) 1 ].pvObject == pvObject )
+		{
+			break;
+		}
+		else
+		{
+			puxLink = &( xObjectRegistry[ *puxLink - ( UBaseType_t ) 1 ].uxNextByObject );
+		}
+	}
+
+	return puxLink;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveItem( UBaseType_t * const puxObjectLink )
+{
+UBaseType_t uxItem = *puxObjectLink;
+ObjectRegistryItem_t * const pxItem = &( xObjectRegistry[ uxItem - ( UBaseType_t ) 1 ] );
+UBaseType_t *puxNameLink;
+
+	/* Unlink the entry from its handle chain. */
+	*puxObjectLink = pxItem->uxNextByObject;
+
+	/* Find and unlink the entry from its name chain. */
+	puxNameLink = &( uxNameBuckets[ prvHashName( pxItem->pcName ) ] );
+
+	while( *puxNameLink != uxItem )
+	{
+		configASSERT( *puxNameLink != orEND_OF_CHAIN );
+		puxNameLink = &( xObjectRegistry[ *puxNameLink - ( UBaseType_t ) 1 ].uxNextByName );
+	}
+
+	*puxNameLink = pxItem->uxNextByName;
+
+	/* Free the entry. */
+	pxItem->pvObject = NULL;
+	pxItem->pcName = NULL;
+	pxItem->uxNextByObject = uxFreeItems;
+	uxFreeItems = uxItem;
+}
+
+/* This entire source file will be skipped if the application is not configured
+to include object registry functionality. */
+#endif /* configUSE_OBJECT_REGISTRY == 1 */
@@ -234,6 +234,41 @@ portFORCE_INLINE static void vPortSetBASEPRI( uint32_t ulNewMaskValue )
 }
 /*-----------------------------------------------------------*/
 
+/* Atomically replace *pulDestination with ulExchange if, and only if, it still
+holds ulComparand.  Uses the LDREX/STREX exclusive monitor so interrupts are
+never masked.  The monitor is cleared on every exception entry and return, so
+an interrupt that touches the same word between the LDREX and the STREX makes
+the STREX fail and the sequence is retried.  Returns pdTRUE if the swap was
+performed. */
+portFORCE_INLINE static BaseType_t xPortCompareAndSwap32( volatile uint32_t *pulDestination, uint32_t ulExchange, uint32_t ulComparand )
+{
+uint32_t ulCurrent, ulStoreFailed;
+
+	do
+	{
+		__asm volatile( "ldrex %0, [%1]" : "=r" ( ulCurrent ) : "r" ( pulDestination ) : "memory" );
+
+		if( ulCurrent != ulComparand )
+		{
+			__asm volatile( "clrex" ::: "memory" );
+			return pdFALSE;
+		}
+
+		__asm volatile( "strex %0, %2, [%1]" : "=&r" ( ulStoreFailed ) : "r" ( pulDestination ), "r" ( ulExchange ) : "memory" );
+
+	} while( ulStoreFailed != 0UL );
+
+	return pdTRUE;
+}
+
+#define portCOMPARE_AND_SWAP_32( pulDestination, ulExchange, ulComparand ) xPortCompareAndSwap32( ( pulDestination ), ( ulExchange ), ( ulComparand ) )
+
+/* The Cortex-M4 is a single in-order core, and interrupts observe memory
+accesses in program order, so only the compiler needs to be stopped from
+reordering accesses across the barrier. */
+#define portMEMORY_BARRIER() __asm volatile( "" ::: "memory" )
+/*-----------------------------------------------------------*/
+
 
 #ifdef __cplusplus
 }
@@ -209,6 +209,11 @@ void *pvReturn = NULL;
 
 					xFreeBytesRemaining -= pxBlock->xBlockSize;
 
+					/* Trace the size of the block actually granted, BlockLink_t
+					included, as traceFREE() does.  It is larger than the
+					wanted size when the remainder was too small to split off. */
+					xWantedSize = pxBlock->xBlockSize;
+
 					if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
 					{
 						xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
@@ -370,6 +375,10 @@ size_t xTotalHeapSize = configTOTAL_HEAP_SIZE;
 	xMinimumEverFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
 	xFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
 
+	/* Let a trace recorder know where the heap lives so it can rebuild the
+	heap layout from the traceMALLOC() and traceFREE() events. */
+	traceHEAP_INIT( pucAlignedHeap, pxFirstFreeBlock->xBlockSize );
+
 	/* Work out the position of the top bit in a size_t variable. */
 	xBlockAllocatedBit = ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 );
 }
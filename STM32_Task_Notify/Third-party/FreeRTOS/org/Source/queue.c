@@ -37,6 +37,7 @@ task.h is included from an application file. */
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
+#include "object_registry.h"
 
 #if ( configUSE_CO_ROUTINES == 1 )
 	#include "croutine.h"
@@ -52,6 +53,7 @@ privileged Vs unprivileged linkage and placement. */
 /* Constants used with the cRxLock and cTxLock structure members. */
 #define queueUNLOCKED					( ( int8_t ) -1 )
 #define queueLOCKED_UNMODIFIED			( ( int8_t ) 0 )
+#define queueMAX_LOCK_COUNT				( ( int8_t ) 127 )
 
 /* When the Queue_t structure is used to represent a base queue its pcHead and
 pcTail members are used as pointers into the queue storage area.  When the
@@ -73,6 +75,95 @@ zero. */
 #define queueSEMAPHORE_QUEUE_ITEM_LENGTH ( ( UBaseType_t ) 0 )
 #define queueMUTEX_GIVE_BLOCK_TIME		 ( ( TickType_t ) 0U )
 
+/* While a slot is lent to a sender the queue looks full to every other sender,
+and while a slot is lent to a receiver the queue looks empty to every other
+receiver.  This keeps items in FIFO order without having to track more than
+one outstanding loan in each direction. */
+#if( configUSE_QUEUE_LOANS == 1 )
+	#define queueWRITE_SLOT_IS_ON_LOAN( pxQueue ) ( ( pxQueue )->pcWriteLoan != NULL )
+	#define queueREAD_SLOT_IS_ON_LOAN( pxQueue )  ( ( pxQueue )->pcReadLoan != NULL )
+#else
+	#define queueWRITE_SLOT_IS_ON_LOAN( pxQueue ) pdFALSE
+	#define queueREAD_SLOT_IS_ON_LOAN( pxQueue )  pdFALSE
+#endif
+
+/* Sending to the front of the queue writes into the slot in front of the
+oldest item, which is the slot lent out when the queue has only one free space
+or holds a single item.  Only sending to the back is safe while a receiver
+holds a slot.  Overwriting is only possible on a queue of length one, which
+cannot lend slots at all, so xQueueOverwrite() always finds the queue free of
+loans and keeps its guarantee that it cannot fail. */
+#define queueLOAN_BLOCKS_SEND( pxQueue, xCopyPosition ) \
+	( ( queueWRITE_SLOT_IS_ON_LOAN( pxQueue ) != pdFALSE ) || ( ( ( xCopyPosition ) != queueSEND_TO_BACK ) && ( queueREAD_SLOT_IS_ON_LOAN( pxQueue ) != pdFALSE ) ) )
+
+/* Copies one item into or out of the queue storage area.  Most queues carry
+pointers or 32-bit values, so when configUSE_QUEUE_WORD_COPY is 1 a word sized
+item is copied with a memcpy() whose size is a compile time constant, which the
+compiler turns into a single load and store, rather than through a call to
+memcpy() with a size that is only known at run time.  The item size is checked
+at run time, so every queue benefits without the application doing anything.
+Copying through memcpy() rather than through uint32_t pointers keeps to the
+strict aliasing rules, and leaves it to the compiler to cope with the
+application's buffer, or the storage area passed to xQueueCreateStatic(), not
+being word aligned. */
+#if( configUSE_QUEUE_WORD_COPY == 1 )
+	#define queueCOPY_ITEM( pvDestination, pvSource, uxItemSize )												\
+	{																											\
+		if( ( uxItemSize ) == ( UBaseType_t ) sizeof( uint32_t ) )												\
+		{																										\
+			( void ) memcpy( ( void * ) ( pvDestination ), ( const void * ) ( pvSource ), sizeof( uint32_t ) );	\
+		}																										\
+		else																									\
+		{																										\
+			( void ) memcpy( ( void * ) ( pvDestination ), ( const void * ) ( pvSource ), ( size_t ) ( uxItemSize ) );	\
+		}																										\
+	}
+#else
+	#define queueCOPY_ITEM( pvDestination, pvSource, uxItemSize ) ( void ) memcpy( ( void * ) ( pvDestination ), ( const void * ) ( pvSource ), ( size_t ) ( uxItemSize ) )
+#endif
+
+/* A priority queue stores its items in slots of the normal storage area, but
+hands them out highest priority first, and in the order they were sent within
+a priority.  The slots holding the items of each priority are kept on a singly
+linked FIFO list, and a bitmap records which priorities hold items, so sending
+and receiving are O(1) whatever the number of items queued.  The index is
+placed in front of the item storage, and is laid out as the structure below
+followed by uxLevels head slot numbers, uxLevels tail slot numbers and
+uxLength next slot numbers.  queuePRIORITY_INDEX_SIZE() in queue.h must be kept
+in step with this layout. */
+#if( configUSE_PRIORITY_QUEUES == 1 )
+	typedef struct QueuePriorityIndex
+	{
+		UBaseType_t uxLevels;			/*< The number of priority levels, from 1 to queuePRIORITY_LEVELS_MAX. */
+		UBaseType_t uxReadyLevels;		/*< Bit n is set while priority n holds at least one item. */
+		UBaseType_t uxFreeSlot;			/*< The first slot on the list of unused slots. */
+	} QueuePriorityIndex_t;
+
+	#define queuePRIORITY_NO_SLOT			( ~( UBaseType_t ) 0 )
+	#define queuePRIORITY_HEADS( pxIndex )	( ( UBaseType_t * ) ( ( pxIndex ) + 1 ) )
+	#define queuePRIORITY_TAILS( pxIndex )	( queuePRIORITY_HEADS( pxIndex ) + ( pxIndex )->uxLevels )
+	#define queuePRIORITY_LINKS( pxIndex )	( queuePRIORITY_TAILS( pxIndex ) + ( pxIndex )->uxLevels )
+	#define queueIS_PRIORITY_QUEUE( pxQueue ) ( ( pxQueue )->pxPriorityIndex != NULL )
+
+	/* Finds the highest priority that holds an item, so is only valid while
+	the queue is not empty.  Uses the same count leading zeros instruction the
+	scheduler uses on its ready list bitmap if the port provides one. */
+	#if( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+		#define queueGET_HIGHEST_LEVEL( uxLevel, pxIndex ) portGET_HIGHEST_PRIORITY( uxLevel, ( pxIndex )->uxReadyLevels )
+	#else
+		#define queueGET_HIGHEST_LEVEL( uxLevel, pxIndex )														\
+		{																										\
+			( uxLevel ) = ( pxIndex )->uxLevels - ( UBaseType_t ) 1;											\
+			while( ( ( pxIndex )->uxReadyLevels & ( ( UBaseType_t ) 1 << ( uxLevel ) ) ) == ( UBaseType_t ) 0 )	\
+			{																									\
+				--( uxLevel );																					\
+			}																									\
+		}
+	#endif
+#else
+	#define queueIS_PRIORITY_QUEUE( pxQueue ) pdFALSE
+#endif
+
 #if( configUSE_PREEMPTION == 0 )
 	/* If the cooperative scheduler is being used then a yield should not be
 	performed just because a higher priority task has been woken. */
@@ -121,6 +212,20 @@ typedef struct QueueDefinition
 		uint8_t ucQueueType;
 	#endif
 
+	#if ( configUSE_QUEUE_LOANS == 1 )
+		int8_t *pcWriteLoan;		/*< Points to the slot lent out by pvQueueLoanWriteSlot(), or NULL if no slot is on loan to a sender. */
+		int8_t *pcReadLoan;			/*< Points to the slot lent out by pvQueueLoanReadSlot(), or NULL if no slot is on loan to a receiver. */
+	#endif
+
+	#if ( configUSE_PRIORITY_QUEUES == 1 )
+		QueuePriorityIndex_t *pxPriorityIndex;	/*< Points to the index that orders the items of a queue created by xQueueCreatePriority(), or NULL for any other queue. */
+	#endif
+
+	#if ( configUSE_QUEUE_STATISTICS == 1 )
+		struct QueueDefinition *pxNextQueue;	/*< The next queue in the list of all queues that uxQueueGetSystemState() walks. */
+		QueueStats_t xStats;					/*< Counters updated as the queue is used.  See QueueStats_t in queue.h. */
+	#endif
+
 } xQUEUE;
 
 /* The old xQUEUE name is maintained above then typedefed to the new Queue_t
@@ -132,8 +237,10 @@ typedef xQUEUE Queue_t;
 /*
  * The queue registry is just a means for kernel aware debuggers to locate
  * queue structures.  It has no other purpose so is an optional component.
+ * When configUSE_OBJECT_REGISTRY is 1 queues are held in the object registry
+ * instead.
  */
-#if ( configQUEUE_REGISTRY_SIZE > 0 )
+#if ( ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configUSE_OBJECT_REGISTRY == 0 ) )
 
 	/* The type stored within the queue registry array.  This allows a name
 	to be assigned to each queue making kernel aware debugging a little
@@ -154,7 +261,22 @@ typedef xQUEUE Queue_t;
 	array position being vacant. */
 	PRIVILEGED_DATA QueueRegistryItem_t xQueueRegistry[ configQUEUE_REGISTRY_SIZE ];
 
-#endif /* configQUEUE_REGISTRY_SIZE */
+#endif /* ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configUSE_OBJECT_REGISTRY == 0 ) */
+
+#if ( configUSE_QUEUE_STATISTICS == 1 )
+
+	/* Every queue, semaphore and mutex that has been created and not deleted,
+	most recently created first, and how many there are.  Only tasks create and
+	delete queues, so a task that holds either the scheduler suspended or a
+	critical section has the list to itself.  Walking the list suspends the
+	scheduler, as the walk is not bounded, but a queue is linked in within a
+	critical section, as queues can be created from inside one - the timer
+	service queue is created by prvCheckForValidListAndQueue() in timers.c, for
+	example - and the scheduler must not be suspended and resumed there. */
+	PRIVILEGED_DATA static Queue_t *pxQueueList = NULL;
+	PRIVILEGED_DATA static UBaseType_t uxQueueCount = ( UBaseType_t ) 0U;
+
+#endif /* configUSE_QUEUE_STATISTICS */
 
 /*
  * Unlocks a queue locked by a call to prvLockQueue.  Locking a queue does not
@@ -191,6 +313,12 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue, const void *pvIte
  */
 static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer ) PRIVILEGED_FUNCTION;
 
+/*
+ * Copies the item that would be received next out of a queue without removing
+ * it from the queue.
+ */
+static void prvPeekDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer ) PRIVILEGED_FUNCTION;
+
 #if ( configUSE_QUEUE_SETS == 1 )
 	/*
 	 * Checks to see if a queue is a member of a queue set, and if so, notifies
@@ -224,6 +352,69 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 	 */
 	static UBaseType_t prvGetDisinheritPriorityAfterTimeout( const Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
 #endif
+
+#if( ( configUSE_QUEUE_LOANS == 1 ) || ( configUSE_QUEUE_BATCHES == 1 ) )
+	/*
+	 * Unblocks up to uxMaxToUnblock of the tasks on pxEventList, highest
+	 * priority first.  Returns pdTRUE if one of them has a higher priority than
+	 * the running task.  Must be called with interrupts masked and the queue
+	 * unlocked.
+	 */
+	static BaseType_t prvUnblockQueueWaiters( List_t * const pxEventList, UBaseType_t uxMaxToUnblock ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Called after uxItemCount items have been added to the back of the queue
+	 * without going through prvCopyDataToQueue().  Posts to the queue set the
+	 * queue is a member of, if any, otherwise unblocks up to uxItemCount
+	 * receivers.  Returns pdTRUE if a higher priority task was unblocked.
+	 */
+	static BaseType_t prvNotifyItemsAdded( Queue_t * const pxQueue, UBaseType_t uxItemCount ) PRIVILEGED_FUNCTION;
+#endif
+
+#if( configUSE_QUEUE_BATCHES == 1 )
+	/*
+	 * Copy uxItemCount items into, or out of, the queue storage area with at
+	 * most two calls to memcpy(), and update the read or write position and the
+	 * number of items in the queue.  The caller must have checked there is
+	 * enough space, or enough items.
+	 */
+	static void prvCopyItemsToQueue( Queue_t * const pxQueue, const int8_t *pcItems, const UBaseType_t uxItemCount ) PRIVILEGED_FUNCTION;
+	static void prvCopyItemsFromQueue( Queue_t * const pxQueue, int8_t *pcBuffer, const UBaseType_t uxItemCount ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Adds uxItemCount to the cTxLock or cRxLock value cLockCount, saturating
+	 * at queueMAX_LOCK_COUNT instead of overflowing.
+	 */
+	static int8_t prvAddToLockCount( const int8_t cLockCount, const UBaseType_t uxItemCount ) PRIVILEGED_FUNCTION;
+#endif
+
+#if( configUSE_PRIORITY_QUEUES == 1 )
+	/*
+	 * Called after the memory for a priority queue has been allocated, either
+	 * statically or dynamically.  pucQueueStorage points to the index, which is
+	 * followed by the item storage.
+	 */
+	static void prvInitialisePriorityQueue( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize, const UBaseType_t uxPriorityLevels, uint8_t *pucQueueStorage, Queue_t *pxNewQueue ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Marks every slot of a priority queue as unused.
+	 */
+	static void prvResetPriorityIndex( Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Copies an item into a free slot of a priority queue and links the slot
+	 * onto the list for the priority encoded in xPosition.  queueSEND_TO_BACK
+	 * and queueOVERWRITE use the lowest priority, and queueSEND_TO_FRONT places
+	 * the item in front of the item that would be received next.
+	 */
+	static void prvAddPriorityItem( Queue_t * const pxQueue, const void *pvItemToQueue, const BaseType_t xPosition ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Copies the oldest item of the highest priority out of a priority queue,
+	 * and frees its slot unless xJustPeeking is pdTRUE.
+	 */
+	static void prvRemovePriorityItem( Queue_t * const pxQueue, void * const pvBuffer, const BaseType_t xJustPeeking ) PRIVILEGED_FUNCTION;
+#endif
 /*-----------------------------------------------------------*/
 
 /*
@@ -245,6 +436,65 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 	taskEXIT_CRITICAL()
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_QUEUE_STATISTICS == 1 )
+
+	/* Record that uxItems items were added to, or removed from, the queue.
+	Called after uxMessagesWaiting has been updated, from within a critical
+	section or with interrupts masked. */
+	#define queueSTATS_ITEMS_SENT( pxQueue, uxItems )										\
+	{																						\
+		( pxQueue )->xStats.ulSendCount += ( uint32_t ) ( uxItems );						\
+		if( ( pxQueue )->uxMessagesWaiting > ( pxQueue )->xStats.uxMaxMessagesWaiting )	\
+		{																					\
+			( pxQueue )->xStats.uxMaxMessagesWaiting = ( pxQueue )->uxMessagesWaiting;		\
+		}																					\
+	}
+	#define queueSTATS_ITEMS_RECEIVED( pxQueue, uxItems ) ( pxQueue )->xStats.ulReceiveCount += ( uint32_t ) ( uxItems )
+
+	/* Record a send that failed because the queue was full.  The _FROM_TASK
+	version is used where interrupts are not already masked, as an interrupt
+	can update the same counter. */
+	#define queueSTATS_SEND_FAILED( pxQueue ) ( ( pxQueue )->xStats.ulSendFailCount )++
+	#define queueSTATS_SEND_FAILED_FROM_TASK( pxQueue )	\
+		do												\
+		{												\
+			taskENTER_CRITICAL();						\
+			{											\
+				queueSTATS_SEND_FAILED( pxQueue );		\
+			}											\
+			taskEXIT_CRITICAL();						\
+		} while( 0 )
+
+	/* Used around the yield in the blocking paths to add the time the calling
+	task spent in the Blocked state to the sender or receiver total.  The
+	scheduler is suspended when the start time is taken, but the tick count
+	catches up when it is resumed, so the time is measured correctly. */
+	#define queueSTATS_BLOCK_START( xBlockStart ) ( xBlockStart ) = xTaskGetTickCount()
+	#define queueSTATS_BLOCK_END( pxQueue, xBlockedTicks, xBlockStart )						\
+		do																					\
+		{																					\
+			taskENTER_CRITICAL();															\
+			{																				\
+				( pxQueue )->xStats.xBlockedTicks += xTaskGetTickCount() - ( xBlockStart );	\
+			}																				\
+			taskEXIT_CRITICAL();															\
+		} while( 0 )
+	#define queueSTATS_SEND_BLOCK_END( pxQueue, xBlockStart ) queueSTATS_BLOCK_END( pxQueue, xSendBlockedTicks, xBlockStart )
+	#define queueSTATS_RECEIVE_BLOCK_END( pxQueue, xBlockStart ) queueSTATS_BLOCK_END( pxQueue, xReceiveBlockedTicks, xBlockStart )
+
+#else
+
+	#define queueSTATS_ITEMS_SENT( pxQueue, uxItems )
+	#define queueSTATS_ITEMS_RECEIVED( pxQueue, uxItems )
+	#define queueSTATS_SEND_FAILED( pxQueue )
+	#define queueSTATS_SEND_FAILED_FROM_TASK( pxQueue )
+	#define queueSTATS_BLOCK_START( xBlockStart )
+	#define queueSTATS_SEND_BLOCK_END( pxQueue, xBlockStart )
+	#define queueSTATS_RECEIVE_BLOCK_END( pxQueue, xBlockStart )
+
+#endif /* configUSE_QUEUE_STATISTICS */
+/*-----------------------------------------------------------*/
+
 BaseType_t xQueueGenericReset( QueueHandle_t xQueue, BaseType_t xNewQueue )
 {
 Queue_t * const pxQueue = ( Queue_t * ) xQueue;
@@ -260,6 +510,27 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 		pxQueue->cRxLock = queueUNLOCKED;
 		pxQueue->cTxLock = queueUNLOCKED;
 
+		#if( configUSE_QUEUE_LOANS == 1 )
+		{
+			/* Resetting the queue cancels any slots that were on loan. */
+			pxQueue->pcWriteLoan = NULL;
+			pxQueue->pcReadLoan = NULL;
+		}
+		#endif
+
+		#if( configUSE_PRIORITY_QUEUES == 1 )
+		{
+			if( pxQueue->pxPriorityIndex != NULL )
+			{
+				prvResetPriorityIndex( pxQueue );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif
+
 		if( xNewQueue == pdFALSE )
 		{
 			/* If there are tasks blocked waiting to read from the queue, then
@@ -430,6 +701,14 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 	defined. */
 	pxNewQueue->uxLength = uxQueueLength;
 	pxNewQueue->uxItemSize = uxItemSize;
+
+	#if( configUSE_PRIORITY_QUEUES == 1 )
+	{
+		/* Set by prvInitialisePriorityQueue() if this is a priority queue. */
+		pxNewQueue->pxPriorityIndex = NULL;
+	}
+	#endif
+
 	( void ) xQueueGenericReset( pxNewQueue, pdTRUE );
 
 	#if ( configUSE_TRACE_FACILITY == 1 )
@@ -444,6 +723,20 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 	}
 	#endif /* configUSE_QUEUE_SETS */
 
+	#if( configUSE_QUEUE_STATISTICS == 1 )
+	{
+		( void ) memset( ( void * ) &( pxNewQueue->xStats ), 0x00, sizeof( pxNewQueue->xStats ) );
+
+		taskENTER_CRITICAL();
+		{
+			pxNewQueue->pxNextQueue = pxQueueList;
+			pxQueueList = pxNewQueue;
+			uxQueueCount++;
+		}
+		taskEXIT_CRITICAL();
+	}
+	#endif /* configUSE_QUEUE_STATISTICS */
+
 	traceQUEUE_CREATE( pxNewQueue );
 }
 /*-----------------------------------------------------------*/
@@ -727,11 +1020,15 @@ BaseType_t xQueueGenericSend( QueueHandle_t xQueue, const void * const pvItemToQ
 {
 BaseType_t xEntryTimeSet = pdFALSE, xYieldRequired;
 TimeOut_t xTimeOut;
+#if( configUSE_QUEUE_STATISTICS == 1 )
+	TickType_t xBlockStart;
+#endif
 Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 
 	configASSERT( pxQueue );
 	configASSERT( !( ( pvItemToQueue == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
 	configASSERT( !( ( xCopyPosition == queueOVERWRITE ) && ( pxQueue->uxLength != 1 ) ) );
+	configASSERT( !( ( xCopyPosition >= queueSEND_WITH_PRIORITY( 0 ) ) && ( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE ) ) );
 	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
 	{
 		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
@@ -750,7 +1047,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 			highest priority task wanting to access the queue.  If the head item
 			in the queue is to be overwritten then it does not matter if the
 			queue is full. */
-			if( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) || ( xCopyPosition == queueOVERWRITE ) )
+			if( ( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) || ( xCopyPosition == queueOVERWRITE ) ) && ( queueLOAN_BLOCKS_SEND( pxQueue, xCopyPosition ) == pdFALSE ) )
 			{
 				traceQUEUE_SEND( pxQueue );
 				xYieldRequired = prvCopyDataToQueue( pxQueue, pvItemToQueue, xCopyPosition );
@@ -847,6 +1144,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 				{
 					/* The queue was full and no block time is specified (or
 					the block time has expired) so leave now. */
+					queueSTATS_SEND_FAILED( pxQueue );
 					taskEXIT_CRITICAL();
 
 					/* Return to the original privilege level before exiting
@@ -882,6 +1180,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 			if( prvIsQueueFull( pxQueue ) != pdFALSE )
 			{
 				traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+				queueSTATS_BLOCK_START( xBlockStart );
 				vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
 
 				/* Unlocking the queue means queue events can effect the
@@ -900,6 +1199,8 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 				{
 					portYIELD_WITHIN_API();
 				}
+
+				queueSTATS_SEND_BLOCK_END( pxQueue, xBlockStart );
 			}
 			else
 			{
@@ -914,6 +1215,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 			prvUnlockQueue( pxQueue );
 			( void ) xTaskResumeAll();
 
+			queueSTATS_SEND_FAILED_FROM_TASK( pxQueue );
 			traceQUEUE_SEND_FAILED( pxQueue );
 			return errQUEUE_FULL;
 		}
@@ -930,6 +1232,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 	configASSERT( pxQueue );
 	configASSERT( !( ( pvItemToQueue == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
 	configASSERT( !( ( xCopyPosition == queueOVERWRITE ) && ( pxQueue->uxLength != 1 ) ) );
+	configASSERT( !( ( xCopyPosition >= queueSEND_WITH_PRIORITY( 0 ) ) && ( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE ) ) );
 
 	/* RTOS ports that support interrupt nesting have the concept of a maximum
 	system call (or maximum API call) interrupt priority.  Interrupts that are
@@ -954,7 +1257,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 	post). */
 	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
 	{
-		if( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) || ( xCopyPosition == queueOVERWRITE ) )
+		if( ( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) || ( xCopyPosition == queueOVERWRITE ) ) && ( queueLOAN_BLOCKS_SEND( pxQueue, xCopyPosition ) == pdFALSE ) )
 		{
 			const int8_t cTxLock = pxQueue->cTxLock;
 
@@ -1063,6 +1366,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 		else
 		{
 			traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+			queueSTATS_SEND_FAILED( pxQueue );
 			xReturn = errQUEUE_FULL;
 		}
 	}
@@ -1131,6 +1435,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 			priority disinheritance is needed.  Simply increase the count of
 			messages (semaphores) available. */
 			pxQueue->uxMessagesWaiting = uxMessagesWaiting + ( UBaseType_t ) 1;
+			queueSTATS_ITEMS_SENT( pxQueue, 1 );
 
 			/* The event list is not altered if the queue is locked.  This will
 			be done when the queue is unlocked later. */
@@ -1228,6 +1533,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 		else
 		{
 			traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+			queueSTATS_SEND_FAILED( pxQueue );
 			xReturn = errQUEUE_FULL;
 		}
 	}
@@ -1241,6 +1547,9 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue, void * const pvBuffer, TickType_
 {
 BaseType_t xEntryTimeSet = pdFALSE;
 TimeOut_t xTimeOut;
+#if( configUSE_QUEUE_STATISTICS == 1 )
+	TickType_t xBlockStart;
+#endif
 Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 
 	/* Check the pointer is not NULL. */
@@ -1270,12 +1579,13 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 
 			/* Is there data in the queue now?  To be running the calling task
 			must be the highest priority task wanting to access the queue. */
-			if( uxMessagesWaiting > ( UBaseType_t ) 0 )
+			if( ( uxMessagesWaiting > ( UBaseType_t ) 0 ) && ( queueREAD_SLOT_IS_ON_LOAN( pxQueue ) == pdFALSE ) )
 			{
 				/* Data available, remove one item. */
 				prvCopyDataFromQueue( pxQueue, pvBuffer );
 				traceQUEUE_RECEIVE( pxQueue );
 				pxQueue->uxMessagesWaiting = uxMessagesWaiting - ( UBaseType_t ) 1;
+				queueSTATS_ITEMS_RECEIVED( pxQueue, 1 );
 
 				/* There is now space in the queue, were any tasks waiting to
 				post to the queue?  If so, unblock the highest priority waiting
@@ -1339,6 +1649,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 			if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
 			{
 				traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+				queueSTATS_BLOCK_START( xBlockStart );
 				vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
 				prvUnlockQueue( pxQueue );
 				if( xTaskResumeAll() == pdFALSE )
@@ -1349,6 +1660,8 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 				{
 					mtCOVERAGE_TEST_MARKER();
 				}
+
+				queueSTATS_RECEIVE_BLOCK_END( pxQueue, xBlockStart );
 			}
 			else
 			{
@@ -1383,6 +1696,9 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue, TickType_t xTicksToWait )
 {
 BaseType_t xEntryTimeSet = pdFALSE;
 TimeOut_t xTimeOut;
+#if( configUSE_QUEUE_STATISTICS == 1 )
+	TickType_t xBlockStart;
+#endif
 Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 
 #if( configUSE_MUTEXES == 1 )
@@ -1425,6 +1741,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 				/* Semaphores are queues with a data size of zero and where the
 				messages waiting is the semaphore's count.  Reduce the count. */
 				pxQueue->uxMessagesWaiting = uxSemaphoreCount - ( UBaseType_t ) 1;
+				queueSTATS_ITEMS_RECEIVED( pxQueue, 1 );
 
 				#if ( configUSE_MUTEXES == 1 )
 				{
@@ -1531,6 +1848,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 				}
 				#endif
 
+				queueSTATS_BLOCK_START( xBlockStart );
 				vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
 				prvUnlockQueue( pxQueue );
 				if( xTaskResumeAll() == pdFALSE )
@@ -1541,6 +1859,8 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 				{
 					mtCOVERAGE_TEST_MARKER();
 				}
+
+				queueSTATS_RECEIVE_BLOCK_END( pxQueue, xBlockStart );
 			}
 			else
 			{
@@ -1602,7 +1922,9 @@ BaseType_t xQueuePeek( QueueHandle_t xQueue, void * const pvBuffer, TickType_t x
 {
 BaseType_t xEntryTimeSet = pdFALSE;
 TimeOut_t xTimeOut;
-int8_t *pcOriginalReadPosition;
+#if( configUSE_QUEUE_STATISTICS == 1 )
+	TickType_t xBlockStart;
+#endif
 Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 
 	/* Check the pointer is not NULL. */
@@ -1632,19 +1954,11 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 
 			/* Is there data in the queue now?  To be running the calling task
 			must be the highest priority task wanting to access the queue. */
-			if( uxMessagesWaiting > ( UBaseType_t ) 0 )
+			if( ( uxMessagesWaiting > ( UBaseType_t ) 0 ) && ( queueREAD_SLOT_IS_ON_LOAN( pxQueue ) == pdFALSE ) )
 			{
-				/* Remember the read position so it can be reset after the data
-				is read from the queue as this function is only peeking the
-				data, not removing it. */
-				pcOriginalReadPosition = pxQueue->u.pcReadFrom;
-
-				prvCopyDataFromQueue( pxQueue, pvBuffer );
+				prvPeekDataFromQueue( pxQueue, pvBuffer );
 				traceQUEUE_PEEK( pxQueue );
 
-				/* The data is not being removed, so reset the read pointer. */
-				pxQueue->u.pcReadFrom = pcOriginalReadPosition;
-
 				/* The data is being left in the queue, so see if there are
 				any other tasks waiting for the data. */
 				if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
@@ -1708,6 +2022,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 			if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
 			{
 				traceBLOCKING_ON_QUEUE_PEEK( pxQueue );
+				queueSTATS_BLOCK_START( xBlockStart );
 				vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
 				prvUnlockQueue( pxQueue );
 				if( xTaskResumeAll() == pdFALSE )
@@ -1718,6 +2033,8 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 				{
 					mtCOVERAGE_TEST_MARKER();
 				}
+
+				queueSTATS_RECEIVE_BLOCK_END( pxQueue, xBlockStart );
 			}
 			else
 			{
@@ -1778,7 +2095,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 		const UBaseType_t uxMessagesWaiting = pxQueue->uxMessagesWaiting;
 
 		/* Cannot block in an ISR, so check there is data available. */
-		if( uxMessagesWaiting > ( UBaseType_t ) 0 )
+		if( ( uxMessagesWaiting > ( UBaseType_t ) 0 ) && ( queueREAD_SLOT_IS_ON_LOAN( pxQueue ) == pdFALSE ) )
 		{
 			const int8_t cRxLock = pxQueue->cRxLock;
 
@@ -1786,6 +2103,7 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 
 			prvCopyDataFromQueue( pxQueue, pvBuffer );
 			pxQueue->uxMessagesWaiting = uxMessagesWaiting - ( UBaseType_t ) 1;
+			queueSTATS_ITEMS_RECEIVED( pxQueue, 1 );
 
 			/* If the queue is locked the event list will not be modified.
 			Instead update the lock count so the task that unlocks the queue
@@ -1843,7 +2161,6 @@ BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue,  void * const pvBuffer )
 {
 BaseType_t xReturn;
 UBaseType_t uxSavedInterruptStatus;
-int8_t *pcOriginalReadPosition;
 Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 
 	configASSERT( pxQueue );
@@ -1869,15 +2186,11 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
 	{
 		/* Cannot block in an ISR, so check there is data available. */
-		if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+		if( ( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 ) && ( queueREAD_SLOT_IS_ON_LOAN( pxQueue ) == pdFALSE ) )
 		{
 			traceQUEUE_PEEK_FROM_ISR( pxQueue );
 
-			/* Remember the read position so it can be reset as nothing is
-			actually being removed from the queue. */
-			pcOriginalReadPosition = pxQueue->u.pcReadFrom;
-			prvCopyDataFromQueue( pxQueue, pvBuffer );
-			pxQueue->u.pcReadFrom = pcOriginalReadPosition;
+			prvPeekDataFromQueue( pxQueue, pvBuffer );
 
 			xReturn = pdPASS;
 		}
@@ -1893,117 +2206,1068 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 }
 /*-----------------------------------------------------------*/
 
-UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue )
-{
-UBaseType_t uxReturn;
-
-	configASSERT( xQueue );
+#if ( configUSE_QUEUE_LOANS == 1 )
 
-	taskENTER_CRITICAL();
+	void *pvQueueLoanWriteSlot( QueueHandle_t xQueue, TickType_t xTicksToWait )
 	{
-		uxReturn = ( ( Queue_t * ) xQueue )->uxMessagesWaiting;
-	}
-	taskEXIT_CRITICAL();
-
-	return uxReturn;
-} /*lint !e818 Pointer cannot be declared const as xQueue is a typedef not pointer. */
-/*-----------------------------------------------------------*/
+	BaseType_t xEntryTimeSet = pdFALSE;
+	TimeOut_t xTimeOut;
+	#if( configUSE_QUEUE_STATISTICS == 1 )
+		TickType_t xBlockStart;
+	#endif
+	void *pvSlot;
+	Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 
-UBaseType_t uxQueueSpacesAvailable( const QueueHandle_t xQueue )
-{
-UBaseType_t uxReturn;
-Queue_t *pxQueue;
+		configASSERT( pxQueue );
 
-	pxQueue = ( Queue_t * ) xQueue;
-	configASSERT( pxQueue );
+		/* Semaphores and mutexes have no storage to lend. */
+		configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
 
-	taskENTER_CRITICAL();
-	{
-		uxReturn = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
-	}
-	taskEXIT_CRITICAL();
+		/* The items of a priority queue are not stored in order. */
+		configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
 
-	return uxReturn;
-} /*lint !e818 Pointer cannot be declared const as xQueue is a typedef not pointer. */
-/*-----------------------------------------------------------*/
+		/* A queue of length one may be used as a mailbox with
+		xQueueOverwrite(), which must always succeed, so its only slot is
+		never lent out. */
+		configASSERT( pxQueue->uxLength > ( UBaseType_t ) 1 );
 
-UBaseType_t uxQueueMessagesWaitingFromISR( const QueueHandle_t xQueue )
-{
-UBaseType_t uxReturn;
+		#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+		{
+			configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+		}
+		#endif
 
-	configASSERT( xQueue );
+		/* The structure of this function follows xQueueGenericSend(), but the
+		slot the item would have been copied into is handed to the caller
+		instead, so the item is written outside of the critical section. */
+		for( ;; )
+		{
+			taskENTER_CRITICAL();
+			{
+				if( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) && ( queueLOAN_BLOCKS_SEND( pxQueue, queueSEND_TO_BACK ) == pdFALSE ) )
+				{
+					/* The slot at pcWriteTo stays free until the loan is
+					committed, as every other sender now sees a full queue. */
+					pxQueue->pcWriteLoan = pxQueue->pcWriteTo;
+					pvSlot = ( void * ) pxQueue->pcWriteLoan;
+					traceQUEUE_LOAN_WRITE_SLOT( pxQueue, pvSlot, xTicksToWait );
 
-	uxReturn = ( ( Queue_t * ) xQueue )->uxMessagesWaiting;
+					taskEXIT_CRITICAL();
+					return pvSlot;
+				}
+				else
+				{
+					if( xTicksToWait == ( TickType_t ) 0 )
+					{
+						queueSTATS_SEND_FAILED( pxQueue );
+						taskEXIT_CRITICAL();
+						traceQUEUE_LOAN_WRITE_SLOT_FAILED( pxQueue, xTicksToWait );
+						return NULL;
+					}
+					else if( xEntryTimeSet == pdFALSE )
+					{
+						vTaskInternalSetTimeOutState( &xTimeOut );
+						xEntryTimeSet = pdTRUE;
+					}
+					else
+					{
+						/* Entry time was already set. */
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+			taskEXIT_CRITICAL();
 
-	return uxReturn;
-} /*lint !e818 Pointer cannot be declared const as xQueue is a typedef not pointer. */
-/*-----------------------------------------------------------*/
+			vTaskSuspendAll();
+			prvLockQueue( pxQueue );
 
-void vQueueDelete( QueueHandle_t xQueue )
-{
-Queue_t * const pxQueue = ( Queue_t * ) xQueue;
+			if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+			{
+				if( prvIsQueueFull( pxQueue ) != pdFALSE )
+				{
+					traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+					queueSTATS_BLOCK_START( xBlockStart );
+					vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+					prvUnlockQueue( pxQueue );
 
-	configASSERT( pxQueue );
-	traceQUEUE_DELETE( pxQueue );
+					if( xTaskResumeAll() == pdFALSE )
+					{
+						portYIELD_WITHIN_API();
+					}
 
-	#if ( configQUEUE_REGISTRY_SIZE > 0 )
-	{
-		vQueueUnregisterQueue( pxQueue );
-	}
-	#endif
+					queueSTATS_SEND_BLOCK_END( pxQueue, xBlockStart );
+				}
+				else
+				{
+					/* Try again. */
+					prvUnlockQueue( pxQueue );
+					( void ) xTaskResumeAll();
+				}
+			}
+			else
+			{
+				/* The timeout has expired. */
+				prvUnlockQueue( pxQueue );
+				( void ) xTaskResumeAll();
 
-	#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
-	{
-		/* The queue can only have been allocated dynamically - free it
-		again. */
-		vPortFree( pxQueue );
-	}
-	#elif( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
-	{
-		/* The queue could have been allocated statically or dynamically, so
-		check before attempting to free the memory. */
-		if( pxQueue->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
-		{
-			vPortFree( pxQueue );
-		}
-		else
-		{
-			mtCOVERAGE_TEST_MARKER();
+				queueSTATS_SEND_FAILED_FROM_TASK( pxQueue );
+				traceQUEUE_LOAN_WRITE_SLOT_FAILED( pxQueue, xTicksToWait );
+				return NULL;
+			}
 		}
 	}
-	#else
-	{
-		/* The queue must have been statically allocated, so is not going to be
-		deleted.  Avoid compiler warnings about the unused parameter. */
-		( void ) pxQueue;
-	}
-	#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
-}
+
+#endif /* configUSE_QUEUE_LOANS */
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_TRACE_FACILITY == 1 )
+#if ( configUSE_QUEUE_LOANS == 1 )
 
-	UBaseType_t uxQueueGetQueueNumber( QueueHandle_t xQueue )
+	void vQueueCommitWriteSlot( QueueHandle_t xQueue, void *pvSlot )
 	{
-		return ( ( Queue_t * ) xQueue )->uxQueueNumber;
-	}
+	BaseType_t xYieldRequired;
+	Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 
-#endif /* configUSE_TRACE_FACILITY */
-/*-----------------------------------------------------------*/
+		configASSERT( pxQueue );
+		configASSERT( pvSlot );
 
-#if ( configUSE_TRACE_FACILITY == 1 )
+		taskENTER_CRITICAL();
+		{
+			if( pxQueue->pcWriteLoan == ( int8_t * ) pvSlot )
+			{
+				traceQUEUE_COMMIT_WRITE_SLOT( pxQueue, pvSlot );
 
-	void vQueueSetQueueNumber( QueueHandle_t xQueue, UBaseType_t uxQueueNumber )
-	{
-		( ( Queue_t * ) xQueue )->uxQueueNumber = uxQueueNumber;
+				/* The item is already in place, so committing it is the
+				bookkeeping half of prvCopyDataToQueue() only. */
+				pxQueue->pcWriteLoan = NULL;
+				pxQueue->pcWriteTo += pxQueue->uxItemSize;
+				if( pxQueue->pcWriteTo >= pxQueue->pcTail ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
+				{
+					pxQueue->pcWriteTo = pxQueue->pcHead;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				pxQueue->uxMessagesWaiting = pxQueue->uxMessagesWaiting + ( UBaseType_t ) 1;
+				queueSTATS_ITEMS_SENT( pxQueue, 1 );
+
+				xYieldRequired = prvNotifyItemsAdded( pxQueue, ( UBaseType_t ) 1 );
+
+				/* Other senders saw a full queue while the slot was on loan, so
+				one of them may be blocked even though there is space. */
+				if( prvUnblockQueueWaiters( &( pxQueue->xTasksWaitingToSend ), ( UBaseType_t ) 1 ) != pdFALSE )
+				{
+					xYieldRequired = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				if( xYieldRequired != pdFALSE )
+				{
+					/* Yes it is ok to yield from within the critical section -
+					the kernel takes care of that. */
+					queueYIELD_IF_USING_PREEMPTION();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				/* The only way the loan can have gone is for the queue to have
+				been reset while the slot was on loan, in which case the item is
+				dropped. */
+				configASSERT( pxQueue->pcWriteLoan == NULL );
+			}
+		}
+		taskEXIT_CRITICAL();
 	}
 
-#endif /* configUSE_TRACE_FACILITY */
+#endif /* configUSE_QUEUE_LOANS */
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_TRACE_FACILITY == 1 )
+#if ( configUSE_QUEUE_LOANS == 1 )
 
-	uint8_t ucQueueGetQueueType( QueueHandle_t xQueue )
+	void *pvQueueLoanReadSlot( QueueHandle_t xQueue, TickType_t xTicksToWait )
+	{
+	BaseType_t xEntryTimeSet = pdFALSE;
+	TimeOut_t xTimeOut;
+	#if( configUSE_QUEUE_STATISTICS == 1 )
+		TickType_t xBlockStart;
+	#endif
+	int8_t *pcSlot;
+	Queue_t * const pxQueue = ( Queue_t * ) xQueue;
+
+		configASSERT( pxQueue );
+		configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+		/* The items of a priority queue are not stored in order. */
+		configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+
+		/* A queue of length one may be used as a mailbox with
+		xQueueOverwrite(), which must always succeed, so its only slot is
+		never lent out. */
+		configASSERT( pxQueue->uxLength > ( UBaseType_t ) 1 );
+
+		#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+		{
+			configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+		}
+		#endif
+
+		/* The structure of this function follows xQueueReceive(). */
+		for( ;; )
+		{
+			taskENTER_CRITICAL();
+			{
+				if( ( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 ) && ( queueREAD_SLOT_IS_ON_LOAN( pxQueue ) == pdFALSE ) )
+				{
+					/* The oldest item is in the slot after pcReadFrom.  The
+					read position is not moved, and the item stays counted,
+					until the slot is released. */
+					pcSlot = pxQueue->u.pcReadFrom + pxQueue->uxItemSize;
+					if( pcSlot >= pxQueue->pcTail ) /*lint !e946 MISRA exception justified as use of the relational operator is the cleanest solutions. */
+					{
+						pcSlot = pxQueue->pcHead;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					pxQueue->pcReadLoan = pcSlot;
+					traceQUEUE_LOAN_READ_SLOT( pxQueue, ( void * ) pcSlot, xTicksToWait );
+
+					taskEXIT_CRITICAL();
+					return ( void * ) pcSlot;
+				}
+				else
+				{
+					if( xTicksToWait == ( TickType_t ) 0 )
+					{
+						taskEXIT_CRITICAL();
+						traceQUEUE_LOAN_READ_SLOT_FAILED( pxQueue, xTicksToWait );
+						return NULL;
+					}
+					else if( xEntryTimeSet == pdFALSE )
+					{
+						vTaskInternalSetTimeOutState( &xTimeOut );
+						xEntryTimeSet = pdTRUE;
+					}
+					else
+					{
+						/* Entry time was already set. */
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			vTaskSuspendAll();
+			prvLockQueue( pxQueue );
+
+			if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+			{
+				if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+				{
+					traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+					queueSTATS_BLOCK_START( xBlockStart );
+					vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+					prvUnlockQueue( pxQueue );
+
+					if( xTaskResumeAll() == pdFALSE )
+					{
+						portYIELD_WITHIN_API();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					queueSTATS_RECEIVE_BLOCK_END( pxQueue, xBlockStart );
+				}
+				else
+				{
+					/* Try again. */
+					prvUnlockQueue( pxQueue );
+					( void ) xTaskResumeAll();
+				}
+			}
+			else
+			{
+				prvUnlockQueue( pxQueue );
+				( void ) xTaskResumeAll();
+
+				if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+				{
+					traceQUEUE_LOAN_READ_SLOT_FAILED( pxQueue, xTicksToWait );
+					return NULL;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+	}
+
+#endif /* configUSE_QUEUE_LOANS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_LOANS == 1 )
+
+	void vQueueReleaseReadSlot( QueueHandle_t xQueue, void *pvSlot )
+	{
+	BaseType_t xYieldRequired;
+	Queue_t * const pxQueue = ( Queue_t * ) xQueue;
+
+		configASSERT( pxQueue );
+		configASSERT( pvSlot );
+
+		taskENTER_CRITICAL();
+		{
+			if( pxQueue->pcReadLoan == ( int8_t * ) pvSlot )
+			{
+				traceQUEUE_RELEASE_READ_SLOT( pxQueue, pvSlot );
+
+				/* The bookkeeping half of prvCopyDataFromQueue(), plus the
+				item count update made by xQueueReceive(). */
+				pxQueue->pcReadLoan = NULL;
+				pxQueue->u.pcReadFrom = ( int8_t * ) pvSlot;
+				pxQueue->uxMessagesWaiting = pxQueue->uxMessagesWaiting - ( UBaseType_t ) 1;
+				queueSTATS_ITEMS_RECEIVED( pxQueue, 1 );
+
+				/* There is now space in the queue. */
+				xYieldRequired = prvUnblockQueueWaiters( &( pxQueue->xTasksWaitingToSend ), ( UBaseType_t ) 1 );
+
+				/* Other receivers saw an empty queue while the slot was on
+				loan, so one of them may be blocked even though there is more
+				data. */
+				if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+				{
+					if( prvUnblockQueueWaiters( &( pxQueue->xTasksWaitingToReceive ), ( UBaseType_t ) 1 ) != pdFALSE )
+					{
+						xYieldRequired = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				if( xYieldRequired != pdFALSE )
+				{
+					queueYIELD_IF_USING_PREEMPTION();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				/* The queue was reset while the slot was on loan. */
+				configASSERT( pxQueue->pcReadLoan == NULL );
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+
+#endif /* configUSE_QUEUE_LOANS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_BATCHES == 1 )
+
+	UBaseType_t uxQueueSendMultiple( QueueHandle_t xQueue, const void * const pvItems, UBaseType_t uxItemCount, TickType_t xTicksToWait )
+	{
+	BaseType_t xEntryTimeSet = pdFALSE;
+	TimeOut_t xTimeOut;
+	#if( configUSE_QUEUE_STATISTICS == 1 )
+		TickType_t xBlockStart;
+	#endif
+	UBaseType_t uxItemsSent;
+	Queue_t * const pxQueue = ( Queue_t * ) xQueue;
+
+		configASSERT( pxQueue );
+		configASSERT( !( ( pvItems == NULL ) && ( uxItemCount != ( UBaseType_t ) 0U ) ) );
+
+		/* Semaphores and mutexes do not hold items. */
+		configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+		/* The items of a priority queue are not stored in order. */
+		configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+
+		#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+		{
+			configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+		}
+		#endif
+
+		/* Nothing to send, so there is nothing to wait for either, even if the
+		queue is full. */
+		if( uxItemCount == ( UBaseType_t ) 0U )
+		{
+			return ( UBaseType_t ) 0;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* The structure of this function follows xQueueGenericSend(), but as
+		many items as fit are copied in, and waiting tasks are unblocked, under
+		a single critical section. */
+		for( ;; )
+		{
+			taskENTER_CRITICAL();
+			{
+				uxItemsSent = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+
+				if( ( uxItemsSent > ( UBaseType_t ) 0 ) && ( queueLOAN_BLOCKS_SEND( pxQueue, queueSEND_TO_BACK ) == pdFALSE ) )
+				{
+					if( uxItemsSent > uxItemCount )
+					{
+						uxItemsSent = uxItemCount;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					traceQUEUE_SEND_MULTIPLE( pxQueue, uxItemsSent );
+					prvCopyItemsToQueue( pxQueue, ( const int8_t * ) pvItems, uxItemsSent );
+
+					if( prvNotifyItemsAdded( pxQueue, uxItemsSent ) != pdFALSE )
+					{
+						/* Yes it is ok to yield from within the critical
+						section - the kernel takes care of that. */
+						queueYIELD_IF_USING_PREEMPTION();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					taskEXIT_CRITICAL();
+					return uxItemsSent;
+				}
+				else
+				{
+					if( xTicksToWait == ( TickType_t ) 0 )
+					{
+						queueSTATS_SEND_FAILED( pxQueue );
+						taskEXIT_CRITICAL();
+						traceQUEUE_SEND_MULTIPLE( pxQueue, 0 );
+						return ( UBaseType_t ) 0;
+					}
+					else if( xEntryTimeSet == pdFALSE )
+					{
+						vTaskInternalSetTimeOutState( &xTimeOut );
+						xEntryTimeSet = pdTRUE;
+					}
+					else
+					{
+						/* Entry time was already set. */
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			vTaskSuspendAll();
+			prvLockQueue( pxQueue );
+
+			if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+			{
+				if( prvIsQueueFull( pxQueue ) != pdFALSE )
+				{
+					traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+					queueSTATS_BLOCK_START( xBlockStart );
+					vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+					prvUnlockQueue( pxQueue );
+
+					if( xTaskResumeAll() == pdFALSE )
+					{
+						portYIELD_WITHIN_API();
+					}
+
+					queueSTATS_SEND_BLOCK_END( pxQueue, xBlockStart );
+				}
+				else
+				{
+					/* Try again. */
+					prvUnlockQueue( pxQueue );
+					( void ) xTaskResumeAll();
+				}
+			}
+			else
+			{
+				/* The timeout has expired. */
+				prvUnlockQueue( pxQueue );
+				( void ) xTaskResumeAll();
+
+				queueSTATS_SEND_FAILED_FROM_TASK( pxQueue );
+				traceQUEUE_SEND_MULTIPLE( pxQueue, 0 );
+				return ( UBaseType_t ) 0;
+			}
+		}
+	}
+
+#endif /* configUSE_QUEUE_BATCHES */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_BATCHES == 1 )
+
+	UBaseType_t uxQueueSendMultipleFromISR( QueueHandle_t xQueue, const void * const pvItems, UBaseType_t uxItemCount, BaseType_t * const pxHigherPriorityTaskWoken )
+	{
+	UBaseType_t uxItemsSent = ( UBaseType_t ) 0;
+	UBaseType_t uxSavedInterruptStatus;
+	Queue_t * const pxQueue = ( Queue_t * ) xQueue;
+
+		configASSERT( pxQueue );
+		configASSERT( !( ( pvItems == NULL ) && ( uxItemCount != ( UBaseType_t ) 0U ) ) );
+		configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+		/* The items of a priority queue are not stored in order. */
+		configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+
+		/* See the comments in xQueueGenericSendFromISR(). */
+		portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			if( queueLOAN_BLOCKS_SEND( pxQueue, queueSEND_TO_BACK ) == pdFALSE )
+			{
+				uxItemsSent = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+
+				if( uxItemsSent > uxItemCount )
+				{
+					uxItemsSent = uxItemCount;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			traceQUEUE_SEND_MULTIPLE_FROM_ISR( pxQueue, uxItemsSent );
+
+			if( uxItemsSent > ( UBaseType_t ) 0 )
+			{
+				const int8_t cTxLock = pxQueue->cTxLock;
+
+				prvCopyItemsToQueue( pxQueue, ( const int8_t * ) pvItems, uxItemsSent );
+
+				if( cTxLock == queueUNLOCKED )
+				{
+					if( prvNotifyItemsAdded( pxQueue, uxItemsSent ) != pdFALSE )
+					{
+						if( pxHigherPriorityTaskWoken != NULL )
+						{
+							*pxHigherPriorityTaskWoken = pdTRUE;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					/* Increment the lock count so the task that unlocks the
+					queue knows that data was posted while it was locked.  The
+					count saturates, as prvUnlockQueue() stops once no tasks
+					are left to unblock. */
+					pxQueue->cTxLock = prvAddToLockCount( cTxLock, uxItemsSent );
+				}
+			}
+			else
+			{
+				queueSTATS_SEND_FAILED( pxQueue );
+			}
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		return uxItemsSent;
+	}
+
+#endif /* configUSE_QUEUE_BATCHES */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_BATCHES == 1 )
+
+	UBaseType_t uxQueueReceiveMultiple( QueueHandle_t xQueue, void * const pvBuffer, UBaseType_t uxMaxItems, TickType_t xTicksToWait )
+	{
+	BaseType_t xEntryTimeSet = pdFALSE;
+	TimeOut_t xTimeOut;
+	#if( configUSE_QUEUE_STATISTICS == 1 )
+		TickType_t xBlockStart;
+	#endif
+	UBaseType_t uxItemsReceived;
+	Queue_t * const pxQueue = ( Queue_t * ) xQueue;
+
+		configASSERT( pxQueue );
+		configASSERT( !( ( pvBuffer == NULL ) && ( uxMaxItems != ( UBaseType_t ) 0U ) ) );
+		configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+		/* The items of a priority queue are not stored in order. */
+		configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+
+		#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+		{
+			configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+		}
+		#endif
+
+		/* Asking for no items has nothing to wait for, even if the queue is
+		empty. */
+		if( uxMaxItems == ( UBaseType_t ) 0U )
+		{
+			return ( UBaseType_t ) 0;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* The structure of this function follows xQueueReceive(). */
+		for( ;; )
+		{
+			taskENTER_CRITICAL();
+			{
+				uxItemsReceived = pxQueue->uxMessagesWaiting;
+
+				if( ( uxItemsReceived > ( UBaseType_t ) 0 ) && ( queueREAD_SLOT_IS_ON_LOAN( pxQueue ) == pdFALSE ) )
+				{
+					if( uxItemsReceived > uxMaxItems )
+					{
+						uxItemsReceived = uxMaxItems;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					prvCopyItemsFromQueue( pxQueue, ( int8_t * ) pvBuffer, uxItemsReceived );
+					traceQUEUE_RECEIVE_MULTIPLE( pxQueue, uxItemsReceived );
+
+					/* There is now space for uxItemsReceived items, so unblock
+					up to that many senders. */
+					if( prvUnblockQueueWaiters( &( pxQueue->xTasksWaitingToSend ), uxItemsReceived ) != pdFALSE )
+					{
+						queueYIELD_IF_USING_PREEMPTION();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					taskEXIT_CRITICAL();
+					return uxItemsReceived;
+				}
+				else
+				{
+					if( xTicksToWait == ( TickType_t ) 0 )
+					{
+						taskEXIT_CRITICAL();
+						traceQUEUE_RECEIVE_MULTIPLE( pxQueue, 0 );
+						return ( UBaseType_t ) 0;
+					}
+					else if( xEntryTimeSet == pdFALSE )
+					{
+						vTaskInternalSetTimeOutState( &xTimeOut );
+						xEntryTimeSet = pdTRUE;
+					}
+					else
+					{
+						/* Entry time was already set. */
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			vTaskSuspendAll();
+			prvLockQueue( pxQueue );
+
+			if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+			{
+				if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+				{
+					traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+					queueSTATS_BLOCK_START( xBlockStart );
+					vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+					prvUnlockQueue( pxQueue );
+
+					if( xTaskResumeAll() == pdFALSE )
+					{
+						portYIELD_WITHIN_API();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					queueSTATS_RECEIVE_BLOCK_END( pxQueue, xBlockStart );
+				}
+				else
+				{
+					/* Try again. */
+					prvUnlockQueue( pxQueue );
+					( void ) xTaskResumeAll();
+				}
+			}
+			else
+			{
+				prvUnlockQueue( pxQueue );
+				( void ) xTaskResumeAll();
+
+				if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+				{
+					traceQUEUE_RECEIVE_MULTIPLE( pxQueue, 0 );
+					return ( UBaseType_t ) 0;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+	}
+
+#endif /* configUSE_QUEUE_BATCHES */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_BATCHES == 1 )
+
+	UBaseType_t uxQueueReceiveMultipleFromISR( QueueHandle_t xQueue, void * const pvBuffer, UBaseType_t uxMaxItems, BaseType_t * const pxHigherPriorityTaskWoken )
+	{
+	UBaseType_t uxItemsReceived = ( UBaseType_t ) 0;
+	UBaseType_t uxSavedInterruptStatus;
+	Queue_t * const pxQueue = ( Queue_t * ) xQueue;
+
+		configASSERT( pxQueue );
+		configASSERT( !( ( pvBuffer == NULL ) && ( uxMaxItems != ( UBaseType_t ) 0U ) ) );
+		configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+		/* The items of a priority queue are not stored in order. */
+		configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+
+		/* See the comments in xQueueGenericSendFromISR(). */
+		portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			if( queueREAD_SLOT_IS_ON_LOAN( pxQueue ) == pdFALSE )
+			{
+				uxItemsReceived = pxQueue->uxMessagesWaiting;
+
+				if( uxItemsReceived > uxMaxItems )
+				{
+					uxItemsReceived = uxMaxItems;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( uxItemsReceived > ( UBaseType_t ) 0 )
+			{
+				const int8_t cRxLock = pxQueue->cRxLock;
+
+				prvCopyItemsFromQueue( pxQueue, ( int8_t * ) pvBuffer, uxItemsReceived );
+
+				if( cRxLock == queueUNLOCKED )
+				{
+					if( prvUnblockQueueWaiters( &( pxQueue->xTasksWaitingToSend ), uxItemsReceived ) != pdFALSE )
+					{
+						if( pxHigherPriorityTaskWoken != NULL )
+						{
+							*pxHigherPriorityTaskWoken = pdTRUE;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					/* Increment the lock count so the task that unlocks the
+					queue knows that data was removed while it was locked. */
+					pxQueue->cRxLock = prvAddToLockCount( cRxLock, uxItemsReceived );
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			traceQUEUE_RECEIVE_MULTIPLE_FROM_ISR( pxQueue, uxItemsReceived );
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		return uxItemsReceived;
+	}
+
+#endif /* configUSE_QUEUE_BATCHES */
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_PRIORITY_QUEUES == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+
+	QueueHandle_t xQueueCreatePriority( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize, const UBaseType_t uxPriorityLevels )
+	{
+	Queue_t *pxNewQueue;
+	uint8_t *pucQueueStorage;
+
+		configASSERT( uxQueueLength > ( UBaseType_t ) 0 );
+		configASSERT( uxItemSize > ( UBaseType_t ) 0 );
+		configASSERT( ( uxPriorityLevels > ( UBaseType_t ) 0 ) && ( uxPriorityLevels <= queuePRIORITY_LEVELS_MAX ) );
+
+		/* The index and the item storage follow the queue structure in the same
+		allocation.  The size of the queue structure is a multiple of the size
+		of a UBaseType_t, so the index is correctly aligned. */
+		pxNewQueue = ( Queue_t * ) pvPortMalloc( sizeof( Queue_t ) + queuePRIORITY_STORAGE_SIZE( uxQueueLength, uxItemSize, uxPriorityLevels ) );
+
+		if( pxNewQueue != NULL )
+		{
+			pucQueueStorage = ( ( uint8_t * ) pxNewQueue ) + sizeof( Queue_t );
+
+			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+			{
+				/* Queues can be created either statically or dynamically, so
+				note this queue was created dynamically in case it is later
+				deleted. */
+				pxNewQueue->ucStaticallyAllocated = pdFALSE;
+			}
+			#endif /* configSUPPORT_STATIC_ALLOCATION */
+
+			prvInitialisePriorityQueue( uxQueueLength, uxItemSize, uxPriorityLevels, pucQueueStorage, pxNewQueue );
+		}
+		else
+		{
+			traceQUEUE_CREATE_FAILED( queueQUEUE_TYPE_PRIORITY );
+		}
+
+		return pxNewQueue;
+	}
+
+#endif /* ( configUSE_PRIORITY_QUEUES == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_PRIORITY_QUEUES == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+
+	QueueHandle_t xQueueCreatePriorityStatic( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize, const UBaseType_t uxPriorityLevels, uint8_t *pucQueueStorage, StaticQueue_t *pxStaticQueue )
+	{
+	Queue_t *pxNewQueue;
+
+		configASSERT( uxQueueLength > ( UBaseType_t ) 0 );
+		configASSERT( uxItemSize > ( UBaseType_t ) 0 );
+		configASSERT( ( uxPriorityLevels > ( UBaseType_t ) 0 ) && ( uxPriorityLevels <= queuePRIORITY_LEVELS_MAX ) );
+		configASSERT( pxStaticQueue != NULL );
+		configASSERT( pucQueueStorage != NULL );
+
+		/* The index at the start of the storage area is accessed a word at a
+		time. */
+		configASSERT( ( ( ( portPOINTER_SIZE_TYPE ) pucQueueStorage ) & ( portPOINTER_SIZE_TYPE ) ( sizeof( UBaseType_t ) - 1U ) ) == 0 );
+
+		#if( configASSERT_DEFINED == 1 )
+		{
+			/* Sanity check that the size of the structure used to declare a
+			variable of type StaticQueue_t equals the size of the real queue
+			structure. */
+			volatile size_t xSize = sizeof( StaticQueue_t );
+			configASSERT( xSize == sizeof( Queue_t ) );
+		}
+		#endif /* configASSERT_DEFINED */
+
+		pxNewQueue = ( Queue_t * ) pxStaticQueue; /*lint !e740 Unusual cast is ok as the structures are designed to have the same alignment, and the size is checked by an assert. */
+
+		if( pxNewQueue != NULL )
+		{
+			#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+			{
+				/* Queues can be allocated wither statically or dynamically, so
+				note this queue was allocated statically in case the queue is
+				later deleted. */
+				pxNewQueue->ucStaticallyAllocated = pdTRUE;
+			}
+			#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+
+			prvInitialisePriorityQueue( uxQueueLength, uxItemSize, uxPriorityLevels, pucQueueStorage, pxNewQueue );
+		}
+		else
+		{
+			traceQUEUE_CREATE_FAILED( queueQUEUE_TYPE_PRIORITY );
+		}
+
+		return pxNewQueue;
+	}
+
+#endif /* ( configUSE_PRIORITY_QUEUES == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue )
+{
+UBaseType_t uxReturn;
+
+	configASSERT( xQueue );
+
+	taskENTER_CRITICAL();
+	{
+		uxReturn = ( ( Queue_t * ) xQueue )->uxMessagesWaiting;
+	}
+	taskEXIT_CRITICAL();
+
+	return uxReturn;
+} /*lint !e818 Pointer cannot be declared const as xQueue is a typedef not pointer. */
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueSpacesAvailable( const QueueHandle_t xQueue )
+{
+UBaseType_t uxReturn;
+Queue_t *pxQueue;
+
+	pxQueue = ( Queue_t * ) xQueue;
+	configASSERT( pxQueue );
+
+	taskENTER_CRITICAL();
+	{
+		uxReturn = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+	}
+	taskEXIT_CRITICAL();
+
+	return uxReturn;
+} /*lint !e818 Pointer cannot be declared const as xQueue is a typedef not pointer. */
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueMessagesWaitingFromISR( const QueueHandle_t xQueue )
+{
+UBaseType_t uxReturn;
+
+	configASSERT( xQueue );
+
+	uxReturn = ( ( Queue_t * ) xQueue )->uxMessagesWaiting;
+
+	return uxReturn;
+} /*lint !e818 Pointer cannot be declared const as xQueue is a typedef not pointer. */
+/*-----------------------------------------------------------*/
+
+void vQueueDelete( QueueHandle_t xQueue )
+{
+Queue_t * const pxQueue = ( Queue_t * ) xQueue;
+
+	configASSERT( pxQueue );
+	traceQUEUE_DELETE( pxQueue );
+
+	#if ( ( configQUEUE_REGISTRY_SIZE > 0 ) || ( configUSE_OBJECT_REGISTRY == 1 ) )
+	{
+		vQueueUnregisterQueue( pxQueue );
+	}
+	#endif
+
+	#if ( configUSE_QUEUE_STATISTICS == 1 )
+	{
+	Queue_t **ppxLink;
+
+		/* Unlink the queue from the list of all queues. */
+		vTaskSuspendAll();
+		{
+			for( ppxLink = &pxQueueList; *ppxLink != NULL; ppxLink = &( ( *ppxLink )->pxNextQueue ) )
+			{
+				if( *ppxLink == pxQueue )
+				{
+					*ppxLink = pxQueue->pxNextQueue;
+					uxQueueCount--;
+					break;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		( void ) xTaskResumeAll();
+	}
+	#endif
+
+	#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
+	{
+		/* The queue can only have been allocated dynamically - free it
+		again. */
+		vPortFree( pxQueue );
+	}
+	#elif( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+	{
+		/* The queue could have been allocated statically or dynamically, so
+		check before attempting to free the memory. */
+		if( pxQueue->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+		{
+			vPortFree( pxQueue );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#else
+	{
+		/* The queue must have been statically allocated, so is not going to be
+		deleted.  Avoid compiler warnings about the unused parameter. */
+		( void ) pxQueue;
+	}
+	#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+	UBaseType_t uxQueueGetQueueNumber( QueueHandle_t xQueue )
+	{
+		return ( ( Queue_t * ) xQueue )->uxQueueNumber;
+	}
+
+#endif /* configUSE_TRACE_FACILITY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+	void vQueueSetQueueNumber( QueueHandle_t xQueue, UBaseType_t uxQueueNumber )
+	{
+		( ( Queue_t * ) xQueue )->uxQueueNumber = uxQueueNumber;
+	}
+
+#endif /* configUSE_TRACE_FACILITY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+	uint8_t ucQueueGetQueueType( QueueHandle_t xQueue )
 	{
 		return ( ( Queue_t * ) xQueue )->ucQueueType;
 	}
@@ -2011,6 +3275,107 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 #endif /* configUSE_TRACE_FACILITY */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_QUEUE_STATISTICS == 1 )
+
+	void vQueueGetStatistics( QueueHandle_t xQueue, QueueStats_t *pxStats )
+	{
+	Queue_t * const pxQueue = ( Queue_t * ) xQueue;
+
+		configASSERT( pxQueue );
+		configASSERT( pxStats );
+
+		/* Interrupts update the counters too, so take a consistent copy. */
+		taskENTER_CRITICAL();
+		{
+			*pxStats = pxQueue->xStats;
+		}
+		taskEXIT_CRITICAL();
+	}
+
+#endif /* configUSE_QUEUE_STATISTICS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_STATISTICS == 1 )
+
+	void vQueueResetStatistics( QueueHandle_t xQueue )
+	{
+	Queue_t * const pxQueue = ( Queue_t * ) xQueue;
+
+		configASSERT( pxQueue );
+
+		taskENTER_CRITICAL();
+		{
+			( void ) memset( ( void * ) &( pxQueue->xStats ), 0x00, sizeof( pxQueue->xStats ) );
+
+			/* Start the high water mark from the current depth rather than
+			from zero. */
+			pxQueue->xStats.uxMaxMessagesWaiting = pxQueue->uxMessagesWaiting;
+		}
+		taskEXIT_CRITICAL();
+	}
+
+#endif /* configUSE_QUEUE_STATISTICS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_STATISTICS == 1 )
+
+	UBaseType_t uxQueueGetNumberOfQueues( void )
+	{
+		/* A single word read, so no critical section is needed. */
+		return uxQueueCount;
+	}
+
+#endif /* configUSE_QUEUE_STATISTICS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_STATISTICS == 1 )
+
+	UBaseType_t uxQueueGetSystemState( QueueStatus_t * const pxQueueStatusArray, const UBaseType_t uxArraySize )
+	{
+	UBaseType_t uxQueue = ( UBaseType_t ) 0;
+	Queue_t *pxQueue;
+
+		configASSERT( !( ( pxQueueStatusArray == NULL ) && ( uxArraySize != ( UBaseType_t ) 0 ) ) );
+
+		/* Suspending the scheduler stops queues being created or deleted while
+		the list is walked.  Each queue's counters are copied in a short
+		critical section of their own, so interrupts are only ever masked for
+		the time it takes to copy one QueueStatus_t structure. */
+		vTaskSuspendAll();
+		{
+			for( pxQueue = pxQueueList; ( pxQueue != NULL ) && ( uxQueue < uxArraySize ); pxQueue = pxQueue->pxNextQueue )
+			{
+				pxQueueStatusArray[ uxQueue ].xHandle = ( QueueHandle_t ) pxQueue;
+				pxQueueStatusArray[ uxQueue ].uxLength = pxQueue->uxLength;
+
+				#if ( ( configQUEUE_REGISTRY_SIZE > 0 ) || ( configUSE_OBJECT_REGISTRY == 1 ) )
+				{
+					pxQueueStatusArray[ uxQueue ].pcQueueName = pcQueueGetName( pxQueue );
+				}
+				#else
+				{
+					pxQueueStatusArray[ uxQueue ].pcQueueName = NULL;
+				}
+				#endif
+
+				taskENTER_CRITICAL();
+				{
+					pxQueueStatusArray[ uxQueue ].uxMessagesWaiting = pxQueue->uxMessagesWaiting;
+					pxQueueStatusArray[ uxQueue ].xStats = pxQueue->xStats;
+				}
+				taskEXIT_CRITICAL();
+
+				uxQueue++;
+			}
+		}
+		( void ) xTaskResumeAll();
+
+		return uxQueue;
+	}
+
+#endif /* configUSE_QUEUE_STATISTICS */
+/*-----------------------------------------------------------*/
+
 #if( configUSE_MUTEXES == 1 )
 
 	static UBaseType_t prvGetDisinheritPriorityAfterTimeout( const Queue_t * const pxQueue )
@@ -2064,9 +3429,28 @@ UBaseType_t uxMessagesWaiting;
 		}
 		#endif /* configUSE_MUTEXES */
 	}
+	#if( configUSE_PRIORITY_QUEUES == 1 )
+	else if( pxQueue->pxPriorityIndex != NULL )
+	{
+		if( ( xPosition == queueOVERWRITE ) && ( uxMessagesWaiting > ( UBaseType_t ) 0 ) )
+		{
+			/* The queue has a length of one, so the item being overwritten
+			is the only item.  Discard it and count the new item in its
+			place. */
+			prvResetPriorityIndex( pxQueue );
+			--uxMessagesWaiting;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		prvAddPriorityItem( pxQueue, pvItemToQueue, xPosition );
+	}
+	#endif /* configUSE_PRIORITY_QUEUES */
 	else if( xPosition == queueSEND_TO_BACK )
 	{
-		( void ) memcpy( ( void * ) pxQueue->pcWriteTo, pvItemToQueue, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e418 MISRA exception as the casts are only redundant for some ports, plus previous logic ensures a null pointer can only be passed to memcpy() if the copy size is 0. */
+		queueCOPY_ITEM( pxQueue->pcWriteTo, pvItemToQueue, pxQueue->uxItemSize ); /*lint !e961 !e418 MISRA exception as the casts are only redundant for some ports, plus previous logic ensures a null pointer can only be passed to memcpy() if the copy size is 0. */
 		pxQueue->pcWriteTo += pxQueue->uxItemSize;
 		if( pxQueue->pcWriteTo >= pxQueue->pcTail ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
 		{
@@ -2079,7 +3463,7 @@ UBaseType_t uxMessagesWaiting;
 	}
 	else
 	{
-		( void ) memcpy( ( void * ) pxQueue->u.pcReadFrom, pvItemToQueue, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+		queueCOPY_ITEM( pxQueue->u.pcReadFrom, pvItemToQueue, pxQueue->uxItemSize ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 		pxQueue->u.pcReadFrom -= pxQueue->uxItemSize;
 		if( pxQueue->u.pcReadFrom < pxQueue->pcHead ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
 		{
@@ -2112,26 +3496,67 @@ UBaseType_t uxMessagesWaiting;
 	}
 
 	pxQueue->uxMessagesWaiting = uxMessagesWaiting + ( UBaseType_t ) 1;
+	queueSTATS_ITEMS_SENT( pxQueue, 1 );
 
 	return xReturn;
 }
 /*-----------------------------------------------------------*/
 
-static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer )
+static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer )
+{
+	if( pxQueue->uxItemSize != ( UBaseType_t ) 0 )
+	{
+		#if( configUSE_PRIORITY_QUEUES == 1 )
+		{
+			if( pxQueue->pxPriorityIndex != NULL )
+			{
+				prvRemovePriorityItem( pxQueue, pvBuffer, pdFALSE );
+				return;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif
+
+		pxQueue->u.pcReadFrom += pxQueue->uxItemSize;
+		if( pxQueue->u.pcReadFrom >= pxQueue->pcTail ) /*lint !e946 MISRA exception justified as use of the relational operator is the cleanest solutions. */
+		{
+			pxQueue->u.pcReadFrom = pxQueue->pcHead;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+		queueCOPY_ITEM( pvBuffer, pxQueue->u.pcReadFrom, pxQueue->uxItemSize ); /*lint !e961 !e418 MISRA exception as the casts are only redundant for some ports.  Also previous logic ensures a null pointer can only be passed to memcpy() when the count is 0. */
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvPeekDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer )
 {
-	if( pxQueue->uxItemSize != ( UBaseType_t ) 0 )
+int8_t *pcOriginalReadPosition;
+
+	#if( configUSE_PRIORITY_QUEUES == 1 )
 	{
-		pxQueue->u.pcReadFrom += pxQueue->uxItemSize;
-		if( pxQueue->u.pcReadFrom >= pxQueue->pcTail ) /*lint !e946 MISRA exception justified as use of the relational operator is the cleanest solutions. */
+		if( pxQueue->pxPriorityIndex != NULL )
 		{
-			pxQueue->u.pcReadFrom = pxQueue->pcHead;
+			prvRemovePriorityItem( pxQueue, pvBuffer, pdTRUE );
+			return;
 		}
 		else
 		{
 			mtCOVERAGE_TEST_MARKER();
 		}
-		( void ) memcpy( ( void * ) pvBuffer, ( void * ) pxQueue->u.pcReadFrom, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e418 MISRA exception as the casts are only redundant for some ports.  Also previous logic ensures a null pointer can only be passed to memcpy() when the count is 0. */
 	}
+	#endif
+
+	/* Remember the read position so it can be reset after the data is read
+	from the queue as the data is only being peeked, not removed. */
+	pcOriginalReadPosition = pxQueue->u.pcReadFrom;
+	prvCopyDataFromQueue( pxQueue, pvBuffer );
+	pxQueue->u.pcReadFrom = pcOriginalReadPosition;
 }
 /*-----------------------------------------------------------*/
 
@@ -2261,7 +3686,7 @@ BaseType_t xReturn;
 
 	taskENTER_CRITICAL();
 	{
-		if( pxQueue->uxMessagesWaiting == ( UBaseType_t )  0 )
+		if( ( pxQueue->uxMessagesWaiting == ( UBaseType_t )  0 ) || ( queueREAD_SLOT_IS_ON_LOAN( pxQueue ) != pdFALSE ) )
 		{
 			xReturn = pdTRUE;
 		}
@@ -2300,7 +3725,7 @@ BaseType_t xReturn;
 
 	taskENTER_CRITICAL();
 	{
-		if( pxQueue->uxMessagesWaiting == pxQueue->uxLength )
+		if( ( pxQueue->uxMessagesWaiting == pxQueue->uxLength ) || ( queueWRITE_SLOT_IS_ON_LOAN( pxQueue ) != pdFALSE ) || ( queueREAD_SLOT_IS_ON_LOAN( pxQueue ) != pdFALSE ) )
 		{
 			xReturn = pdTRUE;
 		}
@@ -2608,7 +4033,7 @@ BaseType_t xReturn;
 #endif /* configUSE_CO_ROUTINES */
 /*-----------------------------------------------------------*/
 
-#if ( configQUEUE_REGISTRY_SIZE > 0 )
+#if ( ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configUSE_OBJECT_REGISTRY == 0 ) )
 
 	void vQueueAddToRegistry( QueueHandle_t xQueue, const char *pcQueueName ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
 	{
@@ -2634,10 +4059,10 @@ BaseType_t xReturn;
 		}
 	}
 
-#endif /* configQUEUE_REGISTRY_SIZE */
+#endif /* ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configUSE_OBJECT_REGISTRY == 0 ) */
 /*-----------------------------------------------------------*/
 
-#if ( configQUEUE_REGISTRY_SIZE > 0 )
+#if ( ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configUSE_OBJECT_REGISTRY == 0 ) )
 
 	const char *pcQueueGetName( QueueHandle_t xQueue ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
 	{
@@ -2662,10 +4087,10 @@ BaseType_t xReturn;
 		return pcReturn;
 	} /*lint !e818 xQueue cannot be a pointer to const because it is a typedef. */
 
-#endif /* configQUEUE_REGISTRY_SIZE */
+#endif /* ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configUSE_OBJECT_REGISTRY == 0 ) */
 /*-----------------------------------------------------------*/
 
-#if ( configQUEUE_REGISTRY_SIZE > 0 )
+#if ( ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configUSE_OBJECT_REGISTRY == 0 ) )
 
 	void vQueueUnregisterQueue( QueueHandle_t xQueue )
 	{
@@ -2694,7 +4119,59 @@ BaseType_t xReturn;
 
 	} /*lint !e818 xQueue could not be pointer to const because it is a typedef. */
 
-#endif /* configQUEUE_REGISTRY_SIZE */
+#endif /* ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configUSE_OBJECT_REGISTRY == 0 ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_OBJECT_REGISTRY == 1 )
+
+	void vQueueAddToRegistry( QueueHandle_t xQueue, const char *pcQueueName ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+	{
+	Queue_t * const pxQueue = ( Queue_t * ) xQueue;
+	eObjectType eType;
+
+		configASSERT( pxQueue );
+
+		/* Semaphores and mutexes are the queues that hold no data. */
+		if( pxQueue->uxItemSize == ( UBaseType_t ) 0 )
+		{
+			eType = eObjectTypeSemaphore;
+		}
+		else
+		{
+			eType = eObjectTypeQueue;
+		}
+
+		if( xObjectRegistryAdd( xQueue, pcQueueName, eType ) != pdFAIL )
+		{
+			traceQUEUE_REGISTRY_ADD( xQueue, pcQueueName );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_OBJECT_REGISTRY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_OBJECT_REGISTRY == 1 )
+
+	const char *pcQueueGetName( QueueHandle_t xQueue ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+	{
+		return pcObjectRegistryGetName( xQueue );
+	}
+
+#endif /* configUSE_OBJECT_REGISTRY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_OBJECT_REGISTRY == 1 )
+
+	void vQueueUnregisterQueue( QueueHandle_t xQueue )
+	{
+		vObjectRegistryRemove( xQueue );
+	}
+
+#endif /* configUSE_OBJECT_REGISTRY */
 /*-----------------------------------------------------------*/
 
 #if ( configUSE_TIMERS == 1 )
@@ -2766,6 +4243,12 @@ BaseType_t xReturn;
 				items in the queue/semaphore. */
 				xReturn = pdFAIL;
 			}
+			else if( queueIS_PRIORITY_QUEUE( ( Queue_t * ) xQueueOrSemaphore ) != pdFALSE )
+			{
+				/* The queue set would receive the position the item was sent
+				to, and a queue set is not a priority queue. */
+				xReturn = pdFAIL;
+			}
 			else
 			{
 				( ( Queue_t * ) xQueueOrSemaphore )->pxQueueSetContainer = xQueueSet;
@@ -2896,6 +4379,374 @@ BaseType_t xReturn;
 	}
 
 #endif /* configUSE_QUEUE_SETS */
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_QUEUE_LOANS == 1 ) || ( configUSE_QUEUE_BATCHES == 1 ) )
+
+	static BaseType_t prvUnblockQueueWaiters( List_t * const pxEventList, UBaseType_t uxMaxToUnblock )
+	{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+		while( ( uxMaxToUnblock > ( UBaseType_t ) 0 ) && ( listLIST_IS_EMPTY( pxEventList ) == pdFALSE ) )
+		{
+			if( xTaskRemoveFromEventList( pxEventList ) != pdFALSE )
+			{
+				xHigherPriorityTaskWoken = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			uxMaxToUnblock--;
+		}
+
+		return xHigherPriorityTaskWoken;
+	}
+
+#endif /* ( configUSE_QUEUE_LOANS == 1 ) || ( configUSE_QUEUE_BATCHES == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_QUEUE_LOANS == 1 ) || ( configUSE_QUEUE_BATCHES == 1 ) )
+
+	static BaseType_t prvNotifyItemsAdded( Queue_t * const pxQueue, UBaseType_t uxItemCount )
+	{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+		#if ( configUSE_QUEUE_SETS == 1 )
+		{
+			if( pxQueue->pxQueueSetContainer != NULL )
+			{
+				/* The queue set holds one handle per item, as if each item had
+				been sent on its own. */
+				while( uxItemCount > ( UBaseType_t ) 0 )
+				{
+					if( prvNotifyQueueSetContainer( pxQueue, queueSEND_TO_BACK ) != pdFALSE )
+					{
+						xHigherPriorityTaskWoken = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					uxItemCount--;
+				}
+			}
+			else
+			{
+				xHigherPriorityTaskWoken = prvUnblockQueueWaiters( &( pxQueue->xTasksWaitingToReceive ), uxItemCount );
+			}
+		}
+		#else /* configUSE_QUEUE_SETS */
+		{
+			xHigherPriorityTaskWoken = prvUnblockQueueWaiters( &( pxQueue->xTasksWaitingToReceive ), uxItemCount );
+		}
+		#endif /* configUSE_QUEUE_SETS */
+
+		return xHigherPriorityTaskWoken;
+	}
+
+#endif /* ( configUSE_QUEUE_LOANS == 1 ) || ( configUSE_QUEUE_BATCHES == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_BATCHES == 1 )
+
+	static void prvCopyItemsToQueue( Queue_t * const pxQueue, const int8_t *pcItems, const UBaseType_t uxItemCount )
+	{
+	const size_t xBytes = ( size_t ) ( uxItemCount * pxQueue->uxItemSize );
+	size_t xFirstBytes;
+
+		/* The items may wrap around the end of the storage area, in which case
+		they are copied in two parts. */
+		xFirstBytes = ( size_t ) ( pxQueue->pcTail - pxQueue->pcWriteTo );
+		if( xFirstBytes > xBytes )
+		{
+			xFirstBytes = xBytes;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		( void ) memcpy( ( void * ) pxQueue->pcWriteTo, ( const void * ) pcItems, xFirstBytes );
+
+		if( xBytes > xFirstBytes )
+		{
+			( void ) memcpy( ( void * ) pxQueue->pcHead, ( const void * ) ( pcItems + xFirstBytes ), xBytes - xFirstBytes );
+			pxQueue->pcWriteTo = pxQueue->pcHead + ( xBytes - xFirstBytes );
+		}
+		else
+		{
+			pxQueue->pcWriteTo += xBytes;
+			if( pxQueue->pcWriteTo >= pxQueue->pcTail ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
+			{
+				pxQueue->pcWriteTo = pxQueue->pcHead;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		pxQueue->uxMessagesWaiting = pxQueue->uxMessagesWaiting + uxItemCount;
+		queueSTATS_ITEMS_SENT( pxQueue, uxItemCount );
+	}
+
+#endif /* configUSE_QUEUE_BATCHES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_BATCHES == 1 )
+
+	static void prvCopyItemsFromQueue( Queue_t * const pxQueue, int8_t *pcBuffer, const UBaseType_t uxItemCount )
+	{
+	const size_t xBytes = ( size_t ) ( uxItemCount * pxQueue->uxItemSize );
+	size_t xFirstBytes;
+	int8_t *pcReadFrom;
+
+		/* pcReadFrom points to the last item read, so the oldest item is the
+		one after it. */
+		pcReadFrom = pxQueue->u.pcReadFrom + pxQueue->uxItemSize;
+		if( pcReadFrom >= pxQueue->pcTail ) /*lint !e946 MISRA exception justified as use of the relational operator is the cleanest solutions. */
+		{
+			pcReadFrom = pxQueue->pcHead;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		xFirstBytes = ( size_t ) ( pxQueue->pcTail - pcReadFrom );
+		if( xFirstBytes > xBytes )
+		{
+			xFirstBytes = xBytes;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		( void ) memcpy( ( void * ) pcBuffer, ( const void * ) pcReadFrom, xFirstBytes );
+
+		if( xBytes > xFirstBytes )
+		{
+			( void ) memcpy( ( void * ) ( pcBuffer + xFirstBytes ), ( const void * ) pxQueue->pcHead, xBytes - xFirstBytes );
+			pcReadFrom = pxQueue->pcHead + ( xBytes - xFirstBytes );
+		}
+		else
+		{
+			pcReadFrom += xBytes;
+		}
+
+		/* Leave pcReadFrom pointing at the last item read, as
+		prvCopyDataFromQueue() does. */
+		pxQueue->u.pcReadFrom = pcReadFrom - pxQueue->uxItemSize;
+		pxQueue->uxMessagesWaiting = pxQueue->uxMessagesWaiting - uxItemCount;
+		queueSTATS_ITEMS_RECEIVED( pxQueue, uxItemCount );
+	}
+
+#endif /* configUSE_QUEUE_BATCHES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_BATCHES == 1 )
+
+	static int8_t prvAddToLockCount( const int8_t cLockCount, const UBaseType_t uxItemCount )
+	{
+	int8_t cReturn;
+
+		if( uxItemCount >= ( UBaseType_t ) ( queueMAX_LOCK_COUNT - cLockCount ) )
+		{
+			cReturn = queueMAX_LOCK_COUNT;
+		}
+		else
+		{
+			cReturn = ( int8_t ) ( cLockCount + ( int8_t ) uxItemCount );
+		}
+
+		return cReturn;
+	}
+
+#endif /* configUSE_QUEUE_BATCHES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_PRIORITY_QUEUES == 1 )
+
+	static void prvInitialisePriorityQueue( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize, const UBaseType_t uxPriorityLevels, uint8_t *pucQueueStorage, Queue_t *pxNewQueue )
+	{
+	QueuePriorityIndex_t * const pxIndex = ( QueuePriorityIndex_t * ) pucQueueStorage; /*lint !e826 !e9087 The storage area starts with the index, and its alignment has been checked. */
+
+		/* queuePRIORITY_INDEX_SIZE() assumes the index structure is three
+		UBaseType_t variables. */
+		configASSERT( sizeof( QueuePriorityIndex_t ) == ( 3U * sizeof( UBaseType_t ) ) );
+
+		pxIndex->uxLevels = uxPriorityLevels;
+
+		/* The items are stored after the index.  The index is attached, and
+		all its slots freed, once the queue itself has been initialised. */
+		prvInitialiseNewQueue( uxQueueLength, uxItemSize, pucQueueStorage + queuePRIORITY_INDEX_SIZE( uxQueueLength, uxPriorityLevels ), queueQUEUE_TYPE_PRIORITY, pxNewQueue );
+		pxNewQueue->pxPriorityIndex = pxIndex;
+		prvResetPriorityIndex( pxNewQueue );
+	}
+
+#endif /* configUSE_PRIORITY_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_PRIORITY_QUEUES == 1 )
+
+	static void prvResetPriorityIndex( Queue_t * const pxQueue )
+	{
+	QueuePriorityIndex_t * const pxIndex = pxQueue->pxPriorityIndex;
+	UBaseType_t * const puxHeads = queuePRIORITY_HEADS( pxIndex );
+	UBaseType_t * const puxLinks = queuePRIORITY_LINKS( pxIndex );
+	UBaseType_t ux;
+
+		pxIndex->uxReadyLevels = ( UBaseType_t ) 0;
+
+		for( ux = ( UBaseType_t ) 0; ux < pxIndex->uxLevels; ux++ )
+		{
+			puxHeads[ ux ] = queuePRIORITY_NO_SLOT;
+		}
+
+		/* Chain every slot onto the free list in order. */
+		for( ux = ( UBaseType_t ) 0; ux < ( pxQueue->uxLength - ( UBaseType_t ) 1 ); ux++ )
+		{
+			puxLinks[ ux ] = ux + ( UBaseType_t ) 1;
+		}
+
+		puxLinks[ pxQueue->uxLength - ( UBaseType_t ) 1 ] = queuePRIORITY_NO_SLOT;
+		pxIndex->uxFreeSlot = ( UBaseType_t ) 0;
+	}
+
+#endif /* configUSE_PRIORITY_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_PRIORITY_QUEUES == 1 )
+
+	static void prvAddPriorityItem( Queue_t * const pxQueue, const void *pvItemToQueue, const BaseType_t xPosition )
+	{
+	QueuePriorityIndex_t * const pxIndex = pxQueue->pxPriorityIndex;
+	UBaseType_t * const puxHeads = queuePRIORITY_HEADS( pxIndex );
+	UBaseType_t * const puxTails = queuePRIORITY_TAILS( pxIndex );
+	UBaseType_t * const puxLinks = queuePRIORITY_LINKS( pxIndex );
+	UBaseType_t uxSlot, uxLevel;
+
+		/* This function is called from a critical section, and only when the
+		queue has space, so there is always a free slot. */
+		uxSlot = pxIndex->uxFreeSlot;
+		configASSERT( uxSlot != queuePRIORITY_NO_SLOT );
+		pxIndex->uxFreeSlot = puxLinks[ uxSlot ];
+
+		queueCOPY_ITEM( pxQueue->pcHead + ( uxSlot * pxQueue->uxItemSize ), pvItemToQueue, pxQueue->uxItemSize ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+
+		if( xPosition == queueSEND_TO_FRONT )
+		{
+			/* Go in front of the item that would otherwise be received
+			next. */
+			if( pxIndex->uxReadyLevels != ( UBaseType_t ) 0 )
+			{
+				queueGET_HIGHEST_LEVEL( uxLevel, pxIndex );
+			}
+			else
+			{
+				uxLevel = ( UBaseType_t ) 0;
+			}
+
+			if( puxHeads[ uxLevel ] == queuePRIORITY_NO_SLOT )
+			{
+				puxTails[ uxLevel ] = uxSlot;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			puxLinks[ uxSlot ] = puxHeads[ uxLevel ];
+			puxHeads[ uxLevel ] = uxSlot;
+		}
+		else
+		{
+			if( xPosition >= queueSEND_WITH_PRIORITY( 0 ) )
+			{
+				uxLevel = ( UBaseType_t ) ( xPosition - queueSEND_WITH_PRIORITY( 0 ) );
+			}
+			else
+			{
+				/* queueSEND_TO_BACK or queueOVERWRITE. */
+				uxLevel = ( UBaseType_t ) 0;
+			}
+
+			/* Priorities above the highest level the queue was created with
+			are treated as the highest level. */
+			configASSERT( uxLevel < pxIndex->uxLevels );
+			if( uxLevel >= pxIndex->uxLevels )
+			{
+				uxLevel = pxIndex->uxLevels - ( UBaseType_t ) 1;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* Go behind every item already queued at the same priority. */
+			if( puxHeads[ uxLevel ] == queuePRIORITY_NO_SLOT )
+			{
+				puxHeads[ uxLevel ] = uxSlot;
+			}
+			else
+			{
+				puxLinks[ puxTails[ uxLevel ] ] = uxSlot;
+			}
+
+			puxLinks[ uxSlot ] = queuePRIORITY_NO_SLOT;
+			puxTails[ uxLevel ] = uxSlot;
+		}
+
+		pxIndex->uxReadyLevels |= ( ( UBaseType_t ) 1 ) << uxLevel;
+	}
+
+#endif /* configUSE_PRIORITY_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_PRIORITY_QUEUES == 1 )
+
+	static void prvRemovePriorityItem( Queue_t * const pxQueue, void * const pvBuffer, const BaseType_t xJustPeeking )
+	{
+	QueuePriorityIndex_t * const pxIndex = pxQueue->pxPriorityIndex;
+	UBaseType_t * const puxHeads = queuePRIORITY_HEADS( pxIndex );
+	UBaseType_t * const puxLinks = queuePRIORITY_LINKS( pxIndex );
+	UBaseType_t uxSlot, uxLevel;
+
+		/* This function is called from a critical section, and only when the
+		queue is not empty, so at least one level holds an item. */
+		configASSERT( pxIndex->uxReadyLevels != ( UBaseType_t ) 0 );
+		queueGET_HIGHEST_LEVEL( uxLevel, pxIndex );
+		uxSlot = puxHeads[ uxLevel ];
+
+		queueCOPY_ITEM( pvBuffer, pxQueue->pcHead + ( uxSlot * pxQueue->uxItemSize ), pxQueue->uxItemSize ); /*lint !e961 !e418 MISRA exception as the casts are only redundant for some ports. */
+
+		if( xJustPeeking == pdFALSE )
+		{
+			puxHeads[ uxLevel ] = puxLinks[ uxSlot ];
+
+			if( puxHeads[ uxLevel ] == queuePRIORITY_NO_SLOT )
+			{
+				pxIndex->uxReadyLevels &= ~( ( ( UBaseType_t ) 1 ) << uxLevel );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			puxLinks[ uxSlot ] = pxIndex->uxFreeSlot;
+			pxIndex->uxFreeSlot = uxSlot;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_PRIORITY_QUEUES */
 
 
 
@@ -0,0 +1,603 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Implements the relocatable heap described in reloc_heap.h.
+ *
+ * The heap is a single array split into a sequence of blocks in address order,
+ * each starting with a RelocBlock_t header.  A free block has a NULL owner, an
+ * allocated block points back at the handle table entry that owns it so the
+ * handle can be updated when the block is moved.  Adjacent free blocks are
+ * merged lazily whenever the sequence is walked.
+ *
+ * Compaction looks for the lowest free block that is followed by an unlocked
+ * allocated block, then copies the allocated block down over the free block a
+ * chunk at a time.  The free space ends up above the moved block, where it
+ * merges with whatever free space follows.  While a move is in progress the
+ * headers inside the region being copied are not valid, so anything that walks
+ * the blocks completes the move first.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "reloc_heap.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* This entire source file will be skipped if the application is not configured
+to include the relocatable heap. */
+#if( configUSE_RELOCATABLE_HEAP == 1 )
+
+struct xRELOC_HANDLE_ENTRY;
+
+/* The header placed at the start of every block. */
+typedef struct xRELOC_BLOCK
+{
+	size_t xBlockSize;						/*<< The size of the block including this header, a multiple of portBYTE_ALIGNMENT. */
+	struct xRELOC_HANDLE_ENTRY *pxOwner;	/*<< The handle that owns the block, or NULL if the block is free. */
+} RelocBlock_t;
+
+/* A handle is a pointer to one of these. */
+typedef struct xRELOC_HANDLE_ENTRY
+{
+	RelocBlock_t *pxBlock;					/*<< The block holding the buffer, or NULL if the handle is not in use. */
+	UBaseType_t uxLockCount;				/*<< The buffer cannot be moved while this is non-zero. */
+} RelocHandleEntry_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called the first time a buffer is allocated to create a single free block
+ * that spans the whole heap.
+ */
+static void prvHeapInit( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Merge any free blocks that directly follow pxBlock, which must be free, into
+ * pxBlock.
+ */
+static void prvMergeFollowingFreeBlocks( RelocBlock_t *pxBlock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Look for the lowest unlocked buffer that has free space directly below it
+ * and, if one is found, start moving it.
+ */
+static void prvStartNextMove( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Copy up to xMaxBytes more bytes of the buffer being moved, finishing the
+ * move if the whole buffer has been copied.
+ */
+static void prvContinueMove( size_t xMaxBytes ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+/* The memory used by the relocatable heap. */
+static uint8_t ucRelocHeap[ configRELOCATABLE_HEAP_SIZE ];
+
+/* The handles. */
+static RelocHandleEntry_t xHandles[ configRELOCATABLE_HEAP_MAX_HANDLES ];
+
+/* The size of the header placed at the start of each block, padded so the
+buffer that follows it is correctly aligned. */
+static const size_t xBlockHeaderSize = ( sizeof( RelocBlock_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* A free block is only split if the remainder would be at least this big. */
+#define rhMINIMUM_BLOCK_SIZE	( ( size_t ) ( xBlockHeaderSize << 1 ) )
+
+/* The aligned bounds of ucRelocHeap.  pucHeapStart is NULL until the heap has
+been initialised. */
+static uint8_t *pucHeapStart = NULL;
+static uint8_t *pucHeapEnd = NULL;
+
+/* Keeps track of the number of free bytes (including block headers), but says
+nothing about fragmentation. */
+static size_t xFreeBytesRemaining = 0U;
+
+/* Set when compaction has found nothing more to move, and cleared whenever a
+buffer is freed or unlocked as that may have made more work. */
+static BaseType_t xHeapIsCompact = pdFALSE;
+
+/* The state of the move in progress, if any.  The buffer is copied from
+pucMoveSource down to pucMoveDestination, lowest address first, and the size
+is kept here because the header at pucMoveSource may already have been
+overwritten. */
+static RelocHandleEntry_t *pxMovingHandle = NULL;
+static uint8_t *pucMoveSource = NULL;
+static uint8_t *pucMoveDestination = NULL;
+static size_t xMoveBlockSize = 0U;
+static size_t xMoveBytesDone = 0U;
+
+/*-----------------------------------------------------------*/
+
+RelocHandle_t xRelocHeapAlloc( size_t xWantedSize )
+{
+RelocHandleEntry_t *pxHandle = NULL;
+RelocBlock_t *pxBlock, *pxNewBlock;
+UBaseType_t uxIndex;
+
+	vTaskSuspendAll();
+	{
+		if( pucHeapStart == NULL )
+		{
+			prvHeapInit();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* The blocks cannot be walked while one is part way through being
+		moved. */
+		prvContinueMove( ~( ( size_t ) 0 ) );
+
+		for( uxIndex = 0; uxIndex < ( UBaseType_t ) configRELOCATABLE_HEAP_MAX_HANDLES; uxIndex++ )
+		{
+			if( xHandles[ uxIndex ].pxBlock == NULL )
+			{
+				pxHandle = &( xHandles[ uxIndex ] );
+				break;
+			}
+		}
+
+		/* Add space for the header and round up to keep the next block
+		aligned, checking the result has not wrapped. */
+		if( ( xWantedSize > ( size_t ) 0 ) && ( xFreeBytesRemaining > xBlockHeaderSize ) && ( xWantedSize <= ( xFreeBytesRemaining - xBlockHeaderSize ) ) )
+		{
+			xWantedSize += xBlockHeaderSize;
+			xWantedSize = ( xWantedSize + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+		}
+		else
+		{
+			/* Zero, or more than is free in total. */
+			pxHandle = NULL;
+		}
+
+		if( pxHandle != NULL )
+		{
+			/* First fit, walking the blocks in address order.  Compaction
+			moves buffers down, so keeping new buffers low leaves the large
+			free space at the top intact. */
+			pxBlock = ( RelocBlock_t * ) pucHeapStart; /*lint !e826 !e9087 The heap is aligned. */
+
+			while( ( uint8_t * ) pxBlock < pucHeapEnd )
+			{
+				if( pxBlock->pxOwner == NULL )
+				{
+					prvMergeFollowingFreeBlocks( pxBlock );
+
+					if( pxBlock->xBlockSize >= xWantedSize )
+					{
+						break;
+					}
+				}
+
+				pxBlock = ( RelocBlock_t * ) ( ( ( uint8_t * ) pxBlock ) + pxBlock->xBlockSize ); /*lint !e826 !e9087 Block sizes are aligned. */
+			}
+
+			if( ( uint8_t * ) pxBlock < pucHeapEnd )
+			{
+				if( ( pxBlock->xBlockSize - xWantedSize ) >= rhMINIMUM_BLOCK_SIZE )
+				{
+					/* Split the block, leaving the remainder free. */
+					pxNewBlock = ( RelocBlock_t * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize ); /*lint !e826 !e9087 Block sizes are aligned. */
+					pxNewBlock->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+					pxNewBlock->pxOwner = NULL;
+					pxBlock->xBlockSize = xWantedSize;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				pxBlock->pxOwner = pxHandle;
+				pxHandle->pxBlock = pxBlock;
+				pxHandle->uxLockCount = ( UBaseType_t ) 0;
+				xFreeBytesRemaining -= pxBlock->xBlockSize;
+			}
+			else
+			{
+				/* Enough free space in total, but not in one block.  The
+				allocation may succeed once the idle task has compacted the
+				heap. */
+				pxHandle = NULL;
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	return ( RelocHandle_t ) pxHandle;
+}
+/*-----------------------------------------------------------*/
+
+void vRelocHeapFree( RelocHandle_t xHandle )
+{
+RelocHandleEntry_t * const pxHandle = ( RelocHandleEntry_t * ) xHandle; /*lint !e9087 !e9079 Safe cast as RelocHandle_t is opaque RelocHandleEntry_t. */
+RelocBlock_t *pxBlock;
+
+	configASSERT( pxHandle );
+	configASSERT( pxHandle->pxBlock );
+	configASSERT( pxHandle->uxLockCount == ( UBaseType_t ) 0 );
+
+	vTaskSuspendAll();
+	{
+		if( pxHandle == pxMovingHandle )
+		{
+			/* Abandon the move.  The free space it was moving into and the
+			buffer itself become a single free block. */
+			pxBlock = ( RelocBlock_t * ) pucMoveDestination; /*lint !e826 !e9087 Block addresses are aligned. */
+			pxBlock->xBlockSize = ( size_t ) ( pucMoveSource - pucMoveDestination ) + xMoveBlockSize;
+			pxBlock->pxOwner = NULL;
+			xFreeBytesRemaining += xMoveBlockSize;
+			pxMovingHandle = NULL;
+		}
+		else
+		{
+			pxBlock = pxHandle->pxBlock;
+			pxBlock->pxOwner = NULL;
+			xFreeBytesRemaining += pxBlock->xBlockSize;
+		}
+
+		pxHandle->pxBlock = NULL;
+		xHeapIsCompact = pdFALSE;
+	}
+	( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+void *pvRelocHeapLock( RelocHandle_t xHandle )
+{
+RelocHandleEntry_t * const pxHandle = ( RelocHandleEntry_t * ) xHandle; /*lint !e9087 !e9079 Safe cast as RelocHandle_t is opaque RelocHandleEntry_t. */
+void *pvReturn;
+
+	configASSERT( pxHandle );
+	configASSERT( pxHandle->pxBlock );
+
+	vTaskSuspendAll();
+	{
+		if( pxHandle == pxMovingHandle )
+		{
+			prvContinueMove( ~( ( size_t ) 0 ) );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		( pxHandle->uxLockCount )++;
+		pvReturn = ( void * ) ( ( ( uint8_t * ) pxHandle->pxBlock ) + xBlockHeaderSize );
+	}
+	( void ) xTaskResumeAll();
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vRelocHeapUnlock( RelocHandle_t xHandle )
+{
+RelocHandleEntry_t * const pxHandle = ( RelocHandleEntry_t * ) xHandle; /*lint !e9087 !e9079 Safe cast as RelocHandle_t is opaque RelocHandleEntry_t. */
+
+	configASSERT( pxHandle );
+	configASSERT( pxHandle->uxLockCount > ( UBaseType_t ) 0 );
+
+	vTaskSuspendAll();
+	{
+		( pxHandle->uxLockCount )--;
+
+		if( pxHandle->uxLockCount == ( UBaseType_t ) 0 )
+		{
+			/* The buffer may now be able to move down. */
+			xHeapIsCompact = pdFALSE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+size_t xRelocHeapGetBufferSize( RelocHandle_t xHandle )
+{
+RelocHandleEntry_t * const pxHandle = ( RelocHandleEntry_t * ) xHandle; /*lint !e9087 !e9079 Safe cast as RelocHandle_t is opaque RelocHandleEntry_t. */
+size_t xReturn;
+
+	configASSERT( pxHandle );
+	configASSERT( pxHandle->pxBlock );
+
+	vTaskSuspendAll();
+	{
+		if( pxHandle == pxMovingHandle )
+		{
+			xReturn = xMoveBlockSize;
+		}
+		else
+		{
+			xReturn = pxHandle->pxBlock->xBlockSize;
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	return xReturn - xBlockHeaderSize;
+}
+/*-----------------------------------------------------------*/
+
+size_t xRelocHeapGetFreeHeapSize( void )
+{
+	if( pucHeapStart == NULL )
+	{
+		/* Nothing has been allocated yet, so the whole heap less the space
+		lost to alignment will be free. */
+		return ( size_t ) configRELOCATABLE_HEAP_SIZE & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+	}
+
+	return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xRelocHeapGetLargestFreeBlock( void )
+{
+RelocBlock_t *pxBlock;
+size_t xLargest = 0U;
+
+	vTaskSuspendAll();
+	{
+		if( pucHeapStart == NULL )
+		{
+			prvHeapInit();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		prvContinueMove( ~( ( size_t ) 0 ) );
+
+		pxBlock = ( RelocBlock_t * ) pucHeapStart; /*lint !e826 !e9087 The heap is aligned. */
+
+		while( ( uint8_t * ) pxBlock < pucHeapEnd )
+		{
+			if( pxBlock->pxOwner == NULL )
+			{
+				prvMergeFollowingFreeBlocks( pxBlock );
+
+				if( pxBlock->xBlockSize > xLargest )
+				{
+					xLargest = pxBlock->xBlockSize;
+				}
+			}
+
+			pxBlock = ( RelocBlock_t * ) ( ( ( uint8_t * ) pxBlock ) + pxBlock->xBlockSize ); /*lint !e826 !e9087 Block sizes are aligned. */
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	if( xLargest > xBlockHeaderSize )
+	{
+		xLargest -= xBlockHeaderSize;
+	}
+	else
+	{
+		xLargest = 0U;
+	}
+
+	return xLargest;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRelocHeapCompactStep( void )
+{
+BaseType_t xReturn = pdFALSE;
+
+	vTaskSuspendAll();
+	{
+		/* Nothing to do if nothing has ever been allocated. */
+		if( pucHeapStart != NULL )
+		{
+			if( ( pxMovingHandle == NULL ) && ( xHeapIsCompact == pdFALSE ) )
+			{
+				prvStartNextMove();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( pxMovingHandle != NULL )
+			{
+				prvContinueMove( ( size_t ) configRELOCATABLE_HEAP_COMPACT_STEP_BYTES );
+				xReturn = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void )
+{
+RelocBlock_t *pxFirstBlock;
+size_t uxAddress;
+
+	/* Ensure the heap starts and ends on correctly aligned boundaries. */
+	uxAddress = ( size_t ) ucRelocHeap;
+	uxAddress = ( uxAddress + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+	pucHeapStart = ( uint8_t * ) uxAddress;
+
+	uxAddress = ( size_t ) ( ucRelocHeap + configRELOCATABLE_HEAP_SIZE );
+	uxAddress &= ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+	pucHeapEnd = ( uint8_t * ) uxAddress;
+
+	pxFirstBlock = ( RelocBlock_t * ) pucHeapStart; /*lint !e826 !e9087 The heap is aligned. */
+	pxFirstBlock->xBlockSize = ( size_t ) ( pucHeapEnd - pucHeapStart );
+	pxFirstBlock->pxOwner = NULL;
+
+	xFreeBytesRemaining = pxFirstBlock->xBlockSize;
+	xHeapIsCompact = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMergeFollowingFreeBlocks( RelocBlock_t *pxBlock )
+{
+RelocBlock_t *pxNextBlock;
+
+	for( ;; )
+	{
+		pxNextBlock = ( RelocBlock_t * ) ( ( ( uint8_t * ) pxBlock ) + pxBlock->xBlockSize ); /*lint !e826 !e9087 Block sizes are aligned. */
+
+		if( ( ( uint8_t * ) pxNextBlock < pucHeapEnd ) && ( pxNextBlock->pxOwner == NULL ) )
+		{
+			pxBlock->xBlockSize += pxNextBlock->xBlockSize;
+		}
+		else
+		{
+			break;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvStartNextMove( void )
+{
+RelocBlock_t *pxBlock, *pxNextBlock;
+
+	pxBlock = ( RelocBlock_t * ) pucHeapStart; /*lint !e826 !e9087 The heap is aligned. */
+
+	while( ( uint8_t * ) pxBlock < pucHeapEnd )
+	{
+		if( pxBlock->pxOwner == NULL )
+		{
+			/* After merging, the next block (if any) is allocated. */
+			prvMergeFollowingFreeBlocks( pxBlock );
+			pxNextBlock = ( RelocBlock_t * ) ( ( ( uint8_t * ) pxBlock ) + pxBlock->xBlockSize ); /*lint !e826 !e9087 Block sizes are aligned. */
+
+			if( ( ( uint8_t * ) pxNextBlock < pucHeapEnd ) && ( pxNextBlock->pxOwner->uxLockCount == ( UBaseType_t ) 0 ) )
+			{
+				pxMovingHandle = pxNextBlock->pxOwner;
+				pucMoveSource = ( uint8_t * ) pxNextBlock;
+				pucMoveDestination = ( uint8_t * ) pxBlock;
+				xMoveBlockSize = pxNextBlock->xBlockSize;
+				xMoveBytesDone = 0U;
+				return;
+			}
+			else
+			{
+				/* Either the free space is already at the top of the heap or
+				the buffer above it is locked in place. */
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			pxBlock = pxNextBlock;
+		}
+		else
+		{
+			pxBlock = ( RelocBlock_t * ) ( ( ( uint8_t * ) pxBlock ) + pxBlock->xBlockSize ); /*lint !e826 !e9087 Block sizes are aligned. */
+		}
+	}
+
+	/* Every unlocked buffer is already as low as it can go. */
+	xHeapIsCompact = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvContinueMove( size_t xMaxBytes )
+{
+RelocBlock_t *pxFreeBlock;
+size_t xBytesToCopy;
+
+	if( pxMovingHandle != NULL )
+	{
+		xBytesToCopy = xMoveBlockSize - xMoveBytesDone;
+
+		if( xBytesToCopy > xMaxBytes )
+		{
+			xBytesToCopy = xMaxBytes;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* The destination is below the source, so copying in ascending
+		address order never overwrites bytes that have yet to be copied.  The
+		regions within a single chunk can still overlap, hence memmove(). */
+		( void ) memmove( pucMoveDestination + xMoveBytesDone, pucMoveSource + xMoveBytesDone, xBytesToCopy );
+		xMoveBytesDone += xBytesToCopy;
+
+		if( xMoveBytesDone == xMoveBlockSize )
+		{
+			/* The header was copied along with the buffer, so only the
+			handle needs updating.  The space the buffer vacated becomes a
+			free block above it. */
+			pxMovingHandle->pxBlock = ( RelocBlock_t * ) pucMoveDestination; /*lint !e826 !e9087 Block addresses are aligned. */
+
+			pxFreeBlock = ( RelocBlock_t * ) ( pucMoveDestination + xMoveBlockSize ); /*lint !e826 !e9087 Block sizes are aligned. */
+			pxFreeBlock->xBlockSize = ( size_t ) ( pucMoveSource - pucMoveDestination );
+			pxFreeBlock->pxOwner = NULL;
+			prvMergeFollowingFreeBlocks( pxFreeBlock );
+
+			pxMovingHandle = NULL;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+
+/* This entire source file will be skipped if the application is not configured
+to include the relocatable heap. */
+#endif /* configUSE_RELOCATABLE_HEAP == 1 */
@@ -0,0 +1,712 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "rw_lock.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* This entire source file will be skipped if the application is not configured
+to include reader-writer lock functionality. */
+#if( configUSE_RW_LOCKS == 1 )
+
+#if( configUSE_MUTEXES != 1 )
+	#error configUSE_MUTEXES must be set to 1 to build rw_lock.c
+#endif
+
+#if( configRW_LOCK_MAX_READERS < 1 )
+	#error configRW_LOCK_MAX_READERS must be at least 1
+#endif
+
+/* Bits stored in the ucFlags field of the lock. */
+#define rwFLAGS_IS_STATICALLY_ALLOCATED ( ( uint8_t ) 1 ) /* Set if the lock was created using statically allocated memory. */
+
+/*-----------------------------------------------------------*/
+
+/* Structure that holds the state of a reader-writer lock.  Every field is only
+accessed from within a critical section.  The lock is free when xWriter is
+NULL and uxReaders is 0, and is then never left with tasks waiting for it, as
+unlocking passes the lock directly to the tasks that are waiting.  The holders
+are recorded so they can all inherit the priority of a task that waits. */
+typedef struct xRW_LOCK /*lint !e9058 Style convention uses tag. */
+{
+	TaskHandle_t xWriter;										/* The task that holds the lock for writing, or NULL. */
+	UBaseType_t uxReaders;										/* The number of tasks that hold the lock for reading. */
+	TaskHandle_t xReaderTasks[ configRW_LOCK_MAX_READERS ];		/* The tasks that hold the lock for reading, in the first uxReaders entries. */
+	List_t xTasksWaitingToRead;									/* Tasks blocked waiting to read, in priority order. */
+	List_t xTasksWaitingToWrite;								/* Tasks blocked waiting to write, in priority order. */
+	uint8_t ucFlags;
+} RwLock_t;
+
+/*
+ * Called by both xRwLockCreate() and xRwLockCreateStatic() to initialise the
+ * lock structure.
+ */
+static void prvInitialiseNewRwLock( RwLock_t * const pxLock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Common implementation of xRwLockReadLock() and xRwLockWriteLock().
+ */
+static BaseType_t prvLock( RwLock_t * const pxLock, const BaseType_t xForWriting, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * Common implementation of xRwLockReadUnlock() and xRwLockWriteUnlock().
+ */
+static BaseType_t prvUnlock( RwLock_t * const pxLock, const BaseType_t xForWriting ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return pdTRUE if xTask holds the lock for writing (xForWriting is pdTRUE) or
+ * for reading (xForWriting is pdFALSE).  Called from a critical section.
+ */
+static BaseType_t prvIsHolder( const RwLock_t * const pxLock, const TaskHandle_t xTask, const BaseType_t xForWriting ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes xTask from the holders of the lock.  Returns pdFALSE if xTask did
+ * not hold the lock in the given mode.  Called from a critical section.
+ */
+static BaseType_t prvRemoveHolder( RwLock_t * const pxLock, const TaskHandle_t xTask, const BaseType_t xForWriting ) PRIVILEGED_FUNCTION;
+
+/*
+ * Passes the lock to the tasks waiting for it, if the state of the lock now
+ * allows it: to the highest priority waiting writer once no task holds the
+ * lock, or, if no writer is waiting, to as many waiting readers as there is
+ * room for.  Returns pdTRUE if a task of higher priority than the calling task
+ * was unblocked.  Called from a critical section.
+ */
+static BaseType_t prvGrantWaitingTasks( RwLock_t * const pxLock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Raises the priority of every task that holds the lock to that of the
+ * calling task, if it is lower.  Returns pdTRUE if any holder's priority was,
+ * or already had been, raised.  Called from a critical section.
+ */
+static BaseType_t prvInheritToHolders( RwLock_t * const pxLock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called when a task that raised the priority of the holders times out.  The
+ * holders' priorities are lowered again, but not below the priority of the
+ * highest priority task still waiting for the lock.  Called from a critical
+ * section.
+ */
+static void prvDisinheritHoldersAfterTimeout( RwLock_t * const pxLock ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	RwLockHandle_t xRwLockCreate( void )
+	{
+	RwLock_t *pxLock;
+
+		pxLock = ( RwLock_t * ) pvPortMalloc( sizeof( RwLock_t ) ); /*lint !e9079 malloc() only returns void*. */
+
+		if( pxLock != NULL )
+		{
+			prvInitialiseNewRwLock( pxLock );
+			traceRW_LOCK_CREATE( pxLock );
+		}
+		else
+		{
+			traceRW_LOCK_CREATE_FAILED();
+		}
+
+		return ( RwLockHandle_t ) pxLock;
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+	RwLockHandle_t xRwLockCreateStatic( StaticRwLock_t * const pxStaticRwLock )
+	{
+	RwLock_t * const pxLock = ( RwLock_t * ) pxStaticRwLock; /*lint !e740 !e9087 Safe cast as StaticRwLock_t is opaque RwLock_t. */
+	RwLockHandle_t xReturn;
+
+		configASSERT( pxStaticRwLock );
+
+		#if( configASSERT_DEFINED == 1 )
+		{
+			/* Sanity check that the size of the structure used to declare a
+			variable of type StaticRwLock_t equals the size of the real lock
+			structure. */
+			volatile size_t xSize = sizeof( StaticRwLock_t );
+			configASSERT( xSize == sizeof( RwLock_t ) );
+		}
+		#endif /* configASSERT_DEFINED */
+
+		if( pxStaticRwLock != NULL )
+		{
+			prvInitialiseNewRwLock( pxLock );
+
+			/* Remember this was statically allocated in case it is ever deleted
+			again. */
+			pxLock->ucFlags |= rwFLAGS_IS_STATICALLY_ALLOCATED;
+
+			traceRW_LOCK_CREATE( pxLock );
+
+			xReturn = ( RwLockHandle_t ) pxStaticRwLock;
+		}
+		else
+		{
+			xReturn = NULL;
+			traceRW_LOCK_CREATE_FAILED();
+		}
+
+		return xReturn;
+	}
+
+#endif /* ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+/*-----------------------------------------------------------*/
+
+void vRwLockDelete( RwLockHandle_t xLock )
+{
+RwLock_t * const pxLock = ( RwLock_t * ) xLock; /*lint !e9087 !e9079 Safe cast as RwLockHandle_t is opaque RwLock_t. */
+
+	configASSERT( pxLock );
+	configASSERT( pxLock->xWriter == NULL );
+	configASSERT( pxLock->uxReaders == ( UBaseType_t ) 0 );
+
+	traceRW_LOCK_DELETE( pxLock );
+
+	if( ( pxLock->ucFlags & rwFLAGS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) pdFALSE )
+	{
+		#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+		{
+			vPortFree( ( void * ) pxLock );
+		}
+		#else
+		{
+			/* Should not be possible to get here, ucFlags must be corrupt.
+			Force an assert. */
+			configASSERT( xLock == ( RwLockHandle_t ) ~0 );
+		}
+		#endif
+	}
+	else
+	{
+		/* The structure was not allocated dynamically and cannot be freed -
+		just scrub it so future use will assert. */
+		memset( pxLock, 0x00, sizeof( RwLock_t ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRwLockReadLock( RwLockHandle_t xLock, TickType_t xTicksToWait )
+{
+RwLock_t * const pxLock = ( RwLock_t * ) xLock; /*lint !e9087 !e9079 Safe cast as RwLockHandle_t is opaque RwLock_t. */
+BaseType_t xReturn;
+
+	configASSERT( pxLock );
+
+	xReturn = prvLock( pxLock, pdFALSE, xTicksToWait );
+
+	if( xReturn != pdFAIL )
+	{
+		traceRW_LOCK_READ_LOCK( pxLock );
+	}
+	else
+	{
+		traceRW_LOCK_READ_LOCK_FAILED( pxLock );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRwLockReadUnlock( RwLockHandle_t xLock )
+{
+RwLock_t * const pxLock = ( RwLock_t * ) xLock; /*lint !e9087 !e9079 Safe cast as RwLockHandle_t is opaque RwLock_t. */
+
+	configASSERT( pxLock );
+	traceRW_LOCK_READ_UNLOCK( pxLock );
+
+	return prvUnlock( pxLock, pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRwLockWriteLock( RwLockHandle_t xLock, TickType_t xTicksToWait )
+{
+RwLock_t * const pxLock = ( RwLock_t * ) xLock; /*lint !e9087 !e9079 Safe cast as RwLockHandle_t is opaque RwLock_t. */
+BaseType_t xReturn;
+
+	configASSERT( pxLock );
+
+	xReturn = prvLock( pxLock, pdTRUE, xTicksToWait );
+
+	if( xReturn != pdFAIL )
+	{
+		traceRW_LOCK_WRITE_LOCK( pxLock );
+	}
+	else
+	{
+		traceRW_LOCK_WRITE_LOCK_FAILED( pxLock );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRwLockWriteUnlock( RwLockHandle_t xLock )
+{
+RwLock_t * const pxLock = ( RwLock_t * ) xLock; /*lint !e9087 !e9079 Safe cast as RwLockHandle_t is opaque RwLock_t. */
+
+	configASSERT( pxLock );
+	traceRW_LOCK_WRITE_UNLOCK( pxLock );
+
+	return prvUnlock( pxLock, pdTRUE );
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxRwLockGetReaderCount( RwLockHandle_t xLock )
+{
+RwLock_t * const pxLock = ( RwLock_t * ) xLock; /*lint !e9087 !e9079 Safe cast as RwLockHandle_t is opaque RwLock_t. */
+
+	configASSERT( pxLock );
+
+	return pxLock->uxReaders;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvLock( RwLock_t * const pxLock, const BaseType_t xForWriting, TickType_t xTicksToWait )
+{
+TimeOut_t xTimeOut;
+BaseType_t xEntryTimeSet = pdFALSE, xInheritanceOccurred = pdFALSE;
+BaseType_t xReturn = pdFAIL, xBlocked, xCanLock;
+TaskHandle_t xSelf;
+
+	/* Count the lock as a held mutex before trying to take it.  The task that
+	unlocks the lock may pass it to this task while this task is blocked, and
+	from then on another waiting task that times out may disinherit this
+	task's priority, which asserts the held count is not zero. */
+	xSelf = ( TaskHandle_t ) pvTaskIncrementMutexHeldCount();
+
+	/* Can only be called by a task. */
+	configASSERT( xSelf );
+
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+	do
+	{
+		xBlocked = pdFALSE;
+
+		taskENTER_CRITICAL();
+		{
+			if( xForWriting != pdFALSE )
+			{
+				xCanLock = ( ( pxLock->xWriter == NULL ) && ( pxLock->uxReaders == ( UBaseType_t ) 0 ) ) ? pdTRUE : pdFALSE;
+			}
+			else
+			{
+				/* Writers are preferred, so readers also wait while a writer
+				is waiting. */
+				xCanLock = ( ( pxLock->xWriter == NULL ) &&
+							 ( listLIST_IS_EMPTY( &( pxLock->xTasksWaitingToWrite ) ) != pdFALSE ) &&
+							 ( pxLock->uxReaders < ( UBaseType_t ) configRW_LOCK_MAX_READERS ) ) ? pdTRUE : pdFALSE;
+			}
+
+			if( prvIsHolder( pxLock, xSelf, xForWriting ) != pdFALSE )
+			{
+				/* The lock is not recursive, so it was passed to this task by
+				the task that unlocked it while this task was blocked. */
+				configASSERT( xEntryTimeSet != pdFALSE );
+				xReturn = pdPASS;
+			}
+			else if( xCanLock != pdFALSE )
+			{
+				if( xForWriting != pdFALSE )
+				{
+					pxLock->xWriter = xSelf;
+				}
+				else
+				{
+					pxLock->xReaderTasks[ pxLock->uxReaders ] = xSelf;
+					( pxLock->uxReaders )++;
+				}
+
+				xReturn = pdPASS;
+			}
+			else if( ( ( xEntryTimeSet == pdFALSE ) && ( xTicksToWait == ( TickType_t ) 0 ) ) ||
+					 ( ( xEntryTimeSet != pdFALSE ) && ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE ) ) )
+			{
+				if( xInheritanceOccurred != pdFALSE )
+				{
+					prvDisinheritHoldersAfterTimeout( pxLock );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* Readers that were only waiting because this writer was
+				waiting can now be given the lock. */
+				if( xForWriting != pdFALSE )
+				{
+					if( prvGrantWaitingTasks( pxLock ) != pdFALSE )
+					{
+						portYIELD_WITHIN_API();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* Undo the increment made on entry.  This task does not hold
+				the lock, so cannot have inherited a priority through it, but
+				xTaskPriorityDisinherit() is still needed to keep the count
+				consistent with any other mutexes the task holds.  If the count
+				reaches zero while this task still runs at an inherited
+				priority it drops back to its base priority, so a task of a
+				higher priority may now be ready to run.  The yield is pended
+				until the critical section is exited. */
+				if( xTaskPriorityDisinherit( xSelf ) != pdFALSE )
+				{
+					portYIELD_WITHIN_API();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				xReturn = pdFAIL;
+			}
+			else
+			{
+				/* A task that holds the lock must not wait for it again. */
+				configASSERT( ( pxLock->xWriter != xSelf ) && ( prvIsHolder( pxLock, xSelf, pdFALSE ) == pdFALSE ) );
+
+				if( xEntryTimeSet == pdFALSE )
+				{
+					vTaskInternalSetTimeOutState( &xTimeOut );
+					xEntryTimeSet = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				if( prvInheritToHolders( pxLock ) != pdFALSE )
+				{
+					xInheritanceOccurred = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				traceBLOCKING_ON_RW_LOCK( pxLock, xForWriting );
+
+				if( xForWriting != pdFALSE )
+				{
+					vTaskPlaceOnEventList( &( pxLock->xTasksWaitingToWrite ), xTicksToWait );
+				}
+				else
+				{
+					vTaskPlaceOnEventList( &( pxLock->xTasksWaitingToRead ), xTicksToWait );
+				}
+
+				/* The yield is pended until the critical section is exited. */
+				portYIELD_WITHIN_API();
+				xBlocked = pdTRUE;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+	} while( xBlocked != pdFALSE );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvUnlock( RwLock_t * const pxLock, const BaseType_t xForWriting )
+{
+TaskHandle_t xSelf;
+BaseType_t xReturn;
+
+	xSelf = xTaskGetCurrentTaskHandle();
+
+	taskENTER_CRITICAL();
+	{
+		if( prvRemoveHolder( pxLock, xSelf, xForWriting ) != pdFALSE )
+		{
+			if( prvGrantWaitingTasks( pxLock ) != pdFALSE )
+			{
+				portYIELD_WITHIN_API();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* Drop any priority inherited from the tasks that waited. */
+			if( xTaskPriorityDisinherit( xSelf ) != pdFALSE )
+			{
+				portYIELD_WITHIN_API();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			xReturn = pdPASS;
+		}
+		else
+		{
+			xReturn = pdFAIL;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvIsHolder( const RwLock_t * const pxLock, const TaskHandle_t xTask, const BaseType_t xForWriting )
+{
+BaseType_t xReturn = pdFALSE;
+UBaseType_t ux;
+
+	if( xForWriting != pdFALSE )
+	{
+		if( pxLock->xWriter == xTask )
+		{
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		for( ux = ( UBaseType_t ) 0; ux < pxLock->uxReaders; ux++ )
+		{
+			if( pxLock->xReaderTasks[ ux ] == xTask )
+			{
+				xReturn = pdTRUE;
+				break;
+			}
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvRemoveHolder( RwLock_t * const pxLock, const TaskHandle_t xTask, const BaseType_t xForWriting )
+{
+BaseType_t xReturn = pdFALSE;
+UBaseType_t ux;
+
+	if( xForWriting != pdFALSE )
+	{
+		if( pxLock->xWriter == xTask )
+		{
+			pxLock->xWriter = NULL;
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		for( ux = ( UBaseType_t ) 0; ux < pxLock->uxReaders; ux++ )
+		{
+			if( pxLock->xReaderTasks[ ux ] == xTask )
+			{
+				/* The order of the readers does not matter, so fill the gap
+				with the last reader. */
+				( pxLock->uxReaders )--;
+				pxLock->xReaderTasks[ ux ] = pxLock->xReaderTasks[ pxLock->uxReaders ];
+				xReturn = pdTRUE;
+				break;
+			}
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvGrantWaitingTasks( RwLock_t * const pxLock )
+{
+BaseType_t xYieldRequired = pdFALSE;
+
+	if( pxLock->xWriter == NULL )
+	{
+		if( listLIST_IS_EMPTY( &( pxLock->xTasksWaitingToWrite ) ) == pdFALSE )
+		{
+			if( pxLock->uxReaders == ( UBaseType_t ) 0 )
+			{
+				pxLock->xWriter = ( TaskHandle_t ) listGET_OWNER_OF_HEAD_ENTRY( &( pxLock->xTasksWaitingToWrite ) );
+				xYieldRequired = xTaskRemoveFromEventList( &( pxLock->xTasksWaitingToWrite ) );
+			}
+			else
+			{
+				/* The writer must wait for the remaining readers. */
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			/* The number of readers given the lock at once is limited by
+			configRW_LOCK_MAX_READERS, so this loop is bounded. */
+			while( ( listLIST_IS_EMPTY( &( pxLock->xTasksWaitingToRead ) ) == pdFALSE ) &&
+				   ( pxLock->uxReaders < ( UBaseType_t ) configRW_LOCK_MAX_READERS ) )
+			{
+				pxLock->xReaderTasks[ pxLock->uxReaders ] = ( TaskHandle_t ) listGET_OWNER_OF_HEAD_ENTRY( &( pxLock->xTasksWaitingToRead ) );
+				( pxLock->uxReaders )++;
+
+				if( xTaskRemoveFromEventList( &( pxLock->xTasksWaitingToRead ) ) != pdFALSE )
+				{
+					xYieldRequired = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xYieldRequired;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvInheritToHolders( RwLock_t * const pxLock )
+{
+BaseType_t xInheritanceOccurred = pdFALSE;
+UBaseType_t ux;
+
+	if( pxLock->xWriter != NULL )
+	{
+		xInheritanceOccurred = xTaskPriorityInherit( pxLock->xWriter );
+	}
+	else
+	{
+		for( ux = ( UBaseType_t ) 0; ux < pxLock->uxReaders; ux++ )
+		{
+			if( xTaskPriorityInherit( pxLock->xReaderTasks[ ux ] ) != pdFALSE )
+			{
+				xInheritanceOccurred = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
+
+	return xInheritanceOccurred;
+}
+/*-----------------------------------------------------------*/
+
+static void prvDisinheritHoldersAfterTimeout( RwLock_t * const pxLock )
+{
+UBaseType_t uxHighestPriorityOfWaitingTasks = tskIDLE_PRIORITY, uxPriority, ux;
+
+	/* The lists are in priority order, and the item value of a task's event
+	list item is configMAX_PRIORITIES minus the task's priority. */
+	if( listCURRENT_LIST_LENGTH( &( pxLock->xTasksWaitingToWrite ) ) > 0 )
+	{
+		uxHighestPriorityOfWaitingTasks = configMAX_PRIORITIES - listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxLock->xTasksWaitingToWrite ) );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( listCURRENT_LIST_LENGTH( &( pxLock->xTasksWaitingToRead ) ) > 0 )
+	{
+		uxPriority = configMAX_PRIORITIES - listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxLock->xTasksWaitingToRead ) );
+
+		if( uxPriority > uxHighestPriorityOfWaitingTasks )
+		{
+			uxHighestPriorityOfWaitingTasks = uxPriority;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( pxLock->xWriter != NULL )
+	{
+		vTaskPriorityDisinheritAfterTimeout( pxLock->xWriter, uxHighestPriorityOfWaitingTasks );
+	}
+	else
+	{
+		for( ux = ( UBaseType_t ) 0; ux < pxLock->uxReaders; ux++ )
+		{
+			vTaskPriorityDisinheritAfterTimeout( pxLock->xReaderTasks[ ux ], uxHighestPriorityOfWaitingTasks );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseNewRwLock( RwLock_t * const pxLock )
+{
+	pxLock->xWriter = NULL;
+	pxLock->uxReaders = ( UBaseType_t ) 0;
+	vListInitialise( &( pxLock->xTasksWaitingToRead ) );
+	vListInitialise( &( pxLock->xTasksWaitingToWrite ) );
+	pxLock->ucFlags = ( uint8_t ) 0;
+}
+
+/* This entire source file will be skipped if the application is not configured
+to include reader-writer lock functionality. */
+#endif /* configUSE_RW_LOCKS == 1 */
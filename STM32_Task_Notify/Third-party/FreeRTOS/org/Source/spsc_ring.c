@@ -0,0 +1,464 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "spsc_ring.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* This entire source file will be skipped if the application is not configured
+to include SPSC ring functionality. */
+#if( configUSE_SPSC_RINGS == 1 )
+
+#if( configUSE_TASK_NOTIFICATIONS != 1 )
+	#error configUSE_TASK_NOTIFICATIONS must be set to 1 to build spsc_ring.c
+#endif
+
+#if( ( INCLUDE_xTaskGetCurrentTaskHandle != 1 ) && ( configUSE_MUTEXES != 1 ) )
+	#error INCLUDE_xTaskGetCurrentTaskHandle must be set to 1 to build spsc_ring.c
+#endif
+
+/* Bits stored in the ucFlags field of the ring. */
+#define spscFLAGS_IS_STATICALLY_ALLOCATED ( ( uint8_t ) 1 ) /* Set if the ring was created using statically allocated memory. */
+
+/*-----------------------------------------------------------*/
+
+/* Structure that holds the state of a ring.  ulHead and ulOverrunCount are
+only written by the producer, ulTail and xConsumerTask only by the consumer.
+The ring is empty when ulHead equals ulTail, and full when advancing ulHead
+would make it equal ulTail, so one of the ulSlots slots is always unused. */
+typedef struct xSPSC_RING /*lint !e9058 Style convention uses tag. */
+{
+	volatile uint32_t ulHead;				/* Index of the slot the next item is written to. */
+	volatile uint32_t ulTail;				/* Index of the slot holding the oldest item. */
+	volatile uint32_t ulOverrunCount;		/* The number of items dropped because the ring was full. */
+	uint32_t ulSlots;						/* The number of slots, one more than the ring's length. */
+	size_t xItemSize;						/* The size of each item in bytes. */
+	uint8_t *pucStorage;					/* Points to the first slot. */
+	TaskHandle_t volatile xConsumerTask;	/* The task to notify when an item is added to an empty ring, or NULL if no task has waited on the ring yet. */
+	uint8_t ucFlags;
+} SpscRing_t;
+
+/*
+ * Called by both xSpscRingCreate() and xSpscRingCreateStatic() to initialise
+ * the ring structure.
+ */
+static void prvInitialiseNewSpscRing( SpscRing_t * const pxRing,
+									  uint8_t * const pucStorage,
+									  UBaseType_t uxLength,
+									  size_t xItemSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * Common part of xSpscRingSend() and xSpscRingSendFromISR().  Copies the item
+ * in and publishes it.  Returns pdFAIL if the ring was full, otherwise pdPASS,
+ * with *pxNotifyConsumer set to pdTRUE if the ring was empty before the item
+ * was added - in which case the consumer may be blocked and must be notified.
+ */
+static BaseType_t prvSpscRingPush( SpscRing_t * const pxRing, const void * const pvItem, BaseType_t * const pxNotifyConsumer ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	SpscRingHandle_t xSpscRingCreate( UBaseType_t uxLength, size_t xItemSize )
+	{
+	uint8_t *pucAllocatedMemory = NULL;
+	size_t xHeaderSize, xStorageSize;
+
+		configASSERT( uxLength > ( UBaseType_t ) 0 );
+		configASSERT( xItemSize > ( size_t ) 0 );
+
+		/* The SpscRing_t structure is placed at the start of the allocated
+		memory, padded so the storage that follows it is aligned. */
+		xHeaderSize = ( sizeof( SpscRing_t ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+		xStorageSize = spscRING_STORAGE_SIZE( uxLength, xItemSize );
+
+		/* Check for multiplication overflow. */
+		if( ( xStorageSize / xItemSize ) == ( ( size_t ) uxLength + ( size_t ) 1 ) )
+		{
+			pucAllocatedMemory = ( uint8_t * ) pvPortMalloc( xHeaderSize + xStorageSize ); /*lint !e9079 malloc() only returns void*. */
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( pucAllocatedMemory != NULL )
+		{
+			prvInitialiseNewSpscRing( ( SpscRing_t * ) pucAllocatedMemory, /*lint !e9087 !e826 Safe cast as allocated memory is aligned. */
+									  pucAllocatedMemory + xHeaderSize,
+									  uxLength,
+									  xItemSize );
+
+			traceSPSC_RING_CREATE( ( ( SpscRing_t * ) pucAllocatedMemory ) );
+		}
+		else
+		{
+			traceSPSC_RING_CREATE_FAILED();
+		}
+
+		return ( SpscRingHandle_t ) pucAllocatedMemory;
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+	SpscRingHandle_t xSpscRingCreateStatic( UBaseType_t uxLength,
+											size_t xItemSize,
+											uint8_t * const pucRingStorageArea,
+											StaticSpscRing_t * const pxStaticSpscRing )
+	{
+	SpscRing_t * const pxRing = ( SpscRing_t * ) pxStaticSpscRing; /*lint !e740 !e9087 Safe cast as StaticSpscRing_t is opaque SpscRing_t. */
+	SpscRingHandle_t xReturn;
+
+		configASSERT( pucRingStorageArea );
+		configASSERT( pxStaticSpscRing );
+		configASSERT( uxLength > ( UBaseType_t ) 0 );
+		configASSERT( xItemSize > ( size_t ) 0 );
+
+		#if( configASSERT_DEFINED == 1 )
+		{
+			/* Sanity check that the size of the structure used to declare a
+			variable of type StaticSpscRing_t equals the size of the real ring
+			structure. */
+			volatile size_t xSize = sizeof( StaticSpscRing_t );
+			configASSERT( xSize == sizeof( SpscRing_t ) );
+		}
+		#endif /* configASSERT_DEFINED */
+
+		if( ( pucRingStorageArea != NULL ) && ( pxStaticSpscRing != NULL ) )
+		{
+			prvInitialiseNewSpscRing( pxRing, pucRingStorageArea, uxLength, xItemSize );
+
+			/* Remember this was statically allocated in case it is ever deleted
+			again. */
+			pxRing->ucFlags |= spscFLAGS_IS_STATICALLY_ALLOCATED;
+
+			traceSPSC_RING_CREATE( pxRing );
+
+			xReturn = ( SpscRingHandle_t ) pxStaticSpscRing;
+		}
+		else
+		{
+			xReturn = NULL;
+			traceSPSC_RING_CREATE_FAILED();
+		}
+
+		return xReturn;
+	}
+
+#endif /* ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+/*-----------------------------------------------------------*/
+
+void vSpscRingDelete( SpscRingHandle_t xRing )
+{
+SpscRing_t * const pxRing = ( SpscRing_t * ) xRing; /*lint !e9087 !e9079 Safe cast as SpscRingHandle_t is opaque SpscRing_t. */
+
+	configASSERT( pxRing );
+
+	traceSPSC_RING_DELETE( pxRing );
+
+	if( ( pxRing->ucFlags & spscFLAGS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) pdFALSE )
+	{
+		#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+		{
+			/* The structure and the storage were allocated using a single call
+			to pvPortMalloc(), hence only one call to vPortFree() is required. */
+			vPortFree( ( void * ) pxRing );
+		}
+		#else
+		{
+			/* Should not be possible to get here, ucFlags must be corrupt.
+			Force an assert. */
+			configASSERT( xRing == ( SpscRingHandle_t ) ~0 );
+		}
+		#endif
+	}
+	else
+	{
+		/* The structure and storage were not allocated dynamically and cannot
+		be freed - just scrub the structure so future use will assert. */
+		memset( pxRing, 0x00, sizeof( SpscRing_t ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSpscRingSend( SpscRingHandle_t xRing, const void * const pvItem )
+{
+SpscRing_t * const pxRing = ( SpscRing_t * ) xRing; /*lint !e9087 !e9079 Safe cast as SpscRingHandle_t is opaque SpscRing_t. */
+BaseType_t xNotifyConsumer, xReturn;
+TaskHandle_t xConsumerTask;
+
+	configASSERT( pxRing );
+	configASSERT( pvItem );
+
+	xReturn = prvSpscRingPush( pxRing, pvItem, &xNotifyConsumer );
+
+	if( xNotifyConsumer != pdFALSE )
+	{
+		xConsumerTask = pxRing->xConsumerTask;
+
+		if( xConsumerTask != NULL )
+		{
+			( void ) xTaskNotifyGive( xConsumerTask );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSpscRingSendFromISR( SpscRingHandle_t xRing, const void * const pvItem, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+SpscRing_t * const pxRing = ( SpscRing_t * ) xRing; /*lint !e9087 !e9079 Safe cast as SpscRingHandle_t is opaque SpscRing_t. */
+BaseType_t xNotifyConsumer, xReturn;
+TaskHandle_t xConsumerTask;
+
+	configASSERT( pxRing );
+	configASSERT( pvItem );
+
+	xReturn = prvSpscRingPush( pxRing, pvItem, &xNotifyConsumer );
+
+	if( xNotifyConsumer != pdFALSE )
+	{
+		xConsumerTask = pxRing->xConsumerTask;
+
+		if( xConsumerTask != NULL )
+		{
+			vTaskNotifyGiveFromISR( xConsumerTask, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSpscRingReceive( SpscRingHandle_t xRing, void * const pvBuffer, TickType_t xTicksToWait )
+{
+SpscRing_t * const pxRing = ( SpscRing_t * ) xRing; /*lint !e9087 !e9079 Safe cast as SpscRingHandle_t is opaque SpscRing_t. */
+TimeOut_t xTimeOut;
+uint32_t ulTail, ulNextTail;
+BaseType_t xReturn = errQUEUE_EMPTY;
+
+	configASSERT( pxRing );
+	configASSERT( pvBuffer );
+
+	/* Only one task may consume from a ring. */
+	configASSERT( ( pxRing->xConsumerTask == NULL ) || ( pxRing->xConsumerTask == xTaskGetCurrentTaskHandle() ) );
+
+	vTaskSetTimeOutState( &xTimeOut );
+
+	for( ;; )
+	{
+		ulTail = pxRing->ulTail;
+
+		if( pxRing->ulHead != ulTail )
+		{
+			( void ) memcpy( pvBuffer, ( const void * ) ( pxRing->pucStorage + ( ( size_t ) ulTail * pxRing->xItemSize ) ), pxRing->xItemSize );
+
+			ulNextTail = ulTail + 1UL;
+			if( ulNextTail == pxRing->ulSlots )
+			{
+				ulNextTail = 0UL;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* The item must have been copied out before the slot is handed
+			back to the producer. */
+			portMEMORY_BARRIER();
+			pxRing->ulTail = ulNextTail;
+
+			xReturn = pdPASS;
+			break;
+		}
+		else if( xTicksToWait == ( TickType_t ) 0 )
+		{
+			break;
+		}
+		else if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE )
+		{
+			break;
+		}
+		else
+		{
+			/* The ring was empty.  The producer reads ulTail after publishing
+			a new head, and this task read ulHead after publishing its last
+			tail, so either the check above saw the new item or the producer
+			saw an empty ring and will notify this task - in which case the
+			notification is already pending if it arrived before the call
+			below, and ulTaskNotifyTake() returns at once. */
+			if( pxRing->xConsumerTask == NULL )
+			{
+				pxRing->xConsumerTask = xTaskGetCurrentTaskHandle();
+
+				/* The producer may have added an item before it knew which
+				task to notify, so check again before blocking. */
+				continue;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			traceSPSC_RING_BLOCKING_ON_RECEIVE( pxRing );
+			( void ) ulTaskNotifyTake( pdTRUE, xTicksToWait );
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxSpscRingItemsWaiting( SpscRingHandle_t xRing )
+{
+SpscRing_t * const pxRing = ( SpscRing_t * ) xRing; /*lint !e9087 !e9079 Safe cast as SpscRingHandle_t is opaque SpscRing_t. */
+uint32_t ulHead, ulTail;
+
+	configASSERT( pxRing );
+
+	ulTail = pxRing->ulTail;
+	ulHead = pxRing->ulHead;
+
+	if( ulHead < ulTail )
+	{
+		ulHead += pxRing->ulSlots;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return ( UBaseType_t ) ( ulHead - ulTail );
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulSpscRingGetOverrunCount( SpscRingHandle_t xRing )
+{
+SpscRing_t * const pxRing = ( SpscRing_t * ) xRing; /*lint !e9087 !e9079 Safe cast as SpscRingHandle_t is opaque SpscRing_t. */
+
+	configASSERT( pxRing );
+
+	return pxRing->ulOverrunCount;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSpscRingPush( SpscRing_t * const pxRing, const void * const pvItem, BaseType_t * const pxNotifyConsumer )
+{
+uint32_t ulHead, ulNextHead;
+BaseType_t xReturn;
+
+	ulHead = pxRing->ulHead;
+	ulNextHead = ulHead + 1UL;
+
+	if( ulNextHead == pxRing->ulSlots )
+	{
+		ulNextHead = 0UL;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( ulNextHead == pxRing->ulTail )
+	{
+		/* Full.  Only the producer writes the overrun count, so a plain
+		increment is safe. */
+		pxRing->ulOverrunCount++;
+		traceSPSC_RING_OVERRUN( pxRing );
+
+		*pxNotifyConsumer = pdFALSE;
+		xReturn = errQUEUE_FULL;
+	}
+	else
+	{
+		( void ) memcpy( ( void * ) ( pxRing->pucStorage + ( ( size_t ) ulHead * pxRing->xItemSize ) ), pvItem, pxRing->xItemSize );
+
+		/* The item must be in place before the consumer can see it. */
+		portMEMORY_BARRIER();
+		pxRing->ulHead = ulNextHead;
+
+		/* If the consumer had caught up with the old head, the ring was empty
+		and the consumer may be blocked. */
+		*pxNotifyConsumer = ( pxRing->ulTail == ulHead ) ? pdTRUE : pdFALSE;
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseNewSpscRing( SpscRing_t * const pxRing,
+									  uint8_t * const pucStorage,
+									  UBaseType_t uxLength,
+									  size_t xItemSize )
+{
+	/* The index arithmetic is done in 32 bits. */
+	configASSERT( ( uint32_t ) uxLength < ( uint32_t ) 0xffffffffUL );
+
+	memset( ( void * ) pxRing, 0x00, sizeof( SpscRing_t ) );
+
+	pxRing->ulSlots = ( uint32_t ) uxLength + 1UL;
+	pxRing->xItemSize = xItemSize;
+	pxRing->pucStorage = pucStorage;
+}
+
+/* This entire source file will be skipped if the application is not configured
+to include SPSC ring functionality. */
+#endif /* configUSE_SPSC_RINGS == 1 */
@@ -39,6 +39,7 @@ task.h is included from an application file. */
 #include "FreeRTOS.h"
 #include "task.h"
 #include "stream_buffer.h"
+#include "object_registry.h"
 
 /* Lint e961 and e750 are suppressed as a MISRA exception justified because the
 MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined for the
@@ -128,9 +129,28 @@ that uses task notifications. */
 /* The number of bytes used to hold the length of a message in the buffer. */
 #define sbBYTES_TO_STORE_MESSAGE_LENGTH ( sizeof( size_t ) )
 
+/* The most bytes any of the length formats can take.  A size_t in the varint
+format takes one byte for every 7 bits, so 5 bytes for a 32-bit size_t. */
+#define sbMAX_BYTES_TO_STORE_MESSAGE_LENGTH ( ( ( sizeof( size_t ) * ( size_t ) 8 ) + ( size_t ) 6 ) / ( size_t ) 7 )
+
+/* The longest messages the 1 and 2 byte length formats can describe. */
+#define sbMAX_LENGTH_IN_1_BYTE			( ( size_t ) 0xff )
+#define sbMAX_LENGTH_IN_2_BYTES			( ( size_t ) 0xffff )
+
+/* Each byte of a varint length holds 7 bits of the length, least significant
+first, with the top bit set in every byte except the last. */
+#define sbVARINT_MORE_BYTES				( ( uint8_t ) 0x80 )
+#define sbVARINT_VALUE_BITS				( ( uint8_t ) 0x7f )
+
 /* Bits stored in the ucFlags field of the stream buffer. */
 #define sbFLAGS_IS_MESSAGE_BUFFER		( ( uint8_t ) 1 ) /* Set if the stream buffer was created as a message buffer, in which case it holds discrete messages rather than a stream. */
 #define sbFLAGS_IS_STATICALLY_ALLOCATED ( ( uint8_t ) 2 ) /* Set if the stream buffer was created using statically allocated memory. */
+#define sbFLAGS_IS_MULTI_PRODUCER		( ( uint8_t ) 4 ) /* Set if more than one task or interrupt can write to the stream buffer at once. */
+#define sbFLAGS_LENGTH_FORMAT_MASK		( ( uint8_t ) 0x18 ) /* Message buffers only.  How the length of each message is stored, one of the values below. */
+#define sbFLAGS_LENGTH_SIZE_T			( ( uint8_t ) 0x00 ) /* sbBYTES_TO_STORE_MESSAGE_LENGTH bytes in native byte order - the default. */
+#define sbFLAGS_LENGTH_1_BYTE			( ( uint8_t ) 0x08 ) /* One byte, so messages of up to 255 bytes. */
+#define sbFLAGS_LENGTH_2_BYTES			( ( uint8_t ) 0x10 ) /* Two bytes, little endian, so messages of up to 65535 bytes. */
+#define sbFLAGS_LENGTH_VARINT			( ( uint8_t ) 0x18 ) /* One byte for messages of up to 127 bytes, two for up to 16383 bytes, and so on. */
 
 /*-----------------------------------------------------------*/
 
@@ -149,6 +169,18 @@ typedef struct xSTREAM_BUFFER /*lint !e9058 Style convention uses tag. */
 	#if ( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxStreamBufferNumber;		/* Used for tracing purposes. */
 	#endif
+
+	#if ( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+		volatile size_t xReserveHead;			/* Multi-producer buffers only.  Index to the end of the space reserved by writers, which is ahead of xHead while writes are in progress. */
+		volatile UBaseType_t uxWritersInFlight;	/* Multi-producer buffers only.  The number of writers that have reserved space but not yet finished writing to it. */
+		List_t xTasksWaitingToSend;				/* Multi-producer buffers only.  The tasks waiting for space, in priority order.  Used in place of xTaskWaitingToSend, which can only hold one. */
+	#endif
+
+	#if ( configUSE_STREAM_BUFFER_COALESCING == 1 )
+		TickType_t xMaxLatency;					/* The most ticks a reader waits for the trigger level once data has arrived, or 0 if coalescing is off. */
+		volatile TickType_t xFirstByteTime;		/* The tick count at which the oldest byte in the buffer was written.  Only valid while xLatencyClockRunning is pdTRUE. */
+		volatile BaseType_t xLatencyClockRunning;	/* Set when a byte is written to the empty buffer, and cleared when the buffer is emptied again. */
+	#endif
 } StreamBuffer_t;
 
 /*
@@ -157,12 +189,39 @@ typedef struct xSTREAM_BUFFER /*lint !e9058 Style convention uses tag. */
 static size_t prvBytesInBuffer( const StreamBuffer_t * const pxStreamBuffer ) PRIVILEGED_FUNCTION;
 
 /*
- * Add xCount bytes from pucData into the pxStreamBuffer message buffer.
- * Returns the number of bytes written, which will either equal xCount in the
- * success case, or 0 if there was not enough space in the buffer (in which case
- * no data is written into the buffer).
+ * Copy xCount bytes from pucData into the storage area of pxStreamBuffer,
+ * starting at index xHead.  The space must already be known to be free.
+ * Returns the index that follows the bytes written.  The caller moves the
+ * stream buffer's xHead, so it decides when the bytes become visible to the
+ * reader.
+ */
+static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer, const uint8_t *pucData, size_t xCount, size_t xHead ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the number of bytes the message buffer pxStreamBuffer uses to store
+ * a message length of xMessageLength.  Passing 0 gives the fewest bytes any
+ * length can take.  If xMessageLength is too long for the buffer's length
+ * format then the size of the whole storage area is returned, so a message of
+ * that length never fits, and the send functions check for it to fail the
+ * send straight away.
+ */
+static size_t prvBytesToStoreMessageLength( const StreamBuffer_t * const pxStreamBuffer, size_t xMessageLength ) PRIVILEGED_FUNCTION;
+
+/*
+ * Write xMessageLength to the storage area of the message buffer
+ * pxStreamBuffer, starting at index xHead, in the buffer's length format.
+ * xLengthBytes must be at least prvBytesToStoreMessageLength( xMessageLength ),
+ * a varint length being padded out to xLengthBytes bytes if it is longer.
+ * Returns the index that follows the length.
+ */
+static size_t prvWriteMessageLength( StreamBuffer_t * const pxStreamBuffer, size_t xMessageLength, size_t xLengthBytes, size_t xHead ) PRIVILEGED_FUNCTION;
+
+/*
+ * Read the length of the message that starts at index xTail of the message
+ * buffer pxStreamBuffer into *pxMessageLength, without moving xTail.  Returns
+ * the number of bytes the length takes.
  */
-static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer, const uint8_t *pucData, size_t xCount ) PRIVILEGED_FUNCTION;
+static size_t prvReadMessageLength( const StreamBuffer_t * const pxStreamBuffer, size_t xTail, size_t * const pxMessageLength ) PRIVILEGED_FUNCTION;
 
 /*
  * If the stream buffer is being used as a message buffer, then reads an entire
@@ -207,13 +266,123 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 										  uint8_t * const pucBuffer,
 										  size_t xBufferSizeBytes,
 										  size_t xTriggerLevelBytes,
-										  BaseType_t xIsMessageBuffer ) PRIVILEGED_FUNCTION;
+										  uint8_t ucFlags ) PRIVILEGED_FUNCTION;
+
+/*
+ * Convert the sbTYPE_ bits passed to the create functions into the ucFlags
+ * bits stored in the stream buffer structure.
+ */
+static uint8_t prvGetFlagsFromType( BaseType_t xStreamBufferType ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called by the send functions once bytes have been added to the buffer.
+ * Returns pdTRUE if a task waiting for data should be unblocked - that is, if
+ * the trigger level has been reached, or if coalescing is on and the bytes are
+ * the first to arrive since the buffer was last empty.
+ */
+static BaseType_t prvShouldWakeReader( StreamBuffer_t * const pxStreamBuffer ) PRIVILEGED_FUNCTION;
+
+#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+
+	/*
+	 * The write path used by multi-producer stream and message buffers.
+	 * Reserves xRequiredSpace bytes with interrupts briefly masked, copies the
+	 * data (preceded by its length if pxStreamBuffer is a message buffer) with
+	 * interrupts enabled, then marks the write complete.  Returns
+	 * xDataLengthBytes, or 0 if there was not enough space, in which case
+	 * nothing is written.
+	 */
+	static size_t prvWriteMultiProducer( StreamBuffer_t * const pxStreamBuffer,
+										 const void * pvTxData,
+										 size_t xDataLengthBytes,
+										 size_t xRequiredSpace ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Called by the read functions once space has been freed.  Unblocks every
+	 * task waiting on xTasksWaitingToSend, so each can check whether its own
+	 * write now fits.  The list is always empty unless pxStreamBuffer is a
+	 * multi-producer buffer.  The FromISR version returns pdTRUE if any task
+	 * was unblocked.
+	 */
+	static void prvUnblockWaitingWriters( StreamBuffer_t * const pxStreamBuffer ) PRIVILEGED_FUNCTION;
+	static BaseType_t prvUnblockWaitingWritersFromISR( StreamBuffer_t * const pxStreamBuffer, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_STREAM_BUFFER_MULTI_PRODUCER */
+
+#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+
+	/*
+	 * Called by a reader that has found xBytesAvailable bytes in the buffer,
+	 * but fewer than the trigger level.  Blocks until the trigger level is
+	 * reached, the oldest byte has been in the buffer for xMaxLatency ticks, or
+	 * the reader's own timeout expires.  Returns the number of bytes then in the
+	 * buffer.
+	 */
+	static size_t prvWaitForCoalescedData( StreamBuffer_t * const pxStreamBuffer,
+										   size_t xBytesAvailable,
+										   TimeOut_t * const pxTimeOut,
+										   TickType_t * const pxTicksToWait ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Called after bytes have been removed from the buffer.  If the buffer is
+	 * now empty then the next byte written starts the latency clock again.
+	 */
+	static void prvStopLatencyClock( StreamBuffer_t * const pxStreamBuffer ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_STREAM_BUFFER_COALESCING */
+
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+	/*
+	 * Describe the xCount bytes that start at index xStart of the storage area
+	 * as up to two regions, the second of which starts at the beginning of the
+	 * storage area if the bytes wrap.
+	 */
+	static void prvDescribeRegions( const StreamBuffer_t * const pxStreamBuffer,
+									size_t xStart,
+									size_t xCount,
+									StreamBufferRegions_t * const pxRegions ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Describe the free space into which the next write can be made, leaving
+	 * room for the message length if pxStreamBuffer is a message buffer.
+	 * Returns the total length of the regions.
+	 */
+	static size_t prvGetWriteRegions( StreamBuffer_t * const pxStreamBuffer, StreamBufferRegions_t * const pxRegions ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Describe the data that can be read next - all the bytes in a stream
+	 * buffer, or the body of the next message in a message buffer.  Returns the
+	 * total length of the regions.
+	 */
+	static size_t prvGetReadRegions( const StreamBuffer_t * const pxStreamBuffer, StreamBufferRegions_t * const pxRegions ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * The number of bytes the zero copy write functions leave in front of a
+	 * message for its length.  The length is not known until the message is
+	 * committed, so room is left for the length of the longest message the
+	 * buffer can hold.
+	 */
+	static size_t prvReservedLengthBytes( const StreamBuffer_t * const pxStreamBuffer ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Add the xCount bytes the application wrote into the write regions to the
+	 * buffer, preceded by their length if pxStreamBuffer is a message buffer.
+	 */
+	static void prvCommitWrite( StreamBuffer_t * const pxStreamBuffer, size_t xCount ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Remove xCount bytes, or the next message, from the buffer.
+	 */
+	static void prvConsumeRead( StreamBuffer_t * const pxStreamBuffer, size_t xCount ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
 
 /*-----------------------------------------------------------*/
 
 #if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
 
-	StreamBufferHandle_t xStreamBufferGenericCreate( size_t xBufferSizeBytes, size_t xTriggerLevelBytes, BaseType_t xIsMessageBuffer )
+	StreamBufferHandle_t xStreamBufferGenericCreate( size_t xBufferSizeBytes, size_t xTriggerLevelBytes, BaseType_t xStreamBufferType )
 	{
 	uint8_t *pucAllocatedMemory;
 
@@ -248,13 +417,13 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 										   pucAllocatedMemory + sizeof( StreamBuffer_t ),  /* Storage area follows. */ /*lint !e9016 Indexing past structure valid for uint8_t pointer, also storage area has no alignment requirement. */
 										   xBufferSizeBytes,
 										   xTriggerLevelBytes,
-										   xIsMessageBuffer );
+										   prvGetFlagsFromType( xStreamBufferType ) );
 
-			traceSTREAM_BUFFER_CREATE( ( ( StreamBuffer_t * ) pucAllocatedMemory ), xIsMessageBuffer );
+			traceSTREAM_BUFFER_CREATE( ( ( StreamBuffer_t * ) pucAllocatedMemory ), ( xStreamBufferType & sbTYPE_MESSAGE_BUFFER ) );
 		}
 		else
 		{
-			traceSTREAM_BUFFER_CREATE_FAILED( xIsMessageBuffer );
+			traceSTREAM_BUFFER_CREATE_FAILED( ( xStreamBufferType & sbTYPE_MESSAGE_BUFFER ) );
 		}
 
 		return ( StreamBufferHandle_t * ) pucAllocatedMemory; /*lint !e9087 !e826 Safe cast as allocated memory is aligned. */
@@ -267,7 +436,7 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 
 	StreamBufferHandle_t xStreamBufferGenericCreateStatic( size_t xBufferSizeBytes,
 														   size_t xTriggerLevelBytes,
-														   BaseType_t xIsMessageBuffer,
+														   BaseType_t xStreamBufferType,
 														   uint8_t * const pucStreamBufferStorageArea,
 														   StaticStreamBuffer_t * const pxStaticStreamBuffer )
 	{
@@ -307,20 +476,20 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 										  pucStreamBufferStorageArea,
 										  xBufferSizeBytes,
 										  xTriggerLevelBytes,
-										  xIsMessageBuffer );
+										  prvGetFlagsFromType( xStreamBufferType ) );
 
 			/* Remember this was statically allocated in case it is ever deleted
 			again. */
 			pxStreamBuffer->ucFlags |= sbFLAGS_IS_STATICALLY_ALLOCATED;
 
-			traceSTREAM_BUFFER_CREATE( pxStreamBuffer, xIsMessageBuffer );
+			traceSTREAM_BUFFER_CREATE( pxStreamBuffer, ( xStreamBufferType & sbTYPE_MESSAGE_BUFFER ) );
 
 			xReturn = ( StreamBufferHandle_t ) pxStaticStreamBuffer; /*lint !e9087 Data hiding requires cast to opaque type. */
 		}
 		else
 		{
 			xReturn = NULL;
-			traceSTREAM_BUFFER_CREATE_STATIC_FAILED( xReturn, xIsMessageBuffer );
+			traceSTREAM_BUFFER_CREATE_STATIC_FAILED( xReturn, ( xStreamBufferType & sbTYPE_MESSAGE_BUFFER ) );
 		}
 
 		return xReturn;
@@ -337,6 +506,12 @@ StreamBuffer_t * pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9
 
 	traceSTREAM_BUFFER_DELETE( xStreamBuffer );
 
+	#if( configUSE_OBJECT_REGISTRY == 1 )
+	{
+		vObjectRegistryRemove( xStreamBuffer );
+	}
+	#endif
+
 	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) pdFALSE )
 	{
 		#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
@@ -365,11 +540,14 @@ StreamBuffer_t * pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9
 BaseType_t xStreamBufferReset( StreamBufferHandle_t xStreamBuffer )
 {
 StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9087 !e9079 Safe cast as StreamBufferHandle_t is opaque Streambuffer_t. */
-BaseType_t xReturn = pdFAIL, xIsMessageBuffer;
+BaseType_t xReturn = pdFAIL;
 
 #if( configUSE_TRACE_FACILITY == 1 )
 	UBaseType_t uxStreamBufferNumber;
 #endif
+#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+	TickType_t xMaxLatency;
+#endif
 
 	configASSERT( pxStreamBuffer );
 
@@ -381,25 +559,30 @@ BaseType_t xReturn = pdFAIL, xIsMessageBuffer;
 	}
 	#endif
 
+	#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+	{
+		/* Likewise the coalescing latency, which is a setting rather than
+		state. */
+		xMaxLatency = pxStreamBuffer->xMaxLatency;
+	}
+	#endif
+
 	/* Can only reset a message buffer if there are no tasks blocked on it. */
 	if( pxStreamBuffer->xTaskWaitingToReceive == NULL )
 	{
-		if( pxStreamBuffer->xTaskWaitingToSend == NULL )
+		if( ( pxStreamBuffer->xTaskWaitingToSend == NULL )
+			#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+				&& ( listLIST_IS_EMPTY( &( pxStreamBuffer->xTasksWaitingToSend ) ) != pdFALSE )
+			#endif
+			)
 		{
-			if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
-			{
-				xIsMessageBuffer = pdTRUE;
-			}
-			else
-			{
-				xIsMessageBuffer = pdFALSE;
-			}
-
+			/* The flags are passed back in so the buffer keeps its type, and
+			still knows whether it was statically allocated. */
 			prvInitialiseNewStreamBuffer( pxStreamBuffer,
 										  pxStreamBuffer->pucBuffer,
 										  pxStreamBuffer->xLength,
 										  pxStreamBuffer->xTriggerLevelBytes,
-										  xIsMessageBuffer );
+										  pxStreamBuffer->ucFlags );
 			xReturn = pdPASS;
 
 			#if( configUSE_TRACE_FACILITY == 1 )
@@ -408,6 +591,12 @@ BaseType_t xReturn = pdFAIL, xIsMessageBuffer;
 			}
 			#endif
 
+			#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+			{
+				pxStreamBuffer->xMaxLatency = xMaxLatency;
+			}
+			#endif
+
 			traceSTREAM_BUFFER_RESET( xStreamBuffer );
 		}
 	}
@@ -445,6 +634,51 @@ BaseType_t xReturn;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+
+	BaseType_t xStreamBufferSetCoalescing( StreamBufferHandle_t xStreamBuffer, size_t xTriggerLevel, TickType_t xMaxLatency )
+	{
+	StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9087 !e9079 Safe cast as StreamBufferHandle_t is opaque Streambuffer_t. */
+	BaseType_t xReturn;
+
+		configASSERT( pxStreamBuffer );
+
+		/* Message buffers unblock the reader once per message, so there is
+		nothing to coalesce. */
+		configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+		xReturn = xStreamBufferSetTriggerLevel( xStreamBuffer, xTriggerLevel );
+
+		if( xReturn == pdPASS )
+		{
+			taskENTER_CRITICAL();
+			{
+				pxStreamBuffer->xMaxLatency = xMaxLatency;
+
+				/* Any bytes already in the buffer are timed from now. */
+				if( prvBytesInBuffer( pxStreamBuffer ) != ( size_t ) 0 )
+				{
+					pxStreamBuffer->xFirstByteTime = xTaskGetTickCount();
+					pxStreamBuffer->xLatencyClockRunning = pdTRUE;
+				}
+				else
+				{
+					pxStreamBuffer->xLatencyClockRunning = pdFALSE;
+				}
+			}
+			taskEXIT_CRITICAL();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_STREAM_BUFFER_COALESCING */
+/*-----------------------------------------------------------*/
+
 size_t xStreamBufferSpacesAvailable( StreamBufferHandle_t xStreamBuffer )
 {
 const StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9087 !e9079 Safe cast as StreamBufferHandle_t is opaque Streambuffer_t. */
@@ -453,7 +687,26 @@ size_t xSpace;
 	configASSERT( pxStreamBuffer );
 
 	xSpace = pxStreamBuffer->xLength + pxStreamBuffer->xTail;
-	xSpace -= pxStreamBuffer->xHead;
+
+	#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+	{
+		/* Space reserved by a write that is still in progress is not
+		free. */
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) != ( uint8_t ) 0 )
+		{
+			xSpace -= pxStreamBuffer->xReserveHead;
+		}
+		else
+		{
+			xSpace -= pxStreamBuffer->xHead;
+		}
+	}
+	#else
+	{
+		xSpace -= pxStreamBuffer->xHead;
+	}
+	#endif /* configUSE_STREAM_BUFFER_MULTI_PRODUCER */
+
 	xSpace -= ( size_t ) 1;
 
 	if( xSpace >= pxStreamBuffer->xLength )
@@ -487,7 +740,7 @@ size_t xStreamBufferSend( StreamBufferHandle_t xStreamBuffer,
 						  TickType_t xTicksToWait )
 {
 StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9087 !e9079 Safe cast as StreamBufferHandle_t is opaque Streambuffer_t. */
-size_t xReturn, xSpace = 0;
+size_t xReturn, xSpace = 0, xLengthBytes;
 size_t xRequiredSpace = xDataLengthBytes;
 TimeOut_t xTimeOut;
 
@@ -500,7 +753,21 @@ TimeOut_t xTimeOut;
 	message. */
 	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
 	{
-		xRequiredSpace += sbBYTES_TO_STORE_MESSAGE_LENGTH;
+		xLengthBytes = prvBytesToStoreMessageLength( pxStreamBuffer, xDataLengthBytes );
+
+		/* A message that is too long for the buffer's length format can
+		never be sent, so there is no point waiting for space for it. */
+		if( xLengthBytes == pxStreamBuffer->xLength )
+		{
+			traceSTREAM_BUFFER_SEND_FAILED( xStreamBuffer );
+			return ( size_t ) 0;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		xRequiredSpace += xLengthBytes;
 	}
 	else
 	{
@@ -521,12 +788,28 @@ TimeOut_t xTimeOut;
 
 				if( xSpace < xRequiredSpace )
 				{
-					/* Clear notification state as going to wait for space. */
-					( void ) xTaskNotifyStateClear( NULL );
-
-					/* Should only be one writer. */
-					configASSERT( pxStreamBuffer->xTaskWaitingToSend == NULL );
-					pxStreamBuffer->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
+					#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+					if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) != ( uint8_t ) 0 )
+					{
+						/* Any number of writers to a multi-producer buffer
+						can wait for space.  They queue on the buffer's own
+						event list, which is only accessed with interrupts
+						masked, so it can be done from within this critical
+						section.  The task does not leave the Running state
+						until the critical section is exited. */
+						vTaskPlaceOnEventList( &( pxStreamBuffer->xTasksWaitingToSend ), xTicksToWait );
+					}
+					else
+					#endif /* configUSE_STREAM_BUFFER_MULTI_PRODUCER */
+					{
+						/* Clear notification state as going to wait for
+						space. */
+						( void ) xTaskNotifyStateClear( NULL );
+
+						/* Should only be one writer. */
+						configASSERT( pxStreamBuffer->xTaskWaitingToSend == NULL );
+						pxStreamBuffer->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
+					}
 				}
 				else
 				{
@@ -537,8 +820,20 @@ TimeOut_t xTimeOut;
 			taskEXIT_CRITICAL();
 
 			traceBLOCKING_ON_STREAM_BUFFER_SEND( xStreamBuffer );
-			( void ) xTaskNotifyWait( ( uint32_t ) 0, UINT32_MAX, NULL, xTicksToWait );
-			pxStreamBuffer->xTaskWaitingToSend = NULL;
+
+			#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+			if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) != ( uint8_t ) 0 )
+			{
+				/* The reader, or the tick interrupt on a timeout, takes the
+				task off the event list again. */
+				portYIELD_WITHIN_API();
+			}
+			else
+			#endif /* configUSE_STREAM_BUFFER_MULTI_PRODUCER */
+			{
+				( void ) xTaskNotifyWait( ( uint32_t ) 0, UINT32_MAX, NULL, xTicksToWait );
+				pxStreamBuffer->xTaskWaitingToSend = NULL;
+			}
 
 		} while( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE );
 	}
@@ -556,14 +851,34 @@ TimeOut_t xTimeOut;
 		mtCOVERAGE_TEST_MARKER();
 	}
 
-	xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
+	#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) != ( uint8_t ) 0 )
+	{
+		/* The reader only sees the bytes of a multi-producer write once every
+		write that reserved space before it has been copied too.  No other
+		task runs while this task copies, so a writer that gets preempted
+		part way through cannot hold back the writes that follow it for as
+		long as it stays preempted.  Interrupts are left enabled, so ISRs can
+		still write while the copy is in progress, and the time their writes
+		are held back is bounded by the time taken to copy this one. */
+		vTaskSuspendAll();
+		{
+			xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
+		}
+		( void ) xTaskResumeAll();
+	}
+	else
+	#endif /* configUSE_STREAM_BUFFER_MULTI_PRODUCER */
+	{
+		xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
+	}
 
 	if( xReturn > ( size_t ) 0 )
 	{
 		traceSTREAM_BUFFER_SEND( xStreamBuffer, xReturn );
 
 		/* Was a task waiting for the data? */
-		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+		if( prvShouldWakeReader( pxStreamBuffer ) != pdFALSE )
 		{
 			sbSEND_COMPLETED( pxStreamBuffer );
 		}
@@ -588,7 +903,7 @@ size_t xStreamBufferSendFromISR( StreamBufferHandle_t xStreamBuffer,
 								 BaseType_t * const pxHigherPriorityTaskWoken )
 {
 StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9087 !e9079 Safe cast as StreamBufferHandle_t is opaque Streambuffer_t. */
-size_t xReturn, xSpace;
+size_t xReturn, xSpace, xLengthBytes;
 size_t xRequiredSpace = xDataLengthBytes;
 
 	configASSERT( pvTxData );
@@ -600,7 +915,21 @@ size_t xRequiredSpace = xDataLengthBytes;
 	message. */
 	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
 	{
-		xRequiredSpace += sbBYTES_TO_STORE_MESSAGE_LENGTH;
+		xLengthBytes = prvBytesToStoreMessageLength( pxStreamBuffer, xDataLengthBytes );
+
+		/* A message that is too long for the buffer's length format can
+		never be sent, so there is no point waiting for space for it. */
+		if( xLengthBytes == pxStreamBuffer->xLength )
+		{
+			traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, ( size_t ) 0 );
+			return ( size_t ) 0;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		xRequiredSpace += xLengthBytes;
 	}
 	else
 	{
@@ -613,7 +942,7 @@ size_t xRequiredSpace = xDataLengthBytes;
 	if( xReturn > ( size_t ) 0 )
 	{
 		/* Was a task waiting for the data? */
-		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+		if( prvShouldWakeReader( pxStreamBuffer ) != pdFALSE )
 		{
 			sbSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
 		}
@@ -640,7 +969,22 @@ static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
 									   size_t xRequiredSpace )
 {
 	BaseType_t xShouldWrite;
-	size_t xReturn;
+	size_t xReturn, xNextHead = pxStreamBuffer->xHead;
+
+	#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+	{
+		/* Writes to a multi-producer buffer take a separate path, as the space
+		can be taken by another writer at any time. */
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) != ( uint8_t ) 0 )
+		{
+			return prvWriteMultiProducer( pxStreamBuffer, pvTxData, xDataLengthBytes, xRequiredSpace );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configUSE_STREAM_BUFFER_MULTI_PRODUCER */
 
 	if( xSpace == ( size_t ) 0 )
 	{
@@ -661,9 +1005,10 @@ static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
 		/* This is a message buffer, as opposed to a stream buffer, and there
 		is enough space to write both the message length and the message itself
 		into the buffer.  Start by writing the length of the data, the data
-		itself will be written later in this function. */
+		itself will be written later in this function.  The length takes the
+		bytes xRequiredSpace holds on top of the data. */
 		xShouldWrite = pdTRUE;
-		( void ) prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) &( xDataLengthBytes ), sbBYTES_TO_STORE_MESSAGE_LENGTH );
+		xNextHead = prvWriteMessageLength( pxStreamBuffer, xDataLengthBytes, xRequiredSpace - xDataLengthBytes, xNextHead );
 	}
 	else
 	{
@@ -673,8 +1018,10 @@ static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
 
 	if( xShouldWrite != pdFALSE )
 	{
-		/* Writes the data itself. */
-		xReturn = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) pvTxData, xDataLengthBytes ); /*lint !e9079 Storage buffer is implemented as uint8_t for ease of sizing, alighment and access. */
+		/* Writes the data itself, then moves xHead past both the length and
+		the data in one go. */
+		pxStreamBuffer->xHead = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) pvTxData, xDataLengthBytes, xNextHead ); /*lint !e9079 Storage buffer is implemented as uint8_t for ease of sizing, alighment and access. */
+		xReturn = xDataLengthBytes;
 	}
 	else
 	{
@@ -692,18 +1039,20 @@ size_t xStreamBufferReceive( StreamBufferHandle_t xStreamBuffer,
 {
 StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9087 !e9079 Safe cast as StreamBufferHandle_t is opaque Streambuffer_t. */
 size_t xReceivedLength = 0, xBytesAvailable, xBytesToStoreMessageLength;
+#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+	TimeOut_t xTimeOut;
+#endif
 
 	configASSERT( pvRxData );
 	configASSERT( pxStreamBuffer );
 
 	/* This receive function is used by both message buffers, which store
 	discrete messages, and stream buffers, which store a continuous stream of
-	bytes.  Discrete messages include an additional
-	sbBYTES_TO_STORE_MESSAGE_LENGTH bytes that hold the length of the
-	message. */
+	bytes.  Discrete messages include additional bytes that hold the length of
+	the message - at least as many as the shortest length takes. */
 	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
 	{
-		xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+		xBytesToStoreMessageLength = prvBytesToStoreMessageLength( pxStreamBuffer, ( size_t ) 0 );
 	}
 	else
 	{
@@ -712,6 +1061,14 @@ size_t xReceivedLength = 0, xBytesAvailable, xBytesToStoreMessageLength;
 
 	if( xTicksToWait != ( TickType_t ) 0 )
 	{
+		#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+		{
+			/* A coalescing read can block more than once, so the block time
+			is measured from here. */
+			vTaskSetTimeOutState( &xTimeOut );
+		}
+		#endif
+
 		/* Checking if there is data and clearing the notification state must be
 		performed atomically. */
 		taskENTER_CRITICAL();
@@ -753,6 +1110,21 @@ size_t xReceivedLength = 0, xBytesAvailable, xBytesToStoreMessageLength;
 		{
 			mtCOVERAGE_TEST_MARKER();
 		}
+
+		#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+		{
+			/* Hold off reading until the trigger level is reached or the
+			oldest byte has waited long enough. */
+			if( pxStreamBuffer->xMaxLatency != ( TickType_t ) 0 )
+			{
+				xBytesAvailable = prvWaitForCoalescedData( pxStreamBuffer, xBytesAvailable, &xTimeOut, &xTicksToWait );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configUSE_STREAM_BUFFER_COALESCING */
 	}
 	else
 	{
@@ -771,8 +1143,20 @@ size_t xReceivedLength = 0, xBytesAvailable, xBytesToStoreMessageLength;
 		/* Was a task waiting for space in the buffer? */
 		if( xReceivedLength != ( size_t ) 0 )
 		{
+			#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+			{
+				prvStopLatencyClock( pxStreamBuffer );
+			}
+			#endif
+
 			traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xReceivedLength );
 			sbRECEIVE_COMPLETED( pxStreamBuffer );
+
+			#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+			{
+				prvUnblockWaitingWriters( pxStreamBuffer );
+			}
+			#endif
 		}
 		else
 		{
@@ -802,12 +1186,11 @@ size_t xReceivedLength = 0, xBytesAvailable, xBytesToStoreMessageLength;
 
 	/* This receive function is used by both message buffers, which store
 	discrete messages, and stream buffers, which store a continuous stream of
-	bytes.  Discrete messages include an additional
-	sbBYTES_TO_STORE_MESSAGE_LENGTH bytes that hold the length of the
-	message. */
+	bytes.  Discrete messages include additional bytes that hold the length of
+	the message - at least as many as the shortest length takes. */
 	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
 	{
-		xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+		xBytesToStoreMessageLength = prvBytesToStoreMessageLength( pxStreamBuffer, ( size_t ) 0 );
 	}
 	else
 	{
@@ -828,7 +1211,19 @@ size_t xReceivedLength = 0, xBytesAvailable, xBytesToStoreMessageLength;
 		/* Was a task waiting for space in the buffer? */
 		if( xReceivedLength != ( size_t ) 0 )
 		{
+			#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+			{
+				prvStopLatencyClock( pxStreamBuffer );
+			}
+			#endif
+
 			sbRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+
+			#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+			{
+				( void ) prvUnblockWaitingWritersFromISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+			}
+			#endif
 		}
 		else
 		{
@@ -852,34 +1247,40 @@ static size_t prvReadMessageFromBuffer( StreamBuffer_t *pxStreamBuffer,
 										size_t xBytesAvailable,
 										size_t xBytesToStoreMessageLength )
 {
-size_t xOriginalTail, xReceivedLength, xNextMessageLength;
+size_t xReceivedLength, xNextMessageLength, xNextTail;
 
 	if( xBytesToStoreMessageLength != ( size_t ) 0 )
 	{
-		/* A discrete message is being received.  First receive the length
-		of the message.  A copy of the tail is stored so the buffer can be
-		returned to its prior state if the length of the message is too
-		large for the provided buffer. */
-		xOriginalTail = pxStreamBuffer->xTail;
-		( void ) prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xNextMessageLength, xBytesToStoreMessageLength, xBytesAvailable );
-
-		/* Reduce the number of bytes available by the number of bytes just
-		read out. */
-		xBytesAvailable -= xBytesToStoreMessageLength;
+		/* A discrete message is being received.  First decode the length of
+		the message where it is, without moving the tail, so nothing has to be
+		put back if the message is too large for the provided buffer. */
+		xBytesToStoreMessageLength = prvReadMessageLength( pxStreamBuffer, pxStreamBuffer->xTail, &xNextMessageLength );
 
 		/* Check there is enough space in the buffer provided by the
 		user. */
 		if( xNextMessageLength > xBufferLengthBytes )
 		{
-			/* The user has provided insufficient space to read the message
-			so return the buffer to its previous state (so the length of
-			the message is in the buffer again). */
-			pxStreamBuffer->xTail = xOriginalTail;
+			/* The user has provided insufficient space to read the message,
+			so leave the message in the buffer. */
 			xNextMessageLength = 0;
 		}
 		else
 		{
-			mtCOVERAGE_TEST_MARKER();
+			/* Remove the length from the buffer, and reduce the number of
+			bytes available by the number of bytes it took. */
+			xNextTail = pxStreamBuffer->xTail + xBytesToStoreMessageLength;
+
+			if( xNextTail >= pxStreamBuffer->xLength )
+			{
+				xNextTail -= pxStreamBuffer->xLength;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			pxStreamBuffer->xTail = xNextTail;
+			xBytesAvailable -= xBytesToStoreMessageLength;
 		}
 	}
 	else
@@ -929,11 +1330,12 @@ const StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer
 
 	/* This generic version of the receive function is used by both message
 	buffers, which store discrete messages, and stream buffers, which store a
-	continuous stream of bytes.  Discrete messages include an additional
-	sbBYTES_TO_STORE_MESSAGE_LENGTH bytes that hold the length of the message. */
+	continuous stream of bytes.  Discrete messages include additional bytes
+	that hold the length of the message - at least as many as the shortest
+	length takes. */
 	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
 	{
-		xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+		xBytesToStoreMessageLength = prvBytesToStoreMessageLength( pxStreamBuffer, ( size_t ) 0 );
 	}
 	else
 	{
@@ -1010,85 +1412,456 @@ UBaseType_t uxSavedInterruptStatus;
 	}
 	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
 
+	#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+	{
+		if( prvUnblockWaitingWritersFromISR( pxStreamBuffer, pxHigherPriorityTaskWoken ) != pdFALSE )
+		{
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
 	return xReturn;
 }
 /*-----------------------------------------------------------*/
 
-static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer, const uint8_t *pucData, size_t xCount )
-{
-size_t xNextHead, xFirstLength;
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
 
-	configASSERT( xCount > ( size_t ) 0 );
+	size_t xStreamBufferAcquireWrite( StreamBufferHandle_t xStreamBuffer,
+									  StreamBufferRegions_t * const pxRegions,
+									  size_t xWantedBytes,
+									  TickType_t xTicksToWait )
+	{
+	StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9087 !e9079 Safe cast as StreamBufferHandle_t is opaque Streambuffer_t. */
+	TimeOut_t xTimeOut;
+	size_t xLengthBytes = 0;
+
+		configASSERT( pxStreamBuffer );
+		configASSERT( pxRegions );
+
+		/* A message buffer keeps room in front of the message for its length,
+		which is at least the bytes needed for a length of xWantedBytes, and
+		is the whole storage area if xWantedBytes is too long for the
+		buffer's length format. */
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+		{
+			xLengthBytes = prvBytesToStoreMessageLength( pxStreamBuffer, xWantedBytes );
+			xLengthBytes = configMAX( xLengthBytes, prvReservedLengthBytes( pxStreamBuffer ) );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
 
-	xNextHead = pxStreamBuffer->xHead;
+		/* A stream buffer can never hold more than xLength - 1 bytes, less
+		the length of a message, so a task waiting for more than that would
+		wait forever. */
+		configASSERT( xWantedBytes < ( pxStreamBuffer->xLength - xLengthBytes ) );
 
-	/* Calculate the number of bytes that can be added in the first write -
-	which may be less than the total number of bytes that need to be added if
-	the buffer will wrap back to the beginning. */
-	xFirstLength = configMIN( pxStreamBuffer->xLength - xNextHead, xCount );
+		if( xTicksToWait != ( TickType_t ) 0 )
+		{
+			vTaskSetTimeOutState( &xTimeOut );
 
-	/* Write as many bytes as can be written in the first write. */
-	configASSERT( ( xNextHead + xFirstLength ) <= pxStreamBuffer->xLength );
-	memcpy( ( void* ) ( &( pxStreamBuffer->pucBuffer[ xNextHead ] ) ), ( const void * ) pucData, xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+			do
+			{
+				/* Wait until the wanted number of bytes are free in the
+				buffer. */
+				taskENTER_CRITICAL();
+				{
+					if( prvGetWriteRegions( pxStreamBuffer, pxRegions ) < xWantedBytes )
+					{
+						/* Clear notification state as going to wait for
+						space. */
+						( void ) xTaskNotifyStateClear( NULL );
+
+						/* Should only be one writer. */
+						configASSERT( pxStreamBuffer->xTaskWaitingToSend == NULL );
+						pxStreamBuffer->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
+					}
+					else
+					{
+						taskEXIT_CRITICAL();
+						break;
+					}
+				}
+				taskEXIT_CRITICAL();
 
-	/* If the number of bytes written was less than the number that could be
-	written in the first write... */
-	if( xCount > xFirstLength )
-	{
-		/* ...then write the remaining bytes to the start of the buffer. */
-		configASSERT( ( xCount - xFirstLength ) <= pxStreamBuffer->xLength );
-		memcpy( ( void * ) pxStreamBuffer->pucBuffer, ( const void * ) &( pucData[ xFirstLength ] ), xCount - xFirstLength ); /*lint !e9087 memcpy() requires void *. */
-	}
-	else
-	{
-		mtCOVERAGE_TEST_MARKER();
-	}
+				traceBLOCKING_ON_STREAM_BUFFER_SEND( xStreamBuffer );
+				( void ) xTaskNotifyWait( ( uint32_t ) 0, UINT32_MAX, NULL, xTicksToWait );
+				pxStreamBuffer->xTaskWaitingToSend = NULL;
 
-	xNextHead += xCount;
-	if( xNextHead >= pxStreamBuffer->xLength )
-	{
-		xNextHead -= pxStreamBuffer->xLength;
+			} while( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* Describe the space that is free now, which will be less than
+		xWantedBytes if the block time expired first. */
+		return prvGetWriteRegions( pxStreamBuffer, pxRegions );
 	}
-	else
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+	size_t xStreamBufferAcquireWriteFromISR( StreamBufferHandle_t xStreamBuffer,
+											 StreamBufferRegions_t * const pxRegions )
 	{
-		mtCOVERAGE_TEST_MARKER();
-	}
+	StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9087 !e9079 Safe cast as StreamBufferHandle_t is opaque Streambuffer_t. */
 
-	pxStreamBuffer->xHead = xNextHead;
+		configASSERT( pxStreamBuffer );
+		configASSERT( pxRegions );
 
-	return xCount;
-}
-/*-----------------------------------------------------------*/
+		return prvGetWriteRegions( pxStreamBuffer, pxRegions );
+	}
 
-static size_t prvReadBytesFromBuffer( StreamBuffer_t *pxStreamBuffer, uint8_t *pucData, size_t xMaxCount, size_t xBytesAvailable )
-{
-size_t xCount, xFirstLength, xNextTail;
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
 
-	/* Use the minimum of the wanted bytes and the available bytes. */
-	xCount = configMIN( xBytesAvailable, xMaxCount );
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
 
-	if( xCount > ( size_t ) 0 )
+	size_t xStreamBufferCommitWrite( StreamBufferHandle_t xStreamBuffer, size_t xCount )
 	{
-		xNextTail = pxStreamBuffer->xTail;
+	StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9087 !e9079 Safe cast as StreamBufferHandle_t is opaque Streambuffer_t. */
 
-		/* Calculate the number of bytes that can be read - which may be
-		less than the number wanted if the data wraps around to the start of
-		the buffer. */
-		xFirstLength = configMIN( pxStreamBuffer->xLength - xNextTail, xCount );
-
-		/* Obtain the number of bytes it is possible to obtain in the first
-		read.  Asserts check bounds of read and write. */
-		configASSERT( xFirstLength <= xMaxCount );
-		configASSERT( ( xNextTail + xFirstLength ) <= pxStreamBuffer->xLength );
-		memcpy( ( void * ) pucData, ( const void * ) &( pxStreamBuffer->pucBuffer[ xNextTail ] ), xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+		configASSERT( pxStreamBuffer );
 
-		/* If the total number of wanted bytes is greater than the number
-		that could be read in the first read... */
-		if( xCount > xFirstLength )
+		if( xCount > ( size_t ) 0 )
 		{
-			/*...then read the remaining bytes from the start of the buffer. */
-			configASSERT( xCount <= xMaxCount );
-			memcpy( ( void * ) &( pucData[ xFirstLength ] ), ( void * ) ( pxStreamBuffer->pucBuffer ), xCount - xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+			prvCommitWrite( pxStreamBuffer, xCount );
+			traceSTREAM_BUFFER_SEND( xStreamBuffer, xCount );
+
+			/* Was a task waiting for the data? */
+			if( prvShouldWakeReader( pxStreamBuffer ) != pdFALSE )
+			{
+				sbSEND_COMPLETED( pxStreamBuffer );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xCount;
+	}
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+	size_t xStreamBufferCommitWriteFromISR( StreamBufferHandle_t xStreamBuffer,
+											size_t xCount,
+											BaseType_t * const pxHigherPriorityTaskWoken )
+	{
+	StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9087 !e9079 Safe cast as StreamBufferHandle_t is opaque Streambuffer_t. */
+
+		configASSERT( pxStreamBuffer );
+
+		if( xCount > ( size_t ) 0 )
+		{
+			prvCommitWrite( pxStreamBuffer, xCount );
+
+			/* Was a task waiting for the data? */
+			if( prvShouldWakeReader( pxStreamBuffer ) != pdFALSE )
+			{
+				sbSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xCount );
+
+		return xCount;
+	}
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+	size_t xStreamBufferAcquireRead( StreamBufferHandle_t xStreamBuffer,
+									 StreamBufferRegions_t * const pxRegions,
+									 TickType_t xTicksToWait )
+	{
+	StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9087 !e9079 Safe cast as StreamBufferHandle_t is opaque Streambuffer_t. */
+	size_t xBytesAvailable;
+	#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+		TimeOut_t xTimeOut;
+	#endif
+
+		configASSERT( pxStreamBuffer );
+		configASSERT( pxRegions );
+
+		if( xTicksToWait != ( TickType_t ) 0 )
+		{
+			#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+			{
+				vTaskSetTimeOutState( &xTimeOut );
+			}
+			#endif
+
+			/* Checking if there is data and clearing the notification state
+			must be performed atomically. */
+			taskENTER_CRITICAL();
+			{
+				xBytesAvailable = prvGetReadRegions( pxStreamBuffer, pxRegions );
+
+				if( xBytesAvailable == ( size_t ) 0 )
+				{
+					/* Clear notification state as going to wait for data. */
+					( void ) xTaskNotifyStateClear( NULL );
+
+					/* Should only be one reader. */
+					configASSERT( pxStreamBuffer->xTaskWaitingToReceive == NULL );
+					pxStreamBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			if( xBytesAvailable == ( size_t ) 0 )
+			{
+				/* Wait for data to be available. */
+				traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer );
+				( void ) xTaskNotifyWait( ( uint32_t ) 0, UINT32_MAX, NULL, xTicksToWait );
+				pxStreamBuffer->xTaskWaitingToReceive = NULL;
+
+				/* Recheck the data available after blocking. */
+				xBytesAvailable = prvGetReadRegions( pxStreamBuffer, pxRegions );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+			{
+				/* As xStreamBufferReceive().  The regions are described again
+				as more bytes may have arrived. */
+				if( pxStreamBuffer->xMaxLatency != ( TickType_t ) 0 )
+				{
+					( void ) prvWaitForCoalescedData( pxStreamBuffer, xBytesAvailable, &xTimeOut, &xTicksToWait );
+					xBytesAvailable = prvGetReadRegions( pxStreamBuffer, pxRegions );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configUSE_STREAM_BUFFER_COALESCING */
+		}
+		else
+		{
+			xBytesAvailable = prvGetReadRegions( pxStreamBuffer, pxRegions );
+		}
+
+		if( xBytesAvailable == ( size_t ) 0 )
+		{
+			traceSTREAM_BUFFER_RECEIVE_FAILED( xStreamBuffer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xBytesAvailable;
+	}
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+	size_t xStreamBufferAcquireReadFromISR( StreamBufferHandle_t xStreamBuffer,
+											StreamBufferRegions_t * const pxRegions )
+	{
+	StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9087 !e9079 Safe cast as StreamBufferHandle_t is opaque Streambuffer_t. */
+
+		configASSERT( pxStreamBuffer );
+		configASSERT( pxRegions );
+
+		return prvGetReadRegions( pxStreamBuffer, pxRegions );
+	}
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+	size_t xStreamBufferConsume( StreamBufferHandle_t xStreamBuffer, size_t xCount )
+	{
+	StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9087 !e9079 Safe cast as StreamBufferHandle_t is opaque Streambuffer_t. */
+
+		configASSERT( pxStreamBuffer );
+
+		if( xCount > ( size_t ) 0 )
+		{
+			prvConsumeRead( pxStreamBuffer, xCount );
+			traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xCount );
+
+			#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+			{
+				prvStopLatencyClock( pxStreamBuffer );
+			}
+			#endif
+
+			/* Was a task waiting for space in the buffer? */
+			sbRECEIVE_COMPLETED( pxStreamBuffer );
+
+			#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+			{
+				prvUnblockWaitingWriters( pxStreamBuffer );
+			}
+			#endif
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xCount;
+	}
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+	size_t xStreamBufferConsumeFromISR( StreamBufferHandle_t xStreamBuffer,
+										size_t xCount,
+										BaseType_t * const pxHigherPriorityTaskWoken )
+	{
+	StreamBuffer_t * const pxStreamBuffer = ( StreamBuffer_t * ) xStreamBuffer; /*lint !e9087 !e9079 Safe cast as StreamBufferHandle_t is opaque Streambuffer_t. */
+
+		configASSERT( pxStreamBuffer );
+
+		if( xCount > ( size_t ) 0 )
+		{
+			prvConsumeRead( pxStreamBuffer, xCount );
+
+			#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+			{
+				prvStopLatencyClock( pxStreamBuffer );
+			}
+			#endif
+
+			/* Was a task waiting for space in the buffer? */
+			sbRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+
+			#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+			{
+				( void ) prvUnblockWaitingWritersFromISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+			}
+			#endif
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xCount );
+
+		return xCount;
+	}
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer, const uint8_t *pucData, size_t xCount, size_t xHead )
+{
+size_t xNextHead, xFirstLength;
+
+	configASSERT( xCount > ( size_t ) 0 );
+
+	xNextHead = xHead;
+
+	/* Calculate the number of bytes that can be added in the first write -
+	which may be less than the total number of bytes that need to be added if
+	the buffer will wrap back to the beginning. */
+	xFirstLength = configMIN( pxStreamBuffer->xLength - xNextHead, xCount );
+
+	/* Write as many bytes as can be written in the first write. */
+	configASSERT( ( xNextHead + xFirstLength ) <= pxStreamBuffer->xLength );
+	memcpy( ( void* ) ( &( pxStreamBuffer->pucBuffer[ xNextHead ] ) ), ( const void * ) pucData, xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+
+	/* If the number of bytes written was less than the number that could be
+	written in the first write... */
+	if( xCount > xFirstLength )
+	{
+		/* ...then write the remaining bytes to the start of the buffer. */
+		configASSERT( ( xCount - xFirstLength ) <= pxStreamBuffer->xLength );
+		memcpy( ( void * ) pxStreamBuffer->pucBuffer, ( const void * ) &( pucData[ xFirstLength ] ), xCount - xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	xNextHead += xCount;
+	if( xNextHead >= pxStreamBuffer->xLength )
+	{
+		xNextHead -= pxStreamBuffer->xLength;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xNextHead;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvReadBytesFromBuffer( StreamBuffer_t *pxStreamBuffer, uint8_t *pucData, size_t xMaxCount, size_t xBytesAvailable )
+{
+size_t xCount, xFirstLength, xNextTail;
+
+	/* Use the minimum of the wanted bytes and the available bytes. */
+	xCount = configMIN( xBytesAvailable, xMaxCount );
+
+	if( xCount > ( size_t ) 0 )
+	{
+		xNextTail = pxStreamBuffer->xTail;
+
+		/* Calculate the number of bytes that can be read - which may be
+		less than the number wanted if the data wraps around to the start of
+		the buffer. */
+		xFirstLength = configMIN( pxStreamBuffer->xLength - xNextTail, xCount );
+
+		/* Obtain the number of bytes it is possible to obtain in the first
+		read.  Asserts check bounds of read and write. */
+		configASSERT( xFirstLength <= xMaxCount );
+		configASSERT( ( xNextTail + xFirstLength ) <= pxStreamBuffer->xLength );
+		memcpy( ( void * ) pucData, ( const void * ) &( pxStreamBuffer->pucBuffer[ xNextTail ] ), xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+
+		/* If the total number of wanted bytes is greater than the number
+		that could be read in the first read... */
+		if( xCount > xFirstLength )
+		{
+			/*...then read the remaining bytes from the start of the buffer. */
+			configASSERT( xCount <= xMaxCount );
+			memcpy( ( void * ) &( pucData[ xFirstLength ] ), ( void * ) ( pxStreamBuffer->pucBuffer ), xCount - xFirstLength ); /*lint !e9087 memcpy() requires void *. */
 		}
 		else
 		{
@@ -1135,35 +1908,913 @@ size_t xCount;
 }
 /*-----------------------------------------------------------*/
 
-static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
-										  uint8_t * const pucBuffer,
-										  size_t xBufferSizeBytes,
-										  size_t xTriggerLevelBytes,
-										  BaseType_t xIsMessageBuffer )
+static size_t prvBytesToStoreMessageLength( const StreamBuffer_t * const pxStreamBuffer, size_t xMessageLength )
 {
-	/* Assert here is deliberately writing to the entire buffer to ensure it can
-	be written to without generating exceptions, and is setting the buffer to a
-	known value to assist in development/debugging. */
-	#if( configASSERT_DEFINED == 1 )
+size_t xLengthBytes;
+
+	#if( configUSE_COMPACT_MESSAGE_LENGTHS == 1 )
 	{
-		/* The value written just has to be identifiable when looking at the
-		memory.  Don't use 0xA5 as that is the stack fill value and could
-		result in confusion as to what is actually being observed. */
-		const BaseType_t xWriteValue = 0x55;
-		configASSERT( memset( pucBuffer, ( int ) xWriteValue, xBufferSizeBytes ) == pucBuffer );
-	}
-	#endif
+		switch( pxStreamBuffer->ucFlags & sbFLAGS_LENGTH_FORMAT_MASK )
+		{
+			case sbFLAGS_LENGTH_1_BYTE :
+				xLengthBytes = ( xMessageLength <= sbMAX_LENGTH_IN_1_BYTE ) ? ( size_t ) 1 : pxStreamBuffer->xLength;
+				break;
 
-	memset( ( void * ) pxStreamBuffer, 0x00, sizeof( StreamBuffer_t ) ); /*lint !e9087 memset() requires void *. */
-	pxStreamBuffer->pucBuffer = pucBuffer;
-	pxStreamBuffer->xLength = xBufferSizeBytes;
-	pxStreamBuffer->xTriggerLevelBytes = xTriggerLevelBytes;
+			case sbFLAGS_LENGTH_2_BYTES :
+				xLengthBytes = ( xMessageLength <= sbMAX_LENGTH_IN_2_BYTES ) ? ( size_t ) 2 : pxStreamBuffer->xLength;
+				break;
+
+			case sbFLAGS_LENGTH_VARINT :
+				xLengthBytes = ( size_t ) 1;
+
+				while( xMessageLength > ( size_t ) sbVARINT_VALUE_BITS )
+				{
+					xMessageLength >>= 7;
+					xLengthBytes++;
+				}
+				break;
 
-	if( xIsMessageBuffer != pdFALSE )
+			default :
+				xLengthBytes = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+				break;
+		}
+
+	}
+	#else
 	{
-		pxStreamBuffer->ucFlags |= sbFLAGS_IS_MESSAGE_BUFFER;
+		( void ) pxStreamBuffer;
+		( void ) xMessageLength;
+		xLengthBytes = sbBYTES_TO_STORE_MESSAGE_LENGTH;
 	}
+	#endif /* configUSE_COMPACT_MESSAGE_LENGTHS */
+
+	return xLengthBytes;
 }
+/*-----------------------------------------------------------*/
+
+static size_t prvWriteMessageLength( StreamBuffer_t * const pxStreamBuffer, size_t xMessageLength, size_t xLengthBytes, size_t xHead )
+{
+size_t xNextHead;
+
+	#if( configUSE_COMPACT_MESSAGE_LENGTHS == 1 )
+	{
+	uint8_t ucLength[ sbMAX_BYTES_TO_STORE_MESSAGE_LENGTH ];
+	size_t x;
+	const uint8_t ucFormat = pxStreamBuffer->ucFlags & sbFLAGS_LENGTH_FORMAT_MASK;
+
+		if( ucFormat == sbFLAGS_LENGTH_SIZE_T )
+		{
+			xNextHead = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) &xMessageLength, sbBYTES_TO_STORE_MESSAGE_LENGTH, xHead );
+		}
+		else
+		{
+			configASSERT( xLengthBytes <= sizeof( ucLength ) );
+
+			/* Both compact formats are little endian.  A varint gets the top
+			bit set on every byte except the last, which also pads it out if
+			xLengthBytes is more than it needs. */
+			for( x = ( size_t ) 0; x < xLengthBytes; x++ )
+			{
+				if( ucFormat == sbFLAGS_LENGTH_VARINT )
+				{
+					ucLength[ x ] = ( uint8_t ) ( xMessageLength & ( size_t ) sbVARINT_VALUE_BITS );
+					xMessageLength >>= 7;
+
+					if( x < ( xLengthBytes - ( size_t ) 1 ) )
+					{
+						ucLength[ x ] |= sbVARINT_MORE_BYTES;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					ucLength[ x ] = ( uint8_t ) xMessageLength;
+					xMessageLength >>= 8;
+				}
+			}
+
+			/* Every bit of the length must have been stored. */
+			configASSERT( xMessageLength == ( size_t ) 0 );
+
+			xNextHead = prvWriteBytesToBuffer( pxStreamBuffer, ucLength, xLengthBytes, xHead );
+		}
+	}
+	#else
+	{
+		configASSERT( xLengthBytes == sbBYTES_TO_STORE_MESSAGE_LENGTH );
+		xNextHead = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) &xMessageLength, sbBYTES_TO_STORE_MESSAGE_LENGTH, xHead );
+	}
+	#endif /* configUSE_COMPACT_MESSAGE_LENGTHS */
+
+	return xNextHead;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvReadMessageLength( const StreamBuffer_t * const pxStreamBuffer, size_t xTail, size_t * const pxMessageLength )
+{
+size_t xLengthBytes = 0, xMessageLength = 0;
+uint8_t ucByte;
+uint8_t ucFormat = sbFLAGS_LENGTH_SIZE_T;
+
+	#if( configUSE_COMPACT_MESSAGE_LENGTHS == 1 )
+	{
+		ucFormat = pxStreamBuffer->ucFlags & sbFLAGS_LENGTH_FORMAT_MASK;
+	}
+	#endif
+
+	if( ucFormat == sbFLAGS_LENGTH_1_BYTE )
+	{
+		/* The common case for short messages - a single byte, which cannot
+		wrap. */
+		xMessageLength = ( size_t ) pxStreamBuffer->pucBuffer[ xTail ];
+		xLengthBytes = ( size_t ) 1;
+	}
+	else if( ucFormat == sbFLAGS_LENGTH_SIZE_T )
+	{
+		/* The length is copied a byte at a time as it can wrap at the end of
+		the storage area. */
+		for( xLengthBytes = ( size_t ) 0; xLengthBytes < sbBYTES_TO_STORE_MESSAGE_LENGTH; xLengthBytes++ )
+		{
+			( ( uint8_t * ) &xMessageLength )[ xLengthBytes ] = pxStreamBuffer->pucBuffer[ xTail ];
+
+			xTail++;
+			if( xTail == pxStreamBuffer->xLength )
+			{
+				xTail = ( size_t ) 0;
+			}
+		}
+	}
+	else if( ucFormat == sbFLAGS_LENGTH_2_BYTES )
+	{
+		/* Little endian.  The second byte can wrap to the start of the
+		storage area. */
+		xMessageLength = ( size_t ) pxStreamBuffer->pucBuffer[ xTail ];
+
+		xTail++;
+		if( xTail == pxStreamBuffer->xLength )
+		{
+			xTail = ( size_t ) 0;
+		}
+
+		xMessageLength |= ( ( size_t ) pxStreamBuffer->pucBuffer[ xTail ] ) << 8;
+		xLengthBytes = ( size_t ) 2;
+	}
+	else
+	{
+		/* A varint - 7 bits per byte, ending on the first byte that does not
+		have its top bit set. */
+		do
+		{
+			ucByte = pxStreamBuffer->pucBuffer[ xTail ];
+			xMessageLength |= ( ( size_t ) ( ucByte & sbVARINT_VALUE_BITS ) ) << ( xLengthBytes * ( size_t ) 7 );
+			xLengthBytes++;
+
+			xTail++;
+			if( xTail == pxStreamBuffer->xLength )
+			{
+				xTail = ( size_t ) 0;
+			}
+
+		} while( ( ucByte & sbVARINT_MORE_BYTES ) != ( uint8_t ) 0 );
+
+		configASSERT( xLengthBytes <= sbMAX_BYTES_TO_STORE_MESSAGE_LENGTH );
+	}
+
+	*pxMessageLength = xMessageLength;
+
+	return xLengthBytes;
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+	static void prvDescribeRegions( const StreamBuffer_t * const pxStreamBuffer,
+									size_t xStart,
+									size_t xCount,
+									StreamBufferRegions_t * const pxRegions )
+	{
+	size_t xFirstLength;
+
+		/* The first region runs from xStart up to, at most, the end of the
+		storage area. */
+		xFirstLength = configMIN( pxStreamBuffer->xLength - xStart, xCount );
+		pxRegions->pucRegion1 = &( pxStreamBuffer->pucBuffer[ xStart ] );
+		pxRegions->xRegion1Length = xFirstLength;
+
+		/* Anything left over wraps to the start of the storage area. */
+		if( xCount > xFirstLength )
+		{
+			pxRegions->pucRegion2 = pxStreamBuffer->pucBuffer;
+			pxRegions->xRegion2Length = xCount - xFirstLength;
+		}
+		else
+		{
+			pxRegions->pucRegion2 = NULL;
+			pxRegions->xRegion2Length = 0;
+		}
+	}
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+	static size_t prvGetWriteRegions( StreamBuffer_t * const pxStreamBuffer, StreamBufferRegions_t * const pxRegions )
+	{
+	size_t xSpace, xStart, xLengthBytes;
+
+		/* The zero copy write functions assume a single writer. */
+		configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) == ( uint8_t ) 0 );
+
+		xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+		xStart = pxStreamBuffer->xHead;
+
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+		{
+			/* The message body is written after its length, which is not
+			written until the message is committed. */
+			xLengthBytes = prvReservedLengthBytes( pxStreamBuffer );
+
+			if( xSpace > xLengthBytes )
+			{
+				xSpace -= xLengthBytes;
+				xStart += xLengthBytes;
+
+				#if( configUSE_COMPACT_MESSAGE_LENGTHS == 1 )
+				{
+					/* Do not offer more space than the length format can
+					describe. */
+					if( ( pxStreamBuffer->ucFlags & sbFLAGS_LENGTH_FORMAT_MASK ) == sbFLAGS_LENGTH_1_BYTE )
+					{
+						xSpace = configMIN( xSpace, sbMAX_LENGTH_IN_1_BYTE );
+					}
+					else if( ( pxStreamBuffer->ucFlags & sbFLAGS_LENGTH_FORMAT_MASK ) == sbFLAGS_LENGTH_2_BYTES )
+					{
+						xSpace = configMIN( xSpace, sbMAX_LENGTH_IN_2_BYTES );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif /* configUSE_COMPACT_MESSAGE_LENGTHS */
+
+				if( xStart >= pxStreamBuffer->xLength )
+				{
+					xStart -= pxStreamBuffer->xLength;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				xSpace = 0;
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		prvDescribeRegions( pxStreamBuffer, xStart, xSpace, pxRegions );
+
+		return xSpace;
+	}
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+	static size_t prvGetReadRegions( const StreamBuffer_t * const pxStreamBuffer, StreamBufferRegions_t * const pxRegions )
+	{
+	size_t xCount, xStart;
+
+		xCount = prvBytesInBuffer( pxStreamBuffer );
+		xStart = pxStreamBuffer->xTail;
+
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+		{
+			/* Only the body of the next message is described, not its length
+			or any messages that follow it. */
+			if( xCount > prvBytesToStoreMessageLength( pxStreamBuffer, ( size_t ) 0 ) )
+			{
+				xStart += prvReadMessageLength( pxStreamBuffer, xStart, &xCount );
+
+				if( xStart >= pxStreamBuffer->xLength )
+				{
+					xStart -= pxStreamBuffer->xLength;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				xCount = 0;
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		prvDescribeRegions( pxStreamBuffer, xStart, xCount, pxRegions );
+
+		return xCount;
+	}
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+	static size_t prvReservedLengthBytes( const StreamBuffer_t * const pxStreamBuffer )
+	{
+	size_t xLengthBytes;
+
+		#if( configUSE_COMPACT_MESSAGE_LENGTHS == 1 )
+		{
+			/* No message can be longer than the storage area.  A shorter
+			varint is padded out to this size when it is written. */
+			if( ( pxStreamBuffer->ucFlags & sbFLAGS_LENGTH_FORMAT_MASK ) == sbFLAGS_LENGTH_VARINT )
+			{
+				xLengthBytes = prvBytesToStoreMessageLength( pxStreamBuffer, pxStreamBuffer->xLength - ( size_t ) 1 );
+			}
+			else
+			{
+				/* The other formats are a fixed size. */
+				xLengthBytes = prvBytesToStoreMessageLength( pxStreamBuffer, ( size_t ) 0 );
+			}
+		}
+		#else
+		{
+			( void ) pxStreamBuffer;
+			xLengthBytes = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+		}
+		#endif /* configUSE_COMPACT_MESSAGE_LENGTHS */
+
+		return xLengthBytes;
+	}
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+	static void prvCommitWrite( StreamBuffer_t * const pxStreamBuffer, size_t xCount )
+	{
+	size_t xNextHead, xLengthBytes;
+
+		xNextHead = pxStreamBuffer->xHead;
+
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+		{
+			/* The body must fit in the space that was acquired. */
+			xLengthBytes = prvReservedLengthBytes( pxStreamBuffer );
+			configASSERT( ( xCount + xLengthBytes ) <= xStreamBufferSpacesAvailable( pxStreamBuffer ) );
+
+			/* Write the length in front of the body, in the space the acquire
+			left for it.  xHead is not moved until both are in place, so the
+			reader sees the whole message at once. */
+			xNextHead = prvWriteMessageLength( pxStreamBuffer, xCount, xLengthBytes, xNextHead );
+		}
+		else
+		{
+			/* The data must fit in the space that was acquired. */
+			configASSERT( xCount <= xStreamBufferSpacesAvailable( pxStreamBuffer ) );
+		}
+
+		xNextHead += xCount;
+
+		if( xNextHead >= pxStreamBuffer->xLength )
+		{
+			xNextHead -= pxStreamBuffer->xLength;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxStreamBuffer->xHead = xNextHead;
+	}
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+	static void prvConsumeRead( StreamBuffer_t * const pxStreamBuffer, size_t xCount )
+	{
+	size_t xNextTail, xMessageLength, xLengthBytes;
+
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+		{
+			/* Messages can only be removed whole, together with their
+			length. */
+			configASSERT( prvBytesInBuffer( pxStreamBuffer ) > prvBytesToStoreMessageLength( pxStreamBuffer, ( size_t ) 0 ) );
+			xLengthBytes = prvReadMessageLength( pxStreamBuffer, pxStreamBuffer->xTail, &xMessageLength );
+			configASSERT( xCount == xMessageLength );
+			xCount += xLengthBytes;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* Cannot remove more than was acquired. */
+		configASSERT( xCount <= prvBytesInBuffer( pxStreamBuffer ) );
+
+		/* Move the tail pointer to effectively remove the data from the
+		buffer. */
+		xNextTail = pxStreamBuffer->xTail + xCount;
+
+		if( xNextTail >= pxStreamBuffer->xLength )
+		{
+			xNextTail -= pxStreamBuffer->xLength;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxStreamBuffer->xTail = xNextTail;
+	}
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
+										  uint8_t * const pucBuffer,
+										  size_t xBufferSizeBytes,
+										  size_t xTriggerLevelBytes,
+										  uint8_t ucFlags )
+{
+	/* Assert here is deliberately writing to the entire buffer to ensure it can
+	be written to without generating exceptions, and is setting the buffer to a
+	known value to assist in development/debugging. */
+	#if( configASSERT_DEFINED == 1 )
+	{
+		/* The value written just has to be identifiable when looking at the
+		memory.  Don't use 0xA5 as that is the stack fill value and could
+		result in confusion as to what is actually being observed. */
+		const BaseType_t xWriteValue = 0x55;
+		configASSERT( memset( pucBuffer, ( int ) xWriteValue, xBufferSizeBytes ) == pucBuffer );
+	}
+	#endif
+
+	memset( ( void * ) pxStreamBuffer, 0x00, sizeof( StreamBuffer_t ) ); /*lint !e9087 memset() requires void *. */
+	pxStreamBuffer->pucBuffer = pucBuffer;
+	pxStreamBuffer->xLength = xBufferSizeBytes;
+	pxStreamBuffer->xTriggerLevelBytes = xTriggerLevelBytes;
+	pxStreamBuffer->ucFlags = ucFlags;
+
+	#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+	{
+		vListInitialise( &( pxStreamBuffer->xTasksWaitingToSend ) );
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+static uint8_t prvGetFlagsFromType( BaseType_t xStreamBufferType )
+{
+uint8_t ucFlags = 0;
+
+	if( ( xStreamBufferType & sbTYPE_MESSAGE_BUFFER ) != 0 )
+	{
+		ucFlags |= sbFLAGS_IS_MESSAGE_BUFFER;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( ( xStreamBufferType & sbTYPE_MULTI_PRODUCER ) != 0 )
+	{
+		/* Multi-producer buffers are only available when
+		configUSE_STREAM_BUFFER_MULTI_PRODUCER is 1. */
+		configASSERT( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 );
+		ucFlags |= sbFLAGS_IS_MULTI_PRODUCER;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( ( xStreamBufferType & sbTYPE_LENGTH_VARINT ) != 0 )
+	{
+		/* The compact length formats are only available when
+		configUSE_COMPACT_MESSAGE_LENGTHS is 1, and only mean anything to a
+		message buffer. */
+		configASSERT( configUSE_COMPACT_MESSAGE_LENGTHS == 1 );
+		configASSERT( ( ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 );
+
+		if( ( xStreamBufferType & sbTYPE_LENGTH_VARINT ) == sbTYPE_LENGTH_1_BYTE )
+		{
+			ucFlags |= sbFLAGS_LENGTH_1_BYTE;
+		}
+		else if( ( xStreamBufferType & sbTYPE_LENGTH_VARINT ) == sbTYPE_LENGTH_2_BYTES )
+		{
+			ucFlags |= sbFLAGS_LENGTH_2_BYTES;
+		}
+		else
+		{
+			ucFlags |= sbFLAGS_LENGTH_VARINT;
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return ucFlags;
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+
+	static size_t prvWriteMultiProducer( StreamBuffer_t * const pxStreamBuffer,
+										 const void * pvTxData,
+										 size_t xDataLengthBytes,
+										 size_t xRequiredSpace )
+	{
+	UBaseType_t uxSavedInterruptStatus;
+	size_t xStart, xSpace, xNextHead, xReturn = 0;
+	BaseType_t xReserved = pdFALSE;
+
+		/* Writes are all or nothing, so a record is never split, and never
+		interleaved with the bytes of another writer.  The reservation only
+		updates two variables, so interrupts are masked for a few instructions
+		however big the write is.  The FROM_ISR versions of the interrupt
+		masking macros are used as this function is called from tasks and
+		interrupts alike. */
+		uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			xStart = pxStreamBuffer->xReserveHead;
+
+			xSpace = pxStreamBuffer->xLength + pxStreamBuffer->xTail;
+			xSpace -= xStart;
+			xSpace -= ( size_t ) 1;
+
+			if( xSpace >= pxStreamBuffer->xLength )
+			{
+				xSpace -= pxStreamBuffer->xLength;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( ( xDataLengthBytes > ( size_t ) 0 ) && ( xSpace >= xRequiredSpace ) )
+			{
+				xNextHead = xStart + xRequiredSpace;
+
+				if( xNextHead >= pxStreamBuffer->xLength )
+				{
+					xNextHead -= pxStreamBuffer->xLength;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				pxStreamBuffer->xReserveHead = xNextHead;
+				( pxStreamBuffer->uxWritersInFlight )++;
+				xReserved = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		if( xReserved != pdFALSE )
+		{
+			/* Copy into the reserved space with interrupts enabled.  Other
+			writers can reserve and fill the space that follows at the same
+			time, and the reader cannot see any of it until it is committed. */
+			if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+			{
+				xStart = prvWriteMessageLength( pxStreamBuffer, xDataLengthBytes, xRequiredSpace - xDataLengthBytes, xStart );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			( void ) prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) pvTxData, xDataLengthBytes, xStart ); /*lint !e9079 Storage buffer is implemented as uint8_t for ease of sizing, alighment and access. */
+
+			/* Commit.  Space is reserved in order, so when no other write is
+			in progress everything up to xReserveHead has been written and can
+			be handed to the reader in one go.  Otherwise the last writer to
+			finish does that, which keeps the data in the order in which the
+			space was reserved.  Writing tasks hold the scheduler suspended
+			while they are here, and writing interrupts finish before the
+			code they interrupted resumes, so the writes still in progress
+			are at most one task's and those of the interrupts nested in it,
+			and the last of them finishes within the time taken to copy
+			one. */
+			uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+			{
+				( pxStreamBuffer->uxWritersInFlight )--;
+
+				if( pxStreamBuffer->uxWritersInFlight == ( UBaseType_t ) 0 )
+				{
+					pxStreamBuffer->xHead = pxStreamBuffer->xReserveHead;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+			xReturn = xDataLengthBytes;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_STREAM_BUFFER_MULTI_PRODUCER */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+
+	static void prvUnblockWaitingWriters( StreamBuffer_t * const pxStreamBuffer )
+	{
+	BaseType_t xYieldRequired = pdFALSE;
+
+		/* A writer only adds itself to the list from within a critical
+		section in which it has just seen too little space, so if the list is
+		empty here no writer can be waiting for the space just freed. */
+		if( listLIST_IS_EMPTY( &( pxStreamBuffer->xTasksWaitingToSend ) ) == pdFALSE )
+		{
+			taskENTER_CRITICAL();
+			{
+				/* Every waiting writer is unblocked, as a smaller write
+				further down the list may fit where the first does not.  Any
+				that still do not fit wait again. */
+				while( listLIST_IS_EMPTY( &( pxStreamBuffer->xTasksWaitingToSend ) ) == pdFALSE )
+				{
+					if( xTaskRemoveFromEventList( &( pxStreamBuffer->xTasksWaitingToSend ) ) != pdFALSE )
+					{
+						xYieldRequired = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			if( xYieldRequired != pdFALSE )
+			{
+				portYIELD_WITHIN_API();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_STREAM_BUFFER_MULTI_PRODUCER */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+
+	static BaseType_t prvUnblockWaitingWritersFromISR( StreamBuffer_t * const pxStreamBuffer, BaseType_t * const pxHigherPriorityTaskWoken )
+	{
+	UBaseType_t uxSavedInterruptStatus;
+	BaseType_t xReturn = pdFALSE;
+
+		if( listLIST_IS_EMPTY( &( pxStreamBuffer->xTasksWaitingToSend ) ) == pdFALSE )
+		{
+			uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+			{
+				while( listLIST_IS_EMPTY( &( pxStreamBuffer->xTasksWaitingToSend ) ) == pdFALSE )
+				{
+					if( ( xTaskRemoveFromEventList( &( pxStreamBuffer->xTasksWaitingToSend ) ) != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+					{
+						*pxHigherPriorityTaskWoken = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				xReturn = pdTRUE;
+			}
+			portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_STREAM_BUFFER_MULTI_PRODUCER */
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvShouldWakeReader( StreamBuffer_t * const pxStreamBuffer )
+{
+BaseType_t xReturn = pdFALSE;
+
+	#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+	{
+	UBaseType_t uxSavedInterruptStatus;
+
+		if( pxStreamBuffer->xMaxLatency != ( TickType_t ) 0 )
+		{
+			/* The first bytes written to an empty buffer start the latency
+			clock, and unblock the reader so it can wait for the rest of the
+			data with a timeout.  Interrupts are masked so another writer, or
+			the reader stopping the clock, cannot get in between the test and
+			the set. */
+			uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+			{
+				if( pxStreamBuffer->xLatencyClockRunning == pdFALSE )
+				{
+					pxStreamBuffer->xFirstByteTime = xTaskGetTickCountFromISR();
+					pxStreamBuffer->xLatencyClockRunning = pdTRUE;
+					xReturn = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configUSE_STREAM_BUFFER_COALESCING */
+
+	if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+	{
+		xReturn = pdTRUE;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+
+	static size_t prvWaitForCoalescedData( StreamBuffer_t * const pxStreamBuffer,
+										   size_t xBytesAvailable,
+										   TimeOut_t * const pxTimeOut,
+										   TickType_t * const pxTicksToWait )
+	{
+	TickType_t xTimeNow, xTicksToDelay;
+
+		while( ( xBytesAvailable > ( size_t ) 0 ) && ( xBytesAvailable < pxStreamBuffer->xTriggerLevelBytes ) )
+		{
+			/* The reader's own block time still applies. */
+			if( xTaskCheckForTimeOut( pxTimeOut, pxTicksToWait ) != pdFALSE )
+			{
+				break;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* Working out how long to wait and clearing the notification
+			state must be performed atomically, as for the wait for the first
+			byte. */
+			taskENTER_CRITICAL();
+			{
+				xTimeNow = xTaskGetTickCount();
+				xTicksToDelay = ( TickType_t ) 0;
+
+				/* A writer that has made its bytes visible but not yet reached
+				prvShouldWakeReader() has not started the clock - start it
+				now. */
+				if( pxStreamBuffer->xLatencyClockRunning == pdFALSE )
+				{
+					pxStreamBuffer->xFirstByteTime = xTimeNow;
+					pxStreamBuffer->xLatencyClockRunning = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				xTimeNow -= pxStreamBuffer->xFirstByteTime;
+
+				if( ( xTimeNow < pxStreamBuffer->xMaxLatency ) &&
+					( prvBytesInBuffer( pxStreamBuffer ) < pxStreamBuffer->xTriggerLevelBytes ) )
+				{
+					xTicksToDelay = pxStreamBuffer->xMaxLatency - xTimeNow;
+
+					if( xTicksToDelay > *pxTicksToWait )
+					{
+						xTicksToDelay = *pxTicksToWait;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					/* Clear notification state as going to wait for data. */
+					( void ) xTaskNotifyStateClear( NULL );
+
+					/* Should only be one reader. */
+					configASSERT( pxStreamBuffer->xTaskWaitingToReceive == NULL );
+					pxStreamBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			/* Either the latency has expired or the trigger level was reached
+			while the clock was being checked. */
+			if( xTicksToDelay == ( TickType_t ) 0 )
+			{
+				break;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* Wait for the trigger level to be reached, or the latency to
+			expire. */
+			traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( pxStreamBuffer );
+			( void ) xTaskNotifyWait( ( uint32_t ) 0, UINT32_MAX, NULL, xTicksToDelay );
+			pxStreamBuffer->xTaskWaitingToReceive = NULL;
+
+			xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+		}
+
+		return xBytesAvailable;
+	}
+
+#endif /* configUSE_STREAM_BUFFER_COALESCING */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+
+	static void prvStopLatencyClock( StreamBuffer_t * const pxStreamBuffer )
+	{
+	UBaseType_t uxSavedInterruptStatus;
+
+		if( pxStreamBuffer->xMaxLatency != ( TickType_t ) 0 )
+		{
+			/* Can be called from tasks and interrupts.  Interrupts are masked
+			so a byte cannot be written between finding the buffer empty and
+			stopping the clock - that byte would then never be timed. */
+			uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+			{
+				if( pxStreamBuffer->xHead == pxStreamBuffer->xTail )
+				{
+					pxStreamBuffer->xLatencyClockRunning = pdFALSE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_STREAM_BUFFER_COALESCING */
+/*-----------------------------------------------------------*/
 
 #if ( configUSE_TRACE_FACILITY == 1 )
 
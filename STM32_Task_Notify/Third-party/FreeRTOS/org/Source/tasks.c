@@ -40,6 +40,8 @@ task.h is included from an application file. */
 #include "task.h"
 #include "timers.h"
 #include "stack_macros.h"
+#include "reloc_heap.h"
+#include "object_registry.h"
 
 /* Lint e961 and e750 are suppressed as a MISRA exception justified because the
 MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined for the
@@ -358,6 +360,10 @@ typedef struct tskTaskControlBlock
 		uint8_t ucDelayAborted;
 	#endif
 
+	#if( configUSE_64_BIT_EVENT_GROUPS == 1 )
+		uint64_t		ullEventValue64;	/*< The bits a task blocked on a 64-bit event group is waiting for, then the event group value when it is unblocked.  The event list item value is too small to hold them. */
+	#endif
+
 } tskTCB;
 
 /* The old tskTCB name is maintained above then typedefed to the new TCB_t name
@@ -1033,6 +1039,15 @@ UBaseType_t x;
 	}
 	#endif /* portUSING_MPU_WRAPPERS */
 
+	#if( configUSE_OBJECT_REGISTRY == 1 )
+	{
+		/* Register the task under the copy of its name held in the TCB.  The
+		task is still created if the registry is full, in which case
+		xTaskGetHandle() falls back to searching the task lists. */
+		( void ) xObjectRegistryAdd( ( void * ) pxNewTCB, pxNewTCB->pcTaskName, eObjectTypeTask );
+	}
+	#endif /* configUSE_OBJECT_REGISTRY */
+
 	if( ( void * ) pxCreatedTask != NULL )
 	{
 		/* Pass the handle out in an anonymous way.  The handle can be used to
@@ -1135,6 +1150,14 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 	{
 	TCB_t *pxTCB;
 
+		#if( configUSE_OBJECT_REGISTRY == 1 )
+		{
+			/* The registry is protected by suspending the scheduler, so cannot
+			be updated from inside the critical section below. */
+			vObjectRegistryRemove( ( void * ) prvGetTCBFromHandle( xTaskToDelete ) );
+		}
+		#endif
+
 		taskENTER_CRITICAL();
 		{
 			/* If null is passed in here then it is the calling task that is
@@ -2371,6 +2394,24 @@ TCB_t *pxTCB;
 		/* Task names will be truncated to configMAX_TASK_NAME_LEN - 1 bytes. */
 		configASSERT( strlen( pcNameToQuery ) < configMAX_TASK_NAME_LEN );
 
+		#if( configUSE_OBJECT_REGISTRY == 1 )
+		{
+			/* Most tasks are found in the registry.  Only a task that could
+			not be registered, or that has been deleted but not yet freed, is
+			left for the search of the task lists below. */
+			pxTCB = ( TCB_t * ) pvObjectRegistryFind( pcNameToQuery, eObjectTypeTask );
+
+			if( pxTCB != NULL )
+			{
+				return ( TaskHandle_t ) pxTCB;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configUSE_OBJECT_REGISTRY */
+
 		vTaskSuspendAll();
 		{
 			/* Search the ready lists. */
@@ -3105,6 +3146,64 @@ TCB_t *pxUnblockedTCB;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_EVENT_GROUP_ISR_DIRECT == 1 )
+
+	BaseType_t xTaskRemoveFromUnorderedEventListFromISR( ListItem_t * pxEventListItem, const TickType_t xItemValue )
+	{
+	TCB_t *pxUnblockedTCB;
+	BaseType_t xReturn;
+
+		/* THIS FUNCTION MUST BE CALLED FROM A CRITICAL SECTION, or from an
+		interrupt with interrupts masked.  It is used by the event flags
+		implementation, which only calls it when no task is working on the
+		event flag, so the event list can be accessed here. */
+
+		/* Store the new item value in the event list. */
+		listSET_LIST_ITEM_VALUE( pxEventListItem, xItemValue | taskEVENT_LIST_ITEM_VALUE_IN_USE );
+
+		/* Remove the event list form the event flag. */
+		pxUnblockedTCB = ( TCB_t * ) listGET_LIST_ITEM_OWNER( pxEventListItem );
+		configASSERT( pxUnblockedTCB );
+		( void ) uxListRemove( pxEventListItem );
+
+		if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+		{
+			( void ) uxListRemove( &( pxUnblockedTCB->xStateListItem ) );
+			prvAddTaskToReadyList( pxUnblockedTCB );
+		}
+		else
+		{
+			/* The delayed and ready lists cannot be accessed, so hold this task
+			pending until the scheduler is resumed. */
+			vListInsertEnd( &( xPendingReadyList ), pxEventListItem );
+		}
+
+		if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+		{
+			/* Return true so the interrupt can request a context switch, and
+			mark that a yield is pending in case the user is not using the
+			"xHigherPriorityTaskWoken" parameter. */
+			xReturn = pdTRUE;
+			xYieldPending = pdTRUE;
+		}
+		else
+		{
+			xReturn = pdFALSE;
+		}
+
+		#if( configUSE_TICKLESS_IDLE != 0 )
+		{
+			/* As in xTaskRemoveFromEventList(). */
+			prvResetNextTaskUnblockTime();
+		}
+		#endif
+
+		return xReturn;
+	}
+
+#endif /* configUSE_EVENT_GROUP_ISR_DIRECT */
+/*-----------------------------------------------------------*/
+
 void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
 {
 	configASSERT( pxTimeOut );
@@ -3262,6 +3361,15 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
 		is responsible for freeing the deleted task's TCB and stack. */
 		prvCheckTasksWaitingTermination();
 
+		#if ( configUSE_RELOCATABLE_HEAP == 1 )
+		{
+			/* Move part of one relocatable buffer down over any free space
+			below it.  Each step copies a bounded number of bytes so the time
+			the scheduler is suspended for stays short. */
+			( void ) xRelocHeapCompactStep();
+		}
+		#endif /* configUSE_RELOCATABLE_HEAP */
+
 		#if ( configUSE_PREEMPTION == 0 )
 		{
 			/* If we are not using preemption we keep forcing a task switch to
@@ -4426,6 +4534,71 @@ TickType_t uxReturn;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_64_BIT_EVENT_GROUPS == 1 )
+
+	void vTaskPlaceOnUnorderedEventList64( List_t * pxEventList, const TickType_t xItemValue, const uint64_t ullEventValue, const TickType_t xTicksToWait )
+	{
+		/* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED, as checked
+		by vTaskPlaceOnUnorderedEventList().  The value is stored before the
+		task is placed on the list, so it is set whenever another task finds the
+		task's event list item there. */
+		pxCurrentTCB->ullEventValue64 = ullEventValue;
+		vTaskPlaceOnUnorderedEventList( pxEventList, xItemValue, xTicksToWait );
+	}
+
+#endif /* configUSE_64_BIT_EVENT_GROUPS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_64_BIT_EVENT_GROUPS == 1 )
+
+	void vTaskRemoveFromUnorderedEventList64( ListItem_t * pxEventListItem, const TickType_t xItemValue, const uint64_t ullEventValue )
+	{
+	TCB_t *pxUnblockedTCB;
+
+		/* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED, as checked
+		by vTaskRemoveFromUnorderedEventList(). */
+		pxUnblockedTCB = ( TCB_t * ) listGET_LIST_ITEM_OWNER( pxEventListItem );
+		configASSERT( pxUnblockedTCB );
+		pxUnblockedTCB->ullEventValue64 = ullEventValue;
+		vTaskRemoveFromUnorderedEventList( pxEventListItem, xItemValue );
+	}
+
+#endif /* configUSE_64_BIT_EVENT_GROUPS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_64_BIT_EVENT_GROUPS == 1 )
+
+	uint64_t ullTaskGetEventValue64( const ListItem_t * pxEventListItem )
+	{
+	TCB_t *pxTCB;
+
+		/* The scheduler is suspended, so the task cannot leave the event list,
+		or be deleted, while its value is read. */
+		configASSERT( uxSchedulerSuspended != pdFALSE );
+		pxTCB = ( TCB_t * ) listGET_LIST_ITEM_OWNER( pxEventListItem );
+		configASSERT( pxTCB );
+
+		return pxTCB->ullEventValue64;
+	}
+
+#endif /* configUSE_64_BIT_EVENT_GROUPS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_64_BIT_EVENT_GROUPS == 1 )
+
+	uint64_t ullTaskResetEventValue64( void )
+	{
+	uint64_t ullReturn;
+
+		ullReturn = pxCurrentTCB->ullEventValue64;
+		pxCurrentTCB->ullEventValue64 = 0;
+
+		return ullReturn;
+	}
+
+#endif /* configUSE_64_BIT_EVENT_GROUPS */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_MUTEXES == 1 )
 
 	void *pvTaskIncrementMutexHeldCount( void )
@@ -4443,6 +4616,37 @@ TickType_t uxReturn;
 #endif /* configUSE_MUTEXES */
 /*-----------------------------------------------------------*/
 
+#if ( ( configUSE_MUTEXES == 1 ) && ( configUSE_FAST_MUTEXES == 1 ) )
+
+	BaseType_t xTaskDecrementMutexHeldCount( void )
+	{
+	BaseType_t xReturn = pdFALSE;
+
+		configASSERT( pxCurrentTCB->uxMutexesHeld );
+
+		/* Only the running task changes its own held count, so in the common
+		case no critical section is needed.  Disinheriting a priority moves the
+		task between ready lists, and is only necessary when the last mutex is
+		given back while an inherited priority is still in effect. */
+		if( ( pxCurrentTCB->uxMutexesHeld == ( UBaseType_t ) 1 ) && ( pxCurrentTCB->uxPriority != pxCurrentTCB->uxBasePriority ) )
+		{
+			taskENTER_CRITICAL();
+			{
+				xReturn = xTaskPriorityDisinherit( pxCurrentTCB );
+			}
+			taskEXIT_CRITICAL();
+		}
+		else
+		{
+			( pxCurrentTCB->uxMutexesHeld )--;
+		}
+
+		return xReturn;
+	}
+
+#endif /* ( configUSE_MUTEXES == 1 ) && ( configUSE_FAST_MUTEXES == 1 ) */
+/*-----------------------------------------------------------*/
+
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
 	uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
@@ -38,6 +38,7 @@ task.h is included from an application file. */
 #include "task.h"
 #include "queue.h"
 #include "timers.h"
+#include "object_registry.h"
 
 #if ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 0 )
 	#error configUSE_TIMERS must be set to 1 to make the xTimerPendFunctionCall() function available.
@@ -65,6 +66,47 @@ defining trmTIMER_SERVICE_TASK_NAME in FreeRTOSConfig.h. */
 	#define configTIMER_SERVICE_TASK_NAME "Tmr Svc"
 #endif
 
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	/* Each level of the timing wheel has 16 slots, and a slot on one level
+	spans as many ticks as all the slots of the level below it.  Enough levels
+	are used for the top level to reach any expiry time a TickType_t can
+	hold. */
+	#define tmrWHEEL_SLOT_BITS		( 4U )
+	#define tmrWHEEL_SLOTS			( 1U << tmrWHEEL_SLOT_BITS )
+	#define tmrWHEEL_SLOT_MASK		( ( TickType_t ) tmrWHEEL_SLOTS - ( TickType_t ) 1 )
+	#define tmrWHEEL_ALL_SLOTS		( ( 1UL << tmrWHEEL_SLOTS ) - 1UL )
+
+	#if( configUSE_16_BIT_TICKS == 1 )
+		#define tmrWHEEL_LEVELS		( 4U )
+	#else
+		#define tmrWHEEL_LEVELS		( 8U )
+	#endif
+
+	/* Find the number of the least significant bit set in ulBits, which must
+	not be 0. */
+	#if( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+
+		/* Isolate the lowest set bit, then use the count leading zeros
+		instruction the port provides for selecting the highest priority ready
+		task to find its number. */
+		#define tmrGET_LOWEST_BIT( uxBit, ulBits ) portGET_HIGHEST_PRIORITY( uxBit, ( ( ulBits ) & ( ~( ulBits ) + 1UL ) ) )
+
+	#else
+
+		#define tmrGET_LOWEST_BIT( uxBit, ulBits )						\
+		{																\
+			( uxBit ) = 0U;												\
+			while( ( ( ulBits ) & ( 1UL << ( uxBit ) ) ) == 0UL )		\
+			{															\
+				( uxBit )++;											\
+			}															\
+		}
+
+	#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+
+#endif /* configUSE_TIMER_WHEEL */
+
 /* The definition of the timers themselves. */
 typedef struct tmrTimerControl
 {
@@ -126,13 +168,36 @@ typedef struct tmrTimerQueueMessage
 /*lint -save -e956 A manual analysis and inspection has been used to determine
 which static variables must be declared volatile. */
 
-/* The list in which active timers are stored.  Timers are referenced in expire
-time order, with the nearest expiry time at the front of the list.  Only the
-timer service task is allowed to access these lists. */
-PRIVILEGED_DATA static List_t xActiveTimerList1;
-PRIVILEGED_DATA static List_t xActiveTimerList2;
-PRIVILEGED_DATA static List_t *pxCurrentTimerList;
-PRIVILEGED_DATA static List_t *pxOverflowTimerList;
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	/* The timing wheel in which active timers are stored.  Level 0 has a slot
+	for each of the next tmrWHEEL_SLOTS ticks.  A timer is held on the lowest
+	level that reaches its expiry time, in the slot that covers that time, and
+	is moved (cascaded) to a lower level when the wheel time enters its slot.
+	Starting, stopping and expiring a timer are therefore constant time
+	operations however many timers are active.  Only the timer service task is
+	allowed to access the wheel. */
+	PRIVILEGED_DATA static List_t xTimerWheel[ tmrWHEEL_LEVELS ][ tmrWHEEL_SLOTS ];
+
+	/* Bit n of ulWheelOccupied[ x ] is set when slot n of level x holds at
+	least one timer. */
+	PRIVILEGED_DATA static uint32_t ulWheelOccupied[ tmrWHEEL_LEVELS ];
+
+	/* The next tick the wheel will process.  Every timer that expires before
+	this time has been processed already. */
+	PRIVILEGED_DATA static TickType_t xWheelTime;
+
+#else
+
+	/* The list in which active timers are stored.  Timers are referenced in
+	expire time order, with the nearest expiry time at the front of the list.
+	Only the timer service task is allowed to access these lists. */
+	PRIVILEGED_DATA static List_t xActiveTimerList1;
+	PRIVILEGED_DATA static List_t xActiveTimerList2;
+	PRIVILEGED_DATA static List_t *pxCurrentTimerList;
+	PRIVILEGED_DATA static List_t *pxOverflowTimerList;
+
+#endif /* configUSE_TIMER_WHEEL */
 
 /* A queue that is used to send commands to the timer service task. */
 PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
@@ -173,21 +238,47 @@ static void prvProcessReceivedCommands( void ) PRIVILEGED_FUNCTION;
 
 /*
  * Insert the timer into either xActiveTimerList1, or xActiveTimerList2,
- * depending on if the expire time causes a timer counter overflow.
+ * depending on if the expire time causes a timer counter overflow.  When
+ * configUSE_TIMER_WHEEL is 1 the timer is inserted into the timing wheel
+ * instead.
  */
 static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer, const TickType_t xNextExpiryTime, const TickType_t xTimeNow, const TickType_t xCommandTime ) PRIVILEGED_FUNCTION;
 
 /*
  * An active timer has reached its expire time.  Reload the timer if it is an
- * auto reload timer, then call its callback.
+ * auto reload timer, then call its callback.  When configUSE_TIMER_WHEEL is 1
+ * every timer that has reached its expire time by xTimeNow is processed.
  */
 static void prvProcessExpiredTimer( const TickType_t xNextExpireTime, const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
-/*
- * The tick count has overflowed.  Switch the timer lists after ensuring the
- * current timer list does not still reference some timers.
- */
-static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	/*
+	 * Place an active timer in the wheel slot that holds its expiry time, which
+	 * must not be before xWheelTime.
+	 */
+	static void prvInsertTimerInWheel( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Take an active timer out of the wheel.
+	 */
+	static void prvRemoveTimerFromWheel( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Process the wheel time xWheelTime: cascade the higher level slots that
+	 * start at that time, then expire the timers in the level 0 slot.
+	 */
+	static void prvProcessWheelTime( void ) PRIVILEGED_FUNCTION;
+
+#else
+
+	/*
+	 * The tick count has overflowed.  Switch the timer lists after ensuring the
+	 * current timer list does not still reference some timers.
+	 */
+	static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TIMER_WHEEL */
 
 /*
  * Obtain the current tick count, setting *pxTimerListsWereSwitched to pdTRUE
@@ -374,6 +465,21 @@ static void prvInitialiseNewTimer(	const char * const pcTimerName,			/*lint !e97
 		pxNewTimer->pvTimerID = pvTimerID;
 		pxNewTimer->pxCallbackFunction = pxCallbackFunction;
 		vListInitialiseItem( &( pxNewTimer->xTimerListItem ) );
+
+		#if( configUSE_OBJECT_REGISTRY == 1 )
+		{
+			/* Timers are registered under their name, if they have one. */
+			if( pcTimerName != NULL )
+			{
+				( void ) xObjectRegistryAdd( ( void * ) pxNewTimer, pcTimerName, eObjectTypeTimer );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configUSE_OBJECT_REGISTRY */
+
 		traceTIMER_CREATE( pxNewTimer );
 	}
 }
@@ -460,44 +566,48 @@ Timer_t *pxTimer = ( Timer_t * ) xTimer;
 }
 /*-----------------------------------------------------------*/
 
-static void prvProcessExpiredTimer( const TickType_t xNextExpireTime, const TickType_t xTimeNow )
-{
-BaseType_t xResult;
-Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList );
-
-	/* Remove the timer from the list of active timers.  A check has already
-	been performed to ensure the list is not empty. */
-	( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
-	traceTIMER_EXPIRED( pxTimer );
+#if( configUSE_TIMER_WHEEL == 0 )
 
-	/* If the timer is an auto reload timer then calculate the next
-	expiry time and re-insert the timer in the list of active timers. */
-	if( pxTimer->uxAutoReload == ( UBaseType_t ) pdTRUE )
+	static void prvProcessExpiredTimer( const TickType_t xNextExpireTime, const TickType_t xTimeNow )
 	{
-		/* The timer is inserted into a list using a time relative to anything
-		other than the current time.  It will therefore be inserted into the
-		correct list relative to the time this task thinks it is now. */
-		if( prvInsertTimerInActiveList( pxTimer, ( xNextExpireTime + pxTimer->xTimerPeriodInTicks ), xTimeNow, xNextExpireTime ) != pdFALSE )
+	BaseType_t xResult;
+	Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList );
+
+		/* Remove the timer from the list of active timers.  A check has already
+		been performed to ensure the list is not empty. */
+		( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+		traceTIMER_EXPIRED( pxTimer );
+
+		/* If the timer is an auto reload timer then calculate the next
+		expiry time and re-insert the timer in the list of active timers. */
+		if( pxTimer->uxAutoReload == ( UBaseType_t ) pdTRUE )
 		{
-			/* The timer expired before it was added to the active timer
-			list.  Reload it now.  */
-			xResult = xTimerGenericCommand( pxTimer, tmrCOMMAND_START_DONT_TRACE, xNextExpireTime, NULL, tmrNO_DELAY );
-			configASSERT( xResult );
-			( void ) xResult;
+			/* The timer is inserted into a list using a time relative to anything
+			other than the current time.  It will therefore be inserted into the
+			correct list relative to the time this task thinks it is now. */
+			if( prvInsertTimerInActiveList( pxTimer, ( xNextExpireTime + pxTimer->xTimerPeriodInTicks ), xTimeNow, xNextExpireTime ) != pdFALSE )
+			{
+				/* The timer expired before it was added to the active timer
+				list.  Reload it now.  */
+				xResult = xTimerGenericCommand( pxTimer, tmrCOMMAND_START_DONT_TRACE, xNextExpireTime, NULL, tmrNO_DELAY );
+				configASSERT( xResult );
+				( void ) xResult;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
 		}
 		else
 		{
 			mtCOVERAGE_TEST_MARKER();
 		}
-	}
-	else
-	{
-		mtCOVERAGE_TEST_MARKER();
+
+		/* Call the timer callback. */
+		pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
 	}
 
-	/* Call the timer callback. */
-	pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
-}
+#endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
 static void prvTimerTask( void *pvParameters )
@@ -536,154 +646,170 @@ BaseType_t xListWasEmpty;
 }
 /*-----------------------------------------------------------*/
 
-static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime, BaseType_t xListWasEmpty )
-{
-TickType_t xTimeNow;
-BaseType_t xTimerListsWereSwitched;
+#if( configUSE_TIMER_WHEEL == 0 )
 
-	vTaskSuspendAll();
+	static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime, BaseType_t xListWasEmpty )
 	{
-		/* Obtain the time now to make an assessment as to whether the timer
-		has expired or not.  If obtaining the time causes the lists to switch
-		then don't process this timer as any timers that remained in the list
-		when the lists were switched will have been processed within the
-		prvSampleTimeNow() function. */
-		xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
-		if( xTimerListsWereSwitched == pdFALSE )
+	TickType_t xTimeNow;
+	BaseType_t xTimerListsWereSwitched;
+
+		vTaskSuspendAll();
 		{
-			/* The tick count has not overflowed, has the timer expired? */
-			if( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) )
-			{
-				( void ) xTaskResumeAll();
-				prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
-			}
-			else
+			/* Obtain the time now to make an assessment as to whether the timer
+			has expired or not.  If obtaining the time causes the lists to switch
+			then don't process this timer as any timers that remained in the list
+			when the lists were switched will have been processed within the
+			prvSampleTimeNow() function. */
+			xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+			if( xTimerListsWereSwitched == pdFALSE )
 			{
-				/* The tick count has not overflowed, and the next expire
-				time has not been reached yet.  This task should therefore
-				block to wait for the next expire time or a command to be
-				received - whichever comes first.  The following line cannot
-				be reached unless xNextExpireTime > xTimeNow, except in the
-				case when the current timer list is empty. */
-				if( xListWasEmpty != pdFALSE )
+				/* The tick count has not overflowed, has the timer expired? */
+				if( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) )
 				{
-					/* The current timer list is empty - is the overflow list
-					also empty? */
-					xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
-				}
-
-				vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
-
-				if( xTaskResumeAll() == pdFALSE )
-				{
-					/* Yield to wait for either a command to arrive, or the
-					block time to expire.  If a command arrived between the
-					critical section being exited and this yield then the yield
-					will not cause the task to block. */
-					portYIELD_WITHIN_API();
+					( void ) xTaskResumeAll();
+					prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
 				}
 				else
 				{
-					mtCOVERAGE_TEST_MARKER();
+					/* The tick count has not overflowed, and the next expire
+					time has not been reached yet.  This task should therefore
+					block to wait for the next expire time or a command to be
+					received - whichever comes first.  The following line cannot
+					be reached unless xNextExpireTime > xTimeNow, except in the
+					case when the current timer list is empty. */
+					if( xListWasEmpty != pdFALSE )
+					{
+						/* The current timer list is empty - is the overflow list
+						also empty? */
+						xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
+					}
+
+					vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
+
+					if( xTaskResumeAll() == pdFALSE )
+					{
+						/* Yield to wait for either a command to arrive, or the
+						block time to expire.  If a command arrived between the
+						critical section being exited and this yield then the yield
+						will not cause the task to block. */
+						portYIELD_WITHIN_API();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
 				}
 			}
-		}
-		else
-		{
-			( void ) xTaskResumeAll();
+			else
+			{
+				( void ) xTaskResumeAll();
+			}
 		}
 	}
-}
+
+#endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
-static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
-{
-TickType_t xNextExpireTime;
+#if( configUSE_TIMER_WHEEL == 0 )
 
-	/* Timers are listed in expiry time order, with the head of the list
-	referencing the task that will expire first.  Obtain the time at which
-	the timer with the nearest expiry time will expire.  If there are no
-	active timers then just set the next expire time to 0.  That will cause
-	this task to unblock when the tick count overflows, at which point the
-	timer lists will be switched and the next expiry time can be
-	re-assessed.  */
-	*pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
-	if( *pxListWasEmpty == pdFALSE )
+	static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
 	{
-		xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
-	}
-	else
-	{
-		/* Ensure the task unblocks when the tick count rolls over. */
-		xNextExpireTime = ( TickType_t ) 0U;
+	TickType_t xNextExpireTime;
+
+		/* Timers are listed in expiry time order, with the head of the list
+		referencing the task that will expire first.  Obtain the time at which
+		the timer with the nearest expiry time will expire.  If there are no
+		active timers then just set the next expire time to 0.  That will cause
+		this task to unblock when the tick count overflows, at which point the
+		timer lists will be switched and the next expiry time can be
+		re-assessed.  */
+		*pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
+		if( *pxListWasEmpty == pdFALSE )
+		{
+			xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+		}
+		else
+		{
+			/* Ensure the task unblocks when the tick count rolls over. */
+			xNextExpireTime = ( TickType_t ) 0U;
+		}
+
+		return xNextExpireTime;
 	}
 
-	return xNextExpireTime;
-}
+#endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
-static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
-{
-TickType_t xTimeNow;
-PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U; /*lint !e956 Variable is only accessible to one task. */
-
-	xTimeNow = xTaskGetTickCount();
+#if( configUSE_TIMER_WHEEL == 0 )
 
-	if( xTimeNow < xLastTime )
-	{
-		prvSwitchTimerLists();
-		*pxTimerListsWereSwitched = pdTRUE;
-	}
-	else
+	static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
 	{
-		*pxTimerListsWereSwitched = pdFALSE;
-	}
-
-	xLastTime = xTimeNow;
-
-	return xTimeNow;
-}
-/*-----------------------------------------------------------*/
+	TickType_t xTimeNow;
+	PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U; /*lint !e956 Variable is only accessible to one task. */
 
-static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer, const TickType_t xNextExpiryTime, const TickType_t xTimeNow, const TickType_t xCommandTime )
-{
-BaseType_t xProcessTimerNow = pdFALSE;
-
-	listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xNextExpiryTime );
-	listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
+		xTimeNow = xTaskGetTickCount();
 
-	if( xNextExpiryTime <= xTimeNow )
-	{
-		/* Has the expiry time elapsed between the command to start/reset a
-		timer was issued, and the time the command was processed? */
-		if( ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) >= pxTimer->xTimerPeriodInTicks ) /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+		if( xTimeNow < xLastTime )
 		{
-			/* The time between a command being issued and the command being
-			processed actually exceeds the timers period.  */
-			xProcessTimerNow = pdTRUE;
+			prvSwitchTimerLists();
+			*pxTimerListsWereSwitched = pdTRUE;
 		}
 		else
 		{
-			vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+			*pxTimerListsWereSwitched = pdFALSE;
 		}
+
+		xLastTime = xTimeNow;
+
+		return xTimeNow;
 	}
-	else
+
+#endif /* configUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TIMER_WHEEL == 0 )
+
+	static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer, const TickType_t xNextExpiryTime, const TickType_t xTimeNow, const TickType_t xCommandTime )
 	{
-		if( ( xTimeNow < xCommandTime ) && ( xNextExpiryTime >= xCommandTime ) )
+	BaseType_t xProcessTimerNow = pdFALSE;
+
+		listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xNextExpiryTime );
+		listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
+
+		if( xNextExpiryTime <= xTimeNow )
 		{
-			/* If, since the command was issued, the tick count has overflowed
-			but the expiry time has not, then the timer must have already passed
-			its expiry time and should be processed immediately. */
-			xProcessTimerNow = pdTRUE;
+			/* Has the expiry time elapsed between the command to start/reset a
+			timer was issued, and the time the command was processed? */
+			if( ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) >= pxTimer->xTimerPeriodInTicks ) /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+			{
+				/* The time between a command being issued and the command being
+				processed actually exceeds the timers period.  */
+				xProcessTimerNow = pdTRUE;
+			}
+			else
+			{
+				vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+			}
 		}
 		else
 		{
-			vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+			if( ( xTimeNow < xCommandTime ) && ( xNextExpiryTime >= xCommandTime ) )
+			{
+				/* If, since the command was issued, the tick count has overflowed
+				but the expiry time has not, then the timer must have already passed
+				its expiry time and should be processed immediately. */
+				xProcessTimerNow = pdTRUE;
+			}
+			else
+			{
+				vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+			}
 		}
+
+		return xProcessTimerNow;
 	}
 
-	return xProcessTimerNow;
-}
+#endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
 static void	prvProcessReceivedCommands( void )
@@ -728,7 +854,15 @@ TickType_t xTimeNow;
 			if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
 			{
 				/* The timer is in a list, remove it. */
-				( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+				#if( configUSE_TIMER_WHEEL == 1 )
+				{
+					prvRemoveTimerFromWheel( pxTimer );
+				}
+				#else
+				{
+					( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+				}
+				#endif
 			}
 			else
 			{
@@ -798,6 +932,12 @@ TickType_t xTimeNow;
 					break;
 
 				case tmrCOMMAND_DELETE :
+					#if( configUSE_OBJECT_REGISTRY == 1 )
+					{
+						vObjectRegistryRemove( ( void * ) pxTimer );
+					}
+					#endif
+
 					/* The timer has already been removed from the active list,
 					just free up the memory if the memory was dynamically
 					allocated. */
@@ -833,67 +973,378 @@ TickType_t xTimeNow;
 }
 /*-----------------------------------------------------------*/
 
-static void prvSwitchTimerLists( void )
-{
-TickType_t xNextExpireTime, xReloadTime;
-List_t *pxTemp;
-Timer_t *pxTimer;
-BaseType_t xResult;
+#if( configUSE_TIMER_WHEEL == 0 )
 
-	/* The tick count has overflowed.  The timer lists must be switched.
-	If there are any timers still referenced from the current timer list
-	then they must have expired and should be processed before the lists
-	are switched. */
-	while( listLIST_IS_EMPTY( pxCurrentTimerList ) == pdFALSE )
+	static void prvSwitchTimerLists( void )
 	{
-		xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+	TickType_t xNextExpireTime, xReloadTime;
+	List_t *pxTemp;
+	Timer_t *pxTimer;
+	BaseType_t xResult;
+
+		/* The tick count has overflowed.  The timer lists must be switched.
+		If there are any timers still referenced from the current timer list
+		then they must have expired and should be processed before the lists
+		are switched. */
+		while( listLIST_IS_EMPTY( pxCurrentTimerList ) == pdFALSE )
+		{
+			xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
 
-		/* Remove the timer from the list. */
-		pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList );
-		( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
-		traceTIMER_EXPIRED( pxTimer );
+			/* Remove the timer from the list. */
+			pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList );
+			( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+			traceTIMER_EXPIRED( pxTimer );
 
-		/* Execute its callback, then send a command to restart the timer if
-		it is an auto-reload timer.  It cannot be restarted here as the lists
-		have not yet been switched. */
-		pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+			/* Execute its callback, then send a command to restart the timer if
+			it is an auto-reload timer.  It cannot be restarted here as the lists
+			have not yet been switched. */
+			pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
 
-		if( pxTimer->uxAutoReload == ( UBaseType_t ) pdTRUE )
+			if( pxTimer->uxAutoReload == ( UBaseType_t ) pdTRUE )
+			{
+				/* Calculate the reload value, and if the reload value results in
+				the timer going into the same timer list then it has already expired
+				and the timer should be re-inserted into the current list so it is
+				processed again within this loop.  Otherwise a command should be sent
+				to restart the timer to ensure it is only inserted into a list after
+				the lists have been swapped. */
+				xReloadTime = ( xNextExpireTime + pxTimer->xTimerPeriodInTicks );
+				if( xReloadTime > xNextExpireTime )
+				{
+					listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xReloadTime );
+					listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
+					vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+				}
+				else
+				{
+					xResult = xTimerGenericCommand( pxTimer, tmrCOMMAND_START_DONT_TRACE, xNextExpireTime, NULL, tmrNO_DELAY );
+					configASSERT( xResult );
+					( void ) xResult;
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		pxTemp = pxCurrentTimerList;
+		pxCurrentTimerList = pxOverflowTimerList;
+		pxOverflowTimerList = pxTemp;
+	}
+
+#endif /* configUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	static void prvProcessExpiredTimer( const TickType_t xNextExpireTime, const TickType_t xTimeNow )
+	{
+	TickType_t xNextWheelTime = xNextExpireTime;
+	BaseType_t xWheelWasEmpty;
+
+		/* Move the wheel time to each time at which there is something to do -
+		timers to expire or a slot to cascade - up to and including xTimeNow.
+		The times in between hold nothing, so are skipped.  An auto reload timer
+		that is reloaded with an expiry time that has also passed already is
+		processed again within this loop. */
+		do
+		{
+			xWheelTime = xNextWheelTime;
+			prvProcessWheelTime();
+			xWheelTime++;
+
+			xNextWheelTime = prvGetNextExpireTime( &xWheelWasEmpty );
+
+		} while( ( xWheelWasEmpty == pdFALSE ) && ( ( TickType_t ) ( xNextWheelTime - xWheelTime ) < ( TickType_t ) ( ( xTimeNow + ( TickType_t ) 1 ) - xWheelTime ) ) );
+
+		/* Nothing else is due by xTimeNow. */
+		xWheelTime = xTimeNow + ( TickType_t ) 1;
+	}
+
+#endif /* configUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime, BaseType_t xListWasEmpty )
+	{
+	TickType_t xTimeNow;
+
+		vTaskSuspendAll();
 		{
-			/* Calculate the reload value, and if the reload value results in
-			the timer going into the same timer list then it has already expired
-			and the timer should be re-inserted into the current list so it is
-			processed again within this loop.  Otherwise a command should be sent
-			to restart the timer to ensure it is only inserted into a list after
-			the lists have been swapped. */
-			xReloadTime = ( xNextExpireTime + pxTimer->xTimerPeriodInTicks );
-			if( xReloadTime > xNextExpireTime )
+			/* Times are compared as offsets from the wheel time, which is never
+			more than one tick ahead of the tick count, so the tick count
+			overflowing needs no special handling. */
+			xTimeNow = xTaskGetTickCount();
+
+			if( ( xListWasEmpty == pdFALSE ) && ( ( TickType_t ) ( xNextExpireTime - xWheelTime ) < ( TickType_t ) ( ( xTimeNow + ( TickType_t ) 1 ) - xWheelTime ) ) )
 			{
-				listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xReloadTime );
-				listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
-				vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+				( void ) xTaskResumeAll();
+				prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
 			}
 			else
 			{
-				xResult = xTimerGenericCommand( pxTimer, tmrCOMMAND_START_DONT_TRACE, xNextExpireTime, NULL, tmrNO_DELAY );
-				configASSERT( xResult );
-				( void ) xResult;
+				/* Nothing is due by xTimeNow, so the wheel time can catch up
+				with the tick count.  Timers started while this task is blocked
+				are then placed relative to the current time, however long the
+				wheel has been idle. */
+				xWheelTime = xTimeNow + ( TickType_t ) 1;
+
+				vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
+
+				if( xTaskResumeAll() == pdFALSE )
+				{
+					/* Yield to wait for either a command to arrive, or the
+					block time to expire.  If a command arrived between the
+					critical section being exited and this yield then the yield
+					will not cause the task to block. */
+					portYIELD_WITHIN_API();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
 			}
 		}
+	}
+
+#endif /* configUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
+	{
+	TickType_t xWindow, xTicksToWindow, xTicksToNext = ( TickType_t ) 0U;
+	UBaseType_t uxLevel, uxShift, uxSlot;
+	uint32_t ulOccupied;
+
+		/* The next time the wheel has something to do is the start of the
+		nearest occupied slot on any level.  For level 0 that is the expiry
+		time of the timers in the slot, for the other levels it is the time at
+		which the slot is cascaded.  If there are no active timers then just
+		return the wheel time. */
+		*pxListWasEmpty = pdTRUE;
+
+		for( uxLevel = 0U; uxLevel < tmrWHEEL_LEVELS; uxLevel++ )
+		{
+			ulOccupied = ulWheelOccupied[ uxLevel ];
+
+			if( ulOccupied != 0UL )
+			{
+				/* Number the windows of this level - the spans of its slots -
+				from tick 0, and find the first window that does not start
+				before the wheel time. */
+				uxShift = uxLevel * tmrWHEEL_SLOT_BITS;
+				xWindow = xWheelTime >> uxShift;
+
+				if( ( TickType_t ) ( xWindow << uxShift ) != xWheelTime )
+				{
+					xWindow++;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* Rotate the occupied bits so bit 0 is the slot of that window.
+				The lowest set bit is then the number of windows to the first
+				occupied slot. */
+				uxSlot = ( UBaseType_t ) ( xWindow & tmrWHEEL_SLOT_MASK );
+				ulOccupied = ( ( ulOccupied >> uxSlot ) | ( ulOccupied << ( tmrWHEEL_SLOTS - uxSlot ) ) ) & tmrWHEEL_ALL_SLOTS;
+				tmrGET_LOWEST_BIT( uxSlot, ulOccupied );
+
+				xTicksToWindow = ( TickType_t ) ( ( TickType_t ) ( xWindow + ( TickType_t ) uxSlot ) << uxShift ) - xWheelTime;
+
+				if( ( *pxListWasEmpty != pdFALSE ) || ( xTicksToWindow < xTicksToNext ) )
+				{
+					xTicksToNext = xTicksToWindow;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				*pxListWasEmpty = pdFALSE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		return xWheelTime + xTicksToNext;
+	}
+
+#endif /* configUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
+	{
+		/* The wheel has no lists to switch when the tick count overflows. */
+		*pxTimerListsWereSwitched = pdFALSE;
+
+		return xTaskGetTickCount();
+	}
+
+#endif /* configUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer, const TickType_t xNextExpiryTime, const TickType_t xTimeNow, const TickType_t xCommandTime )
+	{
+	BaseType_t xProcessTimerNow = pdFALSE;
+
+		listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xNextExpiryTime );
+		listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
+
+		/* Has the expiry time elapsed between the command to start/reset a
+		timer was issued, and the time the command was processed?  Both times
+		are compared as offsets from the command time, so a tick count overflow
+		in between needs no special handling. */
+		if( ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) >= ( ( TickType_t ) ( xNextExpiryTime - xCommandTime ) ) ) /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+		{
+			xProcessTimerNow = pdTRUE;
+		}
+		else
+		{
+			/* The expiry time is after xTimeNow, so it is not before the wheel
+			time either. */
+			prvInsertTimerInWheel( pxTimer );
+		}
+
+		return xProcessTimerNow;
+	}
+
+#endif /* configUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	static void prvInsertTimerInWheel( Timer_t * const pxTimer )
+	{
+	const TickType_t xExpiryTime = listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) );
+	const TickType_t xTicksToExpiry = xExpiryTime - xWheelTime;
+	UBaseType_t uxLevel = 0U, uxSlot;
+
+		/* Level n reaches tmrWHEEL_SLOTS to the power of n + 1 ticks past the
+		wheel time.  Use the lowest level that reaches the expiry time. */
+		while( ( uxLevel < ( tmrWHEEL_LEVELS - 1U ) ) && ( ( xTicksToExpiry >> ( ( uxLevel + 1U ) * tmrWHEEL_SLOT_BITS ) ) != ( TickType_t ) 0U ) )
+		{
+			uxLevel++;
+		}
+
+		/* The slots are indexed by the expiry time itself, not by the offset
+		from the wheel time, so a timer never has to move as the wheel time
+		advances - only when its slot is cascaded.  The timers in a slot are
+		not kept in any order, so inserting is constant time. */
+		uxSlot = ( UBaseType_t ) ( ( xExpiryTime >> ( uxLevel * tmrWHEEL_SLOT_BITS ) ) & tmrWHEEL_SLOT_MASK );
+
+		vListInsertEnd( &( xTimerWheel[ uxLevel ][ uxSlot ] ), &( pxTimer->xTimerListItem ) );
+		ulWheelOccupied[ uxLevel ] |= ( 1UL << uxSlot );
+	}
+
+#endif /* configUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	static void prvRemoveTimerFromWheel( Timer_t * const pxTimer )
+	{
+	List_t * const pxSlot = ( List_t * ) listLIST_ITEM_CONTAINER( &( pxTimer->xTimerListItem ) );
+	UBaseType_t uxSlotNumber;
+
+		if( uxListRemove( &( pxTimer->xTimerListItem ) ) == ( UBaseType_t ) 0 )
+		{
+			/* That was the last timer in the slot.  The level and slot numbers
+			follow from the position of the slot within the wheel. */
+			uxSlotNumber = ( UBaseType_t ) ( pxSlot - &( xTimerWheel[ 0 ][ 0 ] ) );
+			ulWheelOccupied[ uxSlotNumber / tmrWHEEL_SLOTS ] &= ~( 1UL << ( uxSlotNumber % tmrWHEEL_SLOTS ) );
+		}
 		else
 		{
 			mtCOVERAGE_TEST_MARKER();
 		}
 	}
 
-	pxTemp = pxCurrentTimerList;
-	pxCurrentTimerList = pxOverflowTimerList;
-	pxOverflowTimerList = pxTemp;
-}
+#endif /* configUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	static void prvProcessWheelTime( void )
+	{
+	UBaseType_t uxLevel, uxShift;
+	List_t *pxSlot;
+	Timer_t *pxTimer;
+
+		/* If the wheel time is the start of a level 1 slot then move the
+		timers in that slot down a level.  If it is also the start of a level 2
+		slot then do the same for that slot, and so on up the levels.  A timer
+		in a slot that has just started expires within the span of the slot,
+		so always lands on a lower level. */
+		for( uxLevel = 1U; uxLevel < tmrWHEEL_LEVELS; uxLevel++ )
+		{
+			uxShift = uxLevel * tmrWHEEL_SLOT_BITS;
+
+			if( ( ( xWheelTime >> ( uxShift - tmrWHEEL_SLOT_BITS ) ) & tmrWHEEL_SLOT_MASK ) != ( TickType_t ) 0U )
+			{
+				break;
+			}
+
+			pxSlot = &( xTimerWheel[ uxLevel ][ ( xWheelTime >> uxShift ) & tmrWHEEL_SLOT_MASK ] );
+
+			while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+			{
+				pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlot );
+				prvRemoveTimerFromWheel( pxTimer );
+				prvInsertTimerInWheel( pxTimer );
+			}
+		}
+
+		/* Every timer in the level 0 slot of the wheel time expires now. */
+		pxSlot = &( xTimerWheel[ 0 ][ xWheelTime & tmrWHEEL_SLOT_MASK ] );
+
+		while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+		{
+			pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlot );
+			prvRemoveTimerFromWheel( pxTimer );
+			traceTIMER_EXPIRED( pxTimer );
+
+			/* If the timer is an auto reload timer then calculate the next
+			expiry time and re-insert the timer in the wheel.  The period is
+			not zero, so the timer goes into a later slot.  If the reload time
+			has also passed already the timer is processed again before
+			prvProcessExpiredTimer() returns, so there is no need to send a
+			command to restart it. */
+			if( pxTimer->uxAutoReload == ( UBaseType_t ) pdTRUE )
+			{
+				listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), ( xWheelTime + pxTimer->xTimerPeriodInTicks ) );
+				prvInsertTimerInWheel( pxTimer );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* Call the timer callback. */
+			pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+		}
+	}
+
+#endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
 static void prvCheckForValidListAndQueue( void )
 {
+	#if ( ( configQUEUE_REGISTRY_SIZE > 0 ) || ( configUSE_OBJECT_REGISTRY == 1 ) )
+		BaseType_t xQueueCreated = pdFALSE;
+	#endif
+
 	/* Check that the list from which active timers are referenced, and the
 	queue used to communicate with the timer service, have been
 	initialised. */
@@ -901,10 +1352,30 @@ static void prvCheckForValidListAndQueue( void )
 	{
 		if( xTimerQueue == NULL )
 		{
-			vListInitialise( &xActiveTimerList1 );
-			vListInitialise( &xActiveTimerList2 );
-			pxCurrentTimerList = &xActiveTimerList1;
-			pxOverflowTimerList = &xActiveTimerList2;
+			#if( configUSE_TIMER_WHEEL == 1 )
+			{
+				UBaseType_t uxLevel, uxSlot;
+
+				for( uxLevel = 0U; uxLevel < tmrWHEEL_LEVELS; uxLevel++ )
+				{
+					for( uxSlot = 0U; uxSlot < tmrWHEEL_SLOTS; uxSlot++ )
+					{
+						vListInitialise( &( xTimerWheel[ uxLevel ][ uxSlot ] ) );
+					}
+
+					ulWheelOccupied[ uxLevel ] = 0UL;
+				}
+
+				xWheelTime = xTaskGetTickCount();
+			}
+			#else
+			{
+				vListInitialise( &xActiveTimerList1 );
+				vListInitialise( &xActiveTimerList2 );
+				pxCurrentTimerList = &xActiveTimerList1;
+				pxOverflowTimerList = &xActiveTimerList2;
+			}
+			#endif /* configUSE_TIMER_WHEEL */
 
 			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
 			{
@@ -921,16 +1392,10 @@ static void prvCheckForValidListAndQueue( void )
 			}
 			#endif
 
-			#if ( configQUEUE_REGISTRY_SIZE > 0 )
+			#if ( ( configQUEUE_REGISTRY_SIZE > 0 ) || ( configUSE_OBJECT_REGISTRY == 1 ) )
 			{
-				if( xTimerQueue != NULL )
-				{
-					vQueueAddToRegistry( xTimerQueue, "TmrQ" );
-				}
-				else
-				{
-					mtCOVERAGE_TEST_MARKER();
-				}
+				/* Registered below, once out of the critical section. */
+				xQueueCreated = pdTRUE;
 			}
 			#endif /* configQUEUE_REGISTRY_SIZE */
 		}
@@ -940,6 +1405,22 @@ static void prvCheckForValidListAndQueue( void )
 		}
 	}
 	taskEXIT_CRITICAL();
+
+	/* The object registry suspends the scheduler, which must not be done from
+	within a critical section.  Only the call that created the queue gets
+	here with xQueueCreated set, so the queue is registered once. */
+	#if ( ( configQUEUE_REGISTRY_SIZE > 0 ) || ( configUSE_OBJECT_REGISTRY == 1 ) )
+	{
+		if( ( xQueueCreated != pdFALSE ) && ( xTimerQueue != NULL ) )
+		{
+			vQueueAddToRegistry( xTimerQueue, "TmrQ" );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configQUEUE_REGISTRY_SIZE */
 }
 /*-----------------------------------------------------------*/
 
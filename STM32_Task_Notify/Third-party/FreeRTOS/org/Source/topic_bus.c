@@ -0,0 +1,575 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "block_pool.h"
+#include "topic_bus.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* This entire source file will be skipped if the application is not configured
+to include topic bus functionality. */
+#if( configUSE_TOPIC_BUS == 1 )
+
+#if( configUSE_BLOCK_POOLS != 1 )
+	#error configUSE_BLOCK_POOLS must be set to 1 to build topic_bus.c
+#endif
+
+/* Bits stored in the ucFlags field of the topic. */
+#define topicFLAGS_IS_STATICALLY_ALLOCATED ( ( uint8_t ) 1 ) /* Set if the topic was created using statically allocated memory. */
+
+/*-----------------------------------------------------------*/
+
+/* Structure that holds the state of a topic.  The message pool is followed by
+the table of subscribed inboxes, in which unused entries are NULL. */
+typedef struct xTOPIC /*lint !e9058 Style convention uses tag. */
+{
+	BlockPoolHandle_t xPool;				/* The pool the messages are taken from. */
+	QueueHandle_t *pxInboxes;				/* Points to the table of subscribed inboxes. */
+	size_t xMessageSize;					/* The size of each message in bytes, not including its header. */
+	UBaseType_t uxMaxSubscribers;			/* The number of entries in the table of inboxes. */
+	volatile uint32_t ulDroppedCount;		/* The number of deliveries missed because an inbox was full. */
+	uint8_t ucFlags;
+
+	#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+		StaticBlockPool_t xPoolBuffer;		/* Holds the pool's data structure when the topic is created statically. */
+	#endif
+} Topic_t;
+
+/* Structure placed in front of every message.  A message is referenced by its
+publisher from the time it is allocated until the publish call returns, and
+by every inbox it was delivered to until the subscriber releases it. */
+typedef struct xTOPIC_MESSAGE_HEADER /*lint !e9058 Style convention uses tag. */
+{
+	volatile uint32_t ulReferenceCount;		/* The number of holders that have still to release the message. */
+	Topic_t *pxTopic;						/* The topic whose pool the message came from. */
+} TopicMessageHeader_t;
+
+/* Converts between a pointer to a message and a pointer to its header. */
+#define topicHEADER_FROM_MESSAGE( pvMessage ) ( ( TopicMessageHeader_t * ) ( ( ( uint8_t * ) ( pvMessage ) ) - topicMESSAGE_HEADER_SIZE ) ) /*lint !e9087 !e826 The header is in front of the message in the same block. */
+#define topicMESSAGE_FROM_HEADER( pxHeader ) ( ( void * ) ( ( ( uint8_t * ) ( pxHeader ) ) + topicMESSAGE_HEADER_SIZE ) )
+
+/*
+ * Called by both xTopicCreate() and xTopicCreateStatic() to initialise the
+ * topic structure, once the pool has been created.
+ */
+static void prvInitialiseNewTopic( Topic_t * const pxTopic,
+								   BlockPoolHandle_t xPool,
+								   QueueHandle_t * const pxInboxes,
+								   size_t xMessageSize,
+								   UBaseType_t uxMaxSubscribers ) PRIVILEGED_FUNCTION;
+
+/*
+ * Subtracts ulRemove from the reference count of a message in a single atomic
+ * update, and returns the new count.  Uses portCOMPARE_AND_SWAP_32() so
+ * references can be dropped from any context without a critical section.
+ */
+static uint32_t prvReleaseReferences( TopicMessageHeader_t * const pxHeader, uint32_t ulRemove ) PRIVILEGED_FUNCTION;
+
+/*
+ * Common part of uxTopicPublish() and uxTopicPublishFromISR().  Takes a
+ * reference for every possible subscriber up front, so subscribers that
+ * receive the message can release it while it is still being delivered to
+ * the others, then sends it to every inbox and drops the references that were
+ * not used along with the publisher's own.
+ */
+static UBaseType_t prvPublish( Topic_t * const pxTopic, void *pvMessage, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	TopicHandle_t xTopicCreate( size_t xMessageSize, UBaseType_t uxMessageCount, UBaseType_t uxMaxSubscribers )
+	{
+	Topic_t *pxTopic;
+	BlockPoolHandle_t xPool;
+
+		configASSERT( xMessageSize > ( size_t ) 0 );
+		configASSERT( uxMessageCount > ( UBaseType_t ) 0 );
+		configASSERT( uxMaxSubscribers > ( UBaseType_t ) 0 );
+
+		/* The table of inboxes follows the topic structure, which contains
+		pointers so leaves the table correctly aligned. */
+		pxTopic = ( Topic_t * ) pvPortMalloc( sizeof( Topic_t ) + ( ( size_t ) uxMaxSubscribers * sizeof( QueueHandle_t ) ) ); /*lint !e9079 malloc() only returns void*. */
+
+		if( pxTopic != NULL )
+		{
+			xPool = xBlockPoolCreate( topicBLOCK_SIZE( xMessageSize ), uxMessageCount );
+
+			if( xPool != NULL )
+			{
+				prvInitialiseNewTopic( pxTopic, xPool, ( QueueHandle_t * ) &( pxTopic[ 1 ] ), xMessageSize, uxMaxSubscribers );
+				traceTOPIC_CREATE( pxTopic );
+			}
+			else
+			{
+				vPortFree( pxTopic );
+				pxTopic = NULL;
+				traceTOPIC_CREATE_FAILED();
+			}
+		}
+		else
+		{
+			traceTOPIC_CREATE_FAILED();
+		}
+
+		return ( TopicHandle_t ) pxTopic;
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+	TopicHandle_t xTopicCreateStatic( size_t xMessageSize,
+									  UBaseType_t uxMessageCount,
+									  UBaseType_t uxMaxSubscribers,
+									  uint8_t * const pucTopicStorageArea,
+									  StaticTopic_t * const pxStaticTopic )
+	{
+	Topic_t * const pxTopic = ( Topic_t * ) pxStaticTopic; /*lint !e740 !e9087 Safe cast as StaticTopic_t is opaque Topic_t. */
+	BlockPoolHandle_t xPool;
+	TopicHandle_t xReturn = NULL;
+	size_t xPoolSize;
+
+		configASSERT( pucTopicStorageArea );
+		configASSERT( pxStaticTopic );
+		configASSERT( xMessageSize > ( size_t ) 0 );
+		configASSERT( uxMessageCount > ( UBaseType_t ) 0 );
+		configASSERT( uxMaxSubscribers > ( UBaseType_t ) 0 );
+
+		#if( configASSERT_DEFINED == 1 )
+		{
+			/* Sanity check that the size of the structure used to declare a
+			variable of type StaticTopic_t equals the size of the real topic
+			structure. */
+			volatile size_t xSize = sizeof( StaticTopic_t );
+			configASSERT( xSize == sizeof( Topic_t ) );
+		}
+		#endif /* configASSERT_DEFINED */
+
+		if( ( pucTopicStorageArea != NULL ) && ( pxStaticTopic != NULL ) )
+		{
+			/* The pool comes first in the storage area, and the table of
+			inboxes follows it.  The block size is a multiple of
+			portBYTE_ALIGNMENT so the table is aligned too. */
+			xPoolSize = topicBLOCK_SIZE( xMessageSize ) * ( size_t ) uxMessageCount;
+			xPool = xBlockPoolCreateStatic( topicBLOCK_SIZE( xMessageSize ), uxMessageCount, pucTopicStorageArea, &( pxTopic->xPoolBuffer ) );
+
+			if( xPool != NULL )
+			{
+				prvInitialiseNewTopic( pxTopic, xPool, ( QueueHandle_t * ) &( pucTopicStorageArea[ xPoolSize ] ), xMessageSize, uxMaxSubscribers ); /*lint !e9087 !e826 The table is aligned as described above. */
+
+				/* Remember this was statically allocated in case it is ever
+				deleted again. */
+				pxTopic->ucFlags |= topicFLAGS_IS_STATICALLY_ALLOCATED;
+
+				traceTOPIC_CREATE( pxTopic );
+				xReturn = ( TopicHandle_t ) pxStaticTopic;
+			}
+			else
+			{
+				traceTOPIC_CREATE_FAILED();
+			}
+		}
+		else
+		{
+			traceTOPIC_CREATE_FAILED();
+		}
+
+		return xReturn;
+	}
+
+#endif /* ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+/*-----------------------------------------------------------*/
+
+void vTopicDelete( TopicHandle_t xTopic )
+{
+Topic_t * const pxTopic = ( Topic_t * ) xTopic; /*lint !e9087 !e9079 Safe cast as TopicHandle_t is opaque Topic_t. */
+
+	configASSERT( pxTopic );
+
+	traceTOPIC_DELETE( pxTopic );
+
+	/* The pool asserts that every message has been released. */
+	vBlockPoolDelete( pxTopic->xPool );
+
+	if( ( pxTopic->ucFlags & topicFLAGS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) pdFALSE )
+	{
+		#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+		{
+			/* The structure and the table of inboxes were allocated using a
+			single call to pvPortMalloc(), hence only one call to vPortFree()
+			is required. */
+			vPortFree( ( void * ) pxTopic );
+		}
+		#else
+		{
+			/* Should not be possible to get here, ucFlags must be corrupt.
+			Force an assert. */
+			configASSERT( xTopic == ( TopicHandle_t ) ~0 );
+		}
+		#endif
+	}
+	else
+	{
+		/* The structure and storage were not allocated dynamically and cannot
+		be freed - just scrub the structure so future use will assert. */
+		memset( pxTopic, 0x00, sizeof( Topic_t ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTopicSubscribe( TopicHandle_t xTopic, QueueHandle_t xInbox )
+{
+Topic_t * const pxTopic = ( Topic_t * ) xTopic; /*lint !e9087 !e9079 Safe cast as TopicHandle_t is opaque Topic_t. */
+UBaseType_t ux;
+BaseType_t xReturn = pdFAIL;
+
+	configASSERT( pxTopic );
+	configASSERT( xInbox );
+
+	taskENTER_CRITICAL();
+	{
+		for( ux = ( UBaseType_t ) 0; ux < pxTopic->uxMaxSubscribers; ux++ )
+		{
+			/* Subscribing the same inbox twice would deliver every message to
+			it twice. */
+			configASSERT( pxTopic->pxInboxes[ ux ] != xInbox );
+
+			if( ( xReturn == pdFAIL ) && ( pxTopic->pxInboxes[ ux ] == NULL ) )
+			{
+				pxTopic->pxInboxes[ ux ] = xInbox;
+				xReturn = pdPASS;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTopicUnsubscribe( TopicHandle_t xTopic, QueueHandle_t xInbox )
+{
+Topic_t * const pxTopic = ( Topic_t * ) xTopic; /*lint !e9087 !e9079 Safe cast as TopicHandle_t is opaque Topic_t. */
+UBaseType_t ux;
+BaseType_t xReturn = pdFAIL;
+
+	configASSERT( pxTopic );
+	configASSERT( xInbox );
+
+	taskENTER_CRITICAL();
+	{
+		for( ux = ( UBaseType_t ) 0; ux < pxTopic->uxMaxSubscribers; ux++ )
+		{
+			if( pxTopic->pxInboxes[ ux ] == xInbox )
+			{
+				pxTopic->pxInboxes[ ux ] = NULL;
+				xReturn = pdPASS;
+				break;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void *pvTopicAllocMessage( TopicHandle_t xTopic )
+{
+Topic_t * const pxTopic = ( Topic_t * ) xTopic; /*lint !e9087 !e9079 Safe cast as TopicHandle_t is opaque Topic_t. */
+TopicMessageHeader_t *pxHeader;
+void *pvReturn = NULL;
+
+	configASSERT( pxTopic );
+
+	pxHeader = ( TopicMessageHeader_t * ) pvBlockPoolAlloc( pxTopic->xPool ); /*lint !e9079 !e9087 Blocks are aligned for any type. */
+
+	if( pxHeader != NULL )
+	{
+		/* The only reference is the publisher's.  No other context can see
+		the message yet, so a plain write is safe. */
+		pxHeader->ulReferenceCount = 1UL;
+		pxHeader->pxTopic = pxTopic;
+		pvReturn = topicMESSAGE_FROM_HEADER( pxHeader );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxTopicPublish( TopicHandle_t xTopic, void *pvMessage )
+{
+Topic_t * const pxTopic = ( Topic_t * ) xTopic; /*lint !e9087 !e9079 Safe cast as TopicHandle_t is opaque Topic_t. */
+UBaseType_t uxDelivered;
+
+	configASSERT( pxTopic );
+	configASSERT( pvMessage );
+
+	/* Stop subscribers of a higher priority running, and so releasing the
+	message, until it has been delivered to every inbox.  This is not needed
+	for correctness, but means each subscriber is only switched to once.  A
+	NULL pointer for the woken flag tells prvPublish() to use the task level
+	queue API. */
+	vTaskSuspendAll();
+	{
+		uxDelivered = prvPublish( pxTopic, pvMessage, NULL );
+		traceTOPIC_PUBLISH( pxTopic, uxDelivered );
+	}
+	( void ) xTaskResumeAll();
+
+	return uxDelivered;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxTopicPublishFromISR( TopicHandle_t xTopic, void *pvMessage, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+Topic_t * const pxTopic = ( Topic_t * ) xTopic; /*lint !e9087 !e9079 Safe cast as TopicHandle_t is opaque Topic_t. */
+UBaseType_t uxDelivered;
+
+	configASSERT( pxTopic );
+	configASSERT( pvMessage );
+	configASSERT( pxHigherPriorityTaskWoken );
+
+	uxDelivered = prvPublish( pxTopic, pvMessage, pxHigherPriorityTaskWoken );
+	traceTOPIC_PUBLISH_FROM_ISR( pxTopic, uxDelivered );
+
+	return uxDelivered;
+}
+/*-----------------------------------------------------------*/
+
+void *pvTopicReceive( QueueHandle_t xInbox, TickType_t xTicksToWait )
+{
+void *pvMessage = NULL;
+
+	configASSERT( xInbox );
+
+	if( xQueueReceive( xInbox, &pvMessage, xTicksToWait ) != pdPASS )
+	{
+		pvMessage = NULL;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return pvMessage;
+}
+/*-----------------------------------------------------------*/
+
+void vTopicReleaseMessage( const void *pvMessage )
+{
+TopicMessageHeader_t *pxHeader;
+
+	configASSERT( pvMessage );
+
+	pxHeader = topicHEADER_FROM_MESSAGE( pvMessage );
+
+	/* A count that is already zero means the message was released more times
+	than it was received. */
+	configASSERT( pxHeader->ulReferenceCount != 0UL );
+
+	if( prvReleaseReferences( pxHeader, 1UL ) == 0UL )
+	{
+		vBlockPoolFree( pxHeader->pxTopic->xPool, ( void * ) pxHeader );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxTopicGetFreeMessages( TopicHandle_t xTopic )
+{
+Topic_t * const pxTopic = ( Topic_t * ) xTopic; /*lint !e9087 !e9079 Safe cast as TopicHandle_t is opaque Topic_t. */
+
+	configASSERT( pxTopic );
+
+	return uxBlockPoolGetFreeBlocks( pxTopic->xPool );
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulTopicGetDroppedCount( TopicHandle_t xTopic )
+{
+Topic_t * const pxTopic = ( Topic_t * ) xTopic; /*lint !e9087 !e9079 Safe cast as TopicHandle_t is opaque Topic_t. */
+
+	configASSERT( pxTopic );
+
+	return pxTopic->ulDroppedCount;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvPublish( Topic_t * const pxTopic, void *pvMessage, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+TopicMessageHeader_t * const pxHeader = topicHEADER_FROM_MESSAGE( pvMessage );
+QueueHandle_t xInbox;
+UBaseType_t ux, uxDelivered = ( UBaseType_t ) 0;
+uint32_t ulDropped = 0UL, ulCount;
+BaseType_t xSent;
+
+	/* The message must come from this topic, and must not have been
+	published already. */
+	configASSERT( pxHeader->pxTopic == pxTopic );
+	configASSERT( pxHeader->ulReferenceCount == 1UL );
+
+	/* No other context can see the message until it is in an inbox, so the
+	references can be taken with a plain write. */
+	pxHeader->ulReferenceCount = ( uint32_t ) pxTopic->uxMaxSubscribers + 1UL;
+
+	for( ux = ( UBaseType_t ) 0; ux < pxTopic->uxMaxSubscribers; ux++ )
+	{
+		/* An entry can be cleared by xTopicUnsubscribe() at any time, so read
+		it once. */
+		xInbox = pxTopic->pxInboxes[ ux ];
+
+		if( xInbox != NULL )
+		{
+			if( pxHigherPriorityTaskWoken == NULL )
+			{
+				xSent = xQueueSendToBack( xInbox, &pvMessage, ( TickType_t ) 0 );
+			}
+			else
+			{
+				xSent = xQueueSendToBackFromISR( xInbox, &pvMessage, pxHigherPriorityTaskWoken );
+			}
+
+			if( xSent == pdPASS )
+			{
+				uxDelivered++;
+			}
+			else
+			{
+				ulDropped++;
+				traceTOPIC_INBOX_FULL( pxTopic, xInbox );
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	if( ulDropped != 0UL )
+	{
+		/* Several interrupts can publish to the same topic, so the count is
+		updated with a compare and swap rather than a plain increment. */
+		do
+		{
+			ulCount = pxTopic->ulDroppedCount;
+		} while( portCOMPARE_AND_SWAP_32( &( pxTopic->ulDroppedCount ), ulCount + ulDropped, ulCount ) == pdFALSE );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	/* Drop the references taken for inboxes that did not receive the message,
+	and the publisher's own.  If nobody received it, it goes straight back to
+	the pool. */
+	if( prvReleaseReferences( pxHeader, ( uint32_t ) ( pxTopic->uxMaxSubscribers - uxDelivered ) + 1UL ) == 0UL )
+	{
+		vBlockPoolFree( pxTopic->xPool, ( void * ) pxHeader );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return uxDelivered;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvReleaseReferences( TopicMessageHeader_t * const pxHeader, uint32_t ulRemove )
+{
+uint32_t ulCount;
+
+	do
+	{
+		ulCount = pxHeader->ulReferenceCount;
+	} while( portCOMPARE_AND_SWAP_32( &( pxHeader->ulReferenceCount ), ulCount - ulRemove, ulCount ) == pdFALSE );
+
+	return ulCount - ulRemove;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseNewTopic( Topic_t * const pxTopic,
+								   BlockPoolHandle_t xPool,
+								   QueueHandle_t * const pxInboxes,
+								   size_t xMessageSize,
+								   UBaseType_t uxMaxSubscribers )
+{
+UBaseType_t ux;
+
+	/* topicMESSAGE_HEADER_SIZE must leave room for the header. */
+	configASSERT( sizeof( TopicMessageHeader_t ) <= topicMESSAGE_HEADER_SIZE );
+
+	/* The static pool structure, if any, has already been initialised by the
+	pool, so only the remaining members are set. */
+	pxTopic->xPool = xPool;
+	pxTopic->pxInboxes = pxInboxes;
+	pxTopic->xMessageSize = xMessageSize;
+	pxTopic->uxMaxSubscribers = uxMaxSubscribers;
+	pxTopic->ulDroppedCount = 0UL;
+	pxTopic->ucFlags = ( uint8_t ) 0;
+
+	for( ux = ( UBaseType_t ) 0; ux < uxMaxSubscribers; ux++ )
+	{
+		pxInboxes[ ux ] = NULL;
+	}
+}
+
+/* This entire source file will be skipped if the application is not configured
+to include topic bus functionality. */
+#endif /* configUSE_TOPIC_BUS == 1 */
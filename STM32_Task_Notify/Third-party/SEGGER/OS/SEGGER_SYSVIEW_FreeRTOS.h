@@ -82,6 +82,14 @@ Notes:
 
 #define SYSVIEW_FREERTOS_MAX_NOF_TASKS  8
 
+//
+// Heap events record the allocation site as an offset from the start of
+// code memory, so it fits in fewer bytes of the trace stream.
+//
+#ifndef SYSVIEW_FREERTOS_CODE_BASE
+  #define SYSVIEW_FREERTOS_CODE_BASE    (0x08000000u)
+#endif
+
 /*********************************************************************
 *
 *       Defines, fixed
@@ -201,6 +209,24 @@ Notes:
 #define apiID_XSTREAMBUFFERSENDFROMISR            (109u)
 #define apiID_XSTREAMBUFFERRECEIVE                (110u)
 #define apiID_XSTREAMBUFFERRECEIVEFROMISR         (111u)
+#define apiID_PVPORTMALLOC                        (112u)
+#define apiID_PVPORTMALLOCFAILED                  (113u)
+#define apiID_VPORTFREE                           (114u)
+#define apiID_HEAPINIT                            (115u)
+#define apiID_PVQUEUELOANWRITESLOT                (116u)
+#define apiID_VQUEUECOMMITWRITESLOT               (117u)
+#define apiID_PVQUEUELOANREADSLOT                 (118u)
+#define apiID_VQUEUERELEASEREADSLOT               (119u)
+#define apiID_UXQUEUESENDMULTIPLE                 (120u)
+#define apiID_UXQUEUESENDMULTIPLEFROMISR          (121u)
+#define apiID_UXQUEUERECEIVEMULTIPLE              (122u)
+#define apiID_UXQUEUERECEIVEMULTIPLEFROMISR       (123u)
+#define apiID_XEVENTGROUP64CREATE                 (124u)
+#define apiID_XEVENTGROUP64WAITBITS               (125u)
+#define apiID_XEVENTGROUP64CLEARBITS              (126u)
+#define apiID_XEVENTGROUP64SETBITS                (127u)
+#define apiID_XEVENTGROUP64SYNC                   (128u)
+#define apiID_VEVENTGROUP64DELETE                 (129u)
 
 #define traceTASK_NOTIFY_TAKE()                                                 SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_ULTASKNOTIFYTAKE, xClearCountOnExit, xTicksToWait)
 #define traceTASK_DELAY()                                                       SEGGER_SYSVIEW_RecordU32  (apiID_OFFSET + apiID_VTASKDELAY, xTicksToDelay)
@@ -235,6 +261,16 @@ Notes:
 #define traceQUEUE_SEND_FAILED( pxQueue )                                       SEGGER_SYSVIEW_RecordU32x4(apiID_OFFSET + apiID_XQUEUEGENERICSEND, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), (U32)pvItemToQueue, xTicksToWait, xCopyPosition)
 #define traceQUEUE_SEND_FROM_ISR( pxQueue )                                     SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_XQUEUEGENERICSENDFROMISR, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), (U32)pxHigherPriorityTaskWoken)
 #define traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue )                              SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_XQUEUEGENERICSENDFROMISR, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), (U32)pxHigherPriorityTaskWoken)
+#define traceQUEUE_LOAN_WRITE_SLOT( pxQueue, pvSlot, xTicksToWait )         SEGGER_SYSVIEW_RecordU32x3(apiID_OFFSET + apiID_PVQUEUELOANWRITESLOT, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)pvSlot), xTicksToWait)
+#define traceQUEUE_LOAN_WRITE_SLOT_FAILED( pxQueue, xTicksToWait )          SEGGER_SYSVIEW_RecordU32x3(apiID_OFFSET + apiID_PVQUEUELOANWRITESLOT, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)0), xTicksToWait)
+#define traceQUEUE_COMMIT_WRITE_SLOT( pxQueue, pvSlot )                     SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_VQUEUECOMMITWRITESLOT, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)pvSlot))
+#define traceQUEUE_LOAN_READ_SLOT( pxQueue, pvSlot, xTicksToWait )          SEGGER_SYSVIEW_RecordU32x3(apiID_OFFSET + apiID_PVQUEUELOANREADSLOT, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)pvSlot), xTicksToWait)
+#define traceQUEUE_LOAN_READ_SLOT_FAILED( pxQueue, xTicksToWait )           SEGGER_SYSVIEW_RecordU32x3(apiID_OFFSET + apiID_PVQUEUELOANREADSLOT, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)0), xTicksToWait)
+#define traceQUEUE_RELEASE_READ_SLOT( pxQueue, pvSlot )                     SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_VQUEUERELEASEREADSLOT, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)pvSlot))
+#define traceQUEUE_SEND_MULTIPLE( pxQueue, uxItemCount )                    SEGGER_SYSVIEW_RecordU32x3(apiID_OFFSET + apiID_UXQUEUESENDMULTIPLE, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), (U32)(uxItemCount), xTicksToWait)
+#define traceQUEUE_SEND_MULTIPLE_FROM_ISR( pxQueue, uxItemCount )           SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_UXQUEUESENDMULTIPLEFROMISR, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), (U32)(uxItemCount))
+#define traceQUEUE_RECEIVE_MULTIPLE( pxQueue, uxItemCount )                 SEGGER_SYSVIEW_RecordU32x3(apiID_OFFSET + apiID_UXQUEUERECEIVEMULTIPLE, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), (U32)(uxItemCount), xTicksToWait)
+#define traceQUEUE_RECEIVE_MULTIPLE_FROM_ISR( pxQueue, uxItemCount )        SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_UXQUEUERECEIVEMULTIPLEFROMISR, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), (U32)(uxItemCount))
 #define traceSTREAM_BUFFER_CREATE( pxStreamBuffer, xIsMessageBuffer )           SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_XSTREAMBUFFERCREATE, (U32)xIsMessageBuffer, (U32)pxStreamBuffer)
 #define traceSTREAM_BUFFER_CREATE_FAILED( xIsMessageBuffer )                    SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_XSTREAMBUFFERCREATE, (U32)xIsMessageBuffer, 0u)
 #define traceSTREAM_BUFFER_DELETE( xStreamBuffer )                              SEGGER_SYSVIEW_RecordU32  (apiID_OFFSET + apiID_VSTREAMBUFFERDELETE, (U32)xStreamBuffer)
@@ -246,6 +282,37 @@ Notes:
 #define traceSTREAM_BUFFER_RECEIVE_FAILED( xStreamBuffer )                      SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_XSTREAMBUFFERRECEIVE, (U32)xStreamBuffer, 0u)
 #define traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength )   SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_XSTREAMBUFFERRECEIVEFROMISR, (U32)xStreamBuffer, (U32)xReceivedLength)
 
+//
+// Heap events. Addresses are shrunk like all other Ids, block sizes are sent in
+// units of portBYTE_ALIGNMENT and the allocation site (the caller of
+// pvPortMalloc) as an offset from SYSVIEW_FREERTOS_CODE_BASE, so a typical
+// event needs 2-3 bytes per parameter. Tools/heap_timeline.py decodes them.
+//
+#define SYSVIEW_HEAP_SITE()                                                     ((((U32)__builtin_return_address(0)) & ~1u) - SYSVIEW_FREERTOS_CODE_BASE)
+#define traceHEAP_INIT( pucHeapStart, xHeapSize )                               SEGGER_SYSVIEW_RecordU32x3(apiID_OFFSET + apiID_HEAPINIT, SEGGER_SYSVIEW_ShrinkId((U32)pucHeapStart), (U32)(xHeapSize), portBYTE_ALIGNMENT)
+#define traceMALLOC( pvAddress, uiSize )            {                                                                                                                                                     \
+                                                      if ((pvAddress) != NULL) {                                                                                                                          \
+                                                        SEGGER_SYSVIEW_RecordU32x3(apiID_OFFSET + apiID_PVPORTMALLOC, SEGGER_SYSVIEW_ShrinkId((U32)(pvAddress)), (U32)(uiSize) / portBYTE_ALIGNMENT, SYSVIEW_HEAP_SITE()); \
+                                                      } else {                                                                                                                                            \
+                                                        SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_PVPORTMALLOCFAILED, (U32)(uiSize), SYSVIEW_HEAP_SITE());                                         \
+                                                      }                                                                                                                                                   \
+                                                    }
+#define traceFREE( pvAddress, uiSize )                                          SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_VPORTFREE, SEGGER_SYSVIEW_ShrinkId((U32)(pvAddress)), (U32)(uiSize) / portBYTE_ALIGNMENT)
+
+//
+// 64-bit event groups. Every 64-bit value is sent as two parameters, the low
+// word then the high word. Parameters are packed 7 bits to a byte, so the
+// high word of a group that only uses its low 32 bits costs a single byte.
+//
+#define SYSVIEW_BITS64_LO( x )                                                  ((U32)(x))
+#define SYSVIEW_BITS64_HI( x )                                                  ((U32)((x) >> 32))
+#define traceEVENT_GROUP64_CREATE( xEventGroup )                                SEGGER_SYSVIEW_RecordU32  (apiID_OFFSET + apiID_XEVENTGROUP64CREATE, SEGGER_SYSVIEW_ShrinkId((U32)xEventGroup))
+#define traceEVENT_GROUP64_WAIT_BITS_BLOCK( xEventGroup, uxBitsToWaitFor )      SEGGER_SYSVIEW_RecordU32x4(apiID_OFFSET + apiID_XEVENTGROUP64WAITBITS, SEGGER_SYSVIEW_ShrinkId((U32)xEventGroup), SYSVIEW_BITS64_LO(uxBitsToWaitFor), SYSVIEW_BITS64_HI(uxBitsToWaitFor), xTicksToWait)
+#define traceEVENT_GROUP64_CLEAR_BITS( xEventGroup, uxBitsToClear )             SEGGER_SYSVIEW_RecordU32x3(apiID_OFFSET + apiID_XEVENTGROUP64CLEARBITS, SEGGER_SYSVIEW_ShrinkId((U32)xEventGroup), SYSVIEW_BITS64_LO(uxBitsToClear), SYSVIEW_BITS64_HI(uxBitsToClear))
+#define traceEVENT_GROUP64_SET_BITS( xEventGroup, uxBitsToSet )                 SEGGER_SYSVIEW_RecordU32x3(apiID_OFFSET + apiID_XEVENTGROUP64SETBITS, SEGGER_SYSVIEW_ShrinkId((U32)xEventGroup), SYSVIEW_BITS64_LO(uxBitsToSet), SYSVIEW_BITS64_HI(uxBitsToSet))
+#define traceEVENT_GROUP64_SYNC_BLOCK( xEventGroup, uxBitsToSet, uxBitsToWaitFor ) SEGGER_SYSVIEW_RecordU32x5(apiID_OFFSET + apiID_XEVENTGROUP64SYNC, SEGGER_SYSVIEW_ShrinkId((U32)xEventGroup), SYSVIEW_BITS64_LO(uxBitsToSet), SYSVIEW_BITS64_HI(uxBitsToSet), SYSVIEW_BITS64_LO(uxBitsToWaitFor), SYSVIEW_BITS64_HI(uxBitsToWaitFor))
+#define traceEVENT_GROUP64_DELETE( xEventGroup )                                SEGGER_SYSVIEW_RecordU32  (apiID_OFFSET + apiID_VEVENTGROUP64DELETE, SEGGER_SYSVIEW_ShrinkId((U32)xEventGroup))
+
 
 #define traceTASK_DELETE( pxTCB )                   {                                                                                                   \
                                                       SEGGER_SYSVIEW_RecordU32(apiID_OFFSET + apiID_VTASKDELETE, SEGGER_SYSVIEW_ShrinkId((U32)pxTCB));  \
@@ -0,0 +1,395 @@
+#!/usr/bin/env python3
+"""
+Heap timeline for SystemView recordings.
+
+Rebuilds the heap_4 layout over time from the pvPortMalloc()/vPortFree()
+events that SEGGER_SYSVIEW_FreeRTOS.h records (traceHEAP_INIT, traceMALLOC,
+traceFREE), then reports:
+
+  * heap occupancy and largest free block over time (text chart, optional
+    CSV and PNG),
+  * the allocation sites that pin the heap into fragments - live blocks with
+    free space on both sides, ranked by how long they did so and by how big
+    the free block would be if they were released.
+
+Usage:
+  heap_timeline.py recording.SVDat [--elf Debug/STM32_Task_Notify.elf]
+                   [--csv timeline.csv] [--plot timeline.png]
+
+The input can be a SystemView .SVDat file or a raw RTT capture of the
+SystemView channel.
+"""
+
+import argparse
+import bisect
+import shutil
+import subprocess
+import sys
+
+# Must match apiID_OFFSET and the apiID_* values in SEGGER_SYSVIEW_FreeRTOS.h.
+API_ID_OFFSET = 32
+EVT_MALLOC = API_ID_OFFSET + 112
+EVT_MALLOC_FAILED = API_ID_OFFSET + 113
+EVT_FREE = API_ID_OFFSET + 114
+EVT_HEAP_INIT = API_ID_OFFSET + 115
+
+# Must match SYSVIEW_FREERTOS_CODE_BASE in SEGGER_SYSVIEW_FreeRTOS.h.
+CODE_BASE = 0x08000000
+
+# heap_4 places an 8 byte BlockLink_t in front of every block on Cortex-M.
+HEAP_STRUCT_SIZE = 8
+
+# Fixed SystemView events (Id < 24): number of U32 parameters, then whether a
+# string follows.  Events with an Id of 24 and above carry an explicit length.
+EVT_OVERFLOW = 1
+EVT_INIT = 24
+FIXED_EVENTS = {
+    0: (0, False),   # NOP
+    1: (1, False),   # OVERFLOW
+    2: (1, False),   # ISR_ENTER
+    3: (0, False),   # ISR_EXIT
+    4: (1, False),   # TASK_START_EXEC
+    5: (0, False),   # TASK_STOP_EXEC
+    6: (1, False),   # TASK_START_READY
+    7: (2, False),   # TASK_STOP_READY
+    8: (1, False),   # TASK_CREATE
+    9: (2, True),    # TASK_INFO
+    10: (0, False),  # TRACE_START
+    11: (0, False),  # TRACE_STOP
+    12: (1, False),  # SYSTIME_CYCLES
+    13: (2, False),  # SYSTIME_US
+    14: (0, True),   # SYSDESC
+    15: (1, False),  # USER_START
+    16: (1, False),  # USER_STOP
+    17: (0, False),  # IDLE
+    18: (0, False),  # ISR_TO_SCHEDULER
+    19: (1, False),  # TIMER_ENTER
+    20: (0, False),  # TIMER_EXIT
+    21: (4, False),  # STACK_INFO
+    22: (2, True),   # MODULEDESC
+}
+
+
+class DecodeError(Exception):
+    pass
+
+
+class Reader:
+    def __init__(self, data, pos=0):
+        self.data = data
+        self.pos = pos
+
+    def at_end(self):
+        return self.pos >= len(self.data)
+
+    def byte(self):
+        if self.pos >= len(self.data):
+            raise DecodeError("truncated packet")
+        b = self.data[self.pos]
+        self.pos += 1
+        return b
+
+    def u32(self):
+        value = 0
+        shift = 0
+        while True:
+            b = self.byte()
+            value |= (b & 0x7F) << shift
+            if b < 0x80:
+                return value & 0xFFFFFFFF
+            shift += 7
+
+    def u14(self):
+        b = self.byte()
+        if b & 0x80:
+            return (b & 0x7F) | (self.byte() << 7)
+        return b
+
+    def string(self):
+        n = self.byte()
+        if n == 255:
+            n = self.byte() | (self.byte() << 8)
+        s = self.data[self.pos:self.pos + n]
+        self.pos += n
+        return s.decode("latin-1")
+
+
+def skip_svdat_header(data):
+    """SVDat files start with ';' comment lines; the raw stream follows."""
+    pos = 0
+    while pos < len(data) and data[pos:pos + 1] == b";":
+        nl = data.find(b"\n", pos)
+        if nl < 0:
+            return len(data)
+        pos = nl + 1
+    return pos
+
+
+def read_events(data):
+    """Yield (timestamp, event_id, params) for every packet in the stream."""
+    r = Reader(data, skip_svdat_header(data))
+    timestamp = 0
+    while not r.at_end():
+        start = r.pos
+        event_id = r.byte()
+        if event_id < 24:
+            if event_id not in FIXED_EVENTS:
+                raise DecodeError("unknown event %d at offset %d" % (event_id, start))
+            count, has_string = FIXED_EVENTS[event_id]
+            params = [r.u32() for _ in range(count)]
+            if has_string:
+                params.append(r.string())
+        else:
+            if event_id & 0x80:
+                event_id = (event_id & 0x7F) | (r.byte() << 7)
+            length = r.u14()
+            payload = Reader(data[r.pos:r.pos + length])
+            r.pos += length
+            params = []
+            while not payload.at_end():
+                params.append(payload.u32())
+        timestamp += r.u32()
+        yield timestamp, event_id, params
+
+
+class Heap:
+    """Tracks live blocks by start address and the free gaps between them."""
+
+    def __init__(self):
+        self.base = None
+        self.size = None
+        self.granule = 8
+        self.starts = []      # sorted block start addresses
+        self.blocks = {}      # start -> (length, site)
+
+    def used(self):
+        return sum(length for length, _ in self.blocks.values())
+
+    def gaps(self):
+        """Return the list of (start, length) free gaps in address order."""
+        result = []
+        cursor = self.base
+        for start in self.starts:
+            if start > cursor:
+                result.append((cursor, start - cursor))
+            cursor = max(cursor, start + self.blocks[start][0])
+        end = self.base + self.size
+        if end > cursor:
+            result.append((cursor, end - cursor))
+        return result
+
+    def allocate(self, start, length, site):
+        if start in self.blocks:
+            self.free(start)
+        bisect.insort(self.starts, start)
+        self.blocks[start] = (length, site)
+
+    def free(self, start):
+        if start not in self.blocks:
+            return None
+        self.starts.remove(start)
+        return self.blocks.pop(start)
+
+    def pinning_blocks(self):
+        """Blocks with free space immediately before and after them.
+
+        Yields (start, length, site, merged) where merged is the size of the
+        free block that releasing it would produce."""
+        gaps = self.gaps()
+        gap_end = {s + n: n for s, n in gaps}
+        gap_start = {s: n for s, n in gaps}
+        for start in self.starts:
+            length, site = self.blocks[start]
+            before = gap_end.get(start)
+            after = gap_start.get(start + length)
+            if before and after:
+                yield start, length, site, before + length + after
+
+
+def resolve_sites(sites, elf, addr2line):
+    names = {site: "0x%08x" % (site + CODE_BASE) for site in sites}
+    if not elf or not sites:
+        return names
+    tool = addr2line or shutil.which("arm-none-eabi-addr2line") or shutil.which("addr2line")
+    if not tool:
+        print("warning: addr2line not found, allocation sites left unresolved", file=sys.stderr)
+        return names
+    ordered = sorted(sites)
+    # Return addresses point after the call, step back into the call itself.
+    args = [tool, "-f", "-s", "-e", elf] + ["0x%x" % (site + CODE_BASE - 1) for site in ordered]
+    try:
+        out = subprocess.run(args, check=True, capture_output=True, text=True).stdout.splitlines()
+    except (OSError, subprocess.CalledProcessError) as exc:
+        print("warning: %s failed: %s" % (tool, exc), file=sys.stderr)
+        return names
+    for i, site in enumerate(ordered):
+        if 2 * i + 1 < len(out):
+            names[site] = "%s (%s) 0x%08x" % (out[2 * i], out[2 * i + 1], site + CODE_BASE)
+    return names
+
+
+def bar(value, scale, width):
+    n = 0 if scale == 0 else int(round(width * value / scale))
+    return "#" * n + "." * (width - n)
+
+
+def main(argv=None):
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[1], formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("recording", help="SystemView .SVDat file or raw RTT capture")
+    ap.add_argument("--elf", help="ELF image used to resolve allocation sites")
+    ap.add_argument("--addr2line", help="addr2line binary (default: arm-none-eabi-addr2line)")
+    ap.add_argument("--heap-base", type=lambda s: int(s, 0), help="heap start if the recording has no heap init event")
+    ap.add_argument("--heap-size", type=lambda s: int(s, 0), help="heap size if the recording has no heap init event")
+    ap.add_argument("--csv", help="write the full timeline to this CSV file")
+    ap.add_argument("--plot", help="write a PNG chart (needs matplotlib)")
+    ap.add_argument("--rows", type=int, default=20, help="rows in the text chart")
+    ap.add_argument("--top", type=int, default=10, help="allocation sites to list")
+    args = ap.parse_args(argv)
+
+    with open(args.recording, "rb") as f:
+        data = f.read()
+
+    ram_base = 0x20000000
+    id_shift = 2
+    sys_freq = None
+    heap = Heap()
+    if args.heap_base is not None and args.heap_size is not None:
+        heap.base, heap.size = args.heap_base, args.heap_size
+
+    # Pending events until the heap region is known, in case the recording
+    # started after the heap was initialised.
+    heap_events = []
+    overflows = 0
+    try:
+        for ts, event_id, p in read_events(data):
+            if event_id == EVT_INIT and len(p) >= 4:
+                sys_freq, _, ram_base, id_shift = p[:4]
+            elif event_id == EVT_OVERFLOW:
+                overflows += p[0] if p else 1
+            elif event_id == EVT_HEAP_INIT and len(p) >= 3 and heap.base is None:
+                heap.base = (p[0] << id_shift) + ram_base
+                heap.size = p[1]
+                heap.granule = p[2]
+            elif event_id in (EVT_MALLOC, EVT_MALLOC_FAILED, EVT_FREE):
+                heap_events.append((ts, event_id, p, ram_base, id_shift))
+    except DecodeError as exc:
+        print("warning: stopped decoding: %s" % exc, file=sys.stderr)
+
+    if overflows:
+        print("warning: %d SystemView packets were dropped, the heap state may be incomplete" % overflows, file=sys.stderr)
+    if not heap_events:
+        print("No heap events in %s. Was it recorded with the traceMALLOC/traceFREE hooks enabled?" % args.recording)
+        return 1
+
+    if heap.base is None:
+        addrs = [(p[0] << shift) + base - HEAP_STRUCT_SIZE for _, e, p, base, shift in heap_events if e != EVT_MALLOC_FAILED]
+        heap.base = min(addrs)
+        heap.size = max(addrs) - heap.base + 1
+        print("warning: no heap init event, assuming heap spans 0x%08x-0x%08x" % (heap.base, heap.base + heap.size), file=sys.stderr)
+
+    freq = float(sys_freq) if sys_freq else 1.0
+    unit = "s" if sys_freq else "ticks"
+    timeline = []
+    site_pinning = {}
+    failures = {}
+    allocs = frees = 0
+    worst = None
+    last_ts = None
+    pinning = []
+
+    for ts, event_id, p, base, shift in heap_events:
+        if last_ts is not None:
+            dt = ts - last_ts
+            for _, _, site, _ in pinning:
+                site_pinning[site] = site_pinning.get(site, 0) + dt
+        last_ts = ts
+
+        if event_id == EVT_MALLOC:
+            addr = (p[0] << shift) + base
+            heap.allocate(addr - HEAP_STRUCT_SIZE, p[1] * heap.granule, p[2])
+            allocs += 1
+        elif event_id == EVT_FREE:
+            addr = (p[0] << shift) + base
+            heap.free(addr - HEAP_STRUCT_SIZE)
+            frees += 1
+        else:
+            failures[p[1]] = failures.get(p[1], 0) + 1
+
+        gaps = heap.gaps()
+        free = sum(n for _, n in gaps)
+        largest = max([n for _, n in gaps] or [0])
+        used = heap.size - free
+        timeline.append((ts, used, free, largest, len(gaps), event_id == EVT_MALLOC_FAILED))
+        pinning = list(heap.pinning_blocks())
+        if free and (worst is None or largest / free <= worst[0]):
+            worst = (largest / free, ts, largest, free, pinning)
+
+    all_sites = set(site_pinning) | set(failures) | {s for _, _, s, _ in (worst[4] if worst else [])}
+    names = resolve_sites(all_sites, args.elf, args.addr2line)
+
+    print("Heap 0x%08x-0x%08x (%d bytes), %d allocations, %d frees, %d failed allocations"
+          % (heap.base, heap.base + heap.size, heap.size, allocs, frees, sum(failures.values())))
+    print("Peak used %d bytes, smallest largest-free-block %d bytes"
+          % (max(t[1] for t in timeline), min(t[3] for t in timeline)))
+    print()
+
+    # Text chart: U = used, L = largest free block, sampled evenly over time.
+    width = 50
+    t0, t1 = timeline[0][0], timeline[-1][0]
+    print("%12s  %-*s  %-*s  %5s" % ("time/" + unit, width, "used", width, "largest free block", "frags"))
+    idx = 0
+    for row in range(args.rows):
+        target = t0 + (t1 - t0) * row / max(args.rows - 1, 1)
+        while idx + 1 < len(timeline) and timeline[idx + 1][0] <= target:
+            idx += 1
+        ts, used, free, largest, frags, _ = timeline[idx]
+        print("%12.6f  %s  %s  %5d" % (ts / freq, bar(used, heap.size, width), bar(largest, heap.size, width), frags))
+    print()
+
+    if failures:
+        print("Failed allocations:")
+        for site, count in sorted(failures.items(), key=lambda kv: -kv[1]):
+            print("  %6d x  %s" % (count, names[site]))
+        print()
+
+    if site_pinning:
+        print("Allocation sites pinning free space (time spent with free space on both sides):")
+        ranked = sorted(site_pinning.items(), key=lambda kv: -kv[1])[:args.top]
+        for site, duration in ranked:
+            print("  %12.6f %s  %s" % (duration / freq, unit, names[site]))
+        print()
+
+    if worst and worst[4]:
+        print("At the most fragmented point (t=%.6f %s, largest free %d of %d free bytes),"
+              % (worst[1] / freq, unit, worst[2], worst[3]))
+        print("releasing these blocks would give the largest free blocks:")
+        for start, length, site, merged in sorted(worst[4], key=lambda b: -b[3])[:args.top]:
+            print("  0x%08x %6d bytes -> %6d free  %s" % (start + HEAP_STRUCT_SIZE, length, merged, names[site]))
+
+    if args.csv:
+        with open(args.csv, "w") as f:
+            f.write("time,used,free,largest_free,fragments,failed\n")
+            for ts, used, free, largest, frags, failed in timeline:
+                f.write("%.9f,%d,%d,%d,%d,%d\n" % (ts / freq, used, free, largest, frags, int(failed)))
+
+    if args.plot:
+        try:
+            import matplotlib
+            matplotlib.use("Agg")
+            import matplotlib.pyplot as plt
+        except ImportError:
+            print("warning: matplotlib not installed, --plot ignored", file=sys.stderr)
+        else:
+            t = [row[0] / freq for row in timeline]
+            plt.step(t, [row[1] for row in timeline], where="post", label="used")
+            plt.step(t, [row[3] for row in timeline], where="post", label="largest free block")
+            plt.xlabel("time (%s)" % unit)
+            plt.ylabel("bytes")
+            plt.legend()
+            plt.savefig(args.plot)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,241 @@
+#!/usr/bin/env python3
+"""
+RAM report from a GNU ld link map.
+
+Reads the map file the linker writes for every build (Debug/output.map) and
+prints:
+
+  * how much of each memory region is used,
+  * the RAM taken by every kernel object declared in inc/app_objects.h, found
+    by the names app_objects.c gives its static storage (xTaskTCB_<name>,
+    xTaskStack_<name>, xQueueStruct_<name>, ucQueueStorage_<name>,
+    xTimerStruct_<name>) and by the same pattern for stream buffers
+    (xStreamStruct_<name>, ucStreamStorage_<name>),
+  * the RAM taken by each object file, largest first.
+
+Usage:
+  ram_report.py Debug/output.map [--region RAM] [--budget 100K] [--top 15]
+
+Run from the Debug directory by the post-build step.  With --budget the
+script exits with status 1 when the RAM in use exceeds the budget, which fails
+the build.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# Names app_objects.c gives to static storage, and what each one holds.
+OBJECT_STORAGE = re.compile(r"^(xTaskTCB|xTaskStack|xQueueStruct|ucQueueStorage|xTimerStruct|xStreamStruct|ucStreamStorage)_(\w+)$")
+STORAGE_KIND = {
+    "xTaskTCB": ("task", "TCB"),
+    "xTaskStack": ("task", "stack"),
+    "xQueueStruct": ("queue", "struct"),
+    "ucQueueStorage": ("queue", "storage"),
+    "xTimerStruct": ("timer", "struct"),
+    "xStreamStruct": ("stream", "struct"),
+    "ucStreamStorage": ("stream", "storage"),
+}
+
+OUTPUT_SECTION = re.compile(r"^(\.\S+|\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+load address 0x([0-9a-fA-F]+))?")
+INPUT_SECTION = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(.*))?$")
+ADDR_SIZE_FILE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+load address 0x([0-9a-fA-F]+)|\s+(.*))?$")
+SYMBOL = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_][\w.$]*)\s*$")
+NOLOAD = re.compile(r"bss|heap|stack|noinit")
+REGION = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+
+
+class InputSection:
+    def __init__(self, name, addr, size, source):
+        self.name = name
+        self.addr = addr
+        self.size = size
+        self.source = source
+        self.symbols = []
+
+
+def short_source(path):
+    """Shorten toolchain paths to the archive and member name."""
+    path = path.strip().replace("\\", "/")
+    if ".a(" in path or os.path.isabs(path) or re.match(r"^[A-Za-z]:/", path):
+        return os.path.basename(path)
+    return path
+
+
+def parse_map(lines):
+    regions = []
+    sections = []
+    outputs = []
+    in_regions = False
+    in_map = False
+    pending = None
+    current = None
+
+    for line in lines:
+        line = line.rstrip("\r\n")
+
+        if line.startswith("Memory Configuration"):
+            in_regions = True
+            continue
+        if line.startswith("Linker script and memory map"):
+            in_regions = False
+            in_map = True
+            continue
+
+        if in_regions:
+            m = REGION.match(line)
+            if m and m.group(1) != "*default*":
+                regions.append((m.group(1), int(m.group(2), 16), int(m.group(3), 16)))
+            continue
+
+        if not in_map:
+            continue
+
+        # Long section names push the address, size and file onto the next
+        # line.
+        if pending is not None:
+            m = ADDR_SIZE_FILE.match(line)
+            kind, name = pending
+            pending = None
+            if m:
+                addr, size = int(m.group(1), 16), int(m.group(2), 16)
+                if kind == "output":
+                    outputs.append((name, addr, size, int(m.group(3), 16) if m.group(3) else addr))
+                    current = None
+                else:
+                    current = InputSection(name, addr, size, short_source(m.group(4) or ""))
+                    sections.append(current)
+                continue
+
+        if line and not line[0].isspace():
+            m = OUTPUT_SECTION.match(line)
+            if m:
+                addr = int(m.group(2), 16)
+                outputs.append((m.group(1), addr, int(m.group(3), 16), int(m.group(4), 16) if m.group(4) else addr))
+                current = None
+            elif re.match(r"^\.\S+$", line):
+                pending = ("output", line)
+            continue
+
+        m = INPUT_SECTION.match(line)
+        if m and not m.group(1).startswith("0x"):
+            if m.group(1) == "*fill*":
+                current = None
+                continue
+            current = InputSection(m.group(1), int(m.group(2), 16), int(m.group(3), 16), short_source(m.group(4) or ""))
+            sections.append(current)
+            continue
+
+        if re.match(r"^ \S+$", line) and not line.strip().startswith("*"):
+            pending = ("input", line.strip())
+            continue
+
+        m = SYMBOL.match(line)
+        if m and current is not None:
+            addr = int(m.group(1), 16)
+            if current.addr <= addr < current.addr + current.size:
+                current.symbols.append((addr, m.group(2)))
+
+    return regions, outputs, sections
+
+
+def symbol_sizes(section):
+    """Size each symbol by the distance to the next one (or the section end),
+    which includes any alignment padding that follows it."""
+    syms = sorted(section.symbols)
+    for i, (addr, name) in enumerate(syms):
+        end = syms[i + 1][0] if i + 1 < len(syms) else section.addr + section.size
+        yield name, addr, end - addr
+
+
+def parse_size(text):
+    text = text.strip().upper()
+    scale = 1
+    if text.endswith("K"):
+        scale, text = 1024, text[:-1]
+    elif text.endswith("M"):
+        scale, text = 1024 * 1024, text[:-1]
+    return int(text, 0) * scale
+
+
+def main(argv=None):
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[1], formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("map", help="linker map file, e.g. Debug/output.map")
+    ap.add_argument("--region", default="RAM", help="memory region to report on (default: RAM)")
+    ap.add_argument("--budget", type=parse_size, help="fail if more than this many bytes of the region are used (e.g. 100K)")
+    ap.add_argument("--top", type=int, default=15, help="object files to list")
+    args = ap.parse_args(argv)
+
+    with open(args.map, "r", errors="replace") as f:
+        regions, outputs, sections = parse_map(f)
+
+    if not regions:
+        print("error: no memory configuration found in %s" % args.map, file=sys.stderr)
+        return 2
+
+    def region_of(addr):
+        for name, origin, length in regions:
+            if origin <= addr < origin + length:
+                return name
+        return None
+
+    print("Memory regions")
+    print("  %-8s %10s %10s %7s" % ("region", "used", "size", "used%"))
+    region_used = {}
+    for name, origin, length in regions:
+        # Initialised data occupies both its run address in RAM and its load
+        # address in flash.  ld prints a load address for zero initialised
+        # sections too, but nothing is stored there.
+        used = sum(size for sec, addr, size, load in outputs if size and region_of(addr) == name)
+        used += sum(size for sec, addr, size, load in outputs if size and load != addr and region_of(load) == name and not NOLOAD.search(sec))
+        region_used[name] = used
+        print("  %-8s %10d %10d %6.1f%%" % (name, used, length, 100.0 * used / length if length else 0.0))
+
+    ram = [s for s in sections if s.size and region_of(s.addr) == args.region]
+
+    objects = {}
+    for section in ram:
+        for name, addr, size in symbol_sizes(section):
+            m = OBJECT_STORAGE.match(name)
+            if m:
+                kind, part = STORAGE_KIND[m.group(1)]
+                entry = objects.setdefault((kind, m.group(2)), {})
+                entry[part] = entry.get(part, 0) + size
+
+    print()
+    print("Kernel objects (%s)" % args.region)
+    if objects:
+        print("  %-6s %-16s %8s  %s" % ("kind", "name", "bytes", "detail"))
+        total = 0
+        for (kind, name), parts in sorted(objects.items(), key=lambda kv: -sum(kv[1].values())):
+            size = sum(parts.values())
+            total += size
+            detail = ", ".join("%s %d" % (p, parts[p]) for p in sorted(parts))
+            print("  %-6s %-16s %8d  %s" % (kind, name, size, detail))
+        print("  %-23s %8d" % ("total", total))
+    else:
+        print("  none found - is configSUPPORT_STATIC_ALLOCATION set to 1?")
+
+    by_file = {}
+    for section in ram:
+        by_file[section.source] = by_file.get(section.source, 0) + section.size
+
+    print()
+    print("Object files (%s)" % args.region)
+    for source, size in sorted(by_file.items(), key=lambda kv: -kv[1])[:args.top]:
+        print("  %8d  %s" % (size, source or "(linker)"))
+
+    used = region_used.get(args.region, 0)
+    if args.budget is not None:
+        print()
+        if used > args.budget:
+            print("error: %s use of %d bytes exceeds the budget of %d bytes by %d" % (args.region, used, args.budget, used - args.budget), file=sys.stderr)
+            return 1
+        print("%s use of %d bytes is within the budget of %d bytes (%d spare)" % (args.region, used, args.budget, args.budget - used))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
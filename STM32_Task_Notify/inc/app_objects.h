@@ -0,0 +1,100 @@
+/*
+ * Author: Kevin Tom (https://sites.google.com/view/kevintom)
+ *
+ * Description
+ * ```````````
+ * Declarative tables of the application's tasks, queues and software timers.
+ *
+ * Every kernel object the application needs at start up is listed here, once.
+ * app_objects.c expands the tables into
+ *
+ *  - with configSUPPORT_STATIC_ALLOCATION == 1 : statically sized TCBs, stacks,
+ *    queue storage and timer structures, and xTaskCreateStatic() /
+ *    xQueueCreateStatic() / xTimerCreateStatic() calls. Nothing is taken from
+ *    the FreeRTOS heap at start up and the memory layout is fixed at link time.
+ *
+ *  - otherwise : the equivalent xTaskCreate() / xQueueCreate() / xTimerCreate()
+ *    calls.
+ *
+ * The static storage uses global names (xTaskTCB_<name>, xTaskStack_<name>,
+ * xQueueStruct_<name>, ucQueueStorage_<name>, xTimerStruct_<name>) so that it
+ * shows up in the link map, where Tools/ram_report.py picks it up for the
+ * per-object RAM report printed after every build.
+ *
+ * For each entry a handle called x<name>Task, x<name>Queue or x<name>Timer is
+ * declared below, and is valid once vAppCreateObjects() has returned.
+ *
+ */
+
+#ifndef APP_OBJECTS_H
+#define APP_OBJECTS_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "timers.h"
+
+
+
+//Optional parts of the application, set to 1 to build them in
+#define APP_USE_BENCHMARKS		0		//Kernel benchmarks printed at start up, see bench.h
+#define APP_USE_SELFTESTS		0		//Kernel self tests printed at start up, see selftest.h
+#define APP_USE_HR_TIMERS		0		//Microsecond timers on TIM5, see hr_timer.h
+
+//Tasks
+//X( name, task function, task name string, stack depth in words, parameters, priority )
+//500 words of stack as we are using APIs, we need more memory
+#define APP_TASK_TABLE( X ) \
+	X( LED,    vtask_led_handler,     "LED-Task",    500, NULL, 2 ) \
+	X( Button, vtask_button_handler,  "Button-Task", 500, NULL, 2 ) \
+	X( UartRx, vtask_uart_rx_handler, "UART-RX",     500, NULL, 3 ) \
+	APP_BENCH_TASK( X ) \
+	APP_SELFTEST_TASK( X )
+
+#if( APP_USE_BENCHMARKS == 1 )
+	#define APP_BENCH_TASK( X ) \
+		X( Bench,  vtask_bench_handler,   "Bench",       500, NULL, configMAX_PRIORITIES - 1 )
+#else
+	#define APP_BENCH_TASK( X )
+#endif
+
+#if( APP_USE_SELFTESTS == 1 )
+	#define APP_SELFTEST_TASK( X ) \
+		X( SelfTest, vtask_selftest_handler, "SelfTest", 500, NULL, configMAX_PRIORITIES - 1 )
+#else
+	#define APP_SELFTEST_TASK( X )
+#endif
+
+//Queues
+//X( name, length in items, item size in bytes )
+#define APP_QUEUE_TABLE( X )
+
+//Software timers, only created when configUSE_TIMERS is 1
+//X( name, timer name string, period in ticks, auto reload, timer ID, callback function )
+#define APP_TIMER_TABLE( X )
+
+
+
+
+//Handles and task/timer functions named in the tables
+#define APP_DECLARE_TASK( name, function, pcName, stack_words, params, priority ) \
+	extern TaskHandle_t x##name##Task; \
+	void function( void *pvParameters );
+
+#define APP_DECLARE_QUEUE( name, length, item_size ) \
+	extern QueueHandle_t x##name##Queue;
+
+#define APP_DECLARE_TIMER( name, pcName, period, auto_reload, id, callback ) \
+	extern TimerHandle_t x##name##Timer; \
+	void callback( TimerHandle_t xTimer );
+
+APP_TASK_TABLE( APP_DECLARE_TASK )
+APP_QUEUE_TABLE( APP_DECLARE_QUEUE )
+#if( configUSE_TIMERS == 1 )
+APP_TIMER_TABLE( APP_DECLARE_TIMER )
+#endif
+
+//Creates every object in the tables. Call once from main() before vTaskStartScheduler().
+void vAppCreateObjects(void);
+
+#endif /* APP_OBJECTS_H */
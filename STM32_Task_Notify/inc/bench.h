@@ -0,0 +1,41 @@
+/*
+ * Author: Kevin Tom (https://sites.google.com/view/kevintom)
+ *
+ * Description
+ * ```````````
+ * On target benchmarks of the kernel extensions, timed with the Cortex-M4
+ * DWT cycle counter.
+ *
+ * With APP_USE_BENCHMARKS set to 1 in app_objects.h a Bench task is created at
+ * the highest priority. It runs every benchmark once, as soon as the scheduler
+ * starts, prints the results on USART2 and then suspends itself. Interrupts
+ * are left enabled, so each figure is the fewest cycles seen over
+ * BENCH_REPEATS runs, which leaves out runs an interrupt landed in, along with
+ * the mean over all of them.
+ *
+ * The figures are core clock cycles with the clock and flash as main() leaves
+ * them: 16 MHz HSI, flash at its reset settings. Only the cost of the calls
+ * themselves is counted, the cost of reading the counter is taken off.
+ *
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "FreeRTOS.h"
+
+
+
+//Runs of each measurement
+#define BENCH_REPEATS			64
+
+//Cycle counter to time with. Overridable so the benchmarks can also be built
+//for the host, where there is no DWT.
+#ifndef benchCYCLES
+	#define benchCYCLES()		( DWT->CYCCNT )
+#endif
+
+//Bench task function, listed in APP_TASK_TABLE when APP_USE_BENCHMARKS is 1
+void vtask_bench_handler(void *params);
+
+#endif /* BENCH_H */
@@ -0,0 +1,120 @@
+/*
+ * Author: Kevin Tom (https://sites.google.com/view/kevintom)
+ *
+ * Description
+ * ```````````
+ * High resolution timers with callbacks in interrupt context.
+ *
+ * FreeRTOS software timers (timers.c) only resolve one tick, 2 ms at the
+ * configured 500 Hz, and their callbacks run in the timer service task after
+ * a trip through its command queue. These timers run off TIM5 instead, a 32
+ * bit general purpose timer left counting freely at HR_TIMER_TICKS_PER_US
+ * counts per microsecond. Compare channel 1 is always set to the nearest
+ * deadline, so up to HR_TIMER_MAX_ACTIVE HrTimer_t share the one channel and
+ * the CPU is only interrupted when a timer actually expires.
+ *
+ * vHrTimerInit() is called from main() when APP_USE_HR_TIMERS is set to 1 in
+ * app_objects.h. Nothing else in the application uses these timers.
+ *
+ * Timers are one-shot (period 0) or periodic. A periodic timer's deadlines
+ * are a whole number of periods after the first one, so a late callback does
+ * not delay the ones that follow. Deadlines that have already passed when the
+ * timer is reloaded are skipped and counted in ulOverruns.
+ *
+ * The callbacks run in the TIM5 interrupt, so they must be short and may only
+ * call the FromISR FreeRTOS API functions (and the FromISR functions below).
+ *
+ * How late each callback runs, from its deadline to the moment it is called,
+ * is measured in timer counts and reported by vHrTimerGetStats(). The jitter
+ * is the difference between the largest and the smallest latency. Interrupts
+ * of a higher priority and FreeRTOS critical sections (which mask
+ * HR_TIMER_IRQ_PRIORITY) add to it, as do the callbacks of other timers due
+ * at the same time. The benchmarks (see bench.h) print these figures.
+ *
+ */
+
+#ifndef HR_TIMER_H
+#define HR_TIMER_H
+
+#include "FreeRTOS.h"
+
+
+
+//TIM5 counts per microsecond. The APB1 timer clock must be a whole multiple of
+//HR_TIMER_TICKS_PER_US MHz (16 MHz at reset, 90 MHz with the PLL at 180 MHz).
+#define HR_TIMER_TICKS_PER_US	1
+
+//Deadlines are compared as signed differences of the 32 bit counter, so they
+//can be at most half the counter range away
+#define HR_TIMER_MAX_DELAY_US	( 0x7FFFFFFFUL / HR_TIMER_TICKS_PER_US )
+
+//Most timers active at once. The active timers are kept in a binary heap, so
+//starting, stopping and expiring a timer each take at most log2 of this many
+//steps with the TIM5 interrupt masked.
+#define HR_TIMER_MAX_ACTIVE		8
+
+//NVIC priority of the TIM5 interrupt. The highest priority that may call
+//FreeRTOS, for the least latency, so it must not be above (numerically below)
+//configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY.
+#define HR_TIMER_IRQ_PRIORITY	configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+
+typedef struct HrTimer HrTimer_t;
+
+//Called from the TIM5 interrupt when the timer expires. Set
+//*pxHigherPriorityTaskWoken as the FromISR API functions do.
+typedef void (*HrTimerCallback_t)(HrTimer_t *pxTimer, BaseType_t *pxHigherPriorityTaskWoken);
+
+//Owned by the caller, and must stay valid while the timer is active. Only
+//pvContext may be used directly.
+struct HrTimer
+{
+	UBaseType_t uxHeapIndex;		//Position in the heap of active timers
+	uint32_t ulDeadline;			//TIM5 count at which the timer expires
+	uint32_t ulSequence;			//Order the deadline was set in, for timers due at the same count
+	uint32_t ulPeriod;				//Counts between expiries, 0 for a one-shot timer
+	HrTimerCallback_t pxCallback;
+	void *pvContext;				//For the callback's own use
+	uint8_t ucActive;
+};
+
+typedef struct
+{
+	uint32_t ulCallbacks;			//Callbacks run
+	uint32_t ulOverruns;			//Periodic deadlines skipped as they had already passed
+	uint32_t ulMinLatency;			//Fewest counts from a deadline to its callback
+	uint32_t ulMaxLatency;			//Most counts from a deadline to its callback
+	uint64_t ullTotalLatency;		//Sum of all latencies, for the mean
+} HrTimerStats_t;
+
+
+
+//Starts TIM5 counting. Call once before using any other function, before
+//the scheduler starts.
+void vHrTimerInit(void);
+
+//Sets up pxTimer, inactive, to call pxCallback with pvContext.
+void vHrTimerCreate(HrTimer_t *pxTimer, HrTimerCallback_t pxCallback, void *pvContext);
+
+//Starts (or restarts) pxTimer to expire ulDelayUs microseconds from now, then
+//every ulPeriodUs microseconds if ulPeriodUs is not 0. Both must not be more
+//than HR_TIMER_MAX_DELAY_US. Returns pdFAIL, and leaves pxTimer inactive, if
+//HR_TIMER_MAX_ACTIVE other timers are active already.
+BaseType_t xHrTimerStart(HrTimer_t *pxTimer, uint32_t ulDelayUs, uint32_t ulPeriodUs);
+BaseType_t xHrTimerStartFromISR(HrTimer_t *pxTimer, uint32_t ulDelayUs, uint32_t ulPeriodUs);
+
+//Stops pxTimer. Its callback is not called again unless it is restarted.
+void vHrTimerStop(HrTimer_t *pxTimer);
+void vHrTimerStopFromISR(HrTimer_t *pxTimer);
+
+//pdTRUE if pxTimer has been started and has not expired (one-shot) or been
+//stopped yet.
+BaseType_t xHrTimerIsActive(HrTimer_t *pxTimer);
+
+//The free running TIM5 count, HR_TIMER_TICKS_PER_US per microsecond.
+uint32_t ulHrTimerGetCount(void);
+
+//Copies the callback latency figures, and with xReset set to pdTRUE starts
+//them again.
+void vHrTimerGetStats(HrTimerStats_t *pxStats, BaseType_t xReset);
+
+#endif /* HR_TIMER_H */
@@ -0,0 +1,31 @@
+/*
+ * Author: Kevin Tom (https://sites.google.com/view/kevintom)
+ *
+ * Description
+ * ```````````
+ * On target self tests of the kernel extensions, for the behaviour that only
+ * shows with real blocking and real tick timing, and for the documented
+ * results of the memory APIs with the target's own alignment.
+ *
+ * With APP_USE_SELFTESTS set to 1 in app_objects.h a SelfTest task is created
+ * at the highest priority. It runs every test once, as soon as the scheduler
+ * starts, prints one PASS or FAIL line per test on USART2, with the figures
+ * the test checked, and then suspends itself. The tests create their own
+ * kernel objects and helper tasks and delete them again, so they can be built
+ * in alongside the rest of the application. Not alongside the benchmarks
+ * though: both tasks run at the highest priority, so their output would
+ * interleave and the tests' work would show up in the benchmark figures.
+ *
+ */
+
+#ifndef SELFTEST_H
+#define SELFTEST_H
+
+#include "FreeRTOS.h"
+
+
+
+//SelfTest task function, listed in APP_TASK_TABLE when APP_USE_SELFTESTS is 1
+void vtask_selftest_handler(void *params);
+
+#endif /* SELFTEST_H */
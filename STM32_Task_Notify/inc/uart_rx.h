@@ -0,0 +1,94 @@
+/*
+ * Author: Kevin Tom (https://sites.google.com/view/kevintom)
+ *
+ * Description
+ * ```````````
+ * USART2 receive path: DMA1 Stream5 (channel 4) copies every received byte
+ * into a small ring of its own, running in circular mode so it never has to
+ * be restarted, and the interrupts copy the bytes on from there into a
+ * FreeRTOS stream buffer.
+ *
+ * The CPU is only involved when
+ *  - the DMA has filled half of the ring (half-transfer interrupt),
+ *  - the DMA has filled the other half (transfer-complete interrupt),
+ *  - the line has gone idle for one character time after a burst (USART IDLE
+ *    interrupt).
+ * Each of these copies the bytes the DMA has written since the last one into
+ * the stream buffer and commits them with xStreamBufferCommitWriteFromISR(),
+ * which wakes the task reading xUartRxStream once per burst, not once per
+ * byte. With stream buffer coalescing enabled, bursts that follow each other
+ * closely are gathered up to UART_RX_TRIGGER_BYTES, so the reader runs less
+ * often still, and no byte waits more than UART_RX_MAX_LATENCY_MS. The reader
+ * can parse the bytes in place with xStreamBufferAcquireRead() /
+ * xStreamBufferConsume().
+ *
+ * The DMA never writes into the stream buffer itself, so bytes the reader has
+ * been handed stay as they are until it consumes them, however late it is.
+ * The price is one memcpy() per byte in the interrupts, a few percent of a 16
+ * MHz core at 1 Mbaud.
+ *
+ * The stream buffer must be big enough to hold everything that can arrive
+ * while the reader is not running; bytes that do not fit are dropped and
+ * counted in ulOverruns. The interrupts must run at least once every
+ * UART_RX_DMA_SIZE / 2 character times (about 5.5 ms at 115200 baud). If they
+ * are held off for longer the DMA laps the ring: the lost bytes are counted in
+ * ulLaps and reception goes on from the DMA's position.
+ *
+ * USART2 itself (pins, baud rate) is still set up by prvSetupUART() in main.c.
+ * At the default 16 MHz APB1 clock the USART tops out at 1 Mbaud (2 Mbaud
+ * with USART_OverSampling8Cmd()); a faster APB1 clock is needed above that.
+ * The interrupt cost per burst does not depend on the baud rate.
+ *
+ */
+
+#ifndef UART_RX_H
+#define UART_RX_H
+
+#include "FreeRTOS.h"
+#include "stream_buffer.h"
+
+
+
+//Size of the stream buffer's storage area. It holds at most
+//UART_RX_BUFFER_SIZE - 1 bytes.
+#define UART_RX_BUFFER_SIZE		1024
+
+//Size of the ring the DMA writes into. Even, as the half-transfer interrupt is
+//at UART_RX_DMA_SIZE / 2.
+#define UART_RX_DMA_SIZE		128
+
+//With configUSE_STREAM_BUFFER_COALESCING the reader is woken once this many
+//bytes are waiting, or once the oldest of them has waited UART_RX_MAX_LATENCY_MS,
+//rather than for every burst. UART_RX_TRIGGER_BYTES must not be more than
+//UART_RX_BUFFER_SIZE - 1.
+#define UART_RX_TRIGGER_BYTES	64
+#define UART_RX_MAX_LATENCY_MS	5
+
+//NVIC priority of the DMA and USART interrupts. Both must be the same so the
+//two handlers never preempt each other, and must not be above (numerically
+//below) configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY as they call FreeRTOS.
+#define UART_RX_IRQ_PRIORITY	( configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1 )
+
+typedef struct
+{
+	uint32_t ulBytes;		//Bytes delivered to the stream buffer
+	uint32_t ulBursts;		//Interrupts that delivered at least one byte
+	uint32_t ulOverruns;	//Times received bytes were dropped as the stream buffer was full
+	uint32_t ulLaps;		//Times the DMA lapped its ring before the bytes were copied out
+	uint32_t ulErrors;		//USART noise/framing/overrun and DMA transfer errors
+} UartRxStats_t;
+
+//Valid once vUartRxStart() has returned. Only one task may read from it.
+extern StreamBufferHandle_t xUartRxStream;
+
+
+
+//Creates xUartRxStream and starts DMA reception on USART2. Call after
+//prvSetupUART(), and after vAppCreateObjects() so the interrupts stay masked
+//until the scheduler starts.
+void vUartRxStart(void);
+
+//Copies the receive counters.
+void vUartRxGetStats(UartRxStats_t *pxStats);
+
+#endif /* UART_RX_H */
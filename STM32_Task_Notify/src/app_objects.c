@@ -0,0 +1,136 @@
+/*
+ * Author: Kevin Tom (https://sites.google.com/view/kevintom)
+ *
+ * Description
+ * ```````````
+ * Expands the tables in app_objects.h into kernel objects.
+ *
+ * With configSUPPORT_STATIC_ALLOCATION set to 1 every TCB, stack, queue and
+ * timer gets its own statically sized global buffer, the kernel's own idle
+ * (and timer service) task included, so creating them takes nothing from the
+ * FreeRTOS heap. Otherwise the objects are created from the heap as before.
+ *
+ */
+
+
+
+//Header files
+#include "app_objects.h"
+
+
+
+
+//Handles
+#define APP_DEFINE_TASK_HANDLE( name, function, pcName, stack_words, params, priority ) \
+	TaskHandle_t x##name##Task = NULL;
+#define APP_DEFINE_QUEUE_HANDLE( name, length, item_size ) \
+	QueueHandle_t x##name##Queue = NULL;
+#define APP_DEFINE_TIMER_HANDLE( name, pcName, period, auto_reload, id, callback ) \
+	TimerHandle_t x##name##Timer = NULL;
+
+APP_TASK_TABLE( APP_DEFINE_TASK_HANDLE )
+APP_QUEUE_TABLE( APP_DEFINE_QUEUE_HANDLE )
+#if( configUSE_TIMERS == 1 )
+APP_TIMER_TABLE( APP_DEFINE_TIMER_HANDLE )
+#endif
+
+
+
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+//Storage. Kept global (not static) so every buffer is listed by name in the link map.
+#define APP_DEFINE_TASK_STORAGE( name, function, pcName, stack_words, params, priority ) \
+	StaticTask_t xTaskTCB_##name; \
+	StackType_t xTaskStack_##name[ stack_words ];
+#define APP_DEFINE_QUEUE_STORAGE( name, length, item_size ) \
+	StaticQueue_t xQueueStruct_##name; \
+	uint8_t ucQueueStorage_##name[ ( length ) * ( item_size ) ];
+#define APP_DEFINE_TIMER_STORAGE( name, pcName, period, auto_reload, id, callback ) \
+	StaticTimer_t xTimerStruct_##name;
+
+APP_TASK_TABLE( APP_DEFINE_TASK_STORAGE )
+APP_QUEUE_TABLE( APP_DEFINE_QUEUE_STORAGE )
+#if( configUSE_TIMERS == 1 )
+APP_TIMER_TABLE( APP_DEFINE_TIMER_STORAGE )
+#endif
+
+//The kernel's own tasks
+StaticTask_t xTaskTCB_IDLE;
+StackType_t xTaskStack_IDLE[ configMINIMAL_STACK_SIZE ];
+
+#if( configUSE_TIMERS == 1 )
+StaticTask_t xTaskTCB_Tmr_Svc;
+StackType_t xTaskStack_Tmr_Svc[ configTIMER_TASK_STACK_DEPTH ];
+#endif
+
+//Creation calls
+#define APP_CREATE_TASK( name, function, pcName, stack_words, params, priority ) \
+	x##name##Task = xTaskCreateStatic( function, pcName, stack_words, params, priority, xTaskStack_##name, &xTaskTCB_##name );
+#define APP_CREATE_QUEUE( name, length, item_size ) \
+	x##name##Queue = xQueueCreateStatic( length, item_size, ucQueueStorage_##name, &xQueueStruct_##name );
+#define APP_CREATE_TIMER( name, pcName, period, auto_reload, id, callback ) \
+	x##name##Timer = xTimerCreateStatic( pcName, period, auto_reload, id, callback, &xTimerStruct_##name );
+
+#else
+
+#define APP_CREATE_TASK( name, function, pcName, stack_words, params, priority ) \
+	xTaskCreate( function, pcName, stack_words, params, priority, &x##name##Task );
+#define APP_CREATE_QUEUE( name, length, item_size ) \
+	x##name##Queue = xQueueCreate( length, item_size );
+#define APP_CREATE_TIMER( name, pcName, period, auto_reload, id, callback ) \
+	x##name##Timer = xTimerCreate( pcName, period, auto_reload, id, callback );
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+
+//Every object must exist before the scheduler starts
+#define APP_CHECK_TASK( name, function, pcName, stack_words, params, priority ) \
+	configASSERT( x##name##Task );
+#define APP_CHECK_QUEUE( name, length, item_size ) \
+	configASSERT( x##name##Queue ); \
+	vQueueAddToRegistry( x##name##Queue, #name );
+#define APP_CHECK_TIMER( name, pcName, period, auto_reload, id, callback ) \
+	configASSERT( x##name##Timer );
+
+
+
+
+void vAppCreateObjects(void)
+{
+	//Queues and timers first, so they exist before any task that uses them runs
+	APP_QUEUE_TABLE( APP_CREATE_QUEUE )
+	APP_QUEUE_TABLE( APP_CHECK_QUEUE )
+
+#if( configUSE_TIMERS == 1 )
+	APP_TIMER_TABLE( APP_CREATE_TIMER )
+	APP_TIMER_TABLE( APP_CHECK_TIMER )
+#endif
+
+	APP_TASK_TABLE( APP_CREATE_TASK )
+	APP_TASK_TABLE( APP_CHECK_TASK )
+}
+
+
+
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+//Called by vTaskStartScheduler() to get the idle task's memory
+void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, uint32_t *pulIdleTaskStackSize )
+{
+	*ppxIdleTaskTCBBuffer = &xTaskTCB_IDLE;
+	*ppxIdleTaskStackBuffer = xTaskStack_IDLE;
+	*pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+#if( configUSE_TIMERS == 1 )
+//Called by vTaskStartScheduler() to get the timer service task's memory
+void vApplicationGetTimerTaskMemory( StaticTask_t **ppxTimerTaskTCBBuffer, StackType_t **ppxTimerTaskStackBuffer, uint32_t *pulTimerTaskStackSize )
+{
+	*ppxTimerTaskTCBBuffer = &xTaskTCB_Tmr_Svc;
+	*ppxTimerTaskStackBuffer = xTaskStack_Tmr_Svc;
+	*pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+#endif
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
@@ -0,0 +1,1165 @@
+/*
+ * Author: Kevin Tom (https://sites.google.com/view/kevintom)
+ *
+ * Description
+ * ```````````
+ * On target benchmarks of the kernel extensions. See bench.h.
+ *
+ * Each benchmark times the new API against the code it replaces, on the same
+ * objects and the same data, and prints one line per case:
+ *
+ *   <case>: min <fewest cycles> mean <mean cycles>
+ *
+ * except the high resolution timers, which print the latency of their
+ * callbacks in TIM5 counts instead.
+ *
+ */
+
+
+
+//Header files
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "stm32f4xx.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "stream_buffer.h"
+#include "event_groups.h"
+#include "spsc_ring.h"
+#include "semphr.h"
+#include "fast_mutex.h"
+#include "rw_lock.h"
+#include "topic_bus.h"
+#include "app_objects.h"
+#include "hr_timer.h"
+#include "bench.h"
+
+//Largest batch timed, which is also the benchmark queue's length
+#define BENCH_MAX_BATCH		32
+
+//Items sent in one interrupt's burst
+#define BENCH_ISR_BURST		16
+
+//Priority of the tasks the benchmarks block and wake, below the Bench task so
+//a wake up does not switch away from it
+#define BENCH_HELPER_PRIORITY	( configMAX_PRIORITIES - 2 )
+
+//Event group set bits: the most waiters, one on each bit below the bit that
+//no task waits for
+#define BENCH_EG_MAX_WAITERS	23
+#define BENCH_EG_UNWATCHED_BIT	( ( EventBits_t ) 1 << BENCH_EG_MAX_WAITERS )
+
+//Multi-producer contention: the most writer tasks, the records each writes,
+//and the record and buffer sizes. The reader wakes once half the buffer is
+//full, so the writers do not have to wait for space.
+#define BENCH_MP_MAX_WRITERS	8
+#define BENCH_MP_RECORDS		64
+#define BENCH_MP_RECORD_SIZE	16
+#define BENCH_MP_BUFFER_SIZE	512
+
+//Rate of the TIM7 interrupt that writes to the same buffer as the tasks
+#define BENCH_MP_ISR_HZ			10000
+
+//Read-heavy workload: the reads each reader task makes, each holding the lock
+//across a yield to the other readers
+#define BENCH_RW_READS			32
+
+//Topic fan-out: the most subscribers, and the size of the sample sent to them
+#define BENCH_TOPIC_MAX_SUBS	16
+#define BENCH_TOPIC_MSG_SIZE	64
+
+//High resolution timer latency: the period every timer runs at, and the
+//callbacks each one runs for
+#define BENCH_HR_PERIOD_US		500
+#define BENCH_HR_CALLBACKS		200
+
+typedef struct
+{
+	uint32_t ulMin;
+	uint32_t ulTotal;
+	uint32_t ulRuns;
+} BenchResult_t;
+
+//Shared by the writer tasks and TIM7 in the multi-producer benchmark. Each
+//writer has a result of its own, so none of them is updated concurrently.
+typedef struct
+{
+	StreamBufferHandle_t xBuffer;
+	BaseType_t xLocked;				//pdTRUE for a plain buffer written inside critical sections
+	volatile BaseType_t xIsrWriting;
+	TaskHandle_t xBench;
+	BenchResult_t xSend[ BENCH_MP_MAX_WRITERS ];
+	BenchResult_t xIsrSend;
+} BenchMp_t;
+
+//Shared by the reader tasks in the reader-writer lock benchmark
+typedef struct
+{
+	RwLockHandle_t xLock;
+	SemaphoreHandle_t xMutex;
+	BaseType_t xUseRwLock;			//pdFALSE to read under xMutex instead
+	TaskHandle_t xBench;
+} BenchRw_t;
+
+
+
+
+//Function prototypes
+void printmsg(char *msg);
+static void prvBenchInit(void);
+static void prvBenchReset(BenchResult_t *pxResult);
+static void prvBenchAdd(BenchResult_t *pxResult, uint32_t ulStart, uint32_t ulEnd);
+static void prvBenchPrint(const char *pcCase, const BenchResult_t *pxResult);
+static void prvBenchQueueBatch(void);
+static void prvBenchQueuePair(void);
+static void prvBenchIsrToTask(void);
+static void prvBenchRingConsumer(void *params);
+static void prvBenchQueueConsumer(void *params);
+static void prvBenchFastMutex(void);
+#if( ( configUSE_TOPIC_BUS == 1 ) && ( configUSE_BLOCK_POOLS == 1 ) )
+static void prvBenchTopicFanout(void);
+#endif
+#if( configUSE_RW_LOCKS == 1 )
+static void prvBenchRwLock(void);
+static uint32_t prvBenchRwRun(BaseType_t xUseRwLock, UBaseType_t uxReaders);
+static void prvBenchRwReader(void *params);
+#endif
+static void prvBenchEventGroupSetBits(void);
+static void prvBenchEgWaiter(void *params);
+#if( APP_USE_HR_TIMERS == 1 )
+static void prvBenchHrTimer(void);
+static void prvBenchHrCallback(HrTimer_t *pxTimer, BaseType_t *pxHigherPriorityTaskWoken);
+#endif
+#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+static void prvBenchMultiProducer(void);
+static uint32_t prvBenchMpRun(BaseType_t xLocked, UBaseType_t uxWriters);
+static void prvBenchMpWriter(void *params);
+static void prvBenchMpReader(void *params);
+static void prvBenchMpSend(const uint8_t *pucRecord, size_t xLength);
+#endif
+
+
+
+
+//Global variable section
+static uint32_t ulCounterOverhead = 0;
+static char bench_msg[100];
+static EventGroupHandle_t bench_group;
+#if( configUSE_RW_LOCKS == 1 )
+static BenchRw_t bench_rw;
+#endif
+#if( APP_USE_HR_TIMERS == 1 )
+static HrTimer_t bench_hr_timers[ HR_TIMER_MAX_ACTIVE ];
+static volatile uint32_t bench_hr_callbacks[ HR_TIMER_MAX_ACTIVE ];
+#endif
+#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+static BenchMp_t bench_mp;
+#endif
+
+
+
+
+void vtask_bench_handler(void *params)
+{
+	prvBenchInit();
+
+	printmsg("Benchmarks, core clock cycles\r\n");
+
+	prvBenchQueueBatch();
+	prvBenchQueuePair();
+	prvBenchIsrToTask();
+	prvBenchFastMutex();
+#if( ( configUSE_TOPIC_BUS == 1 ) && ( configUSE_BLOCK_POOLS == 1 ) )
+	prvBenchTopicFanout();
+#endif
+#if( configUSE_RW_LOCKS == 1 )
+	prvBenchRwLock();
+#endif
+	prvBenchEventGroupSetBits();
+#if( APP_USE_HR_TIMERS == 1 )
+	prvBenchHrTimer();
+#endif
+#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+	prvBenchMultiProducer();
+#endif
+
+	printmsg("Benchmarks done\r\n");
+
+	vTaskSuspend(NULL);
+}
+
+
+
+
+static void prvBenchInit(void)
+{
+	uint32_t start, end, i;
+
+	//The counter only runs with trace enabled
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	//Cost of two back to back reads of the counter, taken off every figure
+	ulCounterOverhead = 0xFFFFFFFF;
+	for (i = 0; i < BENCH_REPEATS; i++)
+	{
+		start = benchCYCLES();
+		end = benchCYCLES();
+		if ((end - start) < ulCounterOverhead)
+		{
+			ulCounterOverhead = end - start;
+		}
+	}
+}
+
+
+
+
+static void prvBenchReset(BenchResult_t *pxResult)
+{
+	pxResult->ulMin = 0xFFFFFFFF;
+	pxResult->ulTotal = 0;
+	pxResult->ulRuns = 0;
+}
+
+
+
+
+static void prvBenchAdd(BenchResult_t *pxResult, uint32_t ulStart, uint32_t ulEnd)
+{
+	uint32_t cycles = ulEnd - ulStart - ulCounterOverhead;
+
+	if (cycles < pxResult->ulMin)
+	{
+		pxResult->ulMin = cycles;
+	}
+	pxResult->ulTotal += cycles;
+	pxResult->ulRuns++;
+}
+
+
+
+
+static void prvBenchPrint(const char *pcCase, const BenchResult_t *pxResult)
+{
+	sprintf(bench_msg, "%s: min %lu mean %lu\r\n", pcCase, (unsigned long)pxResult->ulMin,
+			(unsigned long)(pxResult->ulTotal / pxResult->ulRuns));
+	printmsg(bench_msg);
+}
+
+
+
+
+//uxQueueSendMultiple() against the same items sent one at a time with
+//xQueueSend(), into an empty queue with no task waiting on it
+static void prvBenchQueueBatch(void)
+{
+	static const UBaseType_t counts[] = { 1, 4, 8, 16, BENCH_MAX_BATCH };
+	uint32_t items[BENCH_MAX_BATCH];
+	BenchResult_t batch, single;
+	QueueHandle_t queue;
+	uint32_t start, end, i, r, c;
+	char name[40];
+
+	queue = xQueueCreate(BENCH_MAX_BATCH, sizeof(uint32_t));
+	configASSERT(queue);
+
+	for (i = 0; i < BENCH_MAX_BATCH; i++)
+	{
+		items[i] = i;
+	}
+
+	for (c = 0; c < (sizeof(counts) / sizeof(counts[0])); c++)
+	{
+		prvBenchReset(&batch);
+		prvBenchReset(&single);
+
+		for (r = 0; r < BENCH_REPEATS; r++)
+		{
+			start = benchCYCLES();
+			(void)uxQueueSendMultiple(queue, items, counts[c], 0);
+			end = benchCYCLES();
+			prvBenchAdd(&batch, start, end);
+			configASSERT(uxQueueMessagesWaiting(queue) == counts[c]);
+			xQueueReset(queue);
+
+			start = benchCYCLES();
+			for (i = 0; i < counts[c]; i++)
+			{
+				(void)xQueueSend(queue, &items[i], 0);
+			}
+			end = benchCYCLES();
+			prvBenchAdd(&single, start, end);
+			configASSERT(uxQueueMessagesWaiting(queue) == counts[c]);
+			xQueueReset(queue);
+		}
+
+		sprintf(name, "uxQueueSendMultiple x%lu", (unsigned long)counts[c]);
+		prvBenchPrint(name, &batch);
+		sprintf(name, "xQueueSend loop x%lu", (unsigned long)counts[c]);
+		prvBenchPrint(name, &single);
+	}
+
+	vQueueDelete(queue);
+}
+
+
+
+
+//xQueueSend() and xQueueReceive() of one item, on a queue of uint32_t and on a
+//queue of 8 byte items, which is always copied with a memcpy() of run time
+//size. Built with configUSE_QUEUE_WORD_COPY at 0 the uint32_t pair gives the
+//cost before word sized items were copied with a fixed size memcpy(), and at
+//1 the cost after.
+static void prvBenchQueuePair(void)
+{
+	BenchResult_t word, wide;
+	QueueHandle_t word_queue, wide_queue;
+	uint32_t item = 0x5A5A5A5A, received;
+	uint64_t wide_item = 0x5A5A5A5A5A5A5A5A, wide_received;
+	uint32_t start, end, r;
+
+	word_queue = xQueueCreate(1, sizeof(uint32_t));
+	wide_queue = xQueueCreate(1, sizeof(uint64_t));
+	configASSERT(word_queue);
+	configASSERT(wide_queue);
+
+#if( configUSE_QUEUE_WORD_COPY == 1 )
+	printmsg("Queue word items copied with a fixed size memcpy\r\n");
+#else
+	printmsg("Queue word items copied with memcpy\r\n");
+#endif
+
+	prvBenchReset(&word);
+	prvBenchReset(&wide);
+
+	for (r = 0; r < BENCH_REPEATS; r++)
+	{
+		start = benchCYCLES();
+		(void)xQueueSend(word_queue, &item, 0);
+		(void)xQueueReceive(word_queue, &received, 0);
+		end = benchCYCLES();
+		prvBenchAdd(&word, start, end);
+
+		start = benchCYCLES();
+		(void)xQueueSend(wide_queue, &wide_item, 0);
+		(void)xQueueReceive(wide_queue, &wide_received, 0);
+		end = benchCYCLES();
+		prvBenchAdd(&wide, start, end);
+	}
+
+	prvBenchPrint("xQueueSend + Receive, 4 byte item", &word);
+	prvBenchPrint("xQueueSend + Receive, 8 byte item", &wide);
+
+	vQueueDelete(word_queue);
+	vQueueDelete(wide_queue);
+}
+
+
+
+
+//xSpscRingSendFromISR() against xQueueSendFromISR() for the interrupt to task
+//path they are both used for. Timed from the Bench task, as the cost of the
+//calls does not depend on where they are made from.
+//  - burst: BENCH_ISR_BURST items sent with no task waiting, as an interrupt
+//    does while its consumer is still busy with earlier data, then received
+//  - wake: one item sent to an empty ring or queue that a task is blocked on
+static void prvBenchIsrToTask(void)
+{
+	BenchResult_t ring_send, ring_receive, ring_wake, queue_send, queue_receive, queue_wake;
+	BaseType_t woken = pdFALSE;
+	SpscRingHandle_t ring;
+	QueueHandle_t queue;
+	TaskHandle_t consumer;
+	BaseType_t created;
+	uint32_t start, end, i, r, item = 0;
+	char name[40];
+
+	ring = xSpscRingCreate(BENCH_ISR_BURST, sizeof(uint32_t));
+	queue = xQueueCreate(BENCH_ISR_BURST, sizeof(uint32_t));
+	configASSERT(ring);
+	configASSERT(queue);
+
+	prvBenchReset(&ring_send);
+	prvBenchReset(&ring_receive);
+	prvBenchReset(&queue_send);
+	prvBenchReset(&queue_receive);
+
+	for (r = 0; r < BENCH_REPEATS; r++)
+	{
+		start = benchCYCLES();
+		for (i = 0; i < BENCH_ISR_BURST; i++)
+		{
+			(void)xSpscRingSendFromISR(ring, &i, &woken);
+		}
+		end = benchCYCLES();
+		prvBenchAdd(&ring_send, start, end);
+
+		start = benchCYCLES();
+		for (i = 0; i < BENCH_ISR_BURST; i++)
+		{
+			(void)xSpscRingReceive(ring, &item, 0);
+		}
+		end = benchCYCLES();
+		prvBenchAdd(&ring_receive, start, end);
+
+		start = benchCYCLES();
+		for (i = 0; i < BENCH_ISR_BURST; i++)
+		{
+			(void)xQueueSendFromISR(queue, &i, &woken);
+		}
+		end = benchCYCLES();
+		prvBenchAdd(&queue_send, start, end);
+
+		start = benchCYCLES();
+		for (i = 0; i < BENCH_ISR_BURST; i++)
+		{
+			(void)xQueueReceive(queue, &item, 0);
+		}
+		end = benchCYCLES();
+		prvBenchAdd(&queue_receive, start, end);
+	}
+
+	//The ring is only ever consumed by one task, so the wake case gets a new
+	//ring whose consumer is the helper task
+	vSpscRingDelete(ring);
+	ring = xSpscRingCreate(BENCH_ISR_BURST, sizeof(uint32_t));
+	configASSERT(ring);
+
+	prvBenchReset(&ring_wake);
+	prvBenchReset(&queue_wake);
+
+	created = xTaskCreate(prvBenchRingConsumer, "BenchRx", configMINIMAL_STACK_SIZE, ring, BENCH_HELPER_PRIORITY, &consumer);
+	configASSERT(created == pdPASS);
+	for (r = 0; r < BENCH_REPEATS; r++)
+	{
+		//Let the consumer take the last item and block again
+		vTaskDelay(1);
+		start = benchCYCLES();
+		(void)xSpscRingSendFromISR(ring, &r, &woken);
+		end = benchCYCLES();
+		prvBenchAdd(&ring_wake, start, end);
+	}
+	vTaskDelete(consumer);
+
+	created = xTaskCreate(prvBenchQueueConsumer, "BenchRx", configMINIMAL_STACK_SIZE, queue, BENCH_HELPER_PRIORITY, &consumer);
+	configASSERT(created == pdPASS);
+	for (r = 0; r < BENCH_REPEATS; r++)
+	{
+		vTaskDelay(1);
+		start = benchCYCLES();
+		(void)xQueueSendFromISR(queue, &r, &woken);
+		end = benchCYCLES();
+		prvBenchAdd(&queue_wake, start, end);
+	}
+	vTaskDelete(consumer);
+
+	sprintf(name, "xSpscRingSendFromISR burst x%u", BENCH_ISR_BURST);
+	prvBenchPrint(name, &ring_send);
+	sprintf(name, "xQueueSendFromISR burst x%u", BENCH_ISR_BURST);
+	prvBenchPrint(name, &queue_send);
+	sprintf(name, "xSpscRingReceive x%u", BENCH_ISR_BURST);
+	prvBenchPrint(name, &ring_receive);
+	sprintf(name, "xQueueReceive x%u", BENCH_ISR_BURST);
+	prvBenchPrint(name, &queue_receive);
+	prvBenchPrint("xSpscRingSendFromISR wake", &ring_wake);
+	prvBenchPrint("xQueueSendFromISR wake", &queue_wake);
+
+	vSpscRingDelete(ring);
+	vQueueDelete(queue);
+}
+
+
+
+
+static void prvBenchRingConsumer(void *params)
+{
+	uint32_t item;
+
+	for (;;)
+	{
+		(void)xSpscRingReceive((SpscRingHandle_t)params, &item, portMAX_DELAY);
+	}
+}
+
+
+
+
+static void prvBenchQueueConsumer(void *params)
+{
+	uint32_t item;
+
+	for (;;)
+	{
+		(void)xQueueReceive((QueueHandle_t)params, &item, portMAX_DELAY);
+	}
+}
+
+
+
+
+//An uncontended take and give of a fast mutex against the same on a standard
+//FreeRTOS mutex, which is the case the fast mutex is built for
+static void prvBenchFastMutex(void)
+{
+	BenchResult_t fast, standard;
+	FastMutexHandle_t fast_mutex;
+	SemaphoreHandle_t mutex;
+	uint32_t start, end, r;
+
+	fast_mutex = xFastMutexCreate();
+	mutex = xSemaphoreCreateMutex();
+	configASSERT(fast_mutex);
+	configASSERT(mutex);
+
+	prvBenchReset(&fast);
+	prvBenchReset(&standard);
+
+	for (r = 0; r < BENCH_REPEATS; r++)
+	{
+		start = benchCYCLES();
+		(void)xFastMutexTake(fast_mutex, portMAX_DELAY);
+		(void)xFastMutexGive(fast_mutex);
+		end = benchCYCLES();
+		prvBenchAdd(&fast, start, end);
+
+		start = benchCYCLES();
+		(void)xSemaphoreTake(mutex, portMAX_DELAY);
+		(void)xSemaphoreGive(mutex);
+		end = benchCYCLES();
+		prvBenchAdd(&standard, start, end);
+	}
+
+	prvBenchPrint("xFastMutexTake + Give", &fast);
+	prvBenchPrint("xSemaphoreTake + Give (mutex)", &standard);
+
+	vFastMutexDelete(fast_mutex);
+	vSemaphoreDelete(mutex);
+}
+
+
+
+
+#if( ( configUSE_TOPIC_BUS == 1 ) && ( configUSE_BLOCK_POOLS == 1 ) )
+
+//One BENCH_TOPIC_MSG_SIZE byte sample to 1 to BENCH_TOPIC_MAX_SUBS
+//subscribers: published once to a topic and received and released from every
+//inbox, against an xQueueSend() of a copy of it to a queue per subscriber and
+//an xQueueReceive() from each. Both sides are done by this task, so no task
+//switch is counted. Prints the cycles per sample for each count, then the
+//fewest subscribers at which the topic is the cheaper, if there are any.
+static void prvBenchTopicFanout(void)
+{
+	QueueHandle_t inboxes[ BENCH_TOPIC_MAX_SUBS ], queues[ BENCH_TOPIC_MAX_SUBS ];
+	uint8_t sample[ BENCH_TOPIC_MSG_SIZE ], received[ BENCH_TOPIC_MSG_SIZE ];
+	BenchResult_t topic_result, queue_result;
+	TopicHandle_t topic;
+	uint8_t *message;
+	uint32_t start, end, r, n, s, crossover = 0;
+
+	for (s = 0; s < BENCH_TOPIC_MSG_SIZE; s++)
+	{
+		sample[ s ] = (uint8_t)s;
+	}
+
+	for (n = 1; n <= BENCH_TOPIC_MAX_SUBS; n++)
+	{
+		topic = xTopicCreate(BENCH_TOPIC_MSG_SIZE, 2, n);
+		configASSERT(topic);
+		for (s = 0; s < n; s++)
+		{
+			inboxes[ s ] = xQueueCreate(1, sizeof(void *));
+			queues[ s ] = xQueueCreate(1, BENCH_TOPIC_MSG_SIZE);
+			configASSERT(inboxes[ s ]);
+			configASSERT(queues[ s ]);
+			(void)xTopicSubscribe(topic, inboxes[ s ]);
+		}
+
+		prvBenchReset(&topic_result);
+		prvBenchReset(&queue_result);
+
+		for (r = 0; r < BENCH_REPEATS; r++)
+		{
+			start = benchCYCLES();
+			message = pvTopicAllocMessage(topic);
+			memcpy(message, sample, BENCH_TOPIC_MSG_SIZE);
+			(void)uxTopicPublish(topic, message);
+			for (s = 0; s < n; s++)
+			{
+				vTopicReleaseMessage(pvTopicReceive(inboxes[ s ], 0));
+			}
+			end = benchCYCLES();
+			prvBenchAdd(&topic_result, start, end);
+
+			start = benchCYCLES();
+			for (s = 0; s < n; s++)
+			{
+				(void)xQueueSend(queues[ s ], sample, 0);
+			}
+			for (s = 0; s < n; s++)
+			{
+				(void)xQueueReceive(queues[ s ], received, 0);
+			}
+			end = benchCYCLES();
+			prvBenchAdd(&queue_result, start, end);
+		}
+
+		sprintf(bench_msg, "Fan-out x%lu: topic min %lu, queue copies min %lu\r\n", (unsigned long)n,
+				(unsigned long)topic_result.ulMin, (unsigned long)queue_result.ulMin);
+		printmsg(bench_msg);
+
+		if ((crossover == 0) && (topic_result.ulMin < queue_result.ulMin))
+		{
+			crossover = n;
+		}
+
+		for (s = 0; s < n; s++)
+		{
+			(void)xTopicUnsubscribe(topic, inboxes[ s ]);
+			vQueueDelete(inboxes[ s ]);
+			vQueueDelete(queues[ s ]);
+		}
+		vTopicDelete(topic);
+	}
+
+	if (crossover != 0)
+	{
+		sprintf(bench_msg, "Fan-out: topic cheaper from %lu subscribers\r\n", (unsigned long)crossover);
+	}
+	else
+	{
+		sprintf(bench_msg, "Fan-out: queue copies cheaper up to %d subscribers\r\n", BENCH_TOPIC_MAX_SUBS);
+	}
+	printmsg(bench_msg);
+}
+
+#endif /* configUSE_TOPIC_BUS */
+
+
+
+
+#if( configUSE_RW_LOCKS == 1 )
+
+//Reader-writer lock against a standard mutex: one uncontended read lock and
+//unlock against one xSemaphoreTake() and xSemaphoreGive(), then a read-heavy
+//workload of 1, 2, 4 and configRW_LOCK_MAX_READERS reader tasks, each making
+//BENCH_RW_READS reads and yielding to the others in the middle of each. The
+//readers share the rw lock, but queue up behind the mutex. Prints the cycles
+//from starting the readers to the last one finishing, per read.
+static void prvBenchRwLock(void)
+{
+	static const UBaseType_t readers[] = { 1, 2, 4, configRW_LOCK_MAX_READERS };
+	BenchResult_t rw, standard;
+	uint32_t start, end, r, c, elapsed;
+
+	bench_rw.xLock = xRwLockCreate();
+	bench_rw.xMutex = xSemaphoreCreateMutex();
+	configASSERT(bench_rw.xLock);
+	configASSERT(bench_rw.xMutex);
+
+	prvBenchReset(&rw);
+	prvBenchReset(&standard);
+
+	for (r = 0; r < BENCH_REPEATS; r++)
+	{
+		start = benchCYCLES();
+		(void)xRwLockReadLock(bench_rw.xLock, portMAX_DELAY);
+		(void)xRwLockReadUnlock(bench_rw.xLock);
+		end = benchCYCLES();
+		prvBenchAdd(&rw, start, end);
+
+		start = benchCYCLES();
+		(void)xSemaphoreTake(bench_rw.xMutex, portMAX_DELAY);
+		(void)xSemaphoreGive(bench_rw.xMutex);
+		end = benchCYCLES();
+		prvBenchAdd(&standard, start, end);
+	}
+
+	prvBenchPrint("xRwLockReadLock + Unlock", &rw);
+	prvBenchPrint("xSemaphoreTake + Give (mutex)", &standard);
+
+	for (c = 0; c < (sizeof(readers) / sizeof(readers[0])); c++)
+	{
+		elapsed = prvBenchRwRun(pdTRUE, readers[c]);
+		sprintf(bench_msg, "Rw lock x%lu readers: %lu per read\r\n", (unsigned long)readers[c],
+				(unsigned long)(elapsed / (readers[c] * BENCH_RW_READS)));
+		printmsg(bench_msg);
+
+		elapsed = prvBenchRwRun(pdFALSE, readers[c]);
+		sprintf(bench_msg, "Mutex x%lu readers: %lu per read\r\n", (unsigned long)readers[c],
+				(unsigned long)(elapsed / (readers[c] * BENCH_RW_READS)));
+		printmsg(bench_msg);
+	}
+
+	vRwLockDelete(bench_rw.xLock);
+	vSemaphoreDelete(bench_rw.xMutex);
+}
+
+
+
+
+//Runs uxReaders reader tasks against the rw lock, or the mutex, until each
+//has made BENCH_RW_READS reads, and returns the cycles taken
+static uint32_t prvBenchRwRun(BaseType_t xUseRwLock, UBaseType_t uxReaders)
+{
+	TaskHandle_t tasks[ configRW_LOCK_MAX_READERS ];
+	BaseType_t created;
+	uint32_t start, end, t;
+
+	bench_rw.xUseRwLock = xUseRwLock;
+	bench_rw.xBench = xTaskGetCurrentTaskHandle();
+
+	for (t = 0; t < uxReaders; t++)
+	{
+		created = xTaskCreate(prvBenchRwReader, "BenchRd", configMINIMAL_STACK_SIZE, NULL, BENCH_HELPER_PRIORITY, &tasks[ t ]);
+		configASSERT(created == pdPASS);
+	}
+
+	//The readers start once this task blocks, and each notifies it when done
+	start = benchCYCLES();
+	for (t = 0; t < uxReaders; t++)
+	{
+		(void)ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+	}
+	end = benchCYCLES();
+
+	for (t = 0; t < uxReaders; t++)
+	{
+		vTaskDelete(tasks[ t ]);
+	}
+
+	return end - start - ulCounterOverhead;
+}
+
+
+
+
+static void prvBenchRwReader(void *params)
+{
+	uint32_t r;
+
+	for (r = 0; r < BENCH_RW_READS; r++)
+	{
+		if (bench_rw.xUseRwLock == pdTRUE)
+		{
+			(void)xRwLockReadLock(bench_rw.xLock, portMAX_DELAY);
+			taskYIELD();
+			(void)xRwLockReadUnlock(bench_rw.xLock);
+		}
+		else
+		{
+			(void)xSemaphoreTake(bench_rw.xMutex, portMAX_DELAY);
+			taskYIELD();
+			(void)xSemaphoreGive(bench_rw.xMutex);
+		}
+	}
+
+	//Done, wait here to be deleted
+	xTaskNotifyGive(bench_rw.xBench);
+	for (;;)
+	{
+		(void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+	}
+}
+
+#endif /* configUSE_RW_LOCKS */
+
+
+
+
+//xEventGroupSetBits() against the number of tasks blocked on the group, each
+//waiting for a bit of its own: setting the bit no task waits for, and setting
+//the bit the last waiter created waits for, which unblocks it. Built with
+//configUSE_INDEXED_EVENT_GROUPS at 0 this gives the cost before the waiters
+//were indexed by bit, and at 1 the cost after.
+static void prvBenchEventGroupSetBits(void)
+{
+	static const UBaseType_t waiters[] = { 1, 4, 8, 16, BENCH_EG_MAX_WAITERS };
+	TaskHandle_t tasks[ BENCH_EG_MAX_WAITERS ];
+	BenchResult_t result;
+	EventBits_t wake;
+	BaseType_t created;
+	uint32_t start, end, c, w, i;
+	char name[60];
+
+#if( configUSE_INDEXED_EVENT_GROUPS == 1 )
+	printmsg("Event group waiters indexed by bit\r\n");
+#else
+	printmsg("Event group waiters in one list\r\n");
+#endif
+
+	for (c = 0; c < (sizeof(waiters) / sizeof(waiters[0])); c++)
+	{
+		bench_group = xEventGroupCreate();
+		configASSERT(bench_group);
+
+		for (w = 0; w < waiters[c]; w++)
+		{
+			created = xTaskCreate(prvBenchEgWaiter, "BenchEg", configMINIMAL_STACK_SIZE, (void *)w, BENCH_HELPER_PRIORITY, &tasks[ w ]);
+			configASSERT(created == pdPASS);
+		}
+
+		//Let every waiter block on the group
+		vTaskDelay(1);
+
+		prvBenchReset(&result);
+		for (i = 0; i < BENCH_REPEATS; i++)
+		{
+			start = benchCYCLES();
+			(void)xEventGroupSetBits(bench_group, BENCH_EG_UNWATCHED_BIT);
+			end = benchCYCLES();
+			prvBenchAdd(&result, start, end);
+			(void)xEventGroupClearBits(bench_group, BENCH_EG_UNWATCHED_BIT);
+		}
+		sprintf(name, "xEventGroupSetBits no wake, %lu waiters", (unsigned long)waiters[c]);
+		prvBenchPrint(name, &result);
+
+		//The waiter clears its bit as it is unblocked, and waits for it again
+		//while this task is delayed
+		wake = (EventBits_t)1 << (waiters[c] - 1);
+		prvBenchReset(&result);
+		for (i = 0; i < BENCH_REPEATS; i++)
+		{
+			start = benchCYCLES();
+			(void)xEventGroupSetBits(bench_group, wake);
+			end = benchCYCLES();
+			prvBenchAdd(&result, start, end);
+			vTaskDelay(1);
+		}
+		sprintf(name, "xEventGroupSetBits one wake, %lu waiters", (unsigned long)waiters[c]);
+		prvBenchPrint(name, &result);
+
+		for (w = 0; w < waiters[c]; w++)
+		{
+			vTaskDelete(tasks[ w ]);
+		}
+		vEventGroupDelete(bench_group);
+	}
+}
+
+
+
+
+static void prvBenchEgWaiter(void *params)
+{
+	EventBits_t bit = (EventBits_t)1 << (uint32_t)params;
+
+	for (;;)
+	{
+		(void)xEventGroupWaitBits(bench_group, bit, pdTRUE, pdFALSE, portMAX_DELAY);
+	}
+}
+
+
+
+
+#if( APP_USE_HR_TIMERS == 1 )
+
+//Latency of the high resolution timer callbacks, from each deadline to the
+//callback, as vHrTimerGetStats() measures it, with 1, 4 and HR_TIMER_MAX_ACTIVE
+//periodic timers all started together, so their deadlines fall on the same
+//counts and each callback waits for the ones before it. This task is
+//delayed meanwhile, so the other tasks, the tick and their critical sections
+//run as usual. Prints the fewest, mean and most counts and the jitter, the
+//most less the fewest, with the deadlines skipped as already passed.
+static void prvBenchHrTimer(void)
+{
+	static const UBaseType_t timers[] = { 1, 4, HR_TIMER_MAX_ACTIVE };
+	HrTimerStats_t stats;
+	BaseType_t started;
+	uint32_t c, t;
+
+	sprintf(bench_msg, "HR timers, callback latency in TIM5 counts, %d per us\r\n", HR_TIMER_TICKS_PER_US);
+	printmsg(bench_msg);
+
+	for (c = 0; c < (sizeof(timers) / sizeof(timers[0])); c++)
+	{
+		vHrTimerGetStats(&stats, pdTRUE);
+
+		for (t = 0; t < timers[c]; t++)
+		{
+			bench_hr_callbacks[ t ] = 0;
+			vHrTimerCreate(&bench_hr_timers[ t ], prvBenchHrCallback, (void *)&bench_hr_callbacks[ t ]);
+			started = xHrTimerStart(&bench_hr_timers[ t ], BENCH_HR_PERIOD_US, BENCH_HR_PERIOD_US);
+			configASSERT(started == pdPASS);
+		}
+
+		//Every timer stops itself after BENCH_HR_CALLBACKS callbacks
+		for (t = 0; t < timers[c]; t++)
+		{
+			while (xHrTimerIsActive(&bench_hr_timers[ t ]) == pdTRUE)
+			{
+				vTaskDelay(pdMS_TO_TICKS(10));
+			}
+		}
+
+		vHrTimerGetStats(&stats, pdFALSE);
+		configASSERT(stats.ulCallbacks != 0);
+		sprintf(bench_msg, "%lu periodic: min %lu mean %lu max %lu jitter %lu, %lu overruns\r\n",
+				(unsigned long)timers[c], (unsigned long)stats.ulMinLatency,
+				(unsigned long)(stats.ullTotalLatency / stats.ulCallbacks),
+				(unsigned long)stats.ulMaxLatency,
+				(unsigned long)(stats.ulMaxLatency - stats.ulMinLatency),
+				(unsigned long)stats.ulOverruns);
+		printmsg(bench_msg);
+	}
+}
+
+
+
+
+static void prvBenchHrCallback(HrTimer_t *pxTimer, BaseType_t *pxHigherPriorityTaskWoken)
+{
+	volatile uint32_t *pulCount = (volatile uint32_t *)pxTimer->pvContext;
+
+	(void)pxHigherPriorityTaskWoken;
+
+	(*pulCount)++;
+	if (*pulCount == BENCH_HR_CALLBACKS)
+	{
+		vHrTimerStopFromISR(pxTimer);
+	}
+}
+
+#endif /* APP_USE_HR_TIMERS */
+
+
+
+
+#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+
+//Any number of tasks and an interrupt writing 16 byte records to one stream
+//buffer: a multi-producer buffer written with no lock, against a plain buffer
+//with each write in a critical section, as stream_buffer.h asks for when a
+//plain buffer has more than one writer. The writers share one priority, so on
+//this single core they contend when the tick switches between them, or TIM7
+//writes, part way through a write. For each writer count it prints the cost
+//of one send as seen by the writer tasks and by TIM7, and the whole run's
+//cycles divided by the records the tasks wrote.
+static void prvBenchMultiProducer(void)
+{
+	static const UBaseType_t writers[] = { 2, 4, 8 };
+	static uint8_t storage[ BENCH_MP_BUFFER_SIZE + 1 ];
+	static StaticStreamBuffer_t mp_struct, locked_struct;
+	TIM_TimeBaseInitTypeDef time_base;
+	StreamBufferHandle_t mp, locked;
+	BenchResult_t send;
+	uint32_t elapsed, w, c, m;
+	char name[60];
+
+	//Writes from TIM7 at BENCH_MP_ISR_HZ. TIM7 runs off APB1, which main()
+	//leaves undivided, so its clock is SystemCoreClock.
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM7, ENABLE);
+	TIM_TimeBaseStructInit(&time_base);
+	time_base.TIM_Period = (SystemCoreClock / BENCH_MP_ISR_HZ) - 1;
+	TIM_TimeBaseInit(TIM7, &time_base);
+	TIM_ClearITPendingBit(TIM7, TIM_IT_Update);
+	TIM_ITConfig(TIM7, TIM_IT_Update, ENABLE);
+	NVIC_SetPriority(TIM7_IRQn, configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1);
+	NVIC_EnableIRQ(TIM7_IRQn);
+
+	//Both buffers use the one storage area, only one exists at a time
+	for (c = 0; c < (sizeof(writers) / sizeof(writers[0])); c++)
+	{
+		for (m = 0; m < 2; m++)
+		{
+			if (m == 0)
+			{
+				mp = xStreamBufferCreateMultiProducerStatic(sizeof(storage), BENCH_MP_BUFFER_SIZE / 2, storage, &mp_struct);
+				configASSERT(mp);
+				bench_mp.xBuffer = mp;
+			}
+			else
+			{
+				locked = xStreamBufferCreateStatic(sizeof(storage), BENCH_MP_BUFFER_SIZE / 2, storage, &locked_struct);
+				configASSERT(locked);
+				bench_mp.xBuffer = locked;
+			}
+
+			elapsed = prvBenchMpRun((m == 0) ? pdFALSE : pdTRUE, writers[c]);
+			vStreamBufferDelete(bench_mp.xBuffer);
+
+			prvBenchReset(&send);
+			for (w = 0; w < writers[c]; w++)
+			{
+				if (bench_mp.xSend[ w ].ulMin < send.ulMin)
+				{
+					send.ulMin = bench_mp.xSend[ w ].ulMin;
+				}
+				send.ulTotal += bench_mp.xSend[ w ].ulTotal;
+				send.ulRuns += bench_mp.xSend[ w ].ulRuns;
+			}
+
+			sprintf(name, "%s x%lu + ISR, task send", (m == 0) ? "Multi-producer" : "Critical section",
+					(unsigned long)writers[c]);
+			prvBenchPrint(name, &send);
+			sprintf(name, "%s x%lu + ISR, ISR send", (m == 0) ? "Multi-producer" : "Critical section",
+					(unsigned long)writers[c]);
+			prvBenchPrint(name, &bench_mp.xIsrSend);
+			sprintf(bench_msg, "%s x%lu + ISR: %lu per record\r\n", (m == 0) ? "Multi-producer" : "Critical section",
+					(unsigned long)writers[c], (unsigned long)(elapsed / (writers[c] * BENCH_MP_RECORDS)));
+			printmsg(bench_msg);
+		}
+	}
+
+	NVIC_DisableIRQ(TIM7_IRQn);
+	TIM_ITConfig(TIM7, TIM_IT_Update, DISABLE);
+}
+
+
+
+
+//Runs uxWriters writer tasks and TIM7 against bench_mp.xBuffer until each
+//task has written BENCH_MP_RECORDS records, and returns the cycles taken
+static uint32_t prvBenchMpRun(BaseType_t xLocked, UBaseType_t uxWriters)
+{
+	TaskHandle_t tasks[ BENCH_MP_MAX_WRITERS ], reader;
+	BaseType_t created;
+	uint32_t start, end, w;
+
+	bench_mp.xLocked = xLocked;
+	bench_mp.xBench = xTaskGetCurrentTaskHandle();
+	prvBenchReset(&bench_mp.xIsrSend);
+
+	//The reader drains the buffer as soon as it is half full, above the
+	//writers so they never find it full
+	created = xTaskCreate(prvBenchMpReader, "BenchRx", configMINIMAL_STACK_SIZE, NULL, BENCH_HELPER_PRIORITY, &reader);
+	configASSERT(created == pdPASS);
+
+	for (w = 0; w < uxWriters; w++)
+	{
+		prvBenchReset(&bench_mp.xSend[ w ]);
+		created = xTaskCreate(prvBenchMpWriter, "BenchTx", configMINIMAL_STACK_SIZE, (void *)w, BENCH_HELPER_PRIORITY - 1, &tasks[ w ]);
+		configASSERT(created == pdPASS);
+	}
+
+	//The writers start once this task blocks, and each notifies it when done
+	start = benchCYCLES();
+	bench_mp.xIsrWriting = pdTRUE;
+	TIM_Cmd(TIM7, ENABLE);
+	for (w = 0; w < uxWriters; w++)
+	{
+		(void)ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+	}
+	end = benchCYCLES();
+	bench_mp.xIsrWriting = pdFALSE;
+	TIM_Cmd(TIM7, DISABLE);
+
+	for (w = 0; w < uxWriters; w++)
+	{
+		vTaskDelete(tasks[ w ]);
+	}
+	vTaskDelete(reader);
+
+	return end - start - ulCounterOverhead;
+}
+
+
+
+
+static void prvBenchMpWriter(void *params)
+{
+	uint32_t index = (uint32_t)params;
+	uint8_t record[ BENCH_MP_RECORD_SIZE ];
+	uint32_t start, end, r;
+
+	for (r = 0; r < BENCH_MP_RECORD_SIZE; r++)
+	{
+		record[ r ] = (uint8_t)index;
+	}
+
+	for (r = 0; r < BENCH_MP_RECORDS; r++)
+	{
+		start = benchCYCLES();
+		prvBenchMpSend(record, sizeof(record));
+		end = benchCYCLES();
+		prvBenchAdd(&bench_mp.xSend[ index ], start, end);
+	}
+
+	//Done, wait here to be deleted
+	xTaskNotifyGive(bench_mp.xBench);
+	for (;;)
+	{
+		(void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+	}
+}
+
+
+
+
+static void prvBenchMpSend(const uint8_t *pucRecord, size_t xLength)
+{
+	size_t sent;
+
+	if (bench_mp.xLocked == pdTRUE)
+	{
+		//A plain buffer's writers cannot block, so try again until it fits
+		do
+		{
+			taskENTER_CRITICAL();
+			sent = xStreamBufferSend(bench_mp.xBuffer, pucRecord, xLength, 0);
+			taskEXIT_CRITICAL();
+			if (sent == 0)
+			{
+				taskYIELD();
+			}
+		} while (sent == 0);
+	}
+	else
+	{
+		sent = xStreamBufferSend(bench_mp.xBuffer, pucRecord, xLength, portMAX_DELAY);
+		configASSERT(sent == xLength);
+	}
+}
+
+
+
+
+static void prvBenchMpReader(void *params)
+{
+	static uint8_t data[ BENCH_MP_BUFFER_SIZE ];
+
+	for (;;)
+	{
+		(void)xStreamBufferReceive(bench_mp.xBuffer, data, sizeof(data), portMAX_DELAY);
+	}
+}
+
+
+
+
+//Writes one record to the benchmark buffer. Dropped if the buffer is full,
+//as an interrupt cannot wait for space.
+void TIM7_IRQHandler(void)
+{
+	static const uint8_t record[ BENCH_MP_RECORD_SIZE ] = { 0xFF };
+	BaseType_t woken = pdFALSE;
+	UBaseType_t mask;
+	uint32_t start, end;
+
+	TIM_ClearITPendingBit(TIM7, TIM_IT_Update);
+
+	if (bench_mp.xIsrWriting == pdTRUE)
+	{
+		start = benchCYCLES();
+		if (bench_mp.xLocked == pdTRUE)
+		{
+			mask = taskENTER_CRITICAL_FROM_ISR();
+			(void)xStreamBufferSendFromISR(bench_mp.xBuffer, record, sizeof(record), &woken);
+			taskEXIT_CRITICAL_FROM_ISR(mask);
+		}
+		else
+		{
+			(void)xStreamBufferSendFromISR(bench_mp.xBuffer, record, sizeof(record), &woken);
+		}
+		end = benchCYCLES();
+		prvBenchAdd(&bench_mp.xIsrSend, start, end);
+	}
+
+	portYIELD_FROM_ISR(woken);
+}
+
+#endif
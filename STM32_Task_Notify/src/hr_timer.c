@@ -0,0 +1,476 @@
+/*
+ * Author: Kevin Tom (https://sites.google.com/view/kevintom)
+ *
+ * Description
+ * ```````````
+ * High resolution timers on TIM5. See hr_timer.h.
+ *
+ * The active timers are kept in a binary min-heap ordered by deadline, in a
+ * fixed array of HR_TIMER_MAX_ACTIVE entries, and TIM5 compare channel 1
+ * always holds the deadline at the root. Each timer knows its index in the
+ * array, so a timer is removed from anywhere in the heap without a search.
+ * Inserting or removing a timer moves it at most log2(HR_TIMER_MAX_ACTIVE)
+ * levels, which bounds the time spent with the TIM5 interrupt masked
+ * however the timers are used.
+ * A compare value the counter has already passed would only match once the
+ * counter wraps, 71 minutes later at 1 count per microsecond, so whenever the
+ * compare value changes it is checked against the counter and, if already
+ * reached, the compare event is raised by software instead.
+ *
+ * The heap is changed from tasks inside a critical section and from the
+ * interrupt with the interrupt mask raised, which also masks TIM5.
+ *
+ */
+
+
+
+//Header files
+#include "stm32f4xx.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "hr_timer.h"
+
+#define HR_TIMER_TIM		TIM5
+#define HR_TIMER_IRQn		TIM5_IRQn
+
+
+
+
+//Global variable section
+static HrTimer_t *pxActiveTimers[ HR_TIMER_MAX_ACTIVE ];
+static UBaseType_t uxActiveCount = 0;
+static uint32_t ulNextSequence = 0;
+static HrTimerStats_t xStats;
+
+
+
+
+//Function prototypes
+static BaseType_t prvHrTimerStart(HrTimer_t *pxTimer, uint32_t ulDelayUs, uint32_t ulPeriodUs);
+static void prvHrTimerStop(HrTimer_t *pxTimer);
+static void prvHrTimerInsert(HrTimer_t *pxTimer);
+static void prvHrTimerRemove(HrTimer_t *pxTimer);
+static BaseType_t prvHrTimerIsBefore(const HrTimer_t *pxFirst, const HrTimer_t *pxSecond);
+static void prvHrTimerPlace(HrTimer_t *pxTimer, UBaseType_t uxIndex);
+static void prvHrTimerSiftUp(UBaseType_t uxIndex);
+static void prvHrTimerSiftDown(UBaseType_t uxIndex);
+static void prvHrTimerArm(void);
+static void prvHrTimerResetStats(void);
+
+
+
+
+void vHrTimerInit(void)
+{
+	RCC_ClocksTypeDef clocks;
+	TIM_TimeBaseInitTypeDef time_base;
+	TIM_OCInitTypeDef compare;
+	uint32_t timer_clock;
+
+	prvHrTimerResetStats();
+
+	//1. TIM5 is clocked from APB1. When APB1 runs slower than HCLK the timer
+	//clock is twice PCLK1 (RM0390, clock tree).
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM5, ENABLE);
+
+	RCC_GetClocksFreq(&clocks);
+	timer_clock = clocks.PCLK1_Frequency;
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1)
+	{
+		timer_clock *= 2;
+	}
+	configASSERT((timer_clock % (HR_TIMER_TICKS_PER_US * 1000000UL)) == 0);
+
+	//2. Counting up over the whole 32 bit range, forever
+	TIM_TimeBaseStructInit(&time_base);
+	time_base.TIM_Prescaler = (uint16_t)((timer_clock / (HR_TIMER_TICKS_PER_US * 1000000UL)) - 1);
+	time_base.TIM_Period = 0xFFFFFFFF;
+	time_base.TIM_CounterMode = TIM_CounterMode_Up;
+	TIM_TimeBaseInit(HR_TIMER_TIM, &time_base);
+
+	//3. Channel 1 as a plain compare, no output pin. Without preload a new
+	//compare value takes effect at once rather than at the next update event.
+	TIM_OCStructInit(&compare);
+	compare.TIM_OCMode = TIM_OCMode_Timing;
+	TIM_OC1Init(HR_TIMER_TIM, &compare);
+	TIM_OC1PreloadConfig(HR_TIMER_TIM, TIM_OCPreload_Disable);
+
+	//4. Interrupts. The compare interrupt itself is only enabled while a timer
+	//is active.
+	TIM_ClearITPendingBit(HR_TIMER_TIM, TIM_IT_CC1);
+	NVIC_SetPriority(HR_TIMER_IRQn, HR_TIMER_IRQ_PRIORITY);
+	NVIC_EnableIRQ(HR_TIMER_IRQn);
+
+	TIM_Cmd(HR_TIMER_TIM, ENABLE);
+}
+
+
+
+
+void vHrTimerCreate(HrTimer_t *pxTimer, HrTimerCallback_t pxCallback, void *pvContext)
+{
+	configASSERT(pxCallback);
+
+	pxTimer->uxHeapIndex = 0;
+	pxTimer->ulDeadline = 0;
+	pxTimer->ulSequence = 0;
+	pxTimer->ulPeriod = 0;
+	pxTimer->pxCallback = pxCallback;
+	pxTimer->pvContext = pvContext;
+	pxTimer->ucActive = pdFALSE;
+}
+
+
+
+
+BaseType_t xHrTimerStart(HrTimer_t *pxTimer, uint32_t ulDelayUs, uint32_t ulPeriodUs)
+{
+	BaseType_t started;
+
+	taskENTER_CRITICAL();
+	started = prvHrTimerStart(pxTimer, ulDelayUs, ulPeriodUs);
+	taskEXIT_CRITICAL();
+
+	return started;
+}
+
+BaseType_t xHrTimerStartFromISR(HrTimer_t *pxTimer, uint32_t ulDelayUs, uint32_t ulPeriodUs)
+{
+	UBaseType_t saved_mask;
+	BaseType_t started;
+
+	saved_mask = taskENTER_CRITICAL_FROM_ISR();
+	started = prvHrTimerStart(pxTimer, ulDelayUs, ulPeriodUs);
+	taskEXIT_CRITICAL_FROM_ISR(saved_mask);
+
+	return started;
+}
+
+
+
+
+void vHrTimerStop(HrTimer_t *pxTimer)
+{
+	taskENTER_CRITICAL();
+	prvHrTimerStop(pxTimer);
+	taskEXIT_CRITICAL();
+}
+
+void vHrTimerStopFromISR(HrTimer_t *pxTimer)
+{
+	UBaseType_t saved_mask;
+
+	saved_mask = taskENTER_CRITICAL_FROM_ISR();
+	prvHrTimerStop(pxTimer);
+	taskEXIT_CRITICAL_FROM_ISR(saved_mask);
+}
+
+
+
+
+BaseType_t xHrTimerIsActive(HrTimer_t *pxTimer)
+{
+	//A single byte read, so no critical section is needed
+	return (BaseType_t)pxTimer->ucActive;
+}
+
+
+
+
+uint32_t ulHrTimerGetCount(void)
+{
+	return TIM_GetCounter(HR_TIMER_TIM);
+}
+
+
+
+
+void vHrTimerGetStats(HrTimerStats_t *pxStats, BaseType_t xReset)
+{
+	taskENTER_CRITICAL();
+	*pxStats = xStats;
+	if (xReset == pdTRUE)
+	{
+		prvHrTimerResetStats();
+	}
+	taskEXIT_CRITICAL();
+}
+
+
+
+
+//Called with the TIM5 interrupt masked, as are all the functions below
+static BaseType_t prvHrTimerStart(HrTimer_t *pxTimer, uint32_t ulDelayUs, uint32_t ulPeriodUs)
+{
+	BaseType_t started = pdFAIL;
+
+	configASSERT(ulDelayUs <= HR_TIMER_MAX_DELAY_US);
+	configASSERT(ulPeriodUs <= HR_TIMER_MAX_DELAY_US);
+
+	//A timer that is already active has its place in the heap, otherwise
+	//there must be room for one more
+	if (pxTimer->ucActive == pdTRUE)
+	{
+		prvHrTimerRemove(pxTimer);
+	}
+
+	if (uxActiveCount < HR_TIMER_MAX_ACTIVE)
+	{
+		pxTimer->ulDeadline = TIM_GetCounter(HR_TIMER_TIM) + (ulDelayUs * HR_TIMER_TICKS_PER_US);
+		pxTimer->ulPeriod = ulPeriodUs * HR_TIMER_TICKS_PER_US;
+		prvHrTimerInsert(pxTimer);
+
+		prvHrTimerArm();
+		started = pdPASS;
+	}
+
+	return started;
+}
+
+
+
+
+static void prvHrTimerStop(HrTimer_t *pxTimer)
+{
+	if (pxTimer->ucActive == pdTRUE)
+	{
+		prvHrTimerRemove(pxTimer);
+		prvHrTimerArm();
+	}
+}
+
+
+
+
+//Timers with the same deadline expire in the order their deadlines were set
+static void prvHrTimerInsert(HrTimer_t *pxTimer)
+{
+	configASSERT(uxActiveCount < HR_TIMER_MAX_ACTIVE);
+
+	pxTimer->ulSequence = ulNextSequence++;
+	pxTimer->ucActive = pdTRUE;
+
+	//Added as the last leaf, then moved up past any later deadline
+	prvHrTimerPlace(pxTimer, uxActiveCount);
+	uxActiveCount++;
+	prvHrTimerSiftUp(pxTimer->uxHeapIndex);
+}
+
+
+
+
+static void prvHrTimerRemove(HrTimer_t *pxTimer)
+{
+	UBaseType_t index = pxTimer->uxHeapIndex;
+	HrTimer_t *pxLast;
+
+	configASSERT(pxActiveTimers[ index ] == pxTimer);
+
+	pxTimer->ucActive = pdFALSE;
+	uxActiveCount--;
+
+	//The last leaf fills the gap, then moves whichever way its deadline
+	//needs. When the timer was the last leaf there is no gap.
+	if (index != uxActiveCount)
+	{
+		pxLast = pxActiveTimers[ uxActiveCount ];
+		prvHrTimerPlace(pxLast, index);
+		prvHrTimerSiftUp(index);
+		prvHrTimerSiftDown(pxLast->uxHeapIndex);
+	}
+}
+
+
+
+
+//pdTRUE if pxFirst expires before pxSecond. The counter wraps, so deadlines
+//are compared by their signed difference, and so are the sequence numbers.
+static BaseType_t prvHrTimerIsBefore(const HrTimer_t *pxFirst, const HrTimer_t *pxSecond)
+{
+	int32_t difference = (int32_t)(pxFirst->ulDeadline - pxSecond->ulDeadline);
+
+	if (difference == 0)
+	{
+		difference = (int32_t)(pxFirst->ulSequence - pxSecond->ulSequence);
+	}
+
+	return (difference < 0) ? pdTRUE : pdFALSE;
+}
+
+
+
+
+static void prvHrTimerPlace(HrTimer_t *pxTimer, UBaseType_t uxIndex)
+{
+	pxActiveTimers[ uxIndex ] = pxTimer;
+	pxTimer->uxHeapIndex = uxIndex;
+}
+
+
+
+
+//Moves the timer at uxIndex towards the root until its parent expires first
+static void prvHrTimerSiftUp(UBaseType_t uxIndex)
+{
+	HrTimer_t *pxTimer = pxActiveTimers[ uxIndex ];
+	UBaseType_t parent;
+
+	while (uxIndex > 0)
+	{
+		parent = (uxIndex - 1) / 2;
+		if (prvHrTimerIsBefore(pxTimer, pxActiveTimers[ parent ]) == pdFALSE)
+		{
+			break;
+		}
+		prvHrTimerPlace(pxActiveTimers[ parent ], uxIndex);
+		uxIndex = parent;
+	}
+
+	prvHrTimerPlace(pxTimer, uxIndex);
+}
+
+
+
+
+//Moves the timer at uxIndex towards the leaves until both its children
+//expire after it
+static void prvHrTimerSiftDown(UBaseType_t uxIndex)
+{
+	HrTimer_t *pxTimer = pxActiveTimers[ uxIndex ];
+	UBaseType_t child;
+
+	for (;;)
+	{
+		child = (2 * uxIndex) + 1;
+		if (child >= uxActiveCount)
+		{
+			break;
+		}
+		if (((child + 1) < uxActiveCount) && (prvHrTimerIsBefore(pxActiveTimers[ child + 1 ], pxActiveTimers[ child ]) == pdTRUE))
+		{
+			child++;
+		}
+		if (prvHrTimerIsBefore(pxActiveTimers[ child ], pxTimer) == pdFALSE)
+		{
+			break;
+		}
+		prvHrTimerPlace(pxActiveTimers[ child ], uxIndex);
+		uxIndex = child;
+	}
+
+	prvHrTimerPlace(pxTimer, uxIndex);
+}
+
+
+
+
+//Points compare channel 1 at the nearest deadline
+static void prvHrTimerArm(void)
+{
+	if (uxActiveCount == 0)
+	{
+		TIM_ITConfig(HR_TIMER_TIM, TIM_IT_CC1, DISABLE);
+	}
+	else
+	{
+		//A match against the old compare value is of no interest any more
+		TIM_SetCompare1(HR_TIMER_TIM, pxActiveTimers[ 0 ]->ulDeadline);
+		TIM_ClearITPendingBit(HR_TIMER_TIM, TIM_IT_CC1);
+		TIM_ITConfig(HR_TIMER_TIM, TIM_IT_CC1, ENABLE);
+
+		//The compare only matches as the counter reaches the compare value. If
+		//it had already got there when the value was written, raise the event
+		//by software so the deadline is not missed.
+		if ((int32_t)(pxActiveTimers[ 0 ]->ulDeadline - TIM_GetCounter(HR_TIMER_TIM)) <= 0)
+		{
+			TIM_GenerateEvent(HR_TIMER_TIM, TIM_EventSource_CC1);
+		}
+	}
+}
+
+
+
+
+static void prvHrTimerResetStats(void)
+{
+	xStats.ulCallbacks = 0;
+	xStats.ulOverruns = 0;
+	xStats.ulMinLatency = 0xFFFFFFFF;
+	xStats.ulMaxLatency = 0;
+	xStats.ullTotalLatency = 0;
+}
+
+
+
+
+void TIM5_IRQHandler(void)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+	UBaseType_t saved_mask;
+	HrTimer_t *pxTimer;
+	uint32_t now, latency;
+
+	traceISR_ENTER();
+
+	TIM_ClearITPendingBit(HR_TIMER_TIM, TIM_IT_CC1);
+
+	saved_mask = taskENTER_CRITICAL_FROM_ISR();
+
+	//Run every timer whose deadline has been reached, including any that
+	//become due while the callbacks run
+	for (;;)
+	{
+		if (uxActiveCount == 0)
+		{
+			break;
+		}
+
+		pxTimer = pxActiveTimers[ 0 ];
+		now = TIM_GetCounter(HR_TIMER_TIM);
+
+		if ((int32_t)(pxTimer->ulDeadline - now) > 0)
+		{
+			break;
+		}
+
+		prvHrTimerRemove(pxTimer);
+
+		latency = now - pxTimer->ulDeadline;
+		xStats.ulCallbacks++;
+		xStats.ullTotalLatency += latency;
+		if (latency < xStats.ulMinLatency)
+		{
+			xStats.ulMinLatency = latency;
+		}
+		if (latency > xStats.ulMaxLatency)
+		{
+			xStats.ulMaxLatency = latency;
+		}
+
+		//A periodic timer goes back in before its callback, which may then
+		//stop it. Its next deadline is kept in step with the first one, and any
+		//deadline that has passed already is skipped rather than run late.
+		if (pxTimer->ulPeriod != 0)
+		{
+			pxTimer->ulDeadline += pxTimer->ulPeriod;
+			while ((int32_t)(pxTimer->ulDeadline - now) <= 0)
+			{
+				pxTimer->ulDeadline += pxTimer->ulPeriod;
+				xStats.ulOverruns++;
+			}
+			prvHrTimerInsert(pxTimer);
+		}
+
+		//The callback runs with the mask lowered again, so it does not hold
+		//off other interrupts, and can start and stop timers itself
+		taskEXIT_CRITICAL_FROM_ISR(saved_mask);
+		pxTimer->pxCallback(pxTimer, &xHigherPriorityTaskWoken);
+		saved_mask = taskENTER_CRITICAL_FROM_ISR();
+	}
+
+	prvHrTimerArm();
+
+	taskEXIT_CRITICAL_FROM_ISR(saved_mask);
+
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
@@ -10,6 +10,9 @@
  * ```````````
  * This program will toggle on-board LED when the user switch is pressed.
  * Uses TaskNotification API to preempt tasks.
+ * Bytes received on USART2 are echoed back (see uart_rx.c).
+ * With APP_USE_HR_TIMERS set, TIM5 runs free for microsecond resolution
+ * timers (see hr_timer.c).
  *
  * UART Details
  * ````````````
@@ -18,6 +21,8 @@
  * 		 				PA3 (RX)
  * Baudrate 		 : 	115200
  * No. Of Stop Bits  : 	1
+ * RX				 :	DMA1 Stream5 Channel4 (circular) ring, copied into a stream buffer
+ * TX				 :	Polled, by printmsg() and printbytes(), under a mutex
  *
  * GPIO
  * ````
@@ -36,25 +41,29 @@
 #include "stm32f4xx.h"
 #include "FreeRTOS.h"
 #include "task.h"
+#include "semphr.h"
+#include "app_objects.h"
+#include "uart_rx.h"
+#include "hr_timer.h"
 
 
 
 
-TaskHandle_t xTaskHandle1=NULL;
-TaskHandle_t xTaskHandle2=NULL;
-			
 //Function prototypes
 static void prvSetupHardware(void);
 void printmsg(char *msg);
+void printbytes(const uint8_t *data, size_t len);
 static void prvSetupUART(void);
 void prvSetupGPIO(void);
-void vtask_led_handler(void *params);
-void vtask_button_handler(void *params);
 void  rtos_delay(uint32_t delay_in_ms);
 
 //Global variable section
 char usr_msg[200]={0};
 
+//Several tasks print, so each message is sent whole under this mutex
+static SemaphoreHandle_t xTxMutex = NULL;
+static StaticSemaphore_t xTxMutexStruct;
+
 
 
 
@@ -74,14 +83,24 @@ int main(void)
 
 	prvSetupHardware();
 
+	xTxMutex = xSemaphoreCreateMutexStatic(&xTxMutexStruct);
+
 	sprintf(usr_msg,"Task Notification API Project");
 	printmsg(usr_msg);
 
 	SEGGER_SYSVIEW_Conf();
 	SEGGER_SYSVIEW_Start();
 
-	xTaskCreate(vtask_led_handler,"LED-Task",500,NULL,2,&xTaskHandle1 ); //500 is given as stack memory as we are using APIs, we need more memory
-	xTaskCreate(vtask_button_handler,"Button-Task",500,NULL,2,&xTaskHandle2 );
+	//Create the tasks listed in app_objects.h
+	vAppCreateObjects();
+
+	//Start receiving on USART2. Its interrupts stay masked until the scheduler starts.
+	vUartRxStart();
+
+#if( APP_USE_HR_TIMERS == 1 )
+	//Start TIM5 counting for the high resolution timers
+	vHrTimerInit();
+#endif
 
 	//Start the scheduler
 	vTaskStartScheduler();
@@ -120,7 +139,28 @@ void vtask_button_handler(void *params)
 			rtos_delay(100);
 
 			//Send notification to LED task
-			xTaskNotify(xTaskHandle1,0x0,eIncrement);
+			xTaskNotify(xLEDTask,0x0,eIncrement);
+		}
+	}
+}
+
+
+
+void vtask_uart_rx_handler(void *params)
+{
+	StreamBufferRegions_t rx;
+	size_t len;
+
+	while(1)
+	{
+		//Blocks until a burst has been received, then echoes it straight out
+		//of the stream buffer without copying it first
+		len = xStreamBufferAcquireRead(xUartRxStream, &rx, portMAX_DELAY);
+		if (len > 0)
+		{
+			printbytes(rx.pucRegion1, rx.xRegion1Length);
+			printbytes(rx.pucRegion2, rx.xRegion2Length);
+			xStreamBufferConsume(xUartRxStream, len);
 		}
 	}
 }
@@ -138,11 +178,21 @@ static void prvSetupHardware(void)
 
 void printmsg(char *msg)
 {
-	for(uint32_t i=0; i<strlen(msg); i++)
+	printbytes((const uint8_t *)msg, strlen(msg));
+}
+
+
+//Also called from main() before the scheduler starts, where the mutex is
+//always free so the take returns at once
+void printbytes(const uint8_t *data, size_t len)
+{
+	xSemaphoreTake(xTxMutex, portMAX_DELAY);
+	for(size_t i=0; i<len; i++)
 	{
 		while (USART_GetFlagStatus(USART2, USART_FLAG_TXE) != SET);
-		USART_SendData(USART2, msg[i]);
+		USART_SendData(USART2, data[i]);
 	}
+	xSemaphoreGive(xTxMutex);
 }
 
 
@@ -0,0 +1,765 @@
+/*
+ * Author: Kevin Tom (https://sites.google.com/view/kevintom)
+ *
+ * Description
+ * ```````````
+ * On target self tests of the kernel extensions. See selftest.h.
+ *
+ * The timing tests drive a kernel object from a helper task at a lower
+ * priority, on a fixed schedule of ticks, and check what the SelfTest task
+ * sees against the documented bounds. The others call the API directly from
+ * the SelfTest task and check its results against the documented ones, with
+ * the target's own alignment and heap. Each prints one line per case:
+ *
+ *   <case>: PASS|FAIL, <what was measured>
+ *
+ */
+
+
+
+//Header files
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stream_buffer.h"
+#include "message_buffer.h"
+#include "arena.h"
+#include "reloc_heap.h"
+#include "selftest.h"
+
+//Priority of the helper tasks, below the SelfTest task so it is always the
+//one that sees a wake up first
+#define SELFTEST_HELPER_PRIORITY	( configMAX_PRIORITIES - 2 )
+
+//Coalescing: buffer size, trigger level and latency the tests are run with
+#define SELFTEST_COAL_SIZE			128
+#define SELFTEST_COAL_TRIGGER		32
+#define SELFTEST_COAL_LATENCY		10
+
+//Zero copy: buffer size, the bytes sent and received first so the free space
+//wraps, and the ticks the reader waits before making room for a blocked writer
+#define SELFTEST_ZC_SIZE			32
+#define SELFTEST_ZC_OFFSET			20
+#define SELFTEST_ZC_READ_DELAY		2
+
+//Compact message lengths: buffer size, and the message lengths sent in each
+//format, the long one needing 2 bytes as a varint and the too long one more
+//than the 1 byte format can hold
+#define SELFTEST_MLEN_SIZE			300
+#define SELFTEST_MLEN_SHORT			10
+#define SELFTEST_MLEN_LONG			200
+#define SELFTEST_MLEN_TOO_LONG		256
+
+//Arena: storage size, deliberately not a multiple of portBYTE_ALIGNMENT
+#define SELFTEST_ARENA_SIZE			100
+
+//Relocatable heap: the buffers the heap is split into
+#define SELFTEST_RELOC_BUFFERS		8
+
+//Bytes written, how often, and how many ticks apart, by the writer task
+typedef struct
+{
+	StreamBufferHandle_t xBuffer;
+	size_t xBytes;
+	UBaseType_t uxWrites;
+	TickType_t xGap;
+	TickType_t xFirstWrite;			//Tick count at the first write
+	volatile BaseType_t xDone;
+} SelfTestWriter_t;
+
+
+
+
+//Function prototypes
+void printmsg(char *msg);
+static void prvSelfTestReport(const char *pcCase, BaseType_t xPass, const char *pcDetail);
+#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+static void prvSelfTestCoalescing(void);
+static void prvSelfTestCoalCase(const char *pcCase, size_t xBytes, UBaseType_t uxWrites, TickType_t xGap);
+static void prvSelfTestWriter(void *params);
+#endif
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+static void prvSelfTestZeroCopy(void);
+static void prvSelfTestZcBlocking(void);
+static void prvSelfTestZcReader(void *params);
+static size_t prvSelfTestZcFill(const StreamBufferRegions_t *pxRegions, size_t xCount, uint8_t ucFirst);
+static BaseType_t prvSelfTestZcCheck(const StreamBufferRegions_t *pxRegions, size_t xCount, uint8_t ucFirst);
+#endif
+#if( configUSE_COMPACT_MESSAGE_LENGTHS == 1 )
+static void prvSelfTestMessageLengths(void);
+static BaseType_t prvSelfTestMlenSend(MessageBufferHandle_t xBuffer, size_t xLength, size_t xLengthBytes);
+#endif
+#if( configUSE_ARENAS == 1 )
+static void prvSelfTestArena(void);
+#endif
+#if( configUSE_RELOCATABLE_HEAP == 1 )
+static void prvSelfTestRelocHeap(void);
+static BaseType_t prvSelfTestRelocCheck(RelocHandle_t xHandle, uint8_t ucPattern, size_t xSize);
+#endif
+
+
+
+
+//Global variable section
+static char selftest_msg[100];
+static UBaseType_t uxFailures = 0;
+#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+static SelfTestWriter_t selftest_writer;
+#endif
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+static StreamBufferHandle_t selftest_zc_buffer;
+#endif
+#if( configUSE_COMPACT_MESSAGE_LENGTHS == 1 )
+static uint8_t selftest_mlen_data[ SELFTEST_MLEN_TOO_LONG ];
+#endif
+
+
+
+
+void vtask_selftest_handler(void *params)
+{
+	printmsg("Self tests\r\n");
+
+#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+	prvSelfTestCoalescing();
+#endif
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+	prvSelfTestZeroCopy();
+	prvSelfTestZcBlocking();
+#endif
+#if( configUSE_COMPACT_MESSAGE_LENGTHS == 1 )
+	prvSelfTestMessageLengths();
+#endif
+#if( configUSE_ARENAS == 1 )
+	prvSelfTestArena();
+#endif
+#if( configUSE_RELOCATABLE_HEAP == 1 )
+	prvSelfTestRelocHeap();
+#endif
+
+	sprintf(selftest_msg, "Self tests done, %lu failed\r\n", (unsigned long)uxFailures);
+	printmsg(selftest_msg);
+
+	vTaskSuspend(NULL);
+}
+
+
+
+
+static void prvSelfTestReport(const char *pcCase, BaseType_t xPass, const char *pcDetail)
+{
+	if (xPass == pdFALSE)
+	{
+		uxFailures++;
+	}
+
+	sprintf(selftest_msg, "%s: %s, %s\r\n", pcCase, (xPass != pdFALSE) ? "PASS" : "FAIL", pcDetail);
+	printmsg(selftest_msg);
+}
+
+
+
+
+#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+
+//The two bounds of xStreamBufferSetCoalescing(). A reader blocked with no
+//time limit of its own must return as soon as the trigger level is reached,
+//and must not leave the oldest byte waiting for more than the latency, plus
+//up to one tick as the latency is counted in whole ticks.
+static void prvSelfTestCoalescing(void)
+{
+	//8 bytes a tick reaches the trigger level in 4 writes, well inside the
+	//latency
+	prvSelfTestCoalCase("Coalescing, byte threshold", 8, 8, 1);
+
+	//One write that never reaches the trigger level
+	prvSelfTestCoalCase("Coalescing, latency, one write", 8, 1, 1);
+
+	//A byte a tick, which keeps the buffer below the trigger level for longer
+	//than the latency
+	prvSelfTestCoalCase("Coalescing, latency, trickle", 1, SELFTEST_COAL_TRIGGER - 1, 1);
+}
+
+
+
+
+//Receives once, with no block time of its own, while the writer task writes
+//xBytes, uxWrites times, xGap ticks apart, and checks the bytes received and
+//the ticks taken from the first write against the bounds
+static void prvSelfTestCoalCase(const char *pcCase, size_t xBytes, UBaseType_t uxWrites, TickType_t xGap)
+{
+	static uint8_t storage[ SELFTEST_COAL_SIZE + 1 ];
+	static uint8_t data[ SELFTEST_COAL_SIZE ];
+	static StaticStreamBuffer_t buffer_struct;
+	TaskHandle_t writer;
+	BaseType_t created, pass;
+	TickType_t elapsed;
+	size_t total, received;
+	char detail[50];
+
+	selftest_writer.xBuffer = xStreamBufferCreateStatic(sizeof(storage), 1, storage, &buffer_struct);
+	configASSERT(selftest_writer.xBuffer);
+	(void)xStreamBufferSetCoalescing(selftest_writer.xBuffer, SELFTEST_COAL_TRIGGER, SELFTEST_COAL_LATENCY);
+
+	selftest_writer.xBytes = xBytes;
+	selftest_writer.uxWrites = uxWrites;
+	selftest_writer.xGap = xGap;
+	selftest_writer.xDone = pdFALSE;
+
+	//The writer starts once this task blocks in the receive
+	created = xTaskCreate(prvSelfTestWriter, "TestTx", configMINIMAL_STACK_SIZE, NULL, SELFTEST_HELPER_PRIORITY, &writer);
+	configASSERT(created == pdPASS);
+
+	received = xStreamBufferReceive(selftest_writer.xBuffer, data, sizeof(data), portMAX_DELAY);
+	elapsed = xTaskGetTickCount() - selftest_writer.xFirstWrite;
+
+	//Whether the writes ever reach the trigger level decides which bound
+	//applies
+	total = xBytes * uxWrites;
+	if (total >= SELFTEST_COAL_TRIGGER)
+	{
+		//Back as soon as the write that reached the trigger level is made
+		pass = ((received >= SELFTEST_COAL_TRIGGER) && (elapsed < SELFTEST_COAL_LATENCY)) ? pdTRUE : pdFALSE;
+	}
+	else
+	{
+		//Back once the first bytes have waited the latency, not before, and
+		//with everything written up to then
+		pass = ((received > 0) && (received < SELFTEST_COAL_TRIGGER) &&
+				(elapsed >= SELFTEST_COAL_LATENCY) && (elapsed <= (SELFTEST_COAL_LATENCY + 1))) ? pdTRUE : pdFALSE;
+	}
+
+	sprintf(detail, "%lu bytes after %lu ticks", (unsigned long)received, (unsigned long)elapsed);
+	prvSelfTestReport(pcCase, pass, detail);
+
+	while (selftest_writer.xDone == pdFALSE)
+	{
+		vTaskDelay(1);
+	}
+	vTaskDelete(writer);
+	vStreamBufferDelete(selftest_writer.xBuffer);
+}
+
+
+
+
+static void prvSelfTestWriter(void *params)
+{
+	static const uint8_t data[ SELFTEST_COAL_SIZE ] = { 0 };
+	UBaseType_t w;
+
+	for (w = 0; w < selftest_writer.uxWrites; w++)
+	{
+		if (w == 0)
+		{
+			selftest_writer.xFirstWrite = xTaskGetTickCount();
+		}
+		else
+		{
+			vTaskDelay(selftest_writer.xGap);
+		}
+		(void)xStreamBufferSend(selftest_writer.xBuffer, data, selftest_writer.xBytes, 0);
+	}
+
+	//Done, wait here to be deleted
+	selftest_writer.xDone = pdTRUE;
+	for (;;)
+	{
+		vTaskDelay(portMAX_DELAY);
+	}
+}
+
+#endif /* configUSE_STREAM_BUFFER_COALESCING */
+
+
+
+
+#if( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+//The regions of the zero copy API where the space wraps at the end of the
+//storage area. The write regions must add up to the free space, the read
+//regions to the bytes committed, oldest first, and a partial consume must
+//leave the rest for xStreamBufferReceive(). On a message buffer the write
+//regions must leave room for the length, and the commit must post one
+//message.
+static void prvSelfTestZeroCopy(void)
+{
+	static uint8_t storage[ SELFTEST_ZC_SIZE + 1 ];
+	static uint8_t data[ SELFTEST_ZC_SIZE ];
+	static StaticStreamBuffer_t buffer_struct;
+	StreamBufferHandle_t buffer;
+	StreamBufferRegions_t regions;
+	size_t free_space, count, i;
+	BaseType_t pass;
+	char detail[60];
+
+	buffer = xStreamBufferCreateStatic(sizeof(storage), 1, storage, &buffer_struct);
+	configASSERT(buffer);
+
+	//Move the head and tail along so the free space wraps
+	(void)xStreamBufferSend(buffer, data, SELFTEST_ZC_OFFSET, 0);
+	(void)xStreamBufferReceive(buffer, data, SELFTEST_ZC_OFFSET, 0);
+
+	free_space = xStreamBufferSpacesAvailable(buffer);
+	count = xStreamBufferAcquireWrite(buffer, &regions, 0, 0);
+	pass = ((count == free_space) && ((regions.xRegion1Length + regions.xRegion2Length) == count) &&
+			(regions.pucRegion2 != NULL)) ? pdTRUE : pdFALSE;
+
+	//Commit all but the last few bytes, which the reader must not see
+	count = prvSelfTestZcFill(&regions, count - 4, 0);
+	(void)xStreamBufferCommitWrite(buffer, count);
+
+	if ((xStreamBufferAcquireRead(buffer, &regions, 0) != count) || (regions.pucRegion2 == NULL) ||
+		(prvSelfTestZcCheck(&regions, count, 0) == pdFALSE))
+	{
+		pass = pdFALSE;
+	}
+
+	//Consume the first 10 bytes in place, receive the rest by copy
+	(void)xStreamBufferConsume(buffer, 10);
+	if (xStreamBufferReceive(buffer, data, sizeof(data), 0) != (count - 10))
+	{
+		pass = pdFALSE;
+	}
+	for (i = 0; i < (count - 10); i++)
+	{
+		if (data[ i ] != (uint8_t)(i + 10))
+		{
+			pass = pdFALSE;
+		}
+	}
+
+	sprintf(detail, "%lu bytes through 2 regions", (unsigned long)count);
+	prvSelfTestReport("Zero copy, wrapped regions", pass, detail);
+	vStreamBufferDelete(buffer);
+
+	//The same on a message buffer, with the length written by the commit
+	buffer = xMessageBufferCreateStatic(sizeof(storage), storage, &buffer_struct);
+	configASSERT(buffer);
+
+	free_space = xStreamBufferSpacesAvailable(buffer);
+	count = xStreamBufferAcquireWrite(buffer, &regions, 0, 0);
+	pass = (count == (free_space - sizeof(size_t))) ? pdTRUE : pdFALSE;
+	(void)xStreamBufferCommitWrite(buffer, prvSelfTestZcFill(&regions, 7, 0));
+
+	if (xMessageBufferReceive(buffer, data, sizeof(data), 0) != 7)
+	{
+		pass = pdFALSE;
+	}
+	for (i = 0; i < 7; i++)
+	{
+		if (data[ i ] != (uint8_t)i)
+		{
+			pass = pdFALSE;
+		}
+	}
+	if (xStreamBufferIsEmpty(buffer) == pdFALSE)
+	{
+		pass = pdFALSE;
+	}
+
+	sprintf(detail, "%lu of %lu free offered for the body", (unsigned long)count, (unsigned long)free_space);
+	prvSelfTestReport("Zero copy, message buffer", pass, detail);
+	vStreamBufferDelete(buffer);
+}
+
+
+
+
+//xStreamBufferAcquireWrite() with a block time on a full buffer. The reader
+//task makes room after SELFTEST_ZC_READ_DELAY ticks, and the writer must get
+//the space then, not at the end of its block time.
+static void prvSelfTestZcBlocking(void)
+{
+	static uint8_t storage[ SELFTEST_ZC_SIZE + 1 ];
+	static uint8_t data[ SELFTEST_ZC_SIZE ];
+	static StaticStreamBuffer_t buffer_struct;
+	StreamBufferRegions_t regions;
+	TaskHandle_t reader;
+	BaseType_t created, pass;
+	TickType_t start, elapsed;
+	size_t count;
+	char detail[50];
+
+	selftest_zc_buffer = xStreamBufferCreateStatic(sizeof(storage), 1, storage, &buffer_struct);
+	configASSERT(selftest_zc_buffer);
+	(void)xStreamBufferSend(selftest_zc_buffer, data, sizeof(data), 0);
+
+	//The reader starts once this task blocks
+	created = xTaskCreate(prvSelfTestZcReader, "TestRx", configMINIMAL_STACK_SIZE, NULL, SELFTEST_HELPER_PRIORITY, &reader);
+	configASSERT(created == pdPASS);
+
+	start = xTaskGetTickCount();
+	count = xStreamBufferAcquireWrite(selftest_zc_buffer, &regions, SELFTEST_ZC_SIZE / 2, SELFTEST_ZC_READ_DELAY * 5);
+	elapsed = xTaskGetTickCount() - start;
+
+	pass = ((count >= (SELFTEST_ZC_SIZE / 2)) && (elapsed >= SELFTEST_ZC_READ_DELAY) &&
+			(elapsed <= (SELFTEST_ZC_READ_DELAY + 1))) ? pdTRUE : pdFALSE;
+	sprintf(detail, "%lu bytes after %lu ticks", (unsigned long)count, (unsigned long)elapsed);
+	prvSelfTestReport("Zero copy, blocking acquire", pass, detail);
+
+	vTaskDelete(reader);
+	vStreamBufferDelete(selftest_zc_buffer);
+}
+
+
+
+
+static void prvSelfTestZcReader(void *params)
+{
+	uint8_t data[ SELFTEST_ZC_SIZE / 2 ];
+
+	vTaskDelay(SELFTEST_ZC_READ_DELAY);
+	(void)xStreamBufferReceive(selftest_zc_buffer, data, sizeof(data), 0);
+
+	//Done, wait here to be deleted
+	for (;;)
+	{
+		vTaskDelay(portMAX_DELAY);
+	}
+}
+
+
+
+
+//Writes xCount bytes counting up from ucFirst into the regions, and returns
+//xCount
+static size_t prvSelfTestZcFill(const StreamBufferRegions_t *pxRegions, size_t xCount, uint8_t ucFirst)
+{
+	size_t i;
+
+	for (i = 0; i < xCount; i++)
+	{
+		if (i < pxRegions->xRegion1Length)
+		{
+			pxRegions->pucRegion1[ i ] = (uint8_t)(ucFirst + i);
+		}
+		else
+		{
+			pxRegions->pucRegion2[ i - pxRegions->xRegion1Length ] = (uint8_t)(ucFirst + i);
+		}
+	}
+
+	return xCount;
+}
+
+
+
+
+//Returns pdTRUE if the first xCount bytes of the regions count up from ucFirst
+static BaseType_t prvSelfTestZcCheck(const StreamBufferRegions_t *pxRegions, size_t xCount, uint8_t ucFirst)
+{
+	uint8_t byte;
+	size_t i;
+
+	for (i = 0; i < xCount; i++)
+	{
+		byte = (i < pxRegions->xRegion1Length) ? pxRegions->pucRegion1[ i ] : pxRegions->pucRegion2[ i - pxRegions->xRegion1Length ];
+		if (byte != (uint8_t)(ucFirst + i))
+		{
+			return pdFALSE;
+		}
+	}
+
+	return pdTRUE;
+}
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+
+
+
+
+#if( configUSE_COMPACT_MESSAGE_LENGTHS == 1 )
+
+//The bytes each length format takes for a short and a long message, and that
+//each message comes back whole. Then a message too long for the 1 byte format,
+//which must be refused straight away, even with a block time.
+static void prvSelfTestMessageLengths(void)
+{
+	static const struct
+	{
+		const char *pcCase;
+		BaseType_t xFormat;
+		size_t xShortBytes;
+		size_t xLongBytes;
+	} formats[] =
+	{
+		{ "Message lengths, size_t", mbLENGTH_FORMAT_SIZE_T, sizeof(size_t), sizeof(size_t) },
+		{ "Message lengths, 1 byte", mbLENGTH_FORMAT_1_BYTE, 1, 1 },
+		{ "Message lengths, 2 bytes", mbLENGTH_FORMAT_2_BYTES, 2, 2 },
+		{ "Message lengths, varint", mbLENGTH_FORMAT_VARINT, 1, 2 }
+	};
+	static uint8_t storage[ SELFTEST_MLEN_SIZE + 1 ];
+	static StaticMessageBuffer_t buffer_struct;
+	MessageBufferHandle_t buffer;
+	BaseType_t pass;
+	TickType_t start, elapsed;
+	size_t sent, f, i;
+	char detail[50];
+
+	for (i = 0; i < sizeof(selftest_mlen_data); i++)
+	{
+		selftest_mlen_data[ i ] = (uint8_t)i;
+	}
+
+	for (f = 0; f < (sizeof(formats) / sizeof(formats[0])); f++)
+	{
+		buffer = xMessageBufferCreateWithLengthFormatStatic(sizeof(storage), formats[f].xFormat, storage, &buffer_struct);
+		configASSERT(buffer);
+
+		pass = prvSelfTestMlenSend(buffer, SELFTEST_MLEN_SHORT, formats[f].xShortBytes);
+		if (prvSelfTestMlenSend(buffer, SELFTEST_MLEN_LONG, formats[f].xLongBytes) == pdFALSE)
+		{
+			pass = pdFALSE;
+		}
+
+		sprintf(detail, "%lu and %lu length bytes", (unsigned long)formats[f].xShortBytes,
+				(unsigned long)formats[f].xLongBytes);
+		prvSelfTestReport(formats[f].pcCase, pass, detail);
+		vMessageBufferDelete(buffer);
+	}
+
+	//There is room for the message, but its length does not fit in a byte
+	buffer = xMessageBufferCreateWithLengthFormatStatic(sizeof(storage), mbLENGTH_FORMAT_1_BYTE, storage, &buffer_struct);
+	configASSERT(buffer);
+
+	start = xTaskGetTickCount();
+	sent = xMessageBufferSend(buffer, selftest_mlen_data, SELFTEST_MLEN_TOO_LONG, 10);
+	elapsed = xTaskGetTickCount() - start;
+	pass = ((sent == 0) && (elapsed == 0) && (xMessageBufferIsEmpty(buffer) != pdFALSE)) ? pdTRUE : pdFALSE;
+
+	sprintf(detail, "%lu bytes sent after %lu ticks", (unsigned long)sent, (unsigned long)elapsed);
+	prvSelfTestReport("Message lengths, too long for 1 byte", pass, detail);
+	vMessageBufferDelete(buffer);
+}
+
+
+
+
+//Sends a message of xLength bytes to the empty buffer and receives it again.
+//Returns pdTRUE if it took xLength + xLengthBytes bytes of the buffer and came
+//back whole.
+static BaseType_t prvSelfTestMlenSend(MessageBufferHandle_t xBuffer, size_t xLength, size_t xLengthBytes)
+{
+	static uint8_t received[ SELFTEST_MLEN_TOO_LONG ];
+	size_t free_space, taken, i;
+
+	free_space = xMessageBufferSpaceAvailable(xBuffer);
+	if (xMessageBufferSend(xBuffer, selftest_mlen_data, xLength, 0) != xLength)
+	{
+		return pdFALSE;
+	}
+	taken = free_space - xMessageBufferSpaceAvailable(xBuffer);
+
+	if ((taken != (xLength + xLengthBytes)) || (xMessageBufferReceive(xBuffer, received, sizeof(received), 0) != xLength))
+	{
+		return pdFALSE;
+	}
+	for (i = 0; i < xLength; i++)
+	{
+		if (received[ i ] != selftest_mlen_data[ i ])
+		{
+			return pdFALSE;
+		}
+	}
+
+	return pdTRUE;
+}
+
+#endif /* configUSE_COMPACT_MESSAGE_LENGTHS */
+
+
+
+
+#if( configUSE_ARENAS == 1 )
+
+//The documented results of the arena API on a static arena whose size is not
+//a multiple of portBYTE_ALIGNMENT: the usable size is rounded down, every
+//allocation is aligned and rounded up, an allocation that does not fit
+//returns NULL and takes nothing, closing a scope rewinds to its mark but keeps
+//the high water mark, and a reset empties the arena
+static void prvSelfTestArena(void)
+{
+	static uint8_t storage[ SELFTEST_ARENA_SIZE ] __attribute__( ( aligned( portBYTE_ALIGNMENT ) ) );
+	static StaticArena_t arena_struct;
+	const size_t usable = SELFTEST_ARENA_SIZE & ~((size_t)portBYTE_ALIGNMENT_MASK);
+	ArenaHandle_t arena;
+	ArenaMark_t mark;
+	uint8_t *first, *second;
+	BaseType_t pass;
+	size_t used, high;
+	char detail[60];
+
+	arena = xArenaCreateStatic(sizeof(storage), storage, &arena_struct);
+	configASSERT(arena);
+
+	//A 3 byte allocation takes a whole aligned unit
+	first = (uint8_t *)pvArenaAlloc(arena, 3);
+	pass = ((first == storage) && (xArenaGetBytesUsed(arena) == portBYTE_ALIGNMENT) &&
+			(xArenaGetFreeSize(arena) == (usable - portBYTE_ALIGNMENT))) ? pdTRUE : pdFALSE;
+
+	//Too big, by one byte and by everything, and the offset does not move
+	if (pvArenaAlloc(arena, xArenaGetFreeSize(arena) + 1) != NULL)
+	{
+		pass = pdFALSE;
+	}
+	if (pvArenaAlloc(arena, (size_t)-1) != NULL)
+	{
+		pass = pdFALSE;
+	}
+	used = xArenaGetBytesUsed(arena);
+	sprintf(detail, "%lu usable, %lu used after a 3 byte alloc", (unsigned long)usable, (unsigned long)used);
+	prvSelfTestReport("Arena, alignment and bounds", ((pass != pdFALSE) && (used == portBYTE_ALIGNMENT)) ? pdTRUE : pdFALSE,
+			detail);
+
+	//Fill the rest inside a scope, then close it
+	mark = xArenaScopeBegin(arena);
+	second = (uint8_t *)pvArenaAlloc(arena, xArenaGetFreeSize(arena));
+	pass = ((second == (first + portBYTE_ALIGNMENT)) && (xArenaGetFreeSize(arena) == 0)) ? pdTRUE : pdFALSE;
+	vArenaScopeEnd(arena, mark);
+	used = xArenaGetBytesUsed(arena);
+	high = xArenaGetHighWaterMark(arena);
+	if ((used != portBYTE_ALIGNMENT) || (high != usable))
+	{
+		pass = pdFALSE;
+	}
+
+	vArenaReset(arena);
+	if ((xArenaGetBytesUsed(arena) != 0) || (xArenaGetFreeSize(arena) != usable))
+	{
+		pass = pdFALSE;
+	}
+	sprintf(detail, "%lu used after the scope, high water mark %lu", (unsigned long)used, (unsigned long)high);
+	prvSelfTestReport("Arena, scopes and reset", pass, detail);
+
+	vArenaDelete(arena);
+}
+
+#endif /* configUSE_ARENAS */
+
+
+
+
+#if( configUSE_RELOCATABLE_HEAP == 1 )
+
+//Compaction of the relocatable heap. Fills the heap with buffers, frees every
+//other one so the free space is split into holes no larger than one buffer,
+//and runs xRelocHeapCompactStep() to completion with the top buffer locked.
+//The unlocked buffers must keep their contents as they move, the locked one
+//must not move, and the holes must merge into a block that takes three
+//buffers. Expects the heap to be empty, so it must run before anything else
+//uses it.
+static void prvSelfTestRelocHeap(void)
+{
+	RelocHandle_t handles[ SELFTEST_RELOC_BUFFERS ], large;
+	uint8_t *data, *pinned;
+	size_t size, free_before, largest_before, largest_after;
+	BaseType_t pass = pdTRUE;
+	UBaseType_t b, steps;
+	char detail[60];
+
+	free_before = xRelocHeapGetFreeHeapSize();
+	size = free_before / (SELFTEST_RELOC_BUFFERS + 1);
+
+	for (b = 0; b < SELFTEST_RELOC_BUFFERS; b++)
+	{
+		handles[ b ] = xRelocHeapAlloc(size);
+		configASSERT(handles[ b ]);
+		data = (uint8_t *)pvRelocHeapLock(handles[ b ]);
+		if ((((size_t)data) & portBYTE_ALIGNMENT_MASK) != 0)
+		{
+			pass = pdFALSE;
+		}
+		memset(data, (int)b, size);
+		vRelocHeapUnlock(handles[ b ]);
+	}
+
+	for (b = 0; b < SELFTEST_RELOC_BUFFERS; b += 2)
+	{
+		vRelocHeapFree(handles[ b ]);
+	}
+	largest_before = xRelocHeapGetLargestFreeBlock();
+
+	//Every step moves at most configRELOCATABLE_HEAP_COMPACT_STEP_BYTES, so
+	//this many steps is more than enough to finish
+	pinned = (uint8_t *)pvRelocHeapLock(handles[ SELFTEST_RELOC_BUFFERS - 1 ]);
+	for (steps = 0; steps < (configRELOCATABLE_HEAP_SIZE / configRELOCATABLE_HEAP_COMPACT_STEP_BYTES) + SELFTEST_RELOC_BUFFERS; steps++)
+	{
+		if (xRelocHeapCompactStep() == pdFALSE)
+		{
+			break;
+		}
+	}
+	largest_after = xRelocHeapGetLargestFreeBlock();
+
+	if (pvRelocHeapLock(handles[ SELFTEST_RELOC_BUFFERS - 1 ]) != pinned)
+	{
+		pass = pdFALSE;
+	}
+	vRelocHeapUnlock(handles[ SELFTEST_RELOC_BUFFERS - 1 ]);
+	vRelocHeapUnlock(handles[ SELFTEST_RELOC_BUFFERS - 1 ]);
+
+	for (b = 1; b < SELFTEST_RELOC_BUFFERS; b += 2)
+	{
+		if (prvSelfTestRelocCheck(handles[ b ], (uint8_t)b, size) == pdFALSE)
+		{
+			pass = pdFALSE;
+		}
+	}
+
+	//The holes only take three buffers once they are merged
+	if (largest_before >= (3 * size))
+	{
+		pass = pdFALSE;
+	}
+	large = xRelocHeapAlloc(3 * size);
+	if (large == NULL)
+	{
+		pass = pdFALSE;
+	}
+	else
+	{
+		vRelocHeapFree(large);
+	}
+
+	for (b = 1; b < SELFTEST_RELOC_BUFFERS; b += 2)
+	{
+		vRelocHeapFree(handles[ b ]);
+	}
+	if (xRelocHeapGetFreeHeapSize() != free_before)
+	{
+		pass = pdFALSE;
+	}
+
+	sprintf(detail, "largest free %lu before, %lu after %lu steps", (unsigned long)largest_before,
+			(unsigned long)largest_after, (unsigned long)steps);
+	prvSelfTestReport("Relocatable heap, compaction", pass, detail);
+}
+
+
+
+
+//Returns pdTRUE if all xSize bytes of the buffer still hold ucPattern
+static BaseType_t prvSelfTestRelocCheck(RelocHandle_t xHandle, uint8_t ucPattern, size_t xSize)
+{
+	const uint8_t *data = (const uint8_t *)pvRelocHeapLock(xHandle);
+	BaseType_t intact = pdTRUE;
+	size_t i;
+
+	for (i = 0; i < xSize; i++)
+	{
+		if (data[ i ] != ucPattern)
+		{
+			intact = pdFALSE;
+			break;
+		}
+	}
+	vRelocHeapUnlock(xHandle);
+
+	return intact;
+}
+
+#endif /* configUSE_RELOCATABLE_HEAP */
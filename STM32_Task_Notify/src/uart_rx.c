@@ -0,0 +1,351 @@
+/*
+ * Author: Kevin Tom (https://sites.google.com/view/kevintom)
+ *
+ * Description
+ * ```````````
+ * USART2 receive path, circular DMA into a ring of its own, copied into a
+ * stream buffer. See uart_rx.h.
+ *
+ * The DMA writes at the position given by its NDTR (remaining transfer count)
+ * register, while xDmaIndex marks the first byte not yet copied out. On every
+ * half-transfer, transfer-complete and IDLE interrupt the bytes between the
+ * two are copied into the stream buffer and committed, so xDmaIndex catches
+ * up with the DMA.
+ *
+ * NDTR alone only gives the DMA position modulo the ring size, so an
+ * interrupt held off for a whole lap would look like an empty ring, or a short
+ * burst. The HT and TC flags tell which of the two half marks the DMA has
+ * passed since the last call. A flag that is set although the move from
+ * xDmaIndex to NDTR does not pass its mark means the DMA has been round the
+ * ring again, and the ring no longer holds the bytes in order.
+ *
+ */
+
+
+
+//Header files
+#include <string.h>
+
+#include "stm32f4xx.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stream_buffer.h"
+#include "object_registry.h"
+#include "uart_rx.h"
+
+#if( configSUPPORT_STATIC_ALLOCATION != 1 ) || ( configUSE_STREAM_BUFFER_ZERO_COPY != 1 )
+	#error uart_rx.c needs configSUPPORT_STATIC_ALLOCATION and configUSE_STREAM_BUFFER_ZERO_COPY set to 1
+#endif
+
+//USART2_RX is request channel 4 of DMA1 Stream5 (RM0390, DMA1 request mapping)
+#define UART_RX_DMA_STREAM		DMA1_Stream5
+#define UART_RX_DMA_CHANNEL		DMA_Channel_4
+
+//Flags and interrupts of Stream5. The half and full marks are read straight
+//from HISR, so both come from the same read.
+#define UART_RX_DMA_STREAM_ISR	( DMA1->HISR )
+#define UART_RX_DMA_STREAM_IFCR	( DMA1->HIFCR )
+#define UART_RX_DMA_IT_TE		DMA_IT_TEIF5
+#define UART_RX_DMA_HT			DMA_HISR_HTIF5
+#define UART_RX_DMA_TC			DMA_HISR_TCIF5
+#define UART_RX_DMA_FLAGS		( DMA_FLAG_FEIF5 | DMA_FLAG_DMEIF5 | DMA_FLAG_TEIF5 | DMA_FLAG_HTIF5 | DMA_FLAG_TCIF5 )
+
+#define UART_RX_USART_ERRORS	( USART_FLAG_ORE | USART_FLAG_NE | USART_FLAG_FE )
+
+#if( ( UART_RX_DMA_SIZE % 2 ) != 0 )
+	#error UART_RX_DMA_SIZE must be even, the half-transfer mark is at UART_RX_DMA_SIZE / 2
+#endif
+
+
+
+
+//Global variable section
+StreamBufferHandle_t xUartRxStream = NULL;
+
+//Kept global (not static) so the buffers are listed by name in the link map
+StaticStreamBuffer_t xStreamStruct_UartRx;
+uint8_t ucStreamStorage_UartRx[ UART_RX_BUFFER_SIZE ];
+uint8_t ucDmaRing_UartRx[ UART_RX_DMA_SIZE ];
+
+//First byte of the DMA ring not yet copied into the stream buffer
+static size_t xDmaIndex = 0;
+
+static UartRxStats_t xStats;
+
+
+
+
+//Function prototypes
+static void prvUartRxDeliver(BaseType_t *pxHigherPriorityTaskWoken);
+static size_t prvUartRxCopy(size_t xCount);
+static void prvUartRxRestartDma(void);
+
+
+
+
+void vUartRxStart(void)
+{
+	DMA_InitTypeDef dma_init;
+
+	//1. The stream buffer. A trigger level of 1 wakes the reader on the first
+	//commit of a burst; the commits themselves only happen once per burst.
+	xUartRxStream = xStreamBufferCreateStatic( UART_RX_BUFFER_SIZE, 1, ucStreamStorage_UartRx, &xStreamStruct_UartRx );
+	configASSERT( xUartRxStream );
+
+	#if( configUSE_STREAM_BUFFER_COALESCING == 1 )
+		//Back to back short bursts are handed over together, once
+		//UART_RX_TRIGGER_BYTES have arrived or the oldest byte has waited
+		//UART_RX_MAX_LATENCY_MS
+		( void ) xStreamBufferSetCoalescing( xUartRxStream, UART_RX_TRIGGER_BYTES, pdMS_TO_TICKS( UART_RX_MAX_LATENCY_MS ) );
+	#endif
+
+	#if( configUSE_OBJECT_REGISTRY == 1 )
+		( void ) xObjectRegistryAdd( xUartRxStream, "UartRx", eObjectTypeStreamBuffer );
+	#endif
+
+	//2. DMA1 Stream5 channel 4 : USART2->DR to the DMA ring, byte by byte,
+	//wrapping at the end of the ring forever (circular mode)
+	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA1, ENABLE);
+
+	DMA_Cmd(UART_RX_DMA_STREAM, DISABLE);
+	while (DMA_GetCmdStatus(UART_RX_DMA_STREAM) != DISABLE);
+	DMA_DeInit(UART_RX_DMA_STREAM);
+
+	DMA_StructInit(&dma_init);
+	dma_init.DMA_Channel = UART_RX_DMA_CHANNEL;
+	dma_init.DMA_PeripheralBaseAddr = (uint32_t)&USART2->DR;
+	dma_init.DMA_Memory0BaseAddr = (uint32_t)ucDmaRing_UartRx;
+	dma_init.DMA_DIR = DMA_DIR_PeripheralToMemory;
+	dma_init.DMA_BufferSize = UART_RX_DMA_SIZE;
+	dma_init.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	dma_init.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	dma_init.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	dma_init.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	dma_init.DMA_Mode = DMA_Mode_Circular;
+	dma_init.DMA_Priority = DMA_Priority_High;
+	dma_init.DMA_FIFOMode = DMA_FIFOMode_Disable; //Direct mode, so each byte lands in memory as soon as it is received
+	DMA_Init(UART_RX_DMA_STREAM, &dma_init);
+
+	DMA_ClearFlag(UART_RX_DMA_STREAM, UART_RX_DMA_FLAGS);
+	DMA_ITConfig(UART_RX_DMA_STREAM, DMA_IT_HT | DMA_IT_TC | DMA_IT_TE, ENABLE);
+
+	//3. Interrupts. NVIC_SetPriority() takes the 4 bit priority as it is, which
+	//matches what FreeRTOS expects (all priority bits are preemption bits).
+	NVIC_SetPriority(DMA1_Stream5_IRQn, UART_RX_IRQ_PRIORITY);
+	NVIC_SetPriority(USART2_IRQn, UART_RX_IRQ_PRIORITY);
+	NVIC_EnableIRQ(DMA1_Stream5_IRQn);
+	NVIC_EnableIRQ(USART2_IRQn);
+
+	//4. Start. Discard anything received before now, then let the USART raise
+	//DMA requests for RXNE and an interrupt when the line goes idle.
+	(void)USART2->SR;
+	(void)USART2->DR;
+	DMA_Cmd(UART_RX_DMA_STREAM, ENABLE);
+	USART_DMACmd(USART2, USART_DMAReq_Rx, ENABLE);
+	USART_ITConfig(USART2, USART_IT_IDLE, ENABLE);
+}
+
+
+
+
+void vUartRxGetStats(UartRxStats_t *pxStats)
+{
+	taskENTER_CRITICAL();
+	*pxStats = xStats;
+	taskEXIT_CRITICAL();
+}
+
+
+
+
+//Copies the bytes the DMA has written since the last call into the stream
+//buffer. Called only from the DMA and USART interrupts, which share one
+//priority, so never re-entered.
+static void prvUartRxDeliver(BaseType_t *pxHigherPriorityTaskWoken)
+{
+	uint32_t marks;
+	size_t dma_index, received, copied;
+	BaseType_t half_expected, end_expected;
+
+	//Where the DMA will write next, and the marks it has passed. NDTR counts
+	//down from UART_RX_DMA_SIZE and reloads on reaching 0. A mark passed
+	//between the two reads would be missing from marks but included in
+	//dma_index, which is harmless, while one passed after NDTR is read would
+	//look like a lap on the next call, so read again until neither changes.
+	do
+	{
+		marks = UART_RX_DMA_STREAM_ISR & (UART_RX_DMA_HT | UART_RX_DMA_TC);
+		dma_index = UART_RX_DMA_SIZE - DMA_GetCurrDataCounter(UART_RX_DMA_STREAM);
+	} while (marks != (UART_RX_DMA_STREAM_ISR & (UART_RX_DMA_HT | UART_RX_DMA_TC)));
+	UART_RX_DMA_STREAM_IFCR = marks;
+
+	if (dma_index == UART_RX_DMA_SIZE)
+	{
+		dma_index = 0;
+	}
+
+	received = (dma_index + UART_RX_DMA_SIZE - xDmaIndex) % UART_RX_DMA_SIZE;
+
+	//Marks the DMA must have passed to move received bytes on from xDmaIndex
+	if (xDmaIndex < (UART_RX_DMA_SIZE / 2))
+	{
+		half_expected = ((xDmaIndex + received) >= (UART_RX_DMA_SIZE / 2)) ? pdTRUE : pdFALSE;
+	}
+	else
+	{
+		half_expected = ((xDmaIndex + received) >= (UART_RX_DMA_SIZE + (UART_RX_DMA_SIZE / 2))) ? pdTRUE : pdFALSE;
+	}
+	end_expected = ((xDmaIndex + received) >= UART_RX_DMA_SIZE) ? pdTRUE : pdFALSE;
+
+	if ((((marks & UART_RX_DMA_HT) != 0) && (half_expected == pdFALSE)) ||
+		(((marks & UART_RX_DMA_TC) != 0) && (end_expected == pdFALSE)))
+	{
+		//Lapped : the bytes between xDmaIndex and the DMA have been written
+		//over at least once, so none of them can be trusted. Start again from
+		//where the DMA is now.
+		xStats.ulLaps++;
+		xDmaIndex = dma_index;
+		return;
+	}
+
+	if (received > 0)
+	{
+		copied = prvUartRxCopy(received);
+
+		//The stream buffer is full : the rest is lost, as the DMA is already
+		//coming round to it again
+		if (copied < received)
+		{
+			xStats.ulOverruns++;
+		}
+		xDmaIndex = dma_index;
+
+		if (copied > 0)
+		{
+			(void)xStreamBufferCommitWriteFromISR(xUartRxStream, copied, pxHigherPriorityTaskWoken);
+			xStats.ulBytes += copied;
+			xStats.ulBursts++;
+		}
+	}
+}
+
+
+
+
+//Copies up to xCount bytes from xDmaIndex on into the stream buffer's free
+//space, without committing them, and returns how many were copied. Both the
+//DMA ring and the free space may wrap, so this is at most three memcpy().
+static size_t prvUartRxCopy(size_t xCount)
+{
+	StreamBufferRegions_t free_space;
+	size_t space, done, from, len;
+	uint8_t *to;
+
+	space = xStreamBufferAcquireWriteFromISR(xUartRxStream, &free_space);
+	if (xCount > space)
+	{
+		xCount = space;
+	}
+
+	from = xDmaIndex;
+	for (done = 0; done < xCount; done += len)
+	{
+		if (done < free_space.xRegion1Length)
+		{
+			to = free_space.pucRegion1 + done;
+			len = free_space.xRegion1Length - done;
+		}
+		else
+		{
+			to = free_space.pucRegion2 + (done - free_space.xRegion1Length);
+			len = free_space.xRegion2Length - (done - free_space.xRegion1Length);
+		}
+
+		if (len > (UART_RX_DMA_SIZE - from))
+		{
+			len = UART_RX_DMA_SIZE - from;
+		}
+		if (len > (xCount - done))
+		{
+			len = xCount - done;
+		}
+
+		memcpy(to, &ucDmaRing_UartRx[ from ], len);
+		from = (from + len) % UART_RX_DMA_SIZE;
+	}
+
+	return xCount;
+}
+
+
+
+
+//A transfer error disables the stream. Once disabled it restarts from the
+//start of the ring, with whatever count NDTR was left at, so set NDTR back to
+//a whole ring and the copy position to match.
+static void prvUartRxRestartDma(void)
+{
+	while (DMA_GetCmdStatus(UART_RX_DMA_STREAM) != DISABLE);
+	DMA_SetCurrDataCounter(UART_RX_DMA_STREAM, UART_RX_DMA_SIZE);
+	DMA_ClearFlag(UART_RX_DMA_STREAM, UART_RX_DMA_FLAGS);
+	xDmaIndex = 0;
+	DMA_Cmd(UART_RX_DMA_STREAM, ENABLE);
+}
+
+
+
+
+void DMA1_Stream5_IRQHandler(void)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	traceISR_ENTER();
+
+	//Half and full ring marks split long bursts so the reader can start on the
+	//first half while the DMA fills the second. prvUartRxDeliver() reads and
+	//clears the marks itself, as it needs them to tell a lap from a burst.
+	prvUartRxDeliver(&xHigherPriorityTaskWoken);
+
+	if (DMA_GetITStatus(UART_RX_DMA_STREAM, UART_RX_DMA_IT_TE) == SET)
+	{
+		//A transfer error disables the stream, so start it again. The bytes
+		//before the error have been delivered above.
+		DMA_ClearITPendingBit(UART_RX_DMA_STREAM, UART_RX_DMA_IT_TE);
+		xStats.ulErrors++;
+		prvUartRxRestartDma();
+	}
+
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+
+
+
+void USART2_IRQHandler(void)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+	uint16_t status;
+
+	traceISR_ENTER();
+
+	//IDLE (and the error flags) are cleared by reading SR then DR. The DMA has
+	//already taken the data, so the DR read loses nothing.
+	status = USART2->SR;
+	if (status & (USART_FLAG_IDLE | UART_RX_USART_ERRORS))
+	{
+		(void)USART2->DR;
+
+		if (status & UART_RX_USART_ERRORS)
+		{
+			xStats.ulErrors++;
+		}
+
+		//End of a burst : hand over whatever the DMA has written
+		if (status & USART_FLAG_IDLE)
+		{
+			prvUartRxDeliver(&xHigherPriorityTaskWoken);
+		}
+	}
+
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}